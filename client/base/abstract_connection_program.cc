@@ -46,4 +46,9 @@ CHARSET_INFO* Abstract_connection_program::get_current_charset() const
 void Abstract_connection_program::set_current_charset(CHARSET_INFO* charset)
 {
   m_connection_options.set_current_charset(charset);
-}
\ No newline at end of file
+}
+
+void Abstract_connection_program::set_local_infile(bool enabled)
+{
+  m_connection_options.set_local_infile(enabled);
+}
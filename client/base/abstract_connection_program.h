@@ -62,6 +62,11 @@ public:
    */
   void set_current_charset(CHARSET_INFO* charset);
 
+  /**
+    Enables LOAD DATA LOCAL INFILE in new MySQL connections.
+   */
+  void set_local_infile(bool enabled);
+
 protected:
   Abstract_connection_program();
 
@@ -46,7 +46,8 @@ static void atexit_mysql_library_end()
 Mysql_connection_options::Mysql_connection_options(Abstract_program *program)
   : m_ssl_options_provider(),
     m_program(program),
-    m_protocol(0)
+    m_protocol(0),
+    m_local_infile(false)
 {
   if (Mysql_connection_options::mysql_inited == false)
   {
@@ -158,6 +159,11 @@ MYSQL* Mysql_connection_options::create_connection()
   {
     mysql_options(connection, MYSQL_SET_CHARSET_NAME, "utf8mb4");
   }
+  if (this->m_local_infile)
+  {
+    uint local_infile= 1;
+    mysql_options(connection, MYSQL_OPT_LOCAL_INFILE, (char*)&local_infile);
+  }
   if (this->m_plugin_dir.has_value())
     mysql_options(connection, MYSQL_PLUGIN_DIR,
       this->m_plugin_dir.value().c_str());
@@ -209,6 +215,11 @@ void Mysql_connection_options::set_current_charset(CHARSET_INFO* charset)
   m_default_charset= string(charset->csname);
 }
 
+void Mysql_connection_options::set_local_infile(bool enabled)
+{
+  m_local_infile= enabled;
+}
+
 const char* Mysql_connection_options::get_null_or_string(
   Nullable<string>& maybe_string)
 {
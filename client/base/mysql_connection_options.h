@@ -105,6 +105,11 @@ public:
    */
   void set_current_charset(CHARSET_INFO* charset);
 
+  /**
+    Enables LOAD DATA LOCAL INFILE in new MySQL connections.
+   */
+  void set_local_infile(bool enabled);
+
 private:
   /**
     Returns pointer to constant array containing specified string or NULL
@@ -146,6 +151,7 @@ private:
   Nullable<std::string> m_default_charset;
   Nullable<std::string> m_server_public_key;
   bool m_get_server_public_key;
+  bool m_local_infile;
 };
 
 }
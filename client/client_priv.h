@@ -123,6 +123,12 @@ enum options_client
   OPT_START_SQL_FILE,
   OPT_FINISH_SQL_FILE,
   OPT_SKIP_MYSQL_SCHEMA,
+  OPT_MYSQLBINLOG_DECODE_THREADS,
+  OPT_MYSQLBINLOG_OFFSET_INDEX_DIR,
+  OPT_SLAP_RATE,
+  OPT_SLAP_WARMUP_TIME,
+  OPT_SLAP_LATENCY,
+  OPT_SLAP_COMPARE_ENGINES,
   /* Add new option above this */
   OPT_MAX_CLIENT_OPTION
 };
@@ -89,8 +89,10 @@ void Abstract_progress_watcher::object_processing_ended(
   Table_rows_dump_task* processed_table_task=
     dynamic_cast<Table_rows_dump_task*>(
     finished_process_data->get_process_task_object());
+  /* Table split into chunks is counted once, with its first chunk. */
   if (processed_table_task != NULL
-    && finished_process_data->had_chain_created())
+    && finished_process_data->had_chain_created()
+    && processed_table_task->get_chunk_index() == 0)
   {
     m_progress.m_table_count++;
     this->progress_changed();
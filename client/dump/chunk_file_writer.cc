@@ -0,0 +1,139 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "chunk_file_writer.h"
+#include "compression_writer_factory.h"
+#include <stdio.h>
+
+using namespace Mysql::Tools::Dump;
+
+void Chunk_file_writer::append_rows(const std::vector<Row*>& rows)
+{
+  std::string rows_string;
+  for (std::vector<Row*>::const_iterator row_iterator= rows.begin();
+    row_iterator != rows.end(); ++row_iterator)
+  {
+    const Mysql::Tools::Base::Mysql_query_runner::Row& row_data=
+      (*row_iterator)->m_row_data;
+    for (size_t column= 0; column < row_data.size(); ++column)
+    {
+      if (column > 0)
+        rows_string+= '\t';
+      if (row_data.is_value_null(column))
+      {
+        rows_string+= "\\N";
+        continue;
+      }
+      size_t column_length;
+      const char* column_data= row_data.get_buffer(column, column_length);
+      const char* column_end= column_data + column_length;
+      const char* plain_start= column_data;
+      for (; column_data < column_end; ++column_data)
+      {
+        char escaped;
+        switch (*column_data)
+        {
+        case '\\': escaped= '\\'; break;
+        case '\t': escaped= 't'; break;
+        case '\n': escaped= 'n'; break;
+        case '\r': escaped= 'r'; break;
+        case '\0': escaped= '0'; break;
+        default: continue;
+        }
+        rows_string.append(plain_start, column_data - plain_start);
+        rows_string+= '\\';
+        rows_string+= escaped;
+        plain_start= column_data + 1;
+      }
+      rows_string.append(plain_start, column_end - plain_start);
+    }
+    rows_string+= '\n';
+  }
+  m_output->append(rows_string);
+}
+
+void Chunk_file_writer::append_encoded_name(
+  std::string* out, const std::string& name)
+{
+  for (std::string::const_iterator it= name.begin(); it != name.end(); ++it)
+  {
+    unsigned char c= (unsigned char)*it;
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+      || (c >= '0' && c <= '9') || c == '_' || c == '$')
+    {
+      *out+= (char)c;
+    }
+    else
+    {
+      char buffer[4];
+      snprintf(buffer, sizeof(buffer), "@%02x", c);
+      *out+= buffer;
+    }
+  }
+}
+
+std::string Chunk_file_writer::get_file_name(const std::string& schema,
+  const std::string& table, uint chunk_index,
+  const Mysql::Nullable<std::string>* compression)
+{
+  std::string file_name;
+  append_encoded_name(&file_name, schema);
+  file_name+= '.';
+  append_encoded_name(&file_name, table);
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), ".%05u.txt", chunk_index);
+  file_name+= buffer;
+  if (compression != NULL && compression->has_value())
+  {
+    file_name+= Compression_writer_factory::get_file_extension(
+      compression->value());
+  }
+  return file_name;
+}
+
+Chunk_file_writer::~Chunk_file_writer()
+{
+  /* Compression writer flushes its stream to the file on destruction. */
+  delete m_compression_writer;
+  delete m_file_writer;
+}
+
+Chunk_file_writer::Chunk_file_writer(
+  Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+    message_handler, Simple_id_generator* object_id_generator,
+  const Mysql_object_reader_options* options,
+  Table_rows_dump_task* table_rows_dump_task)
+  : m_compression_writer(NULL)
+{
+  Table* table= table_rows_dump_task->get_related_table();
+  std::string file_name= options->m_chunk_output_dir.value() + "/"
+    + get_file_name(table->get_schema(), table->get_name(),
+      table_rows_dump_task->get_chunk_index(),
+      options->m_compress_output_algorithm);
+
+  m_file_writer= new File_writer(message_handler, object_id_generator,
+    file_name);
+  m_output= m_file_writer;
+  if (options->m_compress_output_algorithm != NULL
+    && options->m_compress_output_algorithm->has_value())
+  {
+    m_compression_writer= Compression_writer_factory::create_writer(
+      options->m_compress_output_algorithm->value(), m_file_writer,
+      message_handler, object_id_generator);
+    if (m_compression_writer != NULL)
+      m_output= m_compression_writer;
+  }
+}
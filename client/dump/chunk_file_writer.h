@@ -0,0 +1,72 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef CHUNK_FILE_WRITER_INCLUDED
+#define CHUNK_FILE_WRITER_INCLUDED
+
+#include "i_output_writer.h"
+#include "file_writer.h"
+#include "mysql_object_reader_options.h"
+#include "table_rows_dump_task.h"
+#include "row.h"
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Dump{
+
+/**
+  Writes rows of single table chunk to its own file in --chunk-output-dir,
+  in default LOAD DATA INFILE format: fields terminated by tab, lines
+  terminated by newline, escaped by backslash and NULL written as \N.
+  Chunk files of one table can be loaded in parallel.
+ */
+class Chunk_file_writer
+{
+public:
+  Chunk_file_writer(
+    Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+      message_handler, Simple_id_generator* object_id_generator,
+    const Mysql_object_reader_options* options,
+    Table_rows_dump_task* table_rows_dump_task);
+
+  ~Chunk_file_writer();
+
+  void append_rows(const std::vector<Row*>& rows);
+
+  /**
+    Returns name of file for given chunk, without directory:
+    <schema>.<table>.<chunk>.txt followed by compression extension. Bytes
+    of names other than letters, digits, '_' and '$' are written as @xx.
+   */
+  static std::string get_file_name(const std::string& schema,
+    const std::string& table, uint chunk_index,
+    const Mysql::Nullable<std::string>* compression);
+
+private:
+  static void append_encoded_name(std::string* out, const std::string& name);
+
+  File_writer* m_file_writer;
+  I_output_writer* m_compression_writer;
+  I_output_writer* m_output;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,71 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "compression_writer_factory.h"
+#include "compression_lz4_writer.h"
+#include "compression_zlib_writer.h"
+#include "compression_zstd_writer.h"
+#include "my_sys.h"
+#include <boost/algorithm/string.hpp>
+
+using namespace Mysql::Tools::Dump;
+
+I_output_writer* Compression_writer_factory::create_writer(
+  std::string algorithm_name, I_output_writer* output_writer,
+  Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+    message_handler, Simple_id_generator* object_id_generator)
+{
+  boost::to_lower(algorithm_name);
+  if (algorithm_name == "lz4")
+  {
+    Compression_lz4_writer* compression_writer=
+      new Compression_lz4_writer(message_handler, object_id_generator);
+    compression_writer->register_output_writer(output_writer);
+    return compression_writer;
+  }
+  else if (algorithm_name == "zlib")
+  {
+    Compression_zlib_writer* compression_writer=
+      new Compression_zlib_writer(message_handler, object_id_generator,
+        Z_DEFAULT_COMPRESSION);
+    compression_writer->register_output_writer(output_writer);
+    return compression_writer;
+  }
+#ifdef HAVE_ZSTD
+  else if (algorithm_name == "zstd")
+  {
+    Compression_zstd_writer* compression_writer=
+      new Compression_zstd_writer(message_handler, object_id_generator,
+        MYSQL_ZSTD_DEFAULT_LEVEL);
+    compression_writer->register_output_writer(output_writer);
+    return compression_writer;
+  }
+#endif
+  return NULL;
+}
+
+std::string Compression_writer_factory::get_file_extension(
+  std::string algorithm_name)
+{
+  boost::to_lower(algorithm_name);
+  if (algorithm_name == "lz4")
+    return ".lz4";
+  if (algorithm_name == "zlib")
+    return ".zlib";
+  if (algorithm_name == "zstd")
+    return ".zst";
+  return "";
+}
@@ -0,0 +1,56 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef COMPRESSION_WRITER_FACTORY_INCLUDED
+#define COMPRESSION_WRITER_FACTORY_INCLUDED
+
+#include "i_output_writer.h"
+#include "simple_id_generator.h"
+#include "i_callable.h"
+#include "base/message_data.h"
+#include <string>
+
+namespace Mysql{
+namespace Tools{
+namespace Dump{
+
+/**
+  Creates compression Output Writers by --compress-output algorithm name.
+ */
+class Compression_writer_factory
+{
+public:
+  /**
+    Returns new compression writer for given algorithm name ("lz4", "zlib"
+    or "zstd", case insensitive), that passes compressed data to specified
+    Output Writer, or NULL if algorithm is unknown or not compiled in.
+   */
+  static I_output_writer* create_writer(std::string algorithm_name,
+    I_output_writer* output_writer,
+    Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+      message_handler, Simple_id_generator* object_id_generator);
+
+  /**
+    Returns usual file name extension for given algorithm, including dot.
+   */
+  static std::string get_file_extension(std::string algorithm_name);
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,95 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "compression_zstd_writer.h"
+
+#ifdef HAVE_ZSTD
+
+using namespace Mysql::Tools::Dump;
+
+bool Compression_zstd_writer::check_result(size_t zstd_result)
+{
+  if (ZSTD_isError(zstd_result))
+  {
+    this->pass_message(Mysql::Tools::Base::Message_data(
+      0, std::string("zstd compression failed: ")
+      + ZSTD_getErrorName(zstd_result),
+      Mysql::Tools::Base::Message_type_error));
+    return true;
+  }
+  return false;
+}
+
+void Compression_zstd_writer::append(const std::string& data_to_append)
+{
+  my_boost::mutex::scoped_lock lock(m_zstd_mutex);
+  if (m_compression_context == NULL)
+    return;
+  ZSTD_inBuffer input= { data_to_append.c_str(), data_to_append.size(), 0 };
+  while (input.pos < input.size)
+  {
+    ZSTD_outBuffer output= { &m_buffer[0], m_buffer.size(), 0 };
+    if (this->check_result(ZSTD_compressStream(m_compression_context,
+      &output, &input)))
+    {
+      return;
+    }
+    if (output.pos > 0)
+      this->append_output(std::string(&m_buffer[0], output.pos));
+  }
+}
+
+Compression_zstd_writer::~Compression_zstd_writer()
+{
+  my_boost::mutex::scoped_lock lock(m_zstd_mutex);
+  if (m_compression_context == NULL)
+    return;
+  size_t remaining;
+  do
+  {
+    ZSTD_outBuffer output= { &m_buffer[0], m_buffer.size(), 0 };
+    remaining= ZSTD_endStream(m_compression_context, &output);
+    if (this->check_result(remaining))
+      break;
+    if (output.pos > 0)
+      this->append_output(std::string(&m_buffer[0], output.pos));
+  }
+  while (remaining > 0);
+  ZSTD_freeCStream(m_compression_context);
+}
+
+Compression_zstd_writer::Compression_zstd_writer(
+  Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+    message_handler, Simple_id_generator* object_id_generator,
+    int compression_level)
+  : Abstract_output_writer_wrapper(message_handler, object_id_generator),
+  m_compression_context(ZSTD_createCStream())
+{
+  m_buffer.resize(ZSTD_CStreamOutSize());
+  if (m_compression_context == NULL
+    || this->check_result(ZSTD_initCStream(m_compression_context,
+    compression_level)))
+  {
+    this->pass_message(Mysql::Tools::Base::Message_data(
+      0, "zstd compression initialization failed",
+      Mysql::Tools::Base::Message_type_error));
+    if (m_compression_context != NULL)
+      ZSTD_freeCStream(m_compression_context);
+    m_compression_context= NULL;
+  }
+}
+
+#endif
@@ -0,0 +1,66 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef COMPRESSION_ZSTD_WRITER_INCLUDED
+#define COMPRESSION_ZSTD_WRITER_INCLUDED
+
+#include "my_global.h"
+
+#ifdef HAVE_ZSTD
+
+#include "i_output_writer.h"
+#include "abstract_output_writer_wrapper.h"
+#include "i_callable.h"
+#include "base/mutex.h"
+#include <zstd.h>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Dump{
+
+/**
+  Wrapper to another Output Writer, compresses formatted data stream with
+  zstd. Output is a single zstd frame, readable with zstd -d.
+ */
+class Compression_zstd_writer : public I_output_writer,
+  public Abstract_output_writer_wrapper
+{
+public:
+  Compression_zstd_writer(
+    Mysql::I_callable<bool, const Mysql::Tools::Base::Message_data&>*
+      message_handler, Simple_id_generator* object_id_generator,
+    int compression_level);
+
+  ~Compression_zstd_writer();
+
+  void append(const std::string& data_to_append);
+
+private:
+  bool check_result(size_t zstd_result);
+
+  my_boost::mutex m_zstd_mutex;
+  ZSTD_CStream* m_compression_context;
+  std::vector<char> m_buffer;
+};
+
+}
+}
+}
+
+#endif
+
+#endif
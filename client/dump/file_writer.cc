@@ -23,11 +23,14 @@
 */
 
 #include "file_writer.h"
+#include <errno.h>
 
 using namespace Mysql::Tools::Dump;
 
 void File_writer::append(const std::string& data_to_append)
 {
+  if (m_file == NULL)
+    return;
   fwrite(data_to_append.c_str(), 1, data_to_append.size(), m_file);
   // Check for I/O errors.
   if (ferror(m_file) != 0)
@@ -40,6 +43,8 @@ void File_writer::append(const std::string& data_to_append)
 
 File_writer::~File_writer()
 {
+  if (m_file == NULL)
+    return;
   // Check for I/O errors and close file.
   if (ferror(m_file) != 0 || fclose(m_file) != 0)
   {
@@ -55,4 +60,11 @@ File_writer::File_writer(
   const std::string& file_name)
   : Abstract_chain_element(message_handler, object_id_generator),
   m_file(fopen(file_name.c_str(), "wb"))
-{}
+{
+  if (m_file == NULL)
+  {
+    this->pass_message(Mysql::Tools::Base::Message_data(errno,
+      "Error occurred while opening output file " + file_name + ".",
+      Mysql::Tools::Base::Message_type_error));
+  }
+}
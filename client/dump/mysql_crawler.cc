@@ -28,6 +28,7 @@
 #include "table_definition_dump_task.h"
 #include "mysqldump_tool_chain_maker_options.h"
 #include "table_rows_dump_task.h"
+#include "table_chunk_ranges.h"
 #include "table_deferred_indexes_dump_task.h"
 #include "event_scheduler_event.h"
 #include "privilege.h"
@@ -247,20 +248,42 @@ void Mysql_crawler::enumerate_tables(const Database& db)
 
     Table_definition_dump_task* ddl_task=
       new Table_definition_dump_task(table);
-    Table_rows_dump_task* rows_task= new Table_rows_dump_task(table);
     Table_deferred_indexes_dump_task* indexes_task=
       new Table_deferred_indexes_dump_task(table);
 
+    /*
+      Chunks of one table are independent tasks, so they are dumped
+      concurrently by the queue threads.
+    */
+    std::vector<std::string> chunk_conditions=
+      this->get_table_chunk_conditions(runner, *table);
+    std::vector<Abstract_dump_task*> rows_tasks;
+    if (chunk_conditions.empty())
+      rows_tasks.push_back(new Table_rows_dump_task(table));
+    for (size_t chunk= 0; chunk < chunk_conditions.size(); ++chunk)
+    {
+      rows_tasks.push_back(new Table_rows_dump_task(table,
+        chunk_conditions[chunk], (uint)chunk, (uint)chunk_conditions.size()));
+    }
+
     ddl_task->add_dependency(m_current_database_start_dump_task);
-    rows_task->add_dependency(ddl_task);
-    indexes_task->add_dependency(rows_task);
+    for (std::vector<Abstract_dump_task*>::iterator rows_it=
+      rows_tasks.begin(); rows_it != rows_tasks.end(); ++rows_it)
+    {
+      (*rows_it)->add_dependency(ddl_task);
+      indexes_task->add_dependency(*rows_it);
+    }
     m_current_database_end_dump_task->add_dependency(indexes_task);
     m_tables_definition_ready_dump_task->add_dependency(ddl_task);
 
     this->process_dump_task(ddl_task);
-    this->process_dump_task(rows_task);
+    for (std::vector<Abstract_dump_task*>::iterator rows_it=
+      rows_tasks.begin(); rows_it != rows_tasks.end(); ++rows_it)
+    {
+      this->process_dump_task(*rows_it);
+    }
 
-    this->enumerate_table_triggers(*table, rows_task);
+    this->enumerate_table_triggers(*table, rows_tasks);
 
     this->process_dump_task(indexes_task);
   }
@@ -446,7 +469,7 @@ void Mysql_crawler::enumerate_users()
 }
 
 void Mysql_crawler::enumerate_table_triggers(
-  const Table& table, Abstract_dump_task* dependency)
+  const Table& table, const std::vector<Abstract_dump_task*>& dependencies)
 {
   // Triggers were supported since 5.0.9
   if (this->get_server_version() < 50009)
@@ -471,7 +494,12 @@ void Mysql_crawler::enumerate_table_triggers(
       "TRIGGER", "50017", "50003") + "\n//\n" + "DELIMITER ;\n",
       &table);
 
-    trigger->add_dependency(dependency);
+    for (std::vector<Abstract_dump_task*>::const_iterator dependency_it=
+      dependencies.begin(); dependency_it != dependencies.end();
+      ++dependency_it)
+    {
+      trigger->add_dependency(*dependency_it);
+    }
     m_current_database_end_dump_task->add_dependency(trigger);
 
     this->process_dump_task(trigger);
@@ -481,6 +509,52 @@ void Mysql_crawler::enumerate_table_triggers(
 }
 
 
+std::vector<std::string> Mysql_crawler::get_table_chunk_conditions(
+  Mysql::Tools::Base::Mysql_query_runner* runner, const Table& table)
+{
+  std::vector<std::string> conditions;
+  uint64 chunk_rows= m_mysqldump_tool_cmaker_options->m_table_chunk_rows;
+  if (chunk_rows == 0 || table.get_row_count() <= chunk_rows)
+    return conditions;
+
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*> keys;
+  runner->run_query_store("SHOW KEYS FROM "
+    + this->get_quoted_object_full_name(&table) + " WHERE Key_name = 'PRIMARY'", &keys);
+  std::string key_column;
+  if (keys.size() == 1)
+    key_column= (*keys[0])[4]; // "Column_name"
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&keys);
+
+  /* Only integer keys can be split into ranges by arithmetic. */
+  std::string key_type;
+  for (std::vector<Field>::const_iterator it= table.get_fields().begin();
+    it != table.get_fields().end(); ++it)
+  {
+    if (it->get_name() == key_column)
+      key_type= it->get_type_string();
+  }
+  bool is_unsigned;
+  if (key_column.empty() || !is_integer_column_type(key_type, &is_unsigned))
+    return conditions;
+
+  std::string quoted_key= this->quote_name(key_column);
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*> bounds;
+  runner->run_query_store("SELECT MIN(" + quoted_key + "), MAX("
+    + quoted_key + ") FROM " + this->get_quoted_object_full_name(&table),
+    &bounds);
+  /*
+    The first and the last chunk are open ended, so rows inserted outside
+    of the estimated range are dumped as well when no consistent snapshot
+    is used.
+  */
+  if (bounds.size() == 1 && !bounds[0]->is_value_null(0))
+    conditions= get_key_range_conditions(quoted_key, is_unsigned,
+      (*bounds[0])[0], (*bounds[0])[1], table.get_row_count(), chunk_rows);
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&bounds);
+  return conditions;
+}
+
+
 std::string Mysql_crawler::get_version_specific_statement(
   std::string create_string, const std::string& keyword,
   std::string main_version, std::string definer_version)
@@ -73,7 +73,16 @@ private:
   void enumerate_tables(const Database& db);
 
   void enumerate_table_triggers(const Table& table,
-    Abstract_dump_task* dependency);
+    const std::vector<Abstract_dump_task*>& dependencies);
+
+  /**
+    Returns conditions splitting rows of given table into primary key ranges
+    of about --table-chunk-rows rows each. Returns no conditions if table is
+    not to be split, i.e. it is small or has no single column integer
+    primary key.
+   */
+  std::vector<std::string> get_table_chunk_conditions(
+    Mysql::Tools::Base::Mysql_query_runner* runner, const Table& table);
 
   void enumerate_views(const Database& db);
 
@@ -41,7 +41,17 @@ void Mysql_object_reader::Rows_fetching_context::process_buffer()
 {
   if (m_row_group.m_rows.size() == 0)
     return;
-  m_parent->format_rows(m_item_processing, &m_row_group);
+  if (m_chunk_file != NULL)
+  {
+    m_chunk_file->append_rows(m_row_group.m_rows);
+    for (std::vector<Row*>::iterator it= m_row_group.m_rows.begin();
+      it != m_row_group.m_rows.end(); ++it)
+    {
+      delete *it;
+    }
+  }
+  else
+    m_parent->format_rows(m_item_processing, &m_row_group);
 
   m_row_group.m_rows.clear();
 }
@@ -66,12 +76,13 @@ int64 Mysql_object_reader::Rows_fetching_context::result_callback(
 
 Mysql_object_reader::Rows_fetching_context::Rows_fetching_context(
   Mysql_object_reader* parent, Item_processing_data* item_processing,
-  bool has_generated_column)
+  bool has_generated_column, Chunk_file_writer* chunk_file)
   : m_parent(parent),
   m_item_processing(item_processing),
   m_row_group((Table*)item_processing
     ->get_process_task_object()->get_related_db_object(), m_fields,
-    has_generated_column)
+    has_generated_column),
+  m_chunk_file(chunk_file)
 {
   m_row_group.m_rows.reserve(
     (size_t)m_parent->m_options->m_row_group_size);
@@ -97,8 +108,8 @@ void Mysql_object_reader::read_table_rows_task(
     "SELECT `COLUMN_NAME`, `EXTRA` FROM " +
     this->get_quoted_object_full_name("INFORMATION_SCHEMA", "COLUMNS") +
     "WHERE TABLE_SCHEMA ='" + runner->escape_string(table->get_schema()) +
-    "' AND TABLE_NAME ='" + runner->escape_string(table->get_name()) + "'",
-    &columns);
+    "' AND TABLE_NAME ='" + runner->escape_string(table->get_name()) +
+    "' ORDER BY ORDINAL_POSITION", &columns);
 
   std::string column_names;
   for (std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*>::iterator
@@ -116,12 +127,22 @@ void Mysql_object_reader::read_table_rows_task(
 
   Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&columns);
 
+  Chunk_file_writer* chunk_file= NULL;
+  if (m_options->m_chunk_output_dir.has_value())
+  {
+    chunk_file= new Chunk_file_writer(this->get_message_handler(),
+      this->get_object_id_generator(), m_options, table_rows_dump_task);
+  }
+
   Rows_fetching_context* row_fetching_context=
-    new Rows_fetching_context(this, item_to_process, has_generated_columns);
+    new Rows_fetching_context(this, item_to_process, has_generated_columns,
+      chunk_file);
 
+  std::string where_clause= table_rows_dump_task->get_where_clause();
   runner->run_query(
     "SELECT " + column_names + "  FROM " +
-    this->get_quoted_object_full_name(table),
+    this->get_quoted_object_full_name(table) +
+    (where_clause.empty() ? "" : " WHERE " + where_clause),
     new Mysql::Instance_callback<
       int64, const Mysql::Tools::Base::Mysql_query_runner::Row&,
         Rows_fetching_context>(
@@ -130,6 +151,7 @@ void Mysql_object_reader::read_table_rows_task(
   row_fetching_context->process_buffer();
   if (row_fetching_context->is_all_rows_processed())
     delete row_fetching_context;
+  delete chunk_file;
   delete runner;
 }
 
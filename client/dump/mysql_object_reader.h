@@ -32,6 +32,7 @@
 #include "row_group_dump_task.h"
 #include "table_rows_dump_task.h"
 #include "mysql_field.h"
+#include "chunk_file_writer.h"
 
 namespace Mysql{
 namespace Tools{
@@ -67,7 +68,8 @@ private:
   {
   public:
     Rows_fetching_context(Mysql_object_reader* parent,
-        Item_processing_data* item_processing, bool has_generated_column);
+        Item_processing_data* item_processing, bool has_generated_column,
+        Chunk_file_writer* chunk_file);
 
     int64 result_callback(
       const Mysql::Tools::Base::Mysql_query_runner::Row& row_data);
@@ -82,6 +84,10 @@ private:
     Item_processing_data* m_item_processing;
     Row_group_dump_task m_row_group;
     std::vector<Mysql_field> m_fields;
+    /**
+      File rows are written to instead of the formatters, if any.
+     */
+    Chunk_file_writer* m_chunk_file;
   };
 };
 
@@ -35,9 +35,16 @@ void Mysql_object_reader_options::create_options()
     ->set_minimum_value(1)
     ->set_maximum_value(MAX_EXTENDED_INSERT)
     ->set_value(250);
+  this->create_new_option(&m_chunk_output_dir, "chunk-output-dir",
+    "Write rows of each table, or of each chunk of table split with "
+    "--table-chunk-rows, to separate file in specified directory instead of "
+    "main output. Files are in default LOAD DATA INFILE format, named "
+    "<schema>.<table>.<chunk>.txt and compressed as specified with "
+    "--compress-output, so they can be loaded in parallel.");
 }
 
 Mysql_object_reader_options::Mysql_object_reader_options(
   const Mysql_chain_element_options* mysql_chain_element_options)
-  : m_mysql_chain_element_options(mysql_chain_element_options)
+  : m_mysql_chain_element_options(mysql_chain_element_options),
+  m_compress_output_algorithm(NULL)
 {}
@@ -45,6 +45,14 @@ public:
 
   uint64 m_row_group_size;
   const Mysql_chain_element_options* m_mysql_chain_element_options;
+  /**
+    Directory to write rows of each table chunk to, in separate files.
+   */
+  Mysql::Nullable<std::string> m_chunk_output_dir;
+  /**
+    Compression of chunk files, same as for main output.
+   */
+  const Mysql::Nullable<std::string>* m_compress_output_algorithm;
 };
 
 }
@@ -26,8 +26,7 @@
 #include "i_output_writer.h"
 #include "file_writer.h"
 #include "standard_writer.h"
-#include "compression_lz4_writer.h"
-#include "compression_zlib_writer.h"
+#include "compression_writer_factory.h"
 #include "sql_formatter.h"
 #include "mysqldump_tool_chain_maker_options.h"
 #include <boost/algorithm/string.hpp>
@@ -74,37 +73,20 @@ I_object_reader* Mysqldump_tool_chain_maker::create_chain(
     m_all_created_elements.push_back(writer);
     if (m_options->m_compress_output_algorithm.has_value())
     {
-      std::string algorithm_name=
-        m_options->m_compress_output_algorithm.value();
-      boost::to_lower(algorithm_name);
-
-      Abstract_output_writer_wrapper* compression_writer_as_wrapper= NULL;
-      I_output_writer* compression_writer_as_writer= NULL;
-      if (algorithm_name == "lz4")
-      {
-        Compression_lz4_writer* compression_writer=
-          new Compression_lz4_writer(
-            this->get_message_handler(), this->get_object_id_generator());
-        compression_writer_as_wrapper= compression_writer;
-          compression_writer_as_writer= compression_writer;
-      }
-      else if (algorithm_name =="zlib")
-      {
-        Compression_zlib_writer* compression_writer=
-          new Compression_zlib_writer(
-            this->get_message_handler(), this->get_object_id_generator(),
-            Z_DEFAULT_COMPRESSION);
-        compression_writer_as_wrapper= compression_writer;
-        compression_writer_as_writer= compression_writer;
-      }
-      else
+      I_output_writer* compression_writer=
+        Compression_writer_factory::create_writer(
+          m_options->m_compress_output_algorithm.value(), writer,
+          this->get_message_handler(), this->get_object_id_generator());
+      if (compression_writer == NULL)
         this->pass_message(Mysql::Tools::Base::Message_data(
-          0, "Unknown compression method: " + algorithm_name,
+          0, "Unknown compression method: "
+          + m_options->m_compress_output_algorithm.value(),
           Mysql::Tools::Base::Message_type_error));
-
-      compression_writer_as_wrapper->register_output_writer(writer);
-      writer= compression_writer_as_writer;
-      m_all_created_elements.push_back(writer);
+      else
+      {
+        writer= compression_writer;
+        m_all_created_elements.push_back(writer);
+      }
     }
     Sql_formatter* formatter= new Sql_formatter(
       this->get_connection_provider(),
@@ -235,10 +235,16 @@ void Mysqldump_tool_chain_maker_options::create_options()
   this->create_new_option(&m_result_file, "result-file",
     "Direct all output generated for all objects to a given file.");
   this->create_new_option(&m_compress_output_algorithm, "compress-output",
-    "Compresses all output files with LZ4 or ZLIB compression algorithm.");
+    "Compresses all output files with LZ4, ZLIB or ZSTD compression "
+    "algorithm.");
   this->create_new_option(&m_skip_rows_data, "skip-dump-rows",
     "Skip dumping rows of all tables to output.")
     ->set_short_character('d');
+  this->create_new_option(&m_table_chunk_rows, "table-chunk-rows",
+    "Split rows of tables with more than N rows into primary key ranges of "
+    "about N rows, which are dumped in parallel. Only tables with single "
+    "column integer primary key are split. 0 disables splitting.")
+    ->set_value(0);
 }
 
 Mysqldump_tool_chain_maker_options::~Mysqldump_tool_chain_maker_options()
@@ -259,6 +265,8 @@ Mysqldump_tool_chain_maker_options::Mysqldump_tool_chain_maker_options(
   m_parallel_thread_count(0),
   m_object_filter(mysql_chain_element_options->get_program())
 {
+  m_object_reader_options->m_compress_output_algorithm=
+    &m_compress_output_algorithm;
   this->add_provider(m_formatter_options);
   this->add_provider(m_object_reader_options);
   this->add_provider(&m_object_filter);
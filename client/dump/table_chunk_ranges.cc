@@ -0,0 +1,104 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "table_chunk_ranges.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace Mysql{
+namespace Tools{
+namespace Dump{
+
+bool is_integer_column_type(const std::string& type_string,
+  bool* is_unsigned)
+{
+  static const char* const integer_types[]=
+    { "tinyint", "smallint", "mediumint", "int", "integer", "bigint" };
+
+  /* "bigint(20) unsigned zerofill" */
+  std::string name= type_string.substr(0, type_string.find_first_of("( "));
+  for (size_t i= 0; i < sizeof(integer_types) / sizeof(integer_types[0]);
+    ++i)
+  {
+    if (name == integer_types[i])
+    {
+      *is_unsigned= (" " + type_string + " ").find(" unsigned ")
+        != std::string::npos;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+std::vector<std::string> get_key_range_conditions(
+  const std::string& quoted_key, bool is_unsigned,
+  const std::string& min_value, const std::string& max_value,
+  uint64 row_count, uint64 chunk_rows)
+{
+  std::vector<std::string> conditions;
+  if (chunk_rows == 0)
+    return conditions;
+
+  /*
+    Signed values are handled as offsets from the minimum in unsigned
+    arithmetic, which covers the whole BIGINT range without overflow.
+  */
+  uint64 min_key= is_unsigned
+    ? strtoull(min_value.c_str(), NULL, 10)
+    : (uint64)strtoll(min_value.c_str(), NULL, 10);
+  uint64 max_key= is_unsigned
+    ? strtoull(max_value.c_str(), NULL, 10)
+    : (uint64)strtoll(max_value.c_str(), NULL, 10);
+  uint64 span= max_key - min_key;
+  if (is_unsigned ? max_key < min_key : (longlong)max_key < (longlong)min_key)
+    return conditions;
+
+  uint64 chunks= row_count / chunk_rows + (row_count % chunk_rows != 0);
+  if (chunks > span)
+    chunks= span;
+  if (chunks < 2)
+    return conditions;
+
+  std::string previous_bound;
+  for (uint64 chunk= 1; chunk <= chunks; ++chunk)
+  {
+    std::string bound;
+    if (chunk < chunks)
+    {
+      uint64 value= min_key + span / chunks * chunk;
+      char buffer[32];
+      if (is_unsigned)
+        snprintf(buffer, sizeof(buffer), "%llu", (ulonglong)value);
+      else
+        snprintf(buffer, sizeof(buffer), "%lld", (longlong)value);
+      bound= buffer;
+    }
+    std::string condition;
+    if (!previous_bound.empty())
+      condition= quoted_key + " >= " + previous_bound;
+    if (!bound.empty())
+      condition+= (condition.empty() ? "" : " AND ")
+        + quoted_key + " < " + bound;
+    conditions.push_back(condition);
+    previous_bound= bound;
+  }
+  return conditions;
+}
+
+}
+}
+}
@@ -0,0 +1,50 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef TABLE_CHUNK_RANGES_INCLUDED
+#define TABLE_CHUNK_RANGES_INCLUDED
+
+#include "my_global.h"
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Dump{
+
+/**
+  Returns true if type_string, a column type as SHOW COLUMNS shows it, is
+  one of the integer types, and sets is_unsigned.
+ */
+bool is_integer_column_type(const std::string& type_string,
+  bool* is_unsigned);
+
+/**
+  Returns WHERE conditions splitting the rows with quoted_key between
+  min_value and max_value into ranges of about chunk_rows of row_count
+  rows. The first and the last range are open ended. Returns no conditions
+  if there would be less than two ranges.
+ */
+std::vector<std::string> get_key_range_conditions(
+  const std::string& quoted_key, bool is_unsigned,
+  const std::string& min_value, const std::string& max_value,
+  uint64 row_count, uint64 chunk_rows);
+
+}
+}
+}
+
+#endif
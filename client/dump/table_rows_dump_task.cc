@@ -27,5 +27,30 @@
 using namespace Mysql::Tools::Dump;
 
 Table_rows_dump_task::Table_rows_dump_task(Table* related_table)
-  : Abstract_table_dump_task(related_table)
+  : Abstract_table_dump_task(related_table),
+  m_chunk_index(0),
+  m_chunk_count(1)
 {}
+
+Table_rows_dump_task::Table_rows_dump_task(Table* related_table,
+  const std::string& where_clause, uint chunk_index, uint chunk_count)
+  : Abstract_table_dump_task(related_table),
+  m_where_clause(where_clause),
+  m_chunk_index(chunk_index),
+  m_chunk_count(chunk_count)
+{}
+
+const std::string& Table_rows_dump_task::get_where_clause() const
+{
+  return m_where_clause;
+}
+
+uint Table_rows_dump_task::get_chunk_index() const
+{
+  return m_chunk_index;
+}
+
+uint Table_rows_dump_task::get_chunk_count() const
+{
+  return m_chunk_count;
+}
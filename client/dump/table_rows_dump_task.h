@@ -26,18 +26,43 @@
 #define TABLE_ROWS_DUMP_TASK_INCLUDED
 
 #include "abstract_table_dump_task.h"
+#include <string>
 
 namespace Mysql{
 namespace Tools{
 namespace Dump{
 
 /**
-  Represents task for extracting rows of single DB table.
+  Represents task for extracting rows of single DB table, or of single
+  primary key range (chunk) of it.
  */
 class Table_rows_dump_task : public Abstract_table_dump_task
 {
 public:
   Table_rows_dump_task(Table* related_table);
+
+  Table_rows_dump_task(Table* related_table, const std::string& where_clause,
+    uint chunk_index, uint chunk_count);
+
+  /**
+    Returns condition selecting rows of this chunk, empty for whole table.
+   */
+  const std::string& get_where_clause() const;
+
+  /**
+    Returns index of this chunk, starting from 0.
+   */
+  uint get_chunk_index() const;
+
+  /**
+    Returns number of chunks the table is split into, 1 for whole table.
+   */
+  uint get_chunk_count() const;
+
+private:
+  std::string m_where_clause;
+  uint m_chunk_index;
+  uint m_chunk_count;
 };
 
 }
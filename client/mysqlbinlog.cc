@@ -67,10 +67,13 @@ static void warning(const char *format, ...)
 #include "sql_string.h"
 #include "my_decimal.h"
 #include "rpl_constants.h"
+#include "mysqlbinlog_index.h"
 
 #include <algorithm>
 #include <utility>
 #include <map>
+#include <string>
+#include <vector>
 
 using std::min;
 using std::max;
@@ -305,7 +308,7 @@ struct buff_event_info
   which stores such an event and the corresponding log position.
 */
 typedef Prealloced_array<buff_event_info, 16, true> Buff_ev;
-Buff_ev *buff_ev(PSI_NOT_INSTRUMENTED);
+thread_local Buff_ev *buff_ev= NULL;
 
 // needed by net_serv.c
 ulong bytes_sent = 0L, bytes_received = 0L;
@@ -314,7 +317,7 @@ ulong open_files_limit;
 ulong opt_binlog_rows_event_max_size;
 uint test_flags = 0; 
 static uint opt_protocol= 0;
-static FILE *result_file;
+static thread_local FILE *result_file;
 
 #ifndef NDEBUG
 static const char* default_dbug_option = "d:t:o,/tmp/mysqlbinlog.trace";
@@ -371,12 +374,35 @@ static char *charset= 0;
 static uint verbose= 0;
 
 static ulonglong start_position, stop_position;
-#define start_position_mot ((my_off_t)start_position)
-#define stop_position_mot  ((my_off_t)stop_position)
+#define start_position_mot (log_range.start_position)
+#define stop_position_mot  (log_range.stop_position)
 
 static char *start_datetime_str, *stop_datetime_str;
 static my_time_t start_datetime= 0, stop_datetime= MY_TIME_T_MAX;
-static ulonglong rec_count= 0;
+static thread_local ulonglong rec_count= 0;
+static uint opt_decode_threads= 1;
+static char *opt_offset_index_dir= NULL;
+
+/*
+  The part of a binlog file decoded by the current thread, and the
+  --start-datetime and --offset conditions as they stand for it.
+  The main thread decodes whole files, decode threads get the range
+  of the file planned for them by dump_logs_in_parallel().
+*/
+struct Log_range
+{
+  my_off_t start_position;
+  my_off_t stop_position;
+  /* Reading stops before the event at this offset, without OK_STOP. */
+  my_off_t end_position;
+  my_time_t start_datetime;
+  ulonglong offset;
+  /* False if another thread prints the Format_description event. */
+  bool print_fd;
+  /* Set when events were skipped for being before --start-datetime. */
+  bool skipped_before_start;
+};
+static thread_local Log_range log_range;
 static MYSQL* mysql = NULL;
 static char* dirname_for_local_load= 0;
 static uint opt_server_id_bits = 0;
@@ -392,7 +418,7 @@ Gtid_set *gtid_set_excluded= NULL;
   This will be changed each time a new Format_description_log_event is
   found in the binlog. It is finally destroyed at program termination.
 */
-static Format_description_log_event* glob_description_event= NULL;
+static thread_local Format_description_log_event* glob_description_event= NULL;
 
 /**
   Exit status for functions in this file.
@@ -412,12 +438,14 @@ enum Exit_status {
 static char *opt_include_gtids_str= NULL,
             *opt_exclude_gtids_str= NULL;
 static my_bool opt_skip_gtids= 0;
-static bool filter_based_on_gtids= false;
+static thread_local bool filter_based_on_gtids= false;
 
 /* It is set to true when BEGIN is found, and false when the transaction ends. */
-static bool in_transaction= false;
+static thread_local bool in_transaction= false;
 /* It is set to true when GTID is found, and false when the transaction ends. */
-static bool seen_gtid= false;
+static thread_local bool seen_gtid= false;
+/* Cleared when the first real Format_description event has been seen. */
+static thread_local bool is_first_fd= true;
 
 static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
                                           const char* logname);
@@ -428,7 +456,7 @@ static Exit_status dump_single_log(PRINT_EVENT_INFO *print_event_info,
 static Exit_status dump_multiple_logs(int argc, char **argv);
 static Exit_status safe_connect();
 
-struct buff_event_info buff_event;
+thread_local struct buff_event_info buff_event;
 
 class Load_log_processor
 {
@@ -877,7 +905,7 @@ Exit_status Load_log_processor::process(Append_block_log_event *ae)
 }
 
 
-static Load_log_processor load_processor;
+static thread_local Load_log_processor load_processor;
 
 
 /**
@@ -1177,44 +1205,59 @@ void end_binlog(PRINT_EVENT_INFO *print_event_info)
 }
 
 /**
-  Print the given event, and either delete it or delegate the deletion
-  to someone else.
+  Ends a statement whose last rows event is skipped: appends the
+  END-MARKER to the body cache and flushes the caches to result_file.
 
-  The deletion may be delegated in these cases:
-  (1) the event is a Format_description_log_event, and is saved in
-      glob_description_event.
-  (2) the event is a Create_file_log_event, and is saved in load_processor.
-  (3) the event is an Intvar, Rand or User_var event, it will be kept until
-      the subsequent Query_log_event.
-  (4) the event is a Table_map_log_event, it will be kept until the subsequent
-      Rows_log_event.
-  @param[in,out] print_event_info Parameters and context state
-  determining how to print.
-  @param[in] ev Log_event to process.
-  @param[in] pos Offset from beginning of binlog file.
-  @param[in] logname Name of input binlog.
+  @param[in,out] print_event_info Context state determining how to print.
 
-  @retval ERROR_STOP An error occurred - the program should terminate.
-  @retval OK_CONTINUE No error, the program should continue.
-  @retval OK_STOP No error, but the end of the specified range of
-  events to process has been reached and the program should terminate.
+  @retval true Failed writing to result_file.
+  @retval false Success.
 */
-Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
-                          my_off_t pos, const char *logname)
+static bool end_skipped_statement(PRINT_EVENT_INFO *print_event_info)
 {
-  char ll_buff[21];
-  Log_event_type ev_type= ev->get_type_code();
-  my_bool destroy_evt= TRUE;
-  DBUG_ENTER("process_event");
-  Exit_status retval= OK_CONTINUE;
-  IO_CACHE *const head= &print_event_info->head_cache;
+  // set the unflushed_events flag to false
+  print_event_info->have_unflushed_events= FALSE;
+
+  // append END-MARKER(') with delimiter
+  IO_CACHE *const body_cache= &print_event_info->body_cache;
+  if (my_b_tell(body_cache))
+    my_b_printf(body_cache, "'%s\n", print_event_info->delimiter);
+
+  // flush cache
+  return (copy_event_cache_to_file_and_reinit(&print_event_info->head_cache,
+                                              result_file, stop_never /* flush result_file */) ||
+          copy_event_cache_to_file_and_reinit(&print_event_info->body_cache,
+                                              result_file, stop_never /* flush result_file */) ||
+          copy_event_cache_to_file_and_reinit(&print_event_info->footer_cache,
+                                              result_file, stop_never /* flush result_file */));
+}
 
+
+/**
+  Applies --offset, --start-datetime, --server-id, --stop-datetime and
+  --stop-position to an event, given the fields of its common header.
+
+  @param[in] ev_type Type of the event.
+  @param[in] when Timestamp of the event.
+  @param[in] server_id Server id of the event.
+  @param[in] pos Offset from beginning of binlog file.
+  @param[out] in_range Set to true if the event is to be processed.
+
+  @retval OK_CONTINUE No error, *in_range tells what to do with the event.
+  @retval OK_STOP The end of the specified range of events to process
+  has been reached and the program should terminate.
+*/
+static Exit_status check_event_range(Log_event_type ev_type, my_time_t when,
+                                     ulong server_id, my_off_t pos,
+                                     bool *in_range)
+{
+  *in_range= false;
   /*
     Format and Start encryptions events are not concerned by --offset and such,
     we always need to read them to be able to process the wanted events.
   */
-  if (((rec_count >= offset) &&
-       ((my_time_t) (ev->common_header->when.tv_sec) >= start_datetime)) ||
+  if (((rec_count >= log_range.offset) &&
+       (when >= log_range.start_datetime)) ||
       (ev_type == binary_log::FORMAT_DESCRIPTION_EVENT) ||
       (ev_type == binary_log::START_ENCRYPTION_EVENT))
   {
@@ -1226,8 +1269,8 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         everything (in case the binlog has timestamps increasing and
         decreasing, we do this to avoid cutting the middle).
       */
-      start_datetime= 0;
-      offset= 0; // print everything and protect against cycling rec_count
+      log_range.start_datetime= 0;
+      log_range.offset= 0; // print everything and protect against cycling rec_count
       /*
         Skip events according to the --server-id flag.  However, don't
         skip format_description or rotate events, because they they
@@ -1237,16 +1280,63 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         events.
       */
       if (ev_type != binary_log::ROTATE_EVENT &&
-          filter_server_id && (filter_server_id != ev->server_id))
-        goto end;
+          filter_server_id && (filter_server_id != server_id))
+        return OK_CONTINUE;
     }
-    if (((my_time_t) (ev->common_header->when.tv_sec) >= stop_datetime)
-        || (pos >= stop_position_mot))
+    if ((when >= stop_datetime) || (pos >= stop_position_mot))
     {
       /* end the program */
-      retval= OK_STOP;
-      goto end;
+      return OK_STOP;
     }
+    *in_range= true;
+  }
+  else
+    log_range.skipped_before_start= true;
+  return OK_CONTINUE;
+}
+
+
+/**
+  Print the given event, and either delete it or delegate the deletion
+  to someone else.
+
+  The deletion may be delegated in these cases:
+  (1) the event is a Format_description_log_event, and is saved in
+      glob_description_event.
+  (2) the event is a Create_file_log_event, and is saved in load_processor.
+  (3) the event is an Intvar, Rand or User_var event, it will be kept until
+      the subsequent Query_log_event.
+  (4) the event is a Table_map_log_event, it will be kept until the subsequent
+      Rows_log_event.
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print.
+  @param[in] ev Log_event to process.
+  @param[in] pos Offset from beginning of binlog file.
+  @param[in] logname Name of input binlog.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
+                          my_off_t pos, const char *logname)
+{
+  char ll_buff[21];
+  Log_event_type ev_type= ev->get_type_code();
+  my_bool destroy_evt= TRUE;
+  DBUG_ENTER("process_event");
+  Exit_status retval= OK_CONTINUE;
+  IO_CACHE *const head= &print_event_info->head_cache;
+
+  bool in_range;
+
+  if ((retval= check_event_range(ev_type, ev->common_header->when.tv_sec,
+                                 ev->server_id, pos, &in_range)) !=
+      OK_CONTINUE)
+    goto end;
+  if (in_range)
+  {
     if (!short_form)
       my_b_printf(&print_event_info->head_cache,
                   "# at %s\n",llstr(pos,ll_buff));
@@ -1461,8 +1551,6 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
       */
       if (!ev->is_relay_log_event())
       {
-        static bool is_first_fd= true;
-
         /*
           Before starting next binlog or logical binlog, it should end the
           previous binlog first. For detail, see the comment of end_binlog().
@@ -1608,25 +1696,8 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
            result_file (as it would happen in ev->print(...) if
            event was not skipped).
         */
-        if (skip_event)
-        {
-          // set the unflushed_events flag to false
-          print_event_info->have_unflushed_events= FALSE;
-
-          // append END-MARKER(') with delimiter
-          IO_CACHE *const body_cache= &print_event_info->body_cache;
-          if (my_b_tell(body_cache))
-            my_b_printf(body_cache, "'%s\n", print_event_info->delimiter);
-
-          // flush cache
-          if ((copy_event_cache_to_file_and_reinit(&print_event_info->head_cache,
-                                                   result_file, stop_never /* flush result_file */) ||
-              copy_event_cache_to_file_and_reinit(&print_event_info->body_cache,
-                                                  result_file, stop_never /* flush result_file */) ||
-              copy_event_cache_to_file_and_reinit(&print_event_info->footer_cache,
-                                                  result_file, stop_never /* flush result_file */)))
-            goto err;
-        }
+        if (skip_event && end_skipped_statement(print_event_info))
+          goto err;
       }
 
       /* skip the event check */
@@ -1810,6 +1881,12 @@ static struct my_option my_long_options[] =
     "already have. NOTE: you will need a SUPER privilege to use this option.",
    &disable_log_bin, &disable_log_bin, 0, GET_BOOL,
    NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"decode-threads", OPT_MYSQLBINLOG_DECODE_THREADS,
+   "Number of threads decoding local binlog files in parallel, each "
+   "decoding a binlog file or a segment of one. Events are printed in the "
+   "same order as with a single thread.",
+   &opt_decode_threads, &opt_decode_threads, 0, GET_UINT, REQUIRED_ARG,
+   1, 1, 256, 0, 0, 0},
   {"force-if-open", 'F', "Force if binlog was not closed properly.",
    &force_if_open_opt, &force_if_open_opt, 0, GET_BOOL, NO_ARG,
    1, 0, 0, 0, 0, 0},
@@ -1829,6 +1906,13 @@ static struct my_option my_long_options[] =
    GET_STR_ALLOC, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"offset", 'o', "Skip the first N entries.", &offset, &offset,
    0, GET_ULL, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"offset-index-dir", OPT_MYSQLBINLOG_OFFSET_INDEX_DIR,
+   "Directory in which to keep an offset index of every local binlog file, "
+   "used to skip the parts of the file before --start-datetime, after "
+   "--stop-datetime, or filtered out by --include-gtids or --exclude-gtids "
+   "without reading them. Implies decoding as with --decode-threads.",
+   &opt_offset_index_dir, &opt_offset_index_dir, 0,
+   GET_STR_ALLOC, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"password", 'p', "Password to connect to remote server.",
    0, 0, 0, GET_PASSWORD, OPT_ARG, 0, 0, 0, 0, 0, 0},
   {"plugin_dir", OPT_PLUGIN_DIR, "Directory for client-side plugins.",
@@ -2066,6 +2150,7 @@ static void cleanup()
   my_free(host);
   my_free(user);
   my_free(dirname_for_local_load);
+  my_free(opt_offset_index_dir);
 
   for (size_t i= 0; i < buff_ev->size(); i++)
   {
@@ -2363,6 +2448,814 @@ static Exit_status dump_single_log(PRINT_EVENT_INFO *print_event_info,
 }
 
 
+/**
+  Sets up the context state determining how to print from the options.
+
+  @param[out] print_event_info Context state to set up.
+*/
+static void init_print_event_info(PRINT_EVENT_INFO *print_event_info)
+{
+  my_stpcpy(print_event_info->delimiter, "/*!*/;");
+  print_event_info->verbose= short_form ? 0 : verbose;
+  print_event_info->short_form= short_form;
+  print_event_info->base64_output_mode= opt_base64_output_mode;
+  print_event_info->skip_gtids= opt_skip_gtids;
+}
+
+
+/**
+  Dumps the logs one after the other in the current thread.
+
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print.
+  @param[in] argc Number of logs.
+  @param[in] argv Names of the logs.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status dump_logs(PRINT_EVENT_INFO *print_event_info,
+                             int argc, char **argv)
+{
+  Exit_status rc= OK_CONTINUE;
+
+  for (int i= 0; i < argc; i++)
+  {
+    // last log, --stop-position applies
+    log_range.stop_position= (i == argc - 1) ? stop_position : ~(my_off_t)0;
+    if ((rc= dump_single_log(print_event_info, argv[i])) != OK_CONTINUE)
+      break;
+
+    // For next log, --start-position does not apply
+    log_range.start_position= BIN_LOG_HEADER_SIZE;
+  }
+  return rc;
+}
+
+
+/*
+  Size of the segments the binlog files are split in by
+  scan_binlog_index(), smaller in tests.
+*/
+static my_off_t binlog_segment_size= BINLOG_SEGMENT_SIZE;
+
+
+/**
+  Returns the name of the offset index file of a binlog file in
+  --offset-index-dir.
+*/
+static void get_index_file_name(char *to, const char *logname)
+{
+  fn_format(to, logname, opt_offset_index_dir, ".idx",
+            MY_REPLACE_DIR | MY_APPEND_EXT);
+}
+
+
+/**
+  Reads the offset index of a binlog file from --offset-index-dir.
+
+  @retval true The index file does not exist, is not valid, or is not
+  the index of this version of the binlog file.
+*/
+static bool load_binlog_index(const char *logname, Binlog_index *index)
+{
+  char index_name[FN_REFLEN];
+  FILE *file;
+  bool res;
+
+  get_index_file_name(index_name, logname);
+  if (!(file= my_fopen(index_name, O_RDONLY | O_BINARY, MYF(0))))
+    return true;
+  res= read_binlog_index(file, index);
+  my_fclose(file, MYF(0));
+  return res;
+}
+
+
+/**
+  Writes the offset index of a binlog file to --offset-index-dir. Not
+  being able to write it is not an error, the index is only cached
+  there for the next runs.
+*/
+static void save_binlog_index(const char *logname, const Binlog_index *index)
+{
+  char index_name[FN_REFLEN], tmp_name[FN_REFLEN];
+  FILE *file;
+  bool failed;
+
+  get_index_file_name(index_name, logname);
+  strxnmov(tmp_name, sizeof(tmp_name) - 1, index_name, ".tmp", NullS);
+  if (!(file= my_fopen(tmp_name, O_WRONLY | O_BINARY, MYF(0))))
+  {
+    warning("Could not create offset index file '%s'.", tmp_name);
+    return;
+  }
+
+  failed= write_binlog_index(file, index);
+  if (my_fclose(file, MYF(0)) || failed ||
+      my_rename(tmp_name, index_name, MYF(0)))
+  {
+    warning("Could not write offset index file '%s'.", index_name);
+    my_delete(tmp_name, MYF(0));
+  }
+}
+
+
+/**
+  Ends the segment being built by scan_binlog_index().
+
+  @retval true Out of memory.
+*/
+static bool end_binlog_segment(Binlog_index *index, Binlog_segment *segment,
+                               Gtid_set *gtids, my_off_t end)
+{
+  segment->end= end;
+  if (!gtids->is_empty())
+  {
+    char *buf;
+    if (gtids->to_string(&buf, false, &binlog_index_gtid_format) < 0)
+      return true;
+    segment->gtids.assign(buf);
+    my_free(buf);
+    gtids->clear();
+  }
+  index->segments.push_back(*segment);
+  return false;
+}
+
+
+/**
+  Builds the offset index of a binlog file, reading only the common
+  header of the events and the post-header of GTID events. An encrypted
+  binlog file, or one which is not in binlog version 4 format, gets a
+  single segment covering the whole file.
+
+  @param[in] file IO_CACHE positioned after the Format_description event.
+  @param[in] fd_end Offset of the end of the Format_description event.
+  @param[in,out] index Index to add the segments to.
+
+  @retval true Read error or out of memory.
+*/
+static bool scan_binlog_index(IO_CACHE *file, my_off_t fd_end,
+                              Binlog_index *index)
+{
+  /* A GTID event starts with one byte of flags, the SID and the GNO. */
+  const uint sid_offset= LOG_EVENT_HEADER_LEN + 1;
+  const uint gno_offset= sid_offset + binary_log::Uuid::BYTE_LENGTH;
+  uchar buf[gno_offset + 8];
+  Sid_map sid_map(NULL);
+  Gtid_set gtids(&sid_map);
+  Binlog_segment segment;
+  my_off_t pos= fd_end;
+
+  segment.start= BIN_LOG_HEADER_SIZE;
+  segment.max_when= 0;
+  segment.gtid_only= false;
+
+  while (pos + LOG_EVENT_HEADER_LEN <= index->file_size)
+  {
+    my_b_seek(file, pos);
+    if (my_b_read(file, buf, LOG_EVENT_HEADER_LEN))
+      return true;
+
+    Log_event_type type= (Log_event_type) buf[EVENT_TYPE_OFFSET];
+    my_time_t when= uint4korr(buf);
+    ulong event_len= uint4korr(buf + EVENT_LEN_OFFSET);
+    if (event_len < LOG_EVENT_HEADER_LEN ||
+        pos + event_len > index->file_size)
+      break;                                    // Incomplete event at end
+
+    if (type == binary_log::START_ENCRYPTION_EVENT)
+    {
+      /* The rest of the file can not be read without decrypting it. */
+      segment.start= BIN_LOG_HEADER_SIZE;
+      segment.max_when= MY_TIME_T_MAX;
+      segment.gtid_only= false;
+      segment.gtids.clear();
+      index->segments.clear();
+      gtids.clear();
+      break;
+    }
+
+    if ((type == binary_log::GTID_LOG_EVENT ||
+         type == binary_log::ANONYMOUS_GTID_LOG_EVENT) &&
+        pos - segment.start >= binlog_segment_size)
+    {
+      if (end_binlog_segment(index, &segment, &gtids, pos))
+        return true;
+      segment.start= pos;
+      segment.max_when= 0;
+      segment.gtid_only= true;
+      segment.gtids.clear();
+    }
+
+    switch (type)
+    {
+    case binary_log::GTID_LOG_EVENT:
+    {
+      rpl_sid sid;
+      rpl_sidno sidno;
+      rpl_gno gno;
+
+      if (event_len < sizeof(buf))
+      {
+        segment.gtid_only= false;
+        break;
+      }
+      if (my_b_read(file, buf + LOG_EVENT_HEADER_LEN,
+                    sizeof(buf) - LOG_EVENT_HEADER_LEN))
+        return true;
+      sid.copy_from(buf + sid_offset);
+      gno= sint8korr(buf + gno_offset);
+      if (gno > 0 && gno < GNO_END &&
+          (sidno= sid_map.add_sid(sid)) > 0 &&
+          gtids.ensure_sidno(sidno) == RETURN_STATUS_OK)
+        gtids._add_gtid(sidno, gno);
+      else
+        segment.gtid_only= false;
+      break;
+    }
+    case binary_log::ANONYMOUS_GTID_LOG_EVENT:
+    case binary_log::FORMAT_DESCRIPTION_EVENT:
+    case binary_log::PREVIOUS_GTIDS_LOG_EVENT:
+    case binary_log::ROTATE_EVENT:
+    case binary_log::STOP_EVENT:
+    case binary_log::INCIDENT_EVENT:
+    case binary_log::IGNORABLE_LOG_EVENT:
+      /* Printed even if the transactions around them are not. */
+      segment.gtid_only= false;
+      break;
+    default:
+      break;
+    }
+
+    if (when > segment.max_when)
+      segment.max_when= when;
+    pos+= event_len;
+  }
+
+  return end_binlog_segment(index, &segment, &gtids, index->file_size);
+}
+
+
+/**
+  Gets the offset index of a binlog file, from --offset-index-dir if it
+  has an index for the file, building it otherwise.
+
+  @param[in] logname Name of the binlog file.
+  @param[out] index Offset index of the file.
+
+  @retval true An error occurred - the program should terminate.
+  @retval false Success.
+*/
+static bool get_binlog_index(const char *logname, Binlog_index *index)
+{
+  File fd;
+  IO_CACHE cache;
+  MY_STAT stat;
+  uchar header[BIN_LOG_HEADER_SIZE];
+  uchar buf[LOG_EVENT_HEADER_LEN];
+  bool in_use= false;
+  bool res= true;
+
+  if ((fd= my_open(logname, O_RDONLY | O_BINARY, MYF(MY_WME))) < 0)
+    return true;
+  if (my_fstat(fd, &stat, MYF(0)) ||
+      init_io_cache(&cache, fd, 0, READ_CACHE, 0, 0, MYF(MY_WME | MY_NABP)))
+  {
+    error("Could not read binlog file '%s'.", logname);
+    my_close(fd, MYF(MY_WME));
+    return true;
+  }
+
+  index->file_size= stat.st_size;
+  index->created= 0;
+  index->relay_log= false;
+  index->segments.clear();
+
+  if (my_b_read(&cache, header, sizeof(header)) ||
+      memcmp(header, BINLOG_MAGIC, sizeof(header)))
+  {
+    error("File '%s' is not a binary log file.", logname);
+    goto end;
+  }
+
+  if (my_b_read(&cache, buf, sizeof(buf)) ||
+      buf[EVENT_TYPE_OFFSET] != binary_log::FORMAT_DESCRIPTION_EVENT)
+  {
+    /* Decoded as a whole; check_header() will tell what is wrong. */
+    Binlog_segment segment;
+    segment.start= BIN_LOG_HEADER_SIZE;
+    segment.end= index->file_size;
+    segment.max_when= MY_TIME_T_MAX;
+    segment.gtid_only= false;
+    index->segments.push_back(segment);
+    res= false;
+    goto end;
+  }
+
+  index->created= uint4korr(buf);
+  index->relay_log= uint2korr(buf + FLAGS_OFFSET) & LOG_EVENT_RELAY_LOG_F;
+  in_use= uint2korr(buf + FLAGS_OFFSET) & LOG_EVENT_BINLOG_IN_USE_F;
+
+  if (opt_offset_index_dir && load_binlog_index(logname, index) == false)
+  {
+    res= false;
+    goto end;
+  }
+
+  if (scan_binlog_index(&cache, BIN_LOG_HEADER_SIZE +
+                        uint4korr(buf + EVENT_LEN_OFFSET), index))
+  {
+    error("Could not read entry in '%s' while building its offset index: "
+          "Error in log format or read error.", logname);
+    goto end;
+  }
+  res= false;
+
+  /* The index of a binlog being written would soon be out of date. */
+  if (opt_offset_index_dir && !in_use)
+    save_binlog_index(logname, index);
+
+end:
+  end_io_cache(&cache);
+  my_close(fd, MYF(MY_WME));
+  return res;
+}
+
+
+/**
+  Part of a binlog file decoded by a thread of dump_logs_in_parallel(),
+  and the state of the output stream at its end.
+*/
+struct Decode_job
+{
+  const char *logname;
+  /* Position of the binlog file on the command line. */
+  int log_number;
+  my_off_t start_position;
+  my_off_t stop_position;
+  my_off_t end_position;
+  my_time_t start_datetime;
+  /* True for the first job of the binlog file. */
+  bool print_fd;
+  /* False for the last job, whose unflushed comments are discarded. */
+  bool flush_head;
+
+  FILE *output;
+  char output_name[FN_REFLEN];
+  bool done;
+  Exit_status status;
+  bool started;
+  bool skipped_before_start;
+  bool in_transaction;
+  bool seen_gtid;
+  bool skipped_event_in_transaction;
+  bool have_unflushed_events;
+  bool buffered_events;
+};
+
+/**
+  Work shared by the threads of dump_logs_in_parallel(), protected by
+  lock.
+*/
+struct Decode_threads
+{
+  native_mutex_t lock;
+  /* Signalled when a job is done, or when its output has been copied. */
+  native_cond_t cond;
+  char **logs;
+  std::vector<Binlog_index> indexes;
+  size_t next_index;
+  std::vector<Decode_job> jobs;
+  size_t next_job;
+  /* Jobs whose output has been copied to result_file. */
+  size_t copied_jobs;
+  /* No more than this many jobs are decoded ahead of copied_jobs. */
+  size_t window;
+  bool abort;
+};
+
+
+/**
+  Decodes the part of a binlog file of a job into a temporary file,
+  with the output stream state of the current thread starting afresh.
+*/
+static void decode_job(Decode_job *job)
+{
+  PRINT_EVENT_INFO print_event_info;
+  File file;
+
+  job->status= ERROR_STOP;
+  if (!print_event_info.init_ok())
+    return;
+  init_print_event_info(&print_event_info);
+
+  if ((file= create_temp_file(job->output_name, NULL, "mysqlbinlog",
+                              O_RDWR | O_BINARY | O_TRUNC | O_TEMPORARY,
+                              MYF(MY_WME))) < 0)
+    return;
+#if !defined(_WIN32)
+  /* Only read back through the file handle. */
+  my_delete(job->output_name, MYF(MY_WME));
+#endif
+  if (!(job->output= my_fdopen(file, job->output_name, O_RDWR | O_BINARY,
+                               MYF(MY_WME))))
+  {
+    my_close(file, MYF(0));
+    return;
+  }
+
+  result_file= job->output;
+  buff_ev= new Buff_ev(PSI_NOT_INSTRUMENTED);
+  if (dirname_for_local_load)
+    load_processor.init_by_dir_name(dirname_for_local_load);
+  else
+    load_processor.init_by_cur_dir();
+  rec_count= 0;
+  filter_based_on_gtids= false;
+  in_transaction= false;
+  seen_gtid= false;
+  is_first_fd= true;
+
+  log_range.start_position= job->start_position;
+  log_range.stop_position= job->stop_position;
+  log_range.end_position= job->end_position;
+  log_range.start_datetime= job->start_datetime;
+  log_range.offset= 0;
+  log_range.print_fd= job->print_fd;
+  log_range.skipped_before_start= false;
+
+  job->status= dump_local_log_entries(&print_event_info, job->logname);
+  if (job->status == OK_CONTINUE && job->flush_head &&
+      !print_event_info.have_unflushed_events &&
+      copy_event_cache_to_file_and_reinit(&print_event_info.head_cache,
+                                          result_file, false))
+    job->status= ERROR_STOP;
+  if (fflush(result_file))
+    job->status= ERROR_STOP;
+
+  job->started= (log_range.start_datetime == 0);
+  job->skipped_before_start= log_range.skipped_before_start;
+  job->in_transaction= in_transaction;
+  job->seen_gtid= seen_gtid;
+  job->skipped_event_in_transaction=
+    print_event_info.skipped_event_in_transaction;
+  job->have_unflushed_events= print_event_info.have_unflushed_events;
+  job->buffered_events= !buff_ev->empty();
+
+  for (size_t i= 0; i < buff_ev->size(); i++)
+    delete buff_ev->at(i).event;
+  delete buff_ev;
+  buff_ev= NULL;
+  delete glob_description_event;
+  glob_description_event= NULL;
+  load_processor.destroy();
+  result_file= NULL;
+}
+
+
+extern "C" void *index_thread(void *arg)
+{
+  Decode_threads *threads= static_cast<Decode_threads*>(arg);
+
+  my_thread_init();
+  native_mutex_lock(&threads->lock);
+  while (!threads->abort && threads->next_index < threads->indexes.size())
+  {
+    size_t i= threads->next_index++;
+    native_mutex_unlock(&threads->lock);
+    bool failed= get_binlog_index(threads->logs[i], &threads->indexes[i]);
+    native_mutex_lock(&threads->lock);
+    if (failed)
+      threads->abort= true;
+  }
+  native_mutex_unlock(&threads->lock);
+  my_thread_end();
+  return NULL;
+}
+
+
+extern "C" void *decode_thread(void *arg)
+{
+  Decode_threads *threads= static_cast<Decode_threads*>(arg);
+
+  my_thread_init();
+  native_mutex_lock(&threads->lock);
+  for (;;)
+  {
+    while (!threads->abort && threads->next_job < threads->jobs.size() &&
+           threads->next_job >= threads->copied_jobs + threads->window)
+      native_cond_wait(&threads->cond, &threads->lock);
+    if (threads->abort || threads->next_job >= threads->jobs.size())
+      break;
+    Decode_job *job= &threads->jobs[threads->next_job++];
+    native_mutex_unlock(&threads->lock);
+    decode_job(job);
+    native_mutex_lock(&threads->lock);
+    job->done= true;
+    native_cond_broadcast(&threads->cond);
+  }
+  native_mutex_unlock(&threads->lock);
+  my_thread_end();
+  return NULL;
+}
+
+
+extern "C" void *redecode_thread(void *arg)
+{
+  my_thread_init();
+  decode_job(static_cast<Decode_job*>(arg));
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Starts up to --decode-threads threads running func.
+
+  @return Number of threads started.
+*/
+static size_t start_decode_threads(void *(*func)(void *),
+                                   Decode_threads *threads,
+                                   my_thread_handle *handles)
+{
+  my_thread_attr_t attr;
+  size_t count;
+
+  my_thread_attr_init(&attr);
+  for (count= 0; count < opt_decode_threads; count++)
+  {
+    if (my_thread_create(&handles[count], &attr, func, threads))
+    {
+      warning("Could not create decode thread, errno %d.", errno);
+      break;
+    }
+  }
+  my_thread_attr_destroy(&attr);
+  return count;
+}
+
+
+/**
+  Plans the jobs of dump_logs_in_parallel() from the offset indexes of
+  the binlog files, one job per segment which is not left out.
+*/
+static void plan_decode_jobs(char **argv, Decode_threads *threads)
+{
+  Binlog_segment_filter filter;
+  std::vector<Binlog_segment_range> ranges;
+
+  filter.start_position= start_position;
+  filter.stop_position= stop_position;
+  filter.start_datetime= start_datetime;
+  filter.stop_datetime= stop_datetime;
+  filter.filter_server_id= filter_server_id != 0;
+  filter.include_gtids= opt_include_gtids_str ? gtid_set_included : NULL;
+  filter.exclude_gtids= opt_exclude_gtids_str ? gtid_set_excluded : NULL;
+
+  global_sid_lock->rdlock();
+  plan_binlog_segments(threads->indexes, filter, &ranges);
+  global_sid_lock->unlock();
+
+  for (size_t i= 0; i < ranges.size(); i++)
+  {
+    Decode_job job;
+    memset(&job, 0, sizeof(job));
+    job.logname= argv[ranges[i].log_number];
+    job.log_number= static_cast<int>(ranges[i].log_number);
+    job.start_position= ranges[i].start_position;
+    job.stop_position= ranges[i].stop_position;
+    job.end_position= ranges[i].end_position;
+    job.start_datetime= ranges[i].start_datetime;
+    job.print_fd= ranges[i].print_fd;
+    job.flush_head= ranges[i].flush_head;
+    threads->jobs.push_back(job);
+  }
+}
+
+
+/**
+  Copies the output of a job to result_file and closes it.
+
+  @retval true Read or write error.
+*/
+static bool copy_job_output(Decode_job *job)
+{
+  uchar buff[IO_SIZE * 16];
+  size_t length;
+  bool res= false;
+
+  rewind(job->output);
+  while ((length= fread(buff, 1, sizeof(buff), job->output)) > 0)
+  {
+    if (my_fwrite(result_file, buff, length, MYF(MY_WME | MY_NABP)))
+    {
+      res= true;
+      break;
+    }
+  }
+  if (ferror(job->output))
+  {
+    error("Could not read back decoded events from '%s'.", job->output_name);
+    res= true;
+  }
+  my_fclose(job->output, MYF(0));
+  job->output= NULL;
+  return res;
+}
+
+
+/**
+  Tells if the logs can be decoded by dump_logs_in_parallel(), warning
+  if --decode-threads or --offset-index-dir are ignored.
+*/
+static bool can_decode_in_parallel(int argc, char **argv)
+{
+  if (opt_decode_threads <= 1 && !opt_offset_index_dir)
+    return false;
+
+  const char *reason= NULL;
+  if (opt_remote_proto != BINLOG_LOCAL)
+    reason= "binlogs are read from a server";
+  else if (offset)
+    reason= "--offset is used";
+  else
+  {
+    for (int i= 0; i < argc; i++)
+      if (!strcmp(argv[i], "-"))
+        reason= "a binlog is read from stdin";
+  }
+  if (reason)
+  {
+    warning("The options --decode-threads and --offset-index-dir are "
+            "ignored because %s.", reason);
+    return false;
+  }
+  return true;
+}
+
+
+/**
+  Dumps local binlog files with up to --decode-threads threads, each
+  decoding a segment of a binlog file into a temporary file. The main
+  thread copies the output of the segments to result_file in order, so
+  that the output is the one of dump_logs().
+
+  The offset index of every binlog file is read from --offset-index-dir
+  or built by scanning the headers of the events, and tells which
+  segments can be left out without being read. Segments always begin
+  with a transaction, so the only state of the output stream carried
+  from one segment to the next is the one printed by end_binlog(),
+  which the main thread prints itself between binlog files.
+
+  Relay logs, where transactions can span files, are decoded by
+  dump_logs().
+
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print; set to the state at the end of the last
+  segment.
+  @param[in] argc Number of logs.
+  @param[in] argv Names of the logs.
+  @param[out] buffered_events Set to true if the output ended with
+  buffered events not followed by their Query_log_event.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status dump_logs_in_parallel(PRINT_EVENT_INFO *print_event_info,
+                                         int argc, char **argv,
+                                         bool *buffered_events)
+{
+  Decode_threads threads;
+  std::vector<my_thread_handle> handles(opt_decode_threads);
+  Exit_status rc= OK_CONTINUE;
+  size_t count;
+  bool started= false;
+
+  native_mutex_init(&threads.lock, NULL);
+  native_cond_init(&threads.cond);
+  threads.logs= argv;
+  threads.indexes.resize(argc);
+  threads.next_index= 0;
+  threads.next_job= 0;
+  threads.copied_jobs= 0;
+  threads.window= 2 * opt_decode_threads;
+  threads.abort= false;
+
+  DBUG_EXECUTE_IF("small_binlog_segments", binlog_segment_size= 4096;);
+  if (!(count= start_decode_threads(index_thread, &threads, &handles[0])))
+  {
+    rc= ERROR_STOP;
+    goto end;
+  }
+  for (size_t i= 0; i < count; i++)
+    my_thread_join(&handles[i], NULL);
+  if (threads.abort)
+  {
+    rc= ERROR_STOP;
+    goto end;
+  }
+
+  for (int i= 0; i < argc; i++)
+  {
+    if (threads.indexes[i].relay_log)
+    {
+      rc= dump_logs(print_event_info, argc, argv);
+      *buffered_events= !buff_ev->empty();
+      goto end;
+    }
+  }
+
+  plan_decode_jobs(argv, &threads);
+  if (threads.jobs.empty() ||
+      !(count= start_decode_threads(decode_thread, &threads, &handles[0])))
+  {
+    rc= threads.jobs.empty() ? OK_CONTINUE : ERROR_STOP;
+    goto end;
+  }
+
+  for (size_t i= 0; i < threads.jobs.size(); i++)
+  {
+    Decode_job *job= &threads.jobs[i];
+
+    native_mutex_lock(&threads.lock);
+    while (!job->done)
+      native_cond_wait(&threads.cond, &threads.lock);
+    native_mutex_unlock(&threads.lock);
+
+    /*
+      A job planned to skip events before --start-datetime, because it
+      was not known whether an earlier job would print events, is
+      decoded again if one did.
+    */
+    if (started && job->skipped_before_start && job->status != ERROR_STOP)
+    {
+      my_thread_handle handle;
+      my_thread_attr_t attr;
+
+      if (job->output)
+        my_fclose(job->output, MYF(0));
+      job->output= NULL;
+      job->start_datetime= 0;
+      my_thread_attr_init(&attr);
+      if (my_thread_create(&handle, &attr, redecode_thread, job))
+        job->status= ERROR_STOP;
+      else
+        my_thread_join(&handle, NULL);
+      my_thread_attr_destroy(&attr);
+    }
+    started= started || job->started;
+
+    if (job->print_fd && job->log_number > 0)
+      end_binlog(print_event_info);
+    if (print_event_info->skipped_event_in_transaction)
+      fprintf(result_file, "COMMIT /* added by mysqlbinlog */%s\n",
+              print_event_info->delimiter);
+
+    if (job->output && copy_job_output(job))
+      job->status= ERROR_STOP;
+
+    in_transaction= job->in_transaction;
+    seen_gtid= job->seen_gtid;
+    print_event_info->skipped_event_in_transaction=
+      job->skipped_event_in_transaction;
+    print_event_info->have_unflushed_events= job->have_unflushed_events;
+    *buffered_events= job->buffered_events;
+
+    native_mutex_lock(&threads.lock);
+    threads.copied_jobs= i + 1;
+    native_cond_broadcast(&threads.cond);
+    native_mutex_unlock(&threads.lock);
+
+    if ((rc= job->status) != OK_CONTINUE)
+      break;
+  }
+
+  native_mutex_lock(&threads.lock);
+  threads.abort= true;
+  native_cond_broadcast(&threads.cond);
+  native_mutex_unlock(&threads.lock);
+  for (size_t i= 0; i < count; i++)
+    my_thread_join(&handles[i], NULL);
+
+  for (size_t i= 0; i < threads.jobs.size(); i++)
+  {
+    if (threads.jobs[i].output)
+      my_fclose(threads.jobs[i].output, MYF(0));
+  }
+
+end:
+  native_cond_destroy(&threads.cond);
+  native_mutex_destroy(&threads.lock);
+  return rc;
+}
+
+
 static Exit_status dump_multiple_logs(int argc, char **argv)
 {
   DBUG_ENTER("dump_multiple_logs");
@@ -2379,28 +3272,26 @@ static Exit_status dump_multiple_logs(int argc, char **argv)
   {
     fprintf(result_file, "DELIMITER /*!*/;\n");
   }
-  my_stpcpy(print_event_info.delimiter, "/*!*/;");
-  
-  print_event_info.verbose= short_form ? 0 : verbose;
-  print_event_info.short_form= short_form;
-  print_event_info.base64_output_mode= opt_base64_output_mode;
-  print_event_info.skip_gtids= opt_skip_gtids;
+  init_print_event_info(&print_event_info);
+
+  log_range.start_position= start_position;
+  log_range.end_position= ~(my_off_t)0;
+  log_range.start_datetime= start_datetime;
+  log_range.offset= offset;
+  log_range.print_fd= true;
 
   // Dump all logs.
-  my_off_t save_stop_position= stop_position;
-  stop_position= ~(my_off_t)0;
-  for (int i= 0; i < argc; i++)
+  bool buffered_events= false;
+  if (can_decode_in_parallel(argc, argv))
+    rc= dump_logs_in_parallel(&print_event_info, argc, argv,
+                              &buffered_events);
+  else
   {
-    if (i == argc - 1) // last log, --stop-position applies
-      stop_position= save_stop_position;
-    if ((rc= dump_single_log(&print_event_info, argv[i])) != OK_CONTINUE)
-      break;
-
-    // For next log, --start-position does not apply
-    start_position= BIN_LOG_HEADER_SIZE;
+    rc= dump_logs(&print_event_info, argc, argv);
+    buffered_events= !buff_ev->empty();
   }
 
-  if (!buff_ev->empty())
+  if (buffered_events)
     warning("The range of printed events ends with an Intvar_event, "
             "Rand_event or User_var_event with no matching Query_log_event. "
             "This might be because the last statement was not fully written "
@@ -2615,7 +3506,7 @@ static Exit_status dump_remote_log_entries(PRINT_EVENT_INFO *print_event_info,
       COM_BINLOG_DUMP accepts only 4 bytes for the position, so
       we are forced to cast to uint32.
     */
-    int4store(ptr_buffer, (uint32) start_position);
+    int4store(ptr_buffer, (uint32) start_position_mot);
     ptr_buffer+= ::BINLOG_POS_OLD_INFO_SIZE;
     int2store(ptr_buffer, get_dump_flags());
     ptr_buffer+= ::BINLOG_FLAGS_INFO_SIZE;
@@ -2657,7 +3548,7 @@ static Exit_status dump_remote_log_entries(PRINT_EVENT_INFO *print_event_info,
     ptr_buffer+= ::BINLOG_NAME_SIZE_INFO_SIZE;
     memcpy(ptr_buffer, logname, BINLOG_NAME_INFO_SIZE);
     ptr_buffer+= BINLOG_NAME_INFO_SIZE;
-    int8store(ptr_buffer, start_position);
+    int8store(ptr_buffer, start_position_mot);
     ptr_buffer+= ::BINLOG_POS_INFO_SIZE;
     int4store(ptr_buffer, static_cast<uint32>(encoded_data_size));
     ptr_buffer+= ::BINLOG_DATA_SIZE_INFO_SIZE;
@@ -3048,7 +3939,7 @@ static Exit_status check_header(IO_CACHE* file,
         }
         break;
       }
-      else if (tmp_pos >= start_position)
+      else if (tmp_pos >= start_position_mot)
         break;
       else if (buf[EVENT_TYPE_OFFSET] == binary_log::FORMAT_DESCRIPTION_EVENT)
       {
@@ -3066,7 +3957,17 @@ static Exit_status check_header(IO_CACHE* file,
                 (ulonglong)tmp_pos);
           DBUG_RETURN(ERROR_STOP);
         }
-        if (opt_base64_output_mode == BASE64_OUTPUT_AUTO)
+        if (!log_range.print_fd)
+        {
+          /* Printed by the thread decoding the beginning of the file. */
+          delete glob_description_event;
+          glob_description_event= new_description_event;
+          print_event_info->common_header_len=
+            glob_description_event->common_header_len;
+          print_event_info->printed_fd_event=
+            (opt_base64_output_mode == BASE64_OUTPUT_AUTO);
+        }
+        else if (opt_base64_output_mode == BASE64_OUTPUT_AUTO)
         {
           /*
             process_event will delete *description_event and set it to
@@ -3117,6 +4018,106 @@ static Exit_status check_header(IO_CACHE* file,
 }
 
 
+/**
+  Skips a rows event of a table filtered out by --database without
+  decoding it. The table id and the flags are read from the post-header
+  of the event, and if the Table_map_log_event of the table was ignored
+  the file is positioned at the next event, doing what process_event()
+  would have done with the event. The checksum of a skipped event is
+  not verified.
+
+  @param[in] file IO_CACHE positioned at the event.
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print.
+  @param[in] pos Offset from beginning of binlog file.
+  @param[out] skipped Set to true if the event was skipped, otherwise
+  the file is left positioned at the event.
+
+  @retval ERROR_STOP An error occurred - the program should terminate.
+  @retval OK_CONTINUE No error, the program should continue.
+  @retval OK_STOP No error, but the end of the specified range of
+  events to process has been reached and the program should terminate.
+*/
+static Exit_status skip_ignored_rows_event(IO_CACHE *file,
+                                           PRINT_EVENT_INFO *print_event_info,
+                                           my_off_t pos, bool *skipped)
+{
+  uchar buf[LOG_EVENT_HEADER_LEN + Binary_log_event::ROWS_HEADER_LEN_V1];
+  Log_event_type type;
+  ulong event_len;
+  ulonglong table_id;
+  uint flags;
+
+  *skipped= false;
+  if (glob_description_event->common_header_len != LOG_EVENT_HEADER_LEN ||
+      glob_description_event->crypto_data.is_enabled())
+    return OK_CONTINUE;
+  if (my_b_read(file, buf, sizeof(buf)))
+    goto not_skipped;
+
+  type= (Log_event_type) buf[EVENT_TYPE_OFFSET];
+  event_len= uint4korr(buf + EVENT_LEN_OFFSET);
+  if ((type != binary_log::WRITE_ROWS_EVENT &&
+       type != binary_log::UPDATE_ROWS_EVENT &&
+       type != binary_log::DELETE_ROWS_EVENT &&
+       type != binary_log::WRITE_ROWS_EVENT_V1 &&
+       type != binary_log::UPDATE_ROWS_EVENT_V1 &&
+       type != binary_log::DELETE_ROWS_EVENT_V1) ||
+      event_len < sizeof(buf) ||
+      static_cast<size_t>(type) > glob_description_event->post_header_len.size())
+    goto not_skipped;
+
+  /* Old rows events have a 4 byte table id. */
+  if (glob_description_event->post_header_len[type - 1] == 6)
+  {
+    table_id= uint4korr(buf + LOG_EVENT_HEADER_LEN);
+    flags= uint2korr(buf + LOG_EVENT_HEADER_LEN + 4);
+  }
+  else
+  {
+    table_id= uint6korr(buf + LOG_EVENT_HEADER_LEN);
+    flags= uint2korr(buf + LOG_EVENT_HEADER_LEN + 6);
+  }
+  if (!print_event_info->m_table_map_ignored.get_table(table_id))
+    goto not_skipped;
+
+  {
+    Exit_status retval;
+    bool in_range;
+    char llbuff[21];
+
+    *skipped= true;
+    if ((retval= check_event_range(type, uint4korr(buf),
+                                   uint4korr(buf + SERVER_ID_OFFSET), pos,
+                                   &in_range)) == OK_CONTINUE && in_range)
+    {
+      if (!short_form)
+        my_b_printf(&print_event_info->head_cache,
+                    "# at %s\n", llstr(pos, llbuff));
+      /* What shall_skip_gtids() returns for a rows event. */
+      if (!filter_based_on_gtids)
+      {
+        if (flags & Rows_log_event::STMT_END_F)
+        {
+          print_event_info->m_table_map_ignored.clear_tables();
+          if (end_skipped_statement(print_event_info))
+            retval= ERROR_STOP;
+        }
+        print_event_info->skipped_event_in_transaction= true;
+      }
+    }
+    rec_count++;
+    my_b_seek(file, pos + event_len);
+    return retval;
+  }
+
+not_skipped:
+  my_b_seek(file, pos);
+  file->error= 0;
+  return OK_CONTINUE;
+}
+
+
 /**
   Reads a local binlog and prints the events it sees.
 
@@ -3143,7 +4144,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     /* read from normal file */
     if ((fd = my_open(logname, O_RDONLY | O_BINARY, MYF(MY_WME))) < 0)
       return ERROR_STOP;
-    if (init_io_cache(file, fd, 0, READ_CACHE, start_position_mot, 0,
+    if (init_io_cache(file, fd, 0, READ_CACHE, start_position_mot, 1,
 		      MYF(MY_WME | MY_NABP)))
     {
       my_close(fd, MYF(MY_WME));
@@ -3178,7 +4179,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     }
     if ((retval= check_header(file, print_event_info, logname)) != OK_CONTINUE)
       goto end;
-    if (start_position)
+    if (start_position_mot)
     {
       /* skip 'start_position' characters from stdin */
       uchar buff[IO_SIZE];
@@ -3201,7 +4202,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     goto err;
   }
 
-  if (!start_position && my_b_read(file, tmp_buff, BIN_LOG_HEADER_SIZE))
+  if (!start_position_mot && my_b_read(file, tmp_buff, BIN_LOG_HEADER_SIZE))
   {
     error("Failed reading from file.");
     goto err;
@@ -3211,6 +4212,20 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     char llbuff[21];
     my_off_t old_off = my_b_tell(file);
 
+    if (old_off >= log_range.end_position)
+      goto end;
+
+    /* Rows events of ignored tables are skipped without being decoded. */
+    if (fd >= 0 && print_event_info->m_table_map_ignored.count() > 0)
+    {
+      bool skipped;
+      if ((retval= skip_ignored_rows_event(file, print_event_info, old_off,
+                                           &skipped)) != OK_CONTINUE)
+        goto end;
+      if (skipped)
+        continue;
+    }
+
     binary_log_debug::debug_expect_unknown_event=
       DBUG_EVALUATE_IF("expect_Unknown_event", true, false);
 
@@ -3549,3 +4564,4 @@ int main(int argc, char** argv)
 #include "rpl_gtid_specification.cc"
 #include "rpl_tblmap.cc"
 #include "binlog_crypt_data.cc"
+#include "mysqlbinlog_index.cc"
@@ -0,0 +1,189 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/*
+  Offset index files of mysqlbinlog, and the planning of the parallel
+  decoding of binlog files from them. Compiled as part of mysqlbinlog.cc.
+*/
+
+#include "mysqlbinlog_index.h"
+#include <algorithm>
+
+const Gtid_set::String_format binlog_index_gtid_format=
+{
+  "", "", ":", "-", ":", ",", "",
+  0, 0, 1, 1, 1, 1, 0
+};
+
+static const char *index_file_header= "# mysqlbinlog offset index 1\n";
+
+
+/**
+  Reads a line of any length from a file.
+
+  @retval true End of file or read error.
+*/
+static bool read_index_line(FILE *file, std::string *line)
+{
+  char buff[1024];
+
+  line->clear();
+  while (fgets(buff, sizeof(buff), file))
+  {
+    line->append(buff);
+    if (line->at(line->length() - 1) == '\n')
+    {
+      line->erase(line->length() - 1);
+      return false;
+    }
+  }
+  return line->empty();
+}
+
+
+bool read_binlog_index(FILE *file, Binlog_index *index)
+{
+  std::string line;
+  ulonglong file_size;
+  longlong created;
+  int relay_log;
+
+  if (read_index_line(file, &line) ||
+      line + "\n" != index_file_header ||
+      read_index_line(file, &line) ||
+      sscanf(line.c_str(), "%llu %lld %d",
+             &file_size, &created, &relay_log) != 3 ||
+      file_size != index->file_size || created != index->created)
+    return true;
+
+  index->relay_log= relay_log != 0;
+  index->segments.clear();
+  while (!read_index_line(file, &line))
+  {
+    Binlog_segment segment;
+    ulonglong start, end;
+    longlong max_when;
+    int gtid_only, length;
+
+    if (sscanf(line.c_str(), "%llu %llu %lld %d %n",
+               &start, &end, &max_when, &gtid_only, &length) != 4)
+      return true;
+    segment.start= start;
+    segment.end= end;
+    segment.max_when= (my_time_t) max_when;
+    segment.gtid_only= gtid_only != 0;
+    if (line.compare(length, std::string::npos, "-") != 0)
+      segment.gtids.assign(line, length, std::string::npos);
+    index->segments.push_back(segment);
+  }
+  return index->segments.empty();
+}
+
+
+bool write_binlog_index(FILE *file, const Binlog_index *index)
+{
+  fputs(index_file_header, file);
+  fprintf(file, "%llu %lld %d\n", (ulonglong) index->file_size,
+          (longlong) index->created, index->relay_log ? 1 : 0);
+  for (size_t i= 0; i < index->segments.size(); i++)
+  {
+    const Binlog_segment &segment= index->segments[i];
+    fprintf(file, "%llu %llu %lld %d %s\n",
+            (ulonglong) segment.start, (ulonglong) segment.end,
+            (longlong) segment.max_when, segment.gtid_only ? 1 : 0,
+            segment.gtids.empty() ? "-" : segment.gtids.c_str());
+  }
+  return ferror(file) != 0;
+}
+
+
+bool shall_skip_binlog_segment(const Binlog_segment &segment,
+                               const Binlog_segment_filter &filter)
+{
+  const Gtid_set *any_set= filter.include_gtids ? filter.include_gtids :
+    filter.exclude_gtids;
+
+  if (!segment.gtid_only || any_set == NULL)
+    return false;
+
+  Gtid_set gtids(any_set->get_sid_map());
+  if (gtids.add_gtid_text(segment.gtids.c_str()) != RETURN_STATUS_OK)
+    return false;
+  return ((filter.include_gtids != NULL &&
+           !gtids.is_intersection_nonempty(filter.include_gtids)) ||
+          (filter.exclude_gtids != NULL &&
+           gtids.is_subset(filter.exclude_gtids)));
+}
+
+
+void plan_binlog_segments(const std::vector<Binlog_index> &indexes,
+                          const Binlog_segment_filter &filter,
+                          std::vector<Binlog_segment_range> *ranges)
+{
+  my_time_t range_start_datetime= filter.start_datetime;
+
+  for (size_t i= 0; i < indexes.size(); i++)
+  {
+    const std::vector<Binlog_segment> &segments= indexes[i].segments;
+    my_off_t log_start= (i == 0) ?
+      filter.start_position : BIN_LOG_HEADER_SIZE;
+    my_off_t log_stop= (i == indexes.size() - 1) ?
+      filter.stop_position : ~(my_off_t)0;
+    bool print_fd= true;
+
+    for (size_t s= 0; s < segments.size(); s++)
+    {
+      const Binlog_segment &segment= segments[s];
+      bool last= (s == segments.size() - 1);
+
+      if (segment.start >= log_stop)
+        goto end;
+      if ((segment.end <= log_start && !last) ||
+          (range_start_datetime && segment.max_when < range_start_datetime) ||
+          shall_skip_binlog_segment(segment, filter))
+        continue;
+
+      Binlog_segment_range range;
+      range.log_number= i;
+      range.start_position= std::max(segment.start, log_start);
+      range.stop_position= log_stop;
+      range.end_position= last ? ~(my_off_t)0 : segment.end;
+      range.start_datetime= range_start_datetime;
+      range.print_fd= print_fd;
+      range.flush_head= true;
+      ranges->push_back(range);
+      print_fd= false;
+
+      /*
+        Later segments are printed from their first event, unless the
+        timestamps of this segment are not known.
+      */
+      if (segment.max_when != MY_TIME_T_MAX)
+      {
+        if (segment.max_when >= range_start_datetime)
+          range_start_datetime= 0;
+        /* Events filtered out by --server-id do not stop the output. */
+        if (!range_start_datetime && !filter.filter_server_id &&
+            segment.max_when >= filter.stop_datetime)
+          goto end;
+      }
+    }
+  }
+
+end:
+  if (!ranges->empty())
+    ranges->back().flush_head= false;
+}
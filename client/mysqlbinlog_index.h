@@ -0,0 +1,147 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef MYSQLBINLOG_INDEX_INCLUDED
+#define MYSQLBINLOG_INDEX_INCLUDED
+
+#include "my_global.h"
+#include "my_time.h"
+#include "rpl_gtid.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+  Binlog files are decoded in parallel in segments of about this size,
+  which always begin with the GTID event of a transaction.
+*/
+static const my_off_t BINLOG_SEGMENT_SIZE= 64 * 1024 * 1024;
+
+/* Gtid_set format on a single line, used in offset index files. */
+extern const Gtid_set::String_format binlog_index_gtid_format;
+
+/**
+  Segment of a binlog file, as recorded in the offset index of the file.
+*/
+struct Binlog_segment
+{
+  my_off_t start;
+  my_off_t end;
+  /* Largest event timestamp, MY_TIME_T_MAX if not known. */
+  my_time_t max_when;
+  /*
+    True if every transaction of the segment has a GTID and there are
+    no other events, so that --include-gtids and --exclude-gtids can
+    leave out the whole segment.
+  */
+  bool gtid_only;
+  /* GTIDs of the transactions of the segment. */
+  std::string gtids;
+};
+
+/**
+  Offset index of a binlog file: the segments in which mysqlbinlog
+  decodes the file in parallel, with what is needed to leave out
+  segments for --start-datetime, --stop-datetime, --include-gtids and
+  --exclude-gtids without reading them.
+*/
+struct Binlog_index
+{
+  /* Size of the file and timestamp of its Format_description event. */
+  my_off_t file_size;
+  my_time_t created;
+  bool relay_log;
+  std::vector<Binlog_segment> segments;
+};
+
+/**
+  What the options of mysqlbinlog tell about the events to print, for
+  plan_binlog_segments().
+*/
+struct Binlog_segment_filter
+{
+  /* --start-position in the first log, --stop-position in the last. */
+  my_off_t start_position;
+  my_off_t stop_position;
+  /* --start-datetime, 0 if not given. */
+  my_time_t start_datetime;
+  /* --stop-datetime, MY_TIME_T_MAX if not given. */
+  my_time_t stop_datetime;
+  /* True with --server-id. */
+  bool filter_server_id;
+  /*
+    --include-gtids and --exclude-gtids, NULL if not given. The caller
+    of plan_binlog_segments() holds the lock of their Sid_map.
+  */
+  const Gtid_set *include_gtids;
+  const Gtid_set *exclude_gtids;
+};
+
+/**
+  Part of a binlog file to decode, and how to decode it.
+*/
+struct Binlog_segment_range
+{
+  /* Position of the binlog file in the list of logs. */
+  size_t log_number;
+  my_off_t start_position;
+  my_off_t stop_position;
+  /* Decoding stops before the event at this offset, without OK_STOP. */
+  my_off_t end_position;
+  my_time_t start_datetime;
+  /* True for the first range of the binlog file. */
+  bool print_fd;
+  /* False for the last range, whose unflushed comments are discarded. */
+  bool flush_head;
+};
+
+/**
+  Reads an offset index file.
+
+  @param[in] file The index file.
+  @param[in,out] index Index with the size and creation time of the
+  binlog file set, to which the segments are read.
+
+  @retval true The file is not a valid index, or is not the index of
+  this version of the binlog file.
+*/
+bool read_binlog_index(FILE *file, Binlog_index *index);
+
+/**
+  Writes an offset index file.
+
+  @retval true Write error.
+*/
+bool write_binlog_index(FILE *file, const Binlog_index *index);
+
+/**
+  Tells if a segment has only transactions which --include-gtids or
+  --exclude-gtids filter out.
+*/
+bool shall_skip_binlog_segment(const Binlog_segment &segment,
+                               const Binlog_segment_filter &filter);
+
+/**
+  Plans the decoding of binlog files from their offset indexes: one
+  range per segment, leaving out the segments which --start-position,
+  --start-datetime, --include-gtids and --exclude-gtids tell are not
+  printed, and those after --stop-position or --stop-datetime.
+*/
+void plan_binlog_segments(const std::vector<Binlog_index> &indexes,
+                          const Binlog_segment_filter &filter,
+                          std::vector<Binlog_segment_range> *ranges);
+
+#endif /* MYSQLBINLOG_INDEX_INCLUDED */
@@ -63,6 +63,17 @@
               --iterations=5 --query=query.sql --create=create.sql \
               --delimiter=";"
 
+  Run a key lookup at a fixed rate of 2000 queries per second, whichever
+  client is idle running the next query when it is due, against an InnoDB,
+  a RocksDB and a TokuDB copy of the schema, with zipfian keys, a ten
+  second warm-up, and print the latency percentiles of each engine side by
+  side:
+
+    mysqlslap --concurrency=16 --number-of-queries=100000 \
+              --create=create.sql --delimiter=";" \
+              --query='SELECT * FROM t1 WHERE id = ${zipf:1:1000000}' \
+              --rate=2000 --warmup-time=10 --latency --compare-engines
+
 TODO:
   Add language for better tests
   String length for files and those put on the command line are not
@@ -75,7 +86,6 @@ TODO:
 
 #define SLAP_VERSION "1.0"
 
-#define HUGE_STRING_LENGTH 8196
 #define RAND_STRING_SIZE 126
 
 /* Types */
@@ -88,6 +98,7 @@ TODO:
 #define DELETE_TYPE_REQUIRES_PREFIX 6
 
 #include "client_priv.h"
+#include "mysqlslap_workload.h"
 #include "my_default.h"
 #include <mysqld_error.h>
 #include <my_dir.h>
@@ -103,6 +114,7 @@ TODO:
 #include <sys/time.h>
 #endif
 #include <ctype.h>
+#include <math.h>
 #include <welcome_copyright_notice.h>   /* ORACLE_WELCOME_COPYRIGHT_NOTICE */
 
 #ifdef _WIN32
@@ -163,6 +175,9 @@ static unsigned long connect_flags= CLIENT_MULTI_RESULTS |
 static int verbose;
 static uint commit_rate;
 static uint detach_rate;
+static ulonglong opt_rate= 0;
+static uint opt_warmup_time= 0;
+static my_bool opt_latency= FALSE, opt_compare_engines= FALSE;
 const char *num_int_cols_opt;
 const char *num_char_cols_opt;
 
@@ -197,17 +212,6 @@ static uint opt_mysql_port= 0;
 
 static const char *load_default_groups[]= { "mysqlslap","client",0 };
 
-typedef struct statement statement;
-
-struct statement {
-  char *string;
-  size_t length;
-  unsigned char type;
-  char *option;
-  size_t option_length;
-  statement *next;
-};
-
 typedef struct option_string option_string;
 
 struct option_string {
@@ -231,6 +235,11 @@ typedef struct thread_context thread_context;
 struct thread_context {
   statement *stmt;
   ulonglong limit;
+  query_slots slots;
+  ulonglong start;              /* my_micro_time() when clients wake up */
+  /* One per statement, the clients add theirs when they are done */
+  latency_histogram *histograms;
+  uint stmt_count;
 };
 
 typedef struct conclusions conclusions;
@@ -245,6 +254,14 @@ struct conclusions {
   /* The following are not used yet */
   unsigned long long max_rows;
   unsigned long long min_rows;
+  /* Latency over all queries and iterations, in microseconds */
+  unsigned long long queries;
+  double qps;
+  unsigned long long p50;
+  unsigned long long p99;
+  unsigned long long p999;
+  unsigned long long max_latency;
+  conclusions *next;
 };
 
 static option_string *engine_options= NULL;
@@ -252,11 +269,17 @@ static statement *pre_statements= NULL;
 static statement *post_statements= NULL; 
 static statement *create_statements= NULL, 
                  *query_statements= NULL;
+/* Results of every engine for --compare-engines */
+static conclusions *engine_results= NULL, **engine_results_last= &engine_results;
 
 /* Prototypes */
 void print_conclusions(conclusions *con);
 void print_conclusions_csv(conclusions *con);
 void generate_stats(conclusions *con, option_string *eng, stats *sptr);
+void generate_latency_stats(conclusions *con, latency_histogram *histograms,
+                            uint count);
+void print_query_latencies(statement *stmt, latency_histogram *histograms);
+void print_engine_comparison(void);
 uint parse_comma(const char *string, uint **range);
 uint parse_delimiter(const char *script, statement **stmt, char delm);
 int parse_option(const char *origin, option_string **stmt, char delm);
@@ -272,7 +295,8 @@ static int create_schema(MYSQL *mysql, const char *db, statement *stmt,
               option_string *engine_stmt);
 static void set_sql_mode(MYSQL *mysql);
 static int run_scheduler(stats *sptr, statement *stmts, uint concur, 
-                         ulonglong limit);
+                         ulonglong limit, latency_histogram *histograms,
+                         uint stmt_count);
 extern "C" void *run_task(void *p);
 void statement_cleanup(statement *stmt);
 void option_cleanup(option_string *stmt);
@@ -280,6 +304,7 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr);
 static int run_statements(MYSQL *mysql, statement *stmt);
 int slap_connect(MYSQL *mysql);
 static int run_query(MYSQL *mysql, const char *query, size_t len);
+static uint statement_count(statement *stmt);
 
 static const char ALPHANUMERICS[]=
   "0123456789ABCDEFGHIJKLMNOPQRSTWXYZabcdefghijklmnopqrstuvwxyz";
@@ -421,6 +446,9 @@ int main(int argc, char **argv)
 
   } while (eptr ? (eptr= eptr->next) : 0);
 
+  if (opt_compare_engines)
+    print_engine_comparison();
+
   native_mutex_destroy(&counter_mutex);
   native_cond_destroy(&count_threshold);
   native_mutex_destroy(&sleeper_mutex);
@@ -456,11 +484,20 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
   conclusions conclusion;
   unsigned long long client_limit;
   int sysret;
+  uint stmt_count;
+  latency_histogram *histograms;
 
   head_sptr= (stats *)my_malloc(PSI_NOT_INSTRUMENTED,
                                 sizeof(stats) * iterations, 
                                 MYF(MY_ZEROFILL|MY_FAE|MY_WME));
 
+  /* Latencies of each query are added up over all iterations */
+  stmt_count= statement_count(query_statements);
+  histograms= (latency_histogram *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                             sizeof(latency_histogram) *
+                                             stmt_count,
+                                             MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+
   memset(&conclusion, 0, sizeof(conclusions));
 
   if (auto_actual_queries)
@@ -508,7 +545,8 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
     if (pre_statements)
       run_statements(mysql, pre_statements);
 
-    run_scheduler(sptr, query_statements, current, client_limit); 
+    run_scheduler(sptr, query_statements, current, client_limit,
+                  histograms, stmt_count);
     
     if (post_statements)
       run_statements(mysql, post_statements);
@@ -527,12 +565,28 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr)
     printf("Generating stats\n");
 
   generate_stats(&conclusion, eptr, head_sptr);
+  generate_latency_stats(&conclusion, histograms, stmt_count);
 
   if (!opt_silent)
+  {
     print_conclusions(&conclusion);
+    if (opt_latency)
+      print_query_latencies(query_statements, histograms);
+  }
   if (opt_csv_str)
     print_conclusions_csv(&conclusion);
 
+  if (opt_compare_engines)
+  {
+    conclusions *copy= (conclusions *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                                sizeof(conclusions),
+                                                MYF(MY_FAE|MY_WME));
+    *copy= conclusion;
+    *engine_results_last= copy;
+    engine_results_last= &copy->next;
+  }
+
+  my_free(histograms);
   my_free(head_sptr);
 
 }
@@ -589,6 +643,12 @@ static struct my_option my_long_options[] =
   {"commit", OPT_SLAP_COMMIT, "Commit records every X number of statements.",
     &commit_rate, &commit_rate, 0, GET_UINT, REQUIRED_ARG,
     0, 0, 0, 0, 0, 0},
+  {"compare-engines", OPT_SLAP_COMPARE_ENGINES,
+    "Run the tests against a copy of the schema in each engine of --engine "
+    "(InnoDB, RocksDB and TokuDB if --engine is not given) and print the "
+    "results side by side.",
+    &opt_compare_engines, &opt_compare_engines, 0, GET_BOOL, NO_ARG,
+    0, 0, 0, 0, 0, 0},
   {"compress", 'C', "Use compression in server/client protocol.",
     &opt_compress, &opt_compress, 0, GET_BOOL, NO_ARG, 0, 0, 0,
     0, 0, 0},
@@ -645,6 +705,9 @@ static struct my_option my_long_options[] =
     REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"iterations", 'i', "Number of times to run the tests.", &iterations,
     &iterations, 0, GET_UINT, REQUIRED_ARG, 1, 1, UINT_MAX, 0, 0, 0},
+  {"latency", OPT_SLAP_LATENCY,
+    "Report the p50, p99 and p99.9 latency of every query.",
+    &opt_latency, &opt_latency, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"no-drop", OPT_SLAP_NO_DROP, "Do not drop the schema after the test.",
    &opt_no_drop, &opt_no_drop, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
   {"number-char-cols", 'x', 
@@ -696,9 +759,17 @@ static struct my_option my_long_options[] =
   {"protocol", OPT_MYSQL_PROTOCOL,
     "The protocol to use for connection (tcp, socket, pipe, memory).",
     0, 0, 0, GET_STR,  REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
-  {"query", 'q', "Query to run or file containing query to run.",
+  {"query", 'q', "Query to run or file containing query to run. "
+    "${uniform:LOW:HIGH} and ${zipf:LOW:HIGH[:THETA]} in a query are replaced "
+    "by a random key each time it is run.",
     &user_supplied_query, &user_supplied_query,
     0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"rate", OPT_SLAP_RATE,
+    "Run queries at this fixed rate per second over all clients instead of "
+    "as fast as possible. The next query due is run by whichever client is "
+    "idle, and its latency is measured from the time it was due, so it "
+    "includes the wait for a free client when all of them are busy.",
+    &opt_rate, &opt_rate, 0, GET_ULL, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {"secure-auth", OPT_SECURE_AUTH, "Refuse client connecting to server if it"
     " uses old (pre-4.1.1) protocol. Deprecated. Always TRUE",
     &opt_secure_auth, &opt_secure_auth, 0, GET_BOOL, NO_ARG, 1, 0, 0, 0, 0, 0},
@@ -726,6 +797,10 @@ static struct my_option my_long_options[] =
    0, 0, 0, 0, 0, 0},
   {"version", 'V', "Output version information and exit.", 0, 0, 0,
    GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"warmup-time", OPT_SLAP_WARMUP_TIME,
+    "Run the queries for this many seconds before measuring starts.",
+    &opt_warmup_time, &opt_warmup_time, 0, GET_UINT, REQUIRED_ARG,
+    0, 0, 0, 0, 0, 0},
   {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
 };
 
@@ -1563,9 +1638,32 @@ get_options(int *argc,char ***argv)
                           delimiter[0]);
   }
 
+  for (statement *ptr= query_statements; ptr && ptr->length; ptr= ptr->next)
+  {
+    if (parse_key_params(ptr))
+    {
+      fprintf(stderr, "%s: Invalid key placeholder in query %.*s\n",
+              my_progname, (int)ptr->length, ptr->string);
+      DBUG_RETURN(1);
+    }
+  }
+
   if (verbose >= 2)
     printf("Parsing engines to use.\n");
 
+  if (opt_compare_engines)
+  {
+    if (!create_statements)
+    {
+      fprintf(stderr, "%s: --compare-engines needs --create or "
+              "--auto-generate-sql to create the schema in each engine\n",
+              my_progname);
+      DBUG_RETURN(1);
+    }
+    if (!default_engine)
+      default_engine= (char *)"InnoDB,RocksDB,TokuDB";
+  }
+
   if (default_engine)
   {
     if(parse_option(default_engine, &engine_options, ',') == -1)
@@ -1831,8 +1929,39 @@ run_statements(MYSQL *mysql, statement *stmt)
   DBUG_RETURN(0);
 }
 
+static uint
+statement_count(statement *stmt)
+{
+  uint count= 0;
+
+  for (; stmt && stmt->length; stmt= stmt->next)
+    count++;
+  return count;
+}
+
+/* Copy the query to buffer with a random key for every placeholder */
+static size_t
+expand_key_params(statement *stmt, struct rand_struct *rand, char *buffer)
+{
+  char *to= buffer;
+  size_t from= 0;
+  key_param *param;
+
+  for (param= stmt->params; param; param= param->next)
+  {
+    memcpy(to, stmt->string + from, param->offset - from);
+    to+= param->offset - from;
+    to+= sprintf(to, "%llu", random_key(param, my_rnd(rand)));
+    from= param->offset + param->length;
+  }
+  memcpy(to, stmt->string + from, stmt->length - from);
+  to+= stmt->length - from;
+  return (size_t)(to - buffer);
+}
+
 static int
-run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
+run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit,
+              latency_histogram *histograms, uint stmt_count)
 {
   uint x;
   struct timeval start_time, end_time;
@@ -1843,6 +1972,12 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
 
   con.stmt= stmts;
   con.limit= limit;
+  con.slots.interval= opt_rate ? 1000000.0 / opt_rate : 0;
+  /* With --rate the clients share the queries of the run */
+  con.slots.left= (ulonglong)concur * (limit ? limit : stmt_count);
+  native_mutex_init(&con.slots.mutex, NULL);
+  con.histograms= histograms;
+  con.stmt_count= stmt_count;
 
   my_thread_attr_init(&attr);
   my_thread_attr_setdetachstate(&attr, MY_THREAD_CREATE_DETACHED);
@@ -1868,6 +2003,10 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
   native_mutex_unlock(&counter_mutex);
   my_thread_attr_destroy(&attr);
 
+  con.start= my_micro_time();
+  con.slots.measure_start= con.start + (ulonglong)opt_warmup_time * 1000000;
+  con.slots.next= (double)con.start;
+
   native_mutex_lock(&sleeper_mutex);
   master_wakeup= 0;
   native_mutex_unlock(&sleeper_mutex);
@@ -1889,9 +2028,13 @@ run_scheduler(stats *sptr, statement *stmts, uint concur, ulonglong limit)
   native_mutex_unlock(&counter_mutex);
 
   gettimeofday(&end_time, NULL);
+  native_mutex_destroy(&con.slots.mutex);
 
 
-  sptr->timing= timedif(end_time, start_time);
+  /* The warm-up is not part of the run */
+  sptr->timing= timedif(end_time, start_time) - (long)opt_warmup_time * 1000;
+  if (sptr->timing < 0)
+    sptr->timing= 0;
   sptr->users= concur;
   sptr->rows= limit;
 
@@ -1909,6 +2052,10 @@ extern "C" void *run_task(void *p)
   MYSQL_ROW row;
   statement *ptr;
   thread_context *con= (thread_context *)p;
+  latency_histogram *histograms;
+  struct rand_struct rand;
+  uint stmt_no, x;
+  ulonglong query_start;
 
   DBUG_ENTER("run_task");
   DBUG_PRINT("info", ("task script \"%s\"", con->stmt ? con->stmt->string : ""));
@@ -1920,6 +2067,12 @@ extern "C" void *run_task(void *p)
   }
   native_mutex_unlock(&sleeper_mutex);
 
+  histograms= (latency_histogram *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                             sizeof(latency_histogram) *
+                                             con->stmt_count,
+                                             MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+  randominit(&rand, (ulong)random(), (ulong)random());
+
   if (!(mysql= mysql_init(NULL)))
   {
     fprintf(stderr,"%s: mysql_init() failed ERROR : %s\n",
@@ -1953,9 +2106,9 @@ extern "C" void *run_task(void *p)
     run_query(mysql, "SET AUTOCOMMIT=0", strlen("SET AUTOCOMMIT=0"));
 
 limit_not_met:
-    for (ptr= con->stmt, detach_counter= 0; 
+    for (ptr= con->stmt, detach_counter= 0, stmt_no= 0; 
          ptr && ptr->length; 
-         ptr= ptr->next, detach_counter++)
+         ptr= ptr->next, detach_counter++, stmt_no++)
     {
       if (!opt_only_print && detach_rate && !(detach_counter % detach_rate))
       {
@@ -1972,6 +2125,23 @@ limit_not_met:
           goto end;
       }
 
+      /*
+        With --rate an idle client takes the next query slot and waits
+        for it. A slot which is already past is run right away, and the
+        delay counts as latency.
+      */
+      if (con->slots.interval)
+      {
+        ulonglong now;
+        if (take_query_slot(&con->slots, &query_start))
+          goto end;
+        now= my_micro_time();
+        if (now < query_start)
+          my_sleep((ulong)(query_start - now));
+      }
+      else
+        query_start= my_micro_time();
+
       /* 
         We have to execute differently based on query type. This should become a function.
       */
@@ -2010,6 +2180,19 @@ limit_not_met:
           }
         }
       }
+      else if (ptr->params)
+      {
+        char buffer[HUGE_STRING_LENGTH];
+        size_t length= expand_key_params(ptr, &rand, buffer);
+
+        if (run_query(mysql, buffer, length))
+        {
+          fprintf(stderr,"%s: Cannot run query %.*s ERROR : %s\n",
+                  my_progname, (uint)length, buffer, mysql_error(mysql));
+          mysql_close(mysql);
+          exit(0);
+        }
+      }
       else
       {
         if (run_query(mysql, ptr->string, ptr->length))
@@ -2036,7 +2219,13 @@ limit_not_met:
           }
         }
       } while(mysql_next_result(mysql) == 0);
-      queries++;
+
+      /* Queries of the warm-up are neither timed nor counted */
+      if (query_start >= con->slots.measure_start)
+      {
+        latency_record(&histograms[stmt_no], my_micro_time() - query_start);
+        queries++;
+      }
 
       if (commit_rate && (++commit_counter == commit_rate))
       {
@@ -2044,11 +2233,14 @@ limit_not_met:
         run_query(mysql, "COMMIT", strlen("COMMIT"));
       }
 
-      if (con->limit && queries == con->limit)
+      if (!con->slots.interval && con->limit && queries == con->limit)
         goto end;
     }
 
-    if (con->limit && queries < con->limit)
+    /* With --rate the clients run until all the slots are taken */
+    if (con->slots.interval ||
+        (con->limit && queries < con->limit) ||
+        (opt_warmup_time && my_micro_time() < con->slots.measure_start))
       goto limit_not_met;
 
 end:
@@ -2060,9 +2252,12 @@ end:
   mysql_thread_end();
 
   native_mutex_lock(&counter_mutex);
+  for (x= 0; x < con->stmt_count; x++)
+    latency_merge(&con->histograms[x], &histograms[x]);
   thread_counter--;
   native_cond_signal(&count_threshold);
   native_mutex_unlock(&counter_mutex);
+  my_free(histograms);
 
   DBUG_LEAVE;
   my_thread_exit(0);
@@ -2254,9 +2449,99 @@ print_conclusions(conclusions *con)
                     con->max_timing / 1000, con->max_timing % 1000);
   printf("\tNumber of clients running queries: %d\n", con->users);
   printf("\tAverage number of queries per client: %llu\n", con->avg_rows); 
+  if (opt_latency)
+  {
+    printf("\tNumber of queries per second: %.1f\n", con->qps);
+    printf("\tLatency p50/p99/p99.9/max: %llu.%03llu/%llu.%03llu/"
+           "%llu.%03llu/%llu.%03llu ms\n",
+           con->p50 / 1000, con->p50 % 1000,
+           con->p99 / 1000, con->p99 % 1000,
+           con->p999 / 1000, con->p999 % 1000,
+           con->max_latency / 1000, con->max_latency % 1000);
+  }
   printf("\n");
 }
 
+void
+print_query_latencies(statement *stmt, latency_histogram *histograms)
+{
+  statement *ptr;
+  uint x;
+
+  printf("Latency per query\n");
+  for (ptr= stmt, x= 0; ptr && ptr->length; ptr= ptr->next, x++)
+  {
+    latency_histogram *histogram= &histograms[x];
+    ulonglong p50= latency_percentile(histogram, 50);
+    ulonglong p99= latency_percentile(histogram, 99);
+    ulonglong p999= latency_percentile(histogram, 99.9);
+
+    if (!histogram->count)
+      continue;
+    printf("\t%.*s%s\n", (int)MY_MIN(ptr->length, 64), ptr->string,
+           ptr->length > 64 ? "..." : "");
+    printf("\t\t%llu queries, p50/p99/p99.9/max: %llu.%03llu/%llu.%03llu/"
+           "%llu.%03llu/%llu.%03llu ms\n", histogram->count,
+           p50 / 1000, p50 % 1000, p99 / 1000, p99 % 1000,
+           p999 / 1000, p999 % 1000,
+           histogram->max / 1000, histogram->max % 1000);
+  }
+  printf("\n");
+}
+
+/*
+  Print the results of --compare-engines, one column per engine and one
+  table per concurrency.
+*/
+void
+print_engine_comparison(void)
+{
+  static const char *labels[]=
+  {
+    "Average seconds", "Minimum seconds", "Maximum seconds",
+    "Queries per second", "Latency p50 ms", "Latency p99 ms",
+    "Latency p99.9 ms", "Latency max ms"
+  };
+  uint *current;
+  conclusions *con;
+  uint x;
+
+  for (current= concurrency; current && *current; current++)
+  {
+    printf("Engine comparison with %u clients\n", *current);
+    printf("\t%-20s", "");
+    for (con= engine_results; con; con= con->next)
+      if (con->users == *current)
+        printf(" %12.12s", con->engine ? con->engine : "default");
+    printf("\n");
+
+    for (x= 0; x < array_elements(labels); x++)
+    {
+      printf("\t%-20s", labels[x]);
+      for (con= engine_results; con; con= con->next)
+      {
+        double value;
+
+        if (con->users != *current)
+          continue;
+        switch (x) {
+        case 0: value= con->avg_timing / 1000.0; break;
+        case 1: value= con->min_timing / 1000.0; break;
+        case 2: value= con->max_timing / 1000.0; break;
+        case 3: value= con->qps; break;
+        case 4: value= con->p50 / 1000.0; break;
+        case 5: value= con->p99 / 1000.0; break;
+        case 6: value= con->p999 / 1000.0; break;
+        default: value= con->max_latency / 1000.0; break;
+        }
+        printf(" %12.3f", value);
+      }
+      printf("\n");
+    }
+    printf("\n");
+  }
+}
+
 void
 print_conclusions_csv(conclusions *con)
 {
@@ -2272,6 +2557,16 @@ print_conclusions_csv(conclusions *con)
            con->users, /* Children used */
            con->avg_rows  /* Queries run */
           );
+  if (opt_latency)
+  {
+    /* Replace the new line with the latency columns */
+    size_t length= strlen(buffer) - 1;
+    snprintf(buffer + length, HUGE_STRING_LENGTH - length,
+             ",%.1f,%llu,%llu,%llu,%llu\n",
+             con->qps, /* Queries per second */
+             con->p50, con->p99, con->p999, /* Latency in microseconds */
+             con->max_latency);
+  }
   my_write(csv_file, (uchar*) buffer, (uint)strlen(buffer), MYF(0));
 }
 
@@ -2308,6 +2603,26 @@ generate_stats(conclusions *con, option_string *eng, stats *sptr)
     con->engine= NULL;
 }
 
+void
+generate_latency_stats(conclusions *con, latency_histogram *histograms,
+                       uint count)
+{
+  latency_histogram all;
+  uint x;
+
+  memset(&all, 0, sizeof(all));
+  for (x= 0; x < count; x++)
+    latency_merge(&all, &histograms[x]);
+
+  con->queries= all.count;
+  con->qps= con->avg_timing ?
+            all.count * 1000.0 / ((double)con->avg_timing * iterations) : 0;
+  con->p50= latency_percentile(&all, 50);
+  con->p99= latency_percentile(&all, 99);
+  con->p999= latency_percentile(&all, 99.9);
+  con->max_latency= all.max;
+}
+
 void
 option_cleanup(option_string *stmt)
 {
@@ -2333,7 +2648,14 @@ statement_cleanup(statement *stmt)
 
   for (ptr= stmt; ptr; ptr= nptr)
   {
+    key_param *param, *nparam;
+
     nptr= ptr->next;
+    for (param= ptr->params; param; param= nparam)
+    {
+      nparam= param->next;
+      my_free(param);
+    }
     my_free(ptr->string);
     my_free(ptr);
   }
@@ -2369,3 +2691,5 @@ slap_connect(MYSQL *mysql)
 
   return 0;
 }
+
+#include "mysqlslap_workload.cc"
@@ -0,0 +1,256 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/*
+  Latency histograms, key placeholders and --rate query slots of
+  mysqlslap. Compiled as part of mysqlslap.cc.
+*/
+
+#include "mysqlslap_workload.h"
+#include "my_sys.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint
+latency_bucket(ulonglong value)
+{
+  uint shift;
+
+  if (value >= (1ULL << LATENCY_MAX_BITS))
+    value= (1ULL << LATENCY_MAX_BITS) - 1;
+  if (value < LATENCY_SUB_BUCKETS)
+    return (uint)value;
+
+  for (shift= 1; (value >> shift) >= LATENCY_SUB_BUCKETS; shift++)
+    ;
+  return LATENCY_SUB_BUCKETS + (shift - 1) * LATENCY_SUB_BUCKETS / 2 +
+         (uint)(value >> shift) - LATENCY_SUB_BUCKETS / 2;
+}
+
+ulonglong
+latency_bucket_value(uint bucket)
+{
+  uint shift;
+  ulonglong sub;
+
+  if (bucket < LATENCY_SUB_BUCKETS)
+    return bucket;
+
+  shift= (bucket - LATENCY_SUB_BUCKETS) / (LATENCY_SUB_BUCKETS / 2) + 1;
+  sub= (bucket - LATENCY_SUB_BUCKETS) % (LATENCY_SUB_BUCKETS / 2) +
+       LATENCY_SUB_BUCKETS / 2;
+  return ((sub + 1) << shift) - 1;
+}
+
+void
+latency_record(latency_histogram *histogram, ulonglong value)
+{
+  histogram->buckets[latency_bucket(value)]++;
+  histogram->count++;
+  if (value > histogram->max)
+    histogram->max= value;
+}
+
+void
+latency_merge(latency_histogram *to, const latency_histogram *from)
+{
+  uint x;
+
+  for (x= 0; x < LATENCY_BUCKETS; x++)
+    to->buckets[x]+= from->buckets[x];
+  to->count+= from->count;
+  if (from->max > to->max)
+    to->max= from->max;
+}
+
+ulonglong
+latency_percentile(const latency_histogram *histogram, double percentile)
+{
+  ulonglong rank, seen= 0;
+  uint x;
+
+  if (!histogram->count)
+    return 0;
+
+  rank= (ulonglong)ceil(percentile / 100 * histogram->count);
+  if (!rank)
+    rank= 1;
+  for (x= 0; x < LATENCY_BUCKETS; x++)
+  {
+    seen+= histogram->buckets[x];
+    if (seen >= rank)
+      return MY_MIN(latency_bucket_value(x), histogram->max);
+  }
+  return histogram->max;
+}
+
+/*
+  zeta(n, theta) = sum of 1 / i^theta for i = 1 .. n
+
+  Above a million the sum is estimated with the Euler-Maclaurin formula,
+  which is exact to well below the precision a benchmark needs.
+*/
+static double
+zeta(ulonglong n, double theta)
+{
+  const ulonglong exact= 1000000;
+  double sum= 0;
+  ulonglong i;
+
+  for (i= 1; i <= n && i <= exact; i++)
+    sum+= 1 / pow((double)i, theta);
+  if (n > exact)
+    sum+= (pow((double)n, 1 - theta) - pow((double)exact, 1 - theta)) /
+           (1 - theta) +
+           (pow((double)n, -theta) - pow((double)exact, -theta)) / 2;
+  return sum;
+}
+
+/*
+  Read the LOW or HIGH key of a placeholder, which strtoull() would also
+  take empty, signed or after spaces.
+
+  RETURN
+    0 ok, 1 if there is no number
+*/
+static int
+read_key(char **field, ulonglong *key)
+{
+  if (!isdigit((uchar) **field))
+    return 1;
+  *key= strtoull(*field, field, 10);
+  return 0;
+}
+
+/*
+  THETA is between 0 and 1, the default 0.99 gives the usual skew where
+  a few keys get most of the queries. With zipf the lowest keys are the
+  hottest.
+*/
+int
+parse_key_params(statement *stmt)
+{
+  key_param **last= &stmt->params;
+  char *pos= stmt->string;
+  uint count= 0;
+
+  while ((pos= strstr(pos, "${")))
+  {
+    char *close= strchr(pos, '}');
+    char *field= pos + 2;
+    key_param *param;
+    ulonglong high;
+
+    if (!close)
+      return 1;
+
+    /* Linked in right away so that statement_cleanup() frees it */
+    param= (key_param *)my_malloc(PSI_NOT_INSTRUMENTED, sizeof(key_param),
+                                  MYF(MY_ZEROFILL|MY_FAE|MY_WME));
+    *last= param;
+    last= &param->next;
+    param->offset= (size_t)(pos - stmt->string);
+    param->length= (size_t)(close + 1 - pos);
+    param->theta= 0.99;
+
+    if (!strncmp(field, "uniform:", 8))
+      field+= 8;
+    else if (!strncmp(field, "zipf:", 5))
+    {
+      param->zipf= TRUE;
+      field+= 5;
+    }
+    else
+      return 1;
+
+    if (read_key(&field, &param->low) || *field++ != ':' ||
+        read_key(&field, &high))
+      return 1;
+    if (param->zipf && *field == ':')
+      param->theta= strtod(field + 1, &field);
+    if (field != close || high < param->low ||
+        param->theta <= 0 || param->theta >= 1)
+      return 1;
+    param->items= high - param->low + 1;
+
+    if (param->zipf)
+    {
+      double zeta2= zeta(2, param->theta);
+
+      param->zetan= zeta(param->items, param->theta);
+      param->alpha= 1 / (1 - param->theta);
+      /* With one or two keys the first two ranks cover everything */
+      if (param->items > 2)
+        param->eta= (1 - pow(2.0 / param->items, 1 - param->theta)) /
+                    (1 - zeta2 / param->zetan);
+    }
+
+    count++;
+    pos= close + 1;
+  }
+
+  /* The keys must fit in the buffer of run_task() */
+  if (count && stmt->length + count * 20 >= HUGE_STRING_LENGTH)
+    return 1;
+  return 0;
+}
+
+ulonglong
+random_key(const key_param *param, double u)
+{
+  ulonglong rank;
+
+  if (!param->zipf)
+    rank= (ulonglong)(u * param->items);
+  else
+  {
+    double uz= u * param->zetan;
+
+    if (uz < 1)
+      rank= 0;
+    else if (uz < 1 + pow(0.5, param->theta))
+      rank= 1;
+    else
+      rank= (ulonglong)(param->items *
+                        pow(param->eta * u - param->eta + 1, param->alpha));
+  }
+  if (rank >= param->items)
+    rank= param->items - 1;
+  return param->low + rank;
+}
+
+
+my_bool
+take_query_slot(query_slots *slots, ulonglong *slot)
+{
+  my_bool done= FALSE;
+
+  native_mutex_lock(&slots->mutex);
+  if (slots->left == 0)
+    done= TRUE;
+  else
+  {
+    *slot= (ulonglong)slots->next;
+    slots->next+= slots->interval;
+    /* Queries of the warm-up do not count */
+    if (*slot >= slots->measure_start)
+      slots->left--;
+  }
+  native_mutex_unlock(&slots->mutex);
+  return done;
+}
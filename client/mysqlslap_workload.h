@@ -0,0 +1,120 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef MYSQLSLAP_WORKLOAD_INCLUDED
+#define MYSQLSLAP_WORKLOAD_INCLUDED
+
+#include "my_global.h"
+#include "thr_mutex.h"
+
+#define HUGE_STRING_LENGTH 8196
+
+typedef struct key_param key_param;
+
+/*
+  A ${uniform:LOW:HIGH} or ${zipf:LOW:HIGH[:THETA]} placeholder in a query,
+  replaced by a random key every time the query is run.
+*/
+struct key_param {
+  size_t offset;                /* Position of the placeholder in the query */
+  size_t length;
+  my_bool zipf;
+  ulonglong low;
+  ulonglong items;              /* Keys are low .. low + items - 1 */
+  /* Zipfian distribution, see Gray et al., SIGMOD 1994 */
+  double theta;
+  double alpha;
+  double zetan;
+  double eta;
+  key_param *next;
+};
+
+typedef struct statement statement;
+
+struct statement {
+  char *string;
+  size_t length;
+  unsigned char type;
+  char *option;
+  size_t option_length;
+  key_param *params;
+  statement *next;
+};
+
+/*
+  Latency histogram in microseconds, bucketed like HdrHistogram: exact
+  below LATENCY_SUB_BUCKETS, then LATENCY_SUB_BUCKETS / 2 linear buckets
+  per power of two, so a value is never off by more than 1/64.
+*/
+#define LATENCY_SUB_BUCKET_BITS 7
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_BITS 40
+#define LATENCY_BUCKETS (LATENCY_SUB_BUCKETS + \
+                         (LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS) * \
+                         LATENCY_SUB_BUCKETS / 2)
+
+typedef struct latency_histogram latency_histogram;
+
+struct latency_histogram {
+  ulonglong count;
+  ulonglong max;
+  ulonglong buckets[LATENCY_BUCKETS];
+};
+
+typedef struct query_slots query_slots;
+
+/*
+  With --rate, the time slot of the next query and the number of
+  measured queries left, shared by the clients so that whichever client
+  is idle runs the next query when it is due. Protected by mutex.
+*/
+struct query_slots {
+  /* Microseconds between two queries with --rate, else 0 */
+  double interval;
+  double next;
+  ulonglong left;
+  ulonglong measure_start;      /* End of the warm-up */
+  native_mutex_t mutex;
+};
+
+uint latency_bucket(ulonglong value);
+/* Highest value that falls into the bucket */
+ulonglong latency_bucket_value(uint bucket);
+void latency_record(latency_histogram *histogram, ulonglong value);
+void latency_merge(latency_histogram *to, const latency_histogram *from);
+ulonglong latency_percentile(const latency_histogram *histogram,
+                             double percentile);
+
+/*
+  Find the ${uniform:LOW:HIGH} and ${zipf:LOW:HIGH[:THETA]} placeholders
+  of a query, linked to stmt->params even when one is malformed.
+
+  RETURN
+    0 ok, 1 if a placeholder is malformed
+*/
+int parse_key_params(statement *stmt);
+/* Key of a placeholder for u, uniform between 0 and 1 */
+ulonglong random_key(const key_param *param, double u);
+
+/**
+  Takes the time slot of the next query of the run for the calling
+  client, with --rate.
+
+  @retval TRUE All the queries of the run are taken.
+*/
+my_bool take_query_slot(query_slots *slots, ulonglong *slot);
+
+#endif /* MYSQLSLAP_WORKLOAD_INCLUDED */
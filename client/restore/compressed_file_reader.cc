@@ -0,0 +1,214 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "compressed_file_reader.h"
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+using namespace Mysql::Tools::Restore;
+
+static bool has_suffix(const std::string& name, const char* suffix)
+{
+  size_t suffix_length= strlen(suffix);
+  return name.size() >= suffix_length
+    && name.compare(name.size() - suffix_length, suffix_length, suffix) == 0;
+}
+
+bool Compressed_file_reader::set_error(const std::string& message)
+{
+  m_error= message;
+  return true;
+}
+
+bool Compressed_file_reader::open(const std::string& file_name)
+{
+  m_file= fopen(file_name.c_str(), "rb");
+  if (m_file == NULL)
+    return this->set_error("Cannot open file " + file_name + ": "
+      + strerror(errno));
+
+  if (has_suffix(file_name, ".lz4"))
+  {
+    m_compression= COMPRESSION_LZ4;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&m_lz4_context,
+      LZ4F_VERSION)))
+    {
+      return this->set_error("LZ4 decompression initialization failed");
+    }
+  }
+  else if (has_suffix(file_name, ".zlib"))
+  {
+    m_compression= COMPRESSION_ZLIB;
+    if (inflateInit(&m_zlib_context) != Z_OK)
+      return this->set_error("zlib decompression initialization failed");
+  }
+  else if (has_suffix(file_name, ".zst"))
+  {
+#ifdef HAVE_ZSTD
+    m_compression= COMPRESSION_ZSTD;
+    m_zstd_context= ZSTD_createDStream();
+    if (m_zstd_context == NULL
+      || ZSTD_isError(ZSTD_initDStream(m_zstd_context)))
+    {
+      return this->set_error("zstd decompression initialization failed");
+    }
+#else
+    return this->set_error("zstd compressed file " + file_name
+      + " cannot be read, zstd support is not compiled in");
+#endif
+  }
+  return false;
+}
+
+bool Compressed_file_reader::fill_input()
+{
+  if (m_input_pos < m_input_end || m_end_of_input)
+    return false;
+  m_input_pos= 0;
+  m_input_end= fread(&m_input[0], 1, m_input.size(), m_file);
+  if (m_input_end == 0)
+  {
+    if (ferror(m_file))
+      return this->set_error(std::string("Error reading file: ")
+        + strerror(errno));
+    m_end_of_input= true;
+  }
+  return false;
+}
+
+int64 Compressed_file_reader::read(char* buffer, size_t length)
+{
+  if (m_compression == COMPRESSION_NONE)
+  {
+    size_t bytes= fread(buffer, 1, length, m_file);
+    if (bytes == 0 && ferror(m_file))
+    {
+      this->set_error(std::string("Error reading file: ") + strerror(errno));
+      return -1;
+    }
+    return bytes;
+  }
+
+  /* Decompress until some output is produced or the stream ends. */
+  size_t produced= 0;
+  while (produced == 0 && !m_end_of_stream)
+  {
+    if (this->fill_input())
+      return -1;
+    if (m_end_of_input)
+    {
+      this->set_error("Compressed file is truncated");
+      return -1;
+    }
+    char* input= &m_input[m_input_pos];
+    size_t input_length= m_input_end - m_input_pos;
+
+    switch (m_compression)
+    {
+    case COMPRESSION_LZ4:
+      {
+        size_t output_length= length;
+        size_t result= LZ4F_decompress(m_lz4_context, buffer, &output_length,
+          input, &input_length, NULL);
+        if (LZ4F_isError(result))
+        {
+          this->set_error(std::string("LZ4 decompression failed: ")
+            + LZ4F_getErrorName(result));
+          return -1;
+        }
+        m_input_pos+= input_length;
+        produced= output_length;
+        m_end_of_stream= (result == 0);
+        break;
+      }
+    case COMPRESSION_ZLIB:
+      {
+        m_zlib_context.next_in= (Bytef*)input;
+        m_zlib_context.avail_in= (uInt)input_length;
+        m_zlib_context.next_out= (Bytef*)buffer;
+        m_zlib_context.avail_out= (uInt)length;
+        int result= inflate(&m_zlib_context, Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+        {
+          this->set_error("zlib decompression failed");
+          return -1;
+        }
+        m_input_pos+= input_length - m_zlib_context.avail_in;
+        produced= length - m_zlib_context.avail_out;
+        m_end_of_stream= (result == Z_STREAM_END);
+        break;
+      }
+#ifdef HAVE_ZSTD
+    case COMPRESSION_ZSTD:
+      {
+        ZSTD_inBuffer zstd_input= { input, input_length, 0 };
+        ZSTD_outBuffer zstd_output= { buffer, length, 0 };
+        size_t result= ZSTD_decompressStream(m_zstd_context, &zstd_output,
+          &zstd_input);
+        if (ZSTD_isError(result))
+        {
+          this->set_error(std::string("zstd decompression failed: ")
+            + ZSTD_getErrorName(result));
+          return -1;
+        }
+        m_input_pos+= zstd_input.pos;
+        produced= zstd_output.pos;
+        m_end_of_stream= (result == 0);
+        break;
+      }
+#endif
+    default:
+      assert(false);
+      return -1;
+    }
+  }
+  return produced;
+}
+
+const std::string& Compressed_file_reader::get_error() const
+{
+  return m_error;
+}
+
+Compressed_file_reader::~Compressed_file_reader()
+{
+  if (m_file != NULL)
+    fclose(m_file);
+  if (m_compression == COMPRESSION_LZ4)
+    LZ4F_freeDecompressionContext(m_lz4_context);
+  else if (m_compression == COMPRESSION_ZLIB)
+    inflateEnd(&m_zlib_context);
+#ifdef HAVE_ZSTD
+  else if (m_compression == COMPRESSION_ZSTD && m_zstd_context != NULL)
+    ZSTD_freeDStream(m_zstd_context);
+#endif
+}
+
+Compressed_file_reader::Compressed_file_reader()
+  : m_file(NULL),
+  m_compression(COMPRESSION_NONE),
+  m_input(128 * 1024),
+  m_input_pos(0),
+  m_input_end(0),
+  m_end_of_input(false),
+  m_end_of_stream(false)
+#ifdef HAVE_ZSTD
+  , m_zstd_context(NULL)
+#endif
+{
+  memset(&m_zlib_context, 0, sizeof(m_zlib_context));
+}
@@ -0,0 +1,99 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef COMPRESSED_FILE_READER_INCLUDED
+#define COMPRESSED_FILE_READER_INCLUDED
+
+#include "my_global.h"
+#include <lz4frame.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Reads file written by mysqlpump, decompressing it if it was written with
+  --compress-output. Algorithm is chosen by file name extension: .lz4, .zlib
+  or .zst, other files are read as they are.
+ */
+class Compressed_file_reader
+{
+public:
+  Compressed_file_reader();
+
+  ~Compressed_file_reader();
+
+  /**
+    Opens specified file. Returns true on error.
+   */
+  bool open(const std::string& file_name);
+
+  /**
+    Reads up to length bytes of decompressed data. Returns number of bytes
+    read, 0 at end of file or -1 on error.
+   */
+  int64 read(char* buffer, size_t length);
+
+  /**
+    Returns description of last error.
+   */
+  const std::string& get_error() const;
+
+private:
+  enum Compression
+  {
+    COMPRESSION_NONE,
+    COMPRESSION_LZ4,
+    COMPRESSION_ZLIB,
+    COMPRESSION_ZSTD
+  };
+
+  /**
+    Makes sure there is unprocessed compressed input, unless at end of file.
+    Returns true on error.
+   */
+  bool fill_input();
+
+  bool set_error(const std::string& message);
+
+  FILE* m_file;
+  Compression m_compression;
+  std::vector<char> m_input;
+  size_t m_input_pos;
+  size_t m_input_end;
+  bool m_end_of_input;
+  bool m_end_of_stream;
+  std::string m_error;
+
+  LZ4F_decompressionContext_t m_lz4_context;
+  z_stream m_zlib_context;
+#ifdef HAVE_ZSTD
+  ZSTD_DStream* m_zstd_context;
+#endif
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,398 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef UNITTEST_DATA_FILE_LOADER
+#include "data_file_loader.h"
+#include "errmsg.h"
+#include "instance_callback.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#endif
+#include <string.h>
+#include <string>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+static int decode_hex_digit(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/**
+  Decodes name written by mysqlpump Chunk_file_writer, with @xx standing
+  for byte xx.
+ */
+static bool decode_name(const std::string& encoded, std::string* name)
+{
+  name->clear();
+  for (size_t i= 0; i < encoded.size(); ++i)
+  {
+    if (encoded[i] != '@')
+    {
+      *name+= encoded[i];
+      continue;
+    }
+    if (i + 2 >= encoded.size())
+      return false;
+    int high= decode_hex_digit(encoded[i + 1]);
+    int low= decode_hex_digit(encoded[i + 2]);
+    if (high < 0 || low < 0)
+      return false;
+    *name+= (char)(high * 16 + low);
+    i+= 2;
+  }
+  return !name->empty();
+}
+
+static std::string quote_name(const std::string& name)
+{
+  std::string quoted("`");
+  for (std::string::const_iterator it= name.begin(); it != name.end(); ++it)
+  {
+    if (*it == '`')
+      quoted+= '`';
+    quoted+= *it;
+  }
+  return quoted + "`";
+}
+
+std::string get_quoted_table_name(const std::string& schema,
+  const std::string& table)
+{
+  return quote_name(schema) + "." + quote_name(table);
+}
+
+bool parse_data_file_name(const std::string& file_name,
+  std::string* schema, std::string* table)
+{
+  size_t table_start= file_name.find('.');
+  if (table_start == std::string::npos)
+    return false;
+  size_t chunk_start= file_name.find('.', table_start + 1);
+  if (chunk_start == std::string::npos)
+    return false;
+  size_t chunk_end= file_name.find('.', chunk_start + 1);
+  if (chunk_end == std::string::npos
+    || file_name.compare(chunk_end, 4, ".txt") != 0
+    || strspn(file_name.c_str() + chunk_start + 1, "0123456789")
+      != chunk_end - chunk_start - 1)
+  {
+    return false;
+  }
+  return decode_name(file_name.substr(0, table_start), schema)
+    && decode_name(file_name.substr(table_start + 1,
+      chunk_start - table_start - 1), table);
+}
+
+size_t get_batch_length(const char* data, size_t length, uint64 batch_bytes,
+  uint64 batch_size, bool* complete)
+{
+  if (batch_bytes + length < batch_size)
+    return length;
+
+  /*
+    Batch ends with the line crossing batch size. Data files have line
+    ends escaped inside of values, so any newline ends a row.
+   */
+  size_t search_from= batch_bytes + 1 < batch_size
+    ? (size_t)(batch_size - batch_bytes - 1) : 0;
+  const char* line_end= (const char*)memchr(data + search_from, '\n',
+    length - search_from);
+  if (line_end == NULL)
+    return length;
+  *complete= true;
+  return line_end + 1 - data;
+}
+
+}
+}
+}
+
+#ifndef UNITTEST_DATA_FILE_LOADER
+using namespace Mysql::Tools::Restore;
+
+/* Committed offsets of data files, see Data_file_loader. */
+static const char progress_table[]= "`mysql`.`mysqlrestore_progress`";
+
+bool Data_file_loader::create_progress_table(
+  Mysql::Tools::Base::Mysql_query_runner* runner, bool reset)
+{
+  return runner->run_query(std::string("CREATE TABLE IF NOT EXISTS ")
+      + progress_table + " (`data_file` VARCHAR(512) NOT NULL PRIMARY KEY,"
+      " `offset` BIGINT UNSIGNED NOT NULL) ENGINE=InnoDB") != 0
+    || (reset
+      && runner->run_query(std::string("DELETE FROM ") + progress_table) != 0);
+}
+
+bool Data_file_loader::drop_progress_table(
+  Mysql::Tools::Base::Mysql_query_runner* runner)
+{
+  return runner->run_query(std::string("DROP TABLE IF EXISTS ")
+    + progress_table) != 0;
+}
+
+std::string Data_file_loader::get_column_list(
+  Mysql::Tools::Base::Mysql_query_runner* runner)
+{
+  /* The same columns, in the same order, as mysqlpump selects. */
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*> columns;
+  if (runner->run_query_store(
+    "SELECT `COLUMN_NAME` FROM `INFORMATION_SCHEMA`.`COLUMNS` "
+    "WHERE TABLE_SCHEMA ='" + runner->escape_string(m_schema) +
+    "' AND TABLE_NAME ='" + runner->escape_string(m_table) +
+    "' AND EXTRA NOT IN ('STORED GENERATED', 'VIRTUAL GENERATED') "
+    "ORDER BY ORDINAL_POSITION", &columns) != 0)
+  {
+    return "";
+  }
+
+  std::string column_list;
+  for (std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*>
+    ::iterator it= columns.begin(); it != columns.end(); ++it)
+  {
+    if (!column_list.empty())
+      column_list+= ',';
+    column_list+= quote_name((**it)[0]);
+  }
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&columns);
+  return column_list;
+}
+
+bool Data_file_loader::read_offset(
+  Mysql::Tools::Base::Mysql_query_runner* runner)
+{
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*> offset;
+  if (runner->run_query_store(std::string("SELECT `offset` FROM ")
+    + progress_table + " WHERE `data_file` = '"
+    + runner->escape_string(m_file_name) + "'", &offset) != 0)
+  {
+    return true;
+  }
+  m_offset= offset.size() == 1
+    ? strtoull((*offset[0])[0].c_str(), NULL, 10) : 0;
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&offset);
+  return false;
+}
+
+int64 Data_file_loader::count_warning(
+  const Mysql::Tools::Base::Message_data& message)
+{
+  if (message.get_message_type() == Mysql::Tools::Base::Message_type_warning)
+    ++m_batch_warnings;
+  /* Let the program report it as well. */
+  return 0;
+}
+
+bool Data_file_loader::load_batch(
+  Mysql::Tools::Base::Mysql_query_runner* runner, const std::string& query)
+{
+  /*
+    Warnings are fetched with SHOW WARNINGS right after the statement, so
+    they are counted as reported instead of with mysql_warning_count().
+   */
+  Mysql::Instance_callback<int64, const Mysql::Tools::Base::Message_data&,
+    Data_file_loader> warning_callback(this, &Data_file_loader::count_warning);
+  Mysql::Tools::Base::Mysql_query_runner load_runner(*runner);
+  load_runner.add_message_callback(&warning_callback);
+
+  m_batch_bytes= 0;
+  m_batch_warnings= 0;
+  m_batch_complete= false;
+  mysql_set_local_infile_handler(runner->get_low_level_connection(),
+    &Data_file_loader::local_infile_init,
+    &Data_file_loader::local_infile_read,
+    &Data_file_loader::local_infile_end,
+    &Data_file_loader::local_infile_error, this);
+
+  if (runner->run_query("START TRANSACTION") != 0)
+    return true;
+  if (load_runner.run_query(query) != 0)
+  {
+    runner->run_query("ROLLBACK");
+    return true;
+  }
+  if (m_batch_warnings != 0)
+  {
+    runner->run_query("ROLLBACK");
+    std::cerr << "Loading " << m_file_name << " from offset " << m_offset
+      << " gave " << m_batch_warnings << " warnings, batch rolled back"
+      << std::endl;
+    return true;
+  }
+
+  char offset[32];
+  snprintf(offset, sizeof(offset), "%llu",
+    (unsigned long long)(m_offset + m_batch_bytes));
+  if (runner->run_query(std::string("REPLACE INTO ") + progress_table
+      + " VALUES ('" + runner->escape_string(m_file_name) + "', "
+      + offset + ")") != 0
+    || runner->run_query("COMMIT") != 0)
+  {
+    runner->run_query("ROLLBACK");
+    return true;
+  }
+  m_offset+= m_batch_bytes;
+  return false;
+}
+
+bool Data_file_loader::run(Mysql::Tools::Base::Mysql_query_runner* runner)
+{
+  std::string path= m_directory + "/" + m_file_name;
+  if (m_reader.open(path))
+  {
+    std::cerr << "Cannot open " << path << ": " << m_reader.get_error()
+      << std::endl;
+    return true;
+  }
+
+  /* Skip part of file loaded before restore was interrupted. */
+  if (this->read_offset(runner))
+    return true;
+  for (uint64 skipped= 0; skipped < m_offset;)
+  {
+    int64 bytes= m_reader.read(&m_buffer[0],
+      (size_t)std::min<uint64>(m_buffer.size(), m_offset - skipped));
+    if (bytes <= 0)
+    {
+      std::cerr << "Cannot resume loading of " << path << ": "
+        << (bytes < 0 ? m_reader.get_error() : "file is shorter")
+        << std::endl;
+      return true;
+    }
+    skipped+= bytes;
+  }
+
+  std::string column_list= this->get_column_list(runner);
+  if (column_list.empty())
+  {
+    std::cerr << "Cannot get columns of table " << m_schema << "."
+      << m_table << std::endl;
+    return true;
+  }
+
+  /*
+    Data files are written in character set of dump connections, which is
+    set by SET NAMES in header of dump and replayed on this connection.
+   */
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row*> charset;
+  if (runner->run_query_store("SELECT @@character_set_client", &charset) != 0
+    || charset.size() != 1)
+  {
+    Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&charset);
+    return true;
+  }
+  std::string query= "LOAD DATA LOCAL INFILE '"
+    + runner->escape_string(m_file_name) + "' INTO TABLE "
+    + get_quoted_table_name(m_schema, m_table)
+    + " CHARACTER SET " + (*charset[0])[0]
+    + " (" + column_list + ")";
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&charset);
+
+  while (!m_end_of_file)
+  {
+    if (this->load_batch(runner, query))
+      return true;
+  }
+  return m_checkpoint->data_file_done(m_file_name);
+}
+
+int Data_file_loader::read_batch(char* buffer, uint length)
+{
+  if (m_batch_complete)
+    return 0;
+  if (m_buffer_pos == m_buffer_end)
+  {
+    int64 bytes= m_reader.read(&m_buffer[0], m_buffer.size());
+    if (bytes < 0)
+      return -1;
+    if (bytes == 0)
+    {
+      m_end_of_file= true;
+      m_batch_complete= true;
+      return 0;
+    }
+    m_buffer_pos= 0;
+    m_buffer_end= (size_t)bytes;
+  }
+
+  const char* data= &m_buffer[m_buffer_pos];
+  size_t bytes= get_batch_length(data,
+    std::min<size_t>(length, m_buffer_end - m_buffer_pos), m_batch_bytes,
+    m_batch_size, &m_batch_complete);
+  memcpy(buffer, data, bytes);
+  m_buffer_pos+= bytes;
+  m_batch_bytes+= bytes;
+  return (int)bytes;
+}
+
+int Data_file_loader::local_infile_init(void** ptr, const char*,
+  void* user_data)
+{
+  *ptr= user_data;
+  return 0;
+}
+
+int Data_file_loader::local_infile_read(void* ptr, char* buffer, uint length)
+{
+  return ((Data_file_loader*)ptr)->read_batch(buffer, length);
+}
+
+void Data_file_loader::local_infile_end(void*)
+{}
+
+int Data_file_loader::local_infile_error(void* ptr, char* message,
+  uint length)
+{
+  Data_file_loader* loader= (Data_file_loader*)ptr;
+  snprintf(message, length, "Error reading %s: %s",
+    loader->m_file_name.c_str(), loader->m_reader.get_error().c_str());
+  return CR_UNKNOWN_ERROR;
+}
+
+uint64 Data_file_loader::get_size() const
+{
+  return m_file_size;
+}
+
+Data_file_loader::Data_file_loader(const std::string& directory,
+  const std::string& file_name, const std::string& schema,
+  const std::string& table, uint64 file_size, uint64 batch_size,
+  Restore_checkpoint* checkpoint)
+  : m_directory(directory),
+  m_file_name(file_name),
+  m_schema(schema),
+  m_table(table),
+  m_file_size(file_size),
+  m_batch_size(batch_size),
+  m_checkpoint(checkpoint),
+  m_buffer(1024 * 1024),
+  m_buffer_pos(0),
+  m_buffer_end(0),
+  m_offset(0),
+  m_batch_bytes(0),
+  m_batch_warnings(0),
+  m_batch_complete(false),
+  m_end_of_file(false)
+{}
+
+#endif
@@ -0,0 +1,148 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef DATA_FILE_LOADER_INCLUDED
+#define DATA_FILE_LOADER_INCLUDED
+
+#include "i_restore_job.h"
+#include "compressed_file_reader.h"
+#include "restore_checkpoint.h"
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Parses data file name <schema>.<table>.<chunk>.txt[.<compression>] as
+  written by mysqlpump. Returns false if name does not match.
+ */
+bool parse_data_file_name(const std::string& file_name,
+  std::string* schema, std::string* table);
+
+/**
+  Returns `schema`.`table`, quoted the same way as mysqlpump quotes names.
+ */
+std::string get_quoted_table_name(const std::string& schema,
+  const std::string& table);
+
+/**
+  Returns how many of length bytes at data go to batch of which batch_bytes
+  are read already: all of them, or these up to the first line end after
+  batch_size bytes, in which case complete is set.
+ */
+size_t get_batch_length(const char* data, size_t length, uint64 batch_bytes,
+  uint64 batch_size, bool* complete);
+
+/**
+  Loads single table data file written by mysqlpump --chunk-output-dir with
+  LOAD DATA LOCAL INFILE. File is read through local infile handler, which
+  decompresses it and ends each statement at first line end after
+  --load-batch-size bytes, so every batch is a separate transaction.
+
+  Offset of data file loaded so far is kept in progress table, and updated
+  in transaction of each batch, so loading resumes after the last committed
+  batch even if restore is killed between commit and checkpoint. Batch with
+  warnings is rolled back: LOAD DATA LOCAL turns errors like duplicate keys
+  or invalid values into warnings.
+ */
+class Data_file_loader : public I_restore_job
+{
+public:
+  Data_file_loader(const std::string& directory, const std::string& file_name,
+    const std::string& schema, const std::string& table, uint64 file_size,
+    uint64 batch_size, Restore_checkpoint* checkpoint);
+
+  bool run(Mysql::Tools::Base::Mysql_query_runner* runner);
+
+  uint64 get_size() const;
+
+  /**
+    Creates progress table of data files, emptying it if reset is set.
+    Returns true on error.
+   */
+  static bool create_progress_table(
+    Mysql::Tools::Base::Mysql_query_runner* runner, bool reset);
+
+  /**
+    Drops progress table once all data is loaded. Returns true on error.
+   */
+  static bool drop_progress_table(
+    Mysql::Tools::Base::Mysql_query_runner* runner);
+
+private:
+  /**
+    Returns comma separated list of quoted columns of table, in order of
+    data file fields, or empty string on error.
+   */
+  std::string get_column_list(Mysql::Tools::Base::Mysql_query_runner* runner);
+
+  /**
+    Reads committed offset of data file from progress table into m_offset.
+    Returns true on error.
+   */
+  bool read_offset(Mysql::Tools::Base::Mysql_query_runner* runner);
+
+  /**
+    Loads next batch and records its end in progress table, in one
+    transaction. Returns true on error.
+   */
+  bool load_batch(Mysql::Tools::Base::Mysql_query_runner* runner,
+    const std::string& query);
+
+  /**
+    Counts warnings reported for current batch.
+   */
+  int64 count_warning(const Mysql::Tools::Base::Message_data& message);
+
+  /**
+    Passes data of current batch to LOAD DATA LOCAL INFILE.
+   */
+  int read_batch(char* buffer, uint length);
+
+  static int local_infile_init(void** ptr, const char* file_name,
+    void* user_data);
+  static int local_infile_read(void* ptr, char* buffer, uint length);
+  static void local_infile_end(void* ptr);
+  static int local_infile_error(void* ptr, char* message, uint length);
+
+  std::string m_directory;
+  std::string m_file_name;
+  std::string m_schema;
+  std::string m_table;
+  uint64 m_file_size;
+  uint64 m_batch_size;
+  Restore_checkpoint* m_checkpoint;
+
+  Compressed_file_reader m_reader;
+  std::vector<char> m_buffer;
+  size_t m_buffer_pos;
+  size_t m_buffer_end;
+  /* Bytes of decompressed file committed to table. */
+  uint64 m_offset;
+  /* Bytes passed to server in current batch. */
+  uint64 m_batch_bytes;
+  uint64 m_batch_warnings;
+  bool m_batch_complete;
+  bool m_end_of_file;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef I_RESTORE_JOB_INCLUDED
+#define I_RESTORE_JOB_INCLUDED
+
+#include "my_global.h"
+#include "base/mysql_query_runner.h"
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Unit of restore work which can be run concurrently with other jobs of the
+  same phase, on any of restore connections.
+ */
+class I_restore_job
+{
+public:
+  virtual ~I_restore_job()
+  {}
+
+  /**
+    Runs job using specified connection. Returns true on error.
+   */
+  virtual bool run(Mysql::Tools::Base::Mysql_query_runner* runner)= 0;
+
+  /**
+    Returns approximate amount of work, larger jobs are started first.
+   */
+  virtual uint64 get_size() const= 0;
+};
+
+}
+}
+}
+
+#endif
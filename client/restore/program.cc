@@ -0,0 +1,416 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "program.h"
+#include "data_file_loader.h"
+#include "sql_script_reader.h"
+#include "sql_statement_job.h"
+#include "thread_group.h"
+#include "instance_callback.h"
+#include "my_dir.h"
+#include "m_string.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace Mysql::Tools::Restore;
+
+namespace{
+
+bool compare_job_size(const I_restore_job* first,
+  const I_restore_job* second)
+{
+  return first->get_size() > second->get_size();
+}
+
+bool is_set_statement(const std::string& statement)
+{
+  return statement.size() > 4
+    && native_strncasecmp(statement.c_str(), "SET ", 4) == 0;
+}
+
+/**
+  Returns true if statement changes only session state, and so has to be
+  executed on every connection.
+ */
+bool is_session_statement(const std::string& statement)
+{
+  return is_set_statement(statement)
+    && statement.find("@@GLOBAL") == std::string::npos;
+}
+
+}
+
+int64 Program::message_handler(
+  const Mysql::Tools::Base::Message_data& message)
+{
+  this->error(message);
+  return 0;
+}
+
+void Program::error(const Mysql::Tools::Base::Message_data& message)
+{
+  std::cerr << this->get_name() << ": [" << message.get_message_type_string()
+    << "] (" << message.get_code() << ") " << message.get_message()
+    << std::endl;
+
+  if (message.get_message_type() == Mysql::Tools::Base::Message_type_error)
+    m_error_code.store((int)message.get_code());
+}
+
+Mysql::Tools::Base::Mysql_query_runner* Program::create_runner()
+{
+  MYSQL* connection= this->create_connection();
+  if (connection == NULL)
+    return NULL;
+  return &(new Mysql::Tools::Base::Mysql_query_runner(connection))
+    ->add_message_callback(new Mysql::Instance_callback<
+      int64, const Mysql::Tools::Base::Message_data&, Program>(
+      this, &Program::message_handler));
+}
+
+bool Program::restore_schema(Mysql::Tools::Base::Mysql_query_runner* runner,
+  const std::string& dump_file)
+{
+  Compressed_file_reader input;
+  if (input.open(dump_file))
+  {
+    this->error(Mysql::Tools::Base::Message_data(1,
+      "Cannot open dump file \"" + dump_file + "\": " + input.get_error(),
+      Mysql::Tools::Base::Message_type_error));
+    return true;
+  }
+
+  Sql_script_reader reader(&input);
+  std::map<std::string, size_t> deferred_index_positions;
+  std::string statement;
+  std::string database;
+  std::string table;
+  std::string index_definition;
+  bool in_header= true;
+  uint64 done= m_checkpoint.get_schema_statements_done();
+
+  for (uint64 number= 0; reader.read_statement(&statement); ++number)
+  {
+    if (Sql_script_reader::is_deferred_index_statement(
+      statement, &table, &index_definition))
+    {
+      /* All indexes of table are added with one ALTER TABLE. */
+      std::map<std::string, size_t>::iterator it=
+        deferred_index_positions.find(table);
+      if (it == deferred_index_positions.end())
+      {
+        it= deferred_index_positions.insert(
+          std::make_pair(table, m_deferred_indexes.size())).first;
+        m_deferred_indexes.push_back(Deferred_indexes());
+        m_deferred_indexes.back().m_database= database;
+        m_deferred_indexes.back().m_table= table;
+      }
+      m_deferred_indexes[it->second].m_index_definitions.push_back(
+        index_definition);
+      continue;
+    }
+    if (Sql_script_reader::is_create_trigger_statement(statement))
+    {
+      m_triggers.push_back(std::make_pair(database, statement));
+      continue;
+    }
+
+    in_header= in_header && is_set_statement(statement);
+    if (in_header && is_session_statement(statement))
+      m_session_statements.push_back(statement);
+
+    /*
+      Statements already executed are skipped, except these changing session
+      state, which is lost with connection of interrupted restore.
+     */
+    bool is_use= Sql_script_reader::is_use_statement(statement, &database);
+    if (number < done && !is_use && !is_session_statement(statement))
+      continue;
+    if (runner->run_query(statement) != 0)
+      return true;
+    if (number >= done && m_checkpoint.schema_statement_done(number))
+    {
+      this->error(Mysql::Tools::Base::Message_data(errno,
+        "Cannot write checkpoint file",
+        Mysql::Tools::Base::Message_type_error));
+      return true;
+    }
+  }
+  if (reader.has_error())
+  {
+    this->error(Mysql::Tools::Base::Message_data(1,
+      "Cannot read dump file \"" + dump_file + "\": " + input.get_error(),
+      Mysql::Tools::Base::Message_type_error));
+    return true;
+  }
+  return false;
+}
+
+bool Program::find_data_files(std::vector<I_restore_job*>* jobs)
+{
+  MY_DIR* directory= my_dir(m_data_dir.value().c_str(), MYF(MY_WANT_STAT));
+  if (directory == NULL)
+  {
+    this->error(Mysql::Tools::Base::Message_data(errno,
+      "Cannot read data directory \"" + m_data_dir.value() + "\"",
+      Mysql::Tools::Base::Message_type_error));
+    return true;
+  }
+
+  for (uint i= 0; i < directory->number_off_files; ++i)
+  {
+    const FILEINFO& file= directory->dir_entry[i];
+    std::string schema;
+    std::string table;
+    if (!MY_S_ISREG(file.mystat->st_mode)
+      || !parse_data_file_name(file.name, &schema, &table))
+    {
+      continue;
+    }
+    m_table_data_sizes[get_quoted_table_name(schema,
+      table)]+= file.mystat->st_size;
+    if (m_checkpoint.is_data_file_done(file.name))
+      continue;
+    jobs->push_back(new Data_file_loader(m_data_dir.value(), file.name,
+      schema, table, file.mystat->st_size, m_load_batch_size,
+      &m_checkpoint));
+  }
+  my_dirend(directory);
+  return false;
+}
+
+void Program::worker()
+{
+  mysql_thread_init();
+  Mysql::Tools::Base::Mysql_query_runner* runner= this->create_runner();
+
+  bool failed= runner == NULL;
+  for (std::vector<std::string>::iterator it= m_session_statements.begin();
+    !failed && it != m_session_statements.end(); ++it)
+  {
+    failed= runner->run_query(*it) != 0;
+  }
+  /* mysqlpump reads all rows with UTC session time zone. */
+  failed= failed || runner->run_query("SET TIME_ZONE='+00:00'") != 0;
+
+  while (!failed && m_error_code.load() == 0)
+  {
+    I_restore_job* job;
+    {
+      my_boost::mutex::scoped_lock lock(m_jobs_mutex);
+      if (m_next_job == m_jobs->size())
+        break;
+      job= (*m_jobs)[m_next_job++];
+    }
+    failed= job->run(runner);
+  }
+  if (failed && m_error_code.load() == 0)
+    m_error_code.store(1);
+
+  delete runner;
+  mysql_thread_end();
+}
+
+void Program::run_jobs(std::vector<I_restore_job*>* jobs)
+{
+  std::stable_sort(jobs->begin(), jobs->end(), compare_job_size);
+  m_jobs= jobs;
+  m_next_job= 0;
+
+  my_boost::thread_group threads;
+  uint32 thread_count= std::min<size_t>(m_parallelism, jobs->size());
+  for (uint32 i= 0; i < thread_count; ++i)
+    threads.create_thread(Worker_entry_point(this));
+  threads.join_all();
+
+  for (std::vector<I_restore_job*>::iterator it= jobs->begin();
+    it != jobs->end(); ++it)
+  {
+    delete *it;
+  }
+  jobs->clear();
+}
+
+int Program::execute(std::vector<std::string> positional_options)
+{
+  if (positional_options.size() != 1)
+  {
+    this->short_usage();
+    return 1;
+  }
+  const std::string& dump_file= positional_options[0];
+
+  std::string checkpoint_file= m_checkpoint_file.has_value()
+    ? m_checkpoint_file.value() : dump_file + ".checkpoint";
+  if (m_checkpoint.open(checkpoint_file))
+  {
+    this->error(Mysql::Tools::Base::Message_data(errno,
+      "Cannot open checkpoint file \"" + checkpoint_file + "\"",
+      Mysql::Tools::Base::Message_type_error));
+    return get_error_code();
+  }
+
+  this->set_local_infile(m_data_dir.has_value());
+  Mysql::Tools::Base::Mysql_query_runner* runner= this->create_runner();
+  if (runner == NULL || this->restore_schema(runner, dump_file))
+  {
+    delete runner;
+    return get_error_code() ? get_error_code() : 1;
+  }
+
+  /*
+    Progress left on server by another restore is dropped when data load
+    of this one starts.
+   */
+  std::vector<I_restore_job*> jobs;
+  if (m_data_dir.has_value())
+  {
+    bool started= m_checkpoint.is_data_load_started();
+    if (Data_file_loader::create_progress_table(runner, !started)
+      || (!started && m_checkpoint.data_load_started()))
+    {
+      delete runner;
+      return get_error_code() ? get_error_code() : 1;
+    }
+    if (!this->find_data_files(&jobs))
+      this->run_jobs(&jobs);
+  }
+
+  if (get_error_code() == 0)
+  {
+    uint64 number= 0;
+    for (std::vector<Deferred_indexes>::iterator it=
+      m_deferred_indexes.begin(); it != m_deferred_indexes.end();
+      ++it, ++number)
+    {
+      if (m_checkpoint.is_post_statement_done(number))
+        continue;
+      std::string statement= "ALTER TABLE " + it->m_table;
+      for (std::vector<std::string>::iterator index=
+        it->m_index_definitions.begin();
+        index != it->m_index_definitions.end(); ++index)
+      {
+        statement+= (index == it->m_index_definitions.begin() ? " ADD " :
+          ", ADD ") + *index;
+      }
+      jobs.push_back(new Sql_statement_job(number, it->m_database,
+        statement, m_table_data_sizes[it->m_table], &m_checkpoint));
+    }
+    this->run_jobs(&jobs);
+
+    /* Triggers are created after data is loaded, so they do not fire. */
+    for (std::vector<std::pair<std::string, std::string> >::iterator it=
+      m_triggers.begin(); it != m_triggers.end() && get_error_code() == 0;
+      ++it, ++number)
+    {
+      if (m_checkpoint.is_post_statement_done(number))
+        continue;
+      Sql_statement_job job(number, it->first, it->second, 0, &m_checkpoint);
+      if (job.run(runner) && get_error_code() == 0)
+        m_error_code.store(1);
+    }
+  }
+
+  if (get_error_code() == 0 && m_data_dir.has_value()
+    && Data_file_loader::drop_progress_table(runner))
+  {
+    m_error_code.store(1);
+  }
+  delete runner;
+  if (get_error_code() == 0)
+    std::cerr << "Restore completed." << std::endl;
+  return get_error_code();
+}
+
+void Program::create_options()
+{
+  this->create_new_option(&m_data_dir, "data-dir",
+    "Directory with table data files written by mysqlpump "
+    "--chunk-output-dir. Files are loaded with LOAD DATA LOCAL INFILE, "
+    "which has to be enabled on server. Loaded part of every file is "
+    "recorded in table mysql.mysqlrestore_progress, in the transaction of "
+    "each batch, and the table is dropped when restore completes.");
+  this->create_new_option(&m_parallelism, "parallelism",
+    "Number of connections used to load data and to add deferred indexes.")
+    ->set_minimum_value(1)
+    ->set_value(4);
+  this->create_new_option(&m_checkpoint_file, "checkpoint-file",
+    "File to record progress of restore in, restore is resumed from it when "
+    "it exists. Defaults to name of dump file with \".checkpoint\" "
+    "appended.");
+  this->create_new_option(&m_load_batch_size, "load-batch-size",
+    "Approximate number of bytes of data file loaded in one transaction.")
+    ->set_minimum_value(1024)
+    ->set_value(64 * 1024 * 1024);
+}
+
+int Program::get_error_code()
+{
+  return m_error_code.load();
+}
+
+std::string Program::get_description()
+{
+  return "MySQL utility for restoring dumps written by mysqlpump.";
+}
+
+int Program::get_first_release_year()
+{
+  return 2024;
+}
+
+std::string Program::get_version()
+{
+  return "1.0.0";
+}
+
+void Program::short_usage()
+{
+  std::cout << "Usage: " << get_name() << " [OPTIONS] dump_file"
+    << std::endl;
+}
+
+Program::Worker_entry_point::Worker_entry_point(Program* program)
+  : m_program(program)
+{}
+
+void Program::Worker_entry_point::operator()()
+{
+  m_program->worker();
+}
+
+Program::Program()
+  : Abstract_connection_program(),
+  m_jobs(NULL),
+  m_next_job(0),
+  m_error_code(0)
+{}
+
+const char *load_default_groups[]=
+{
+  "client", /* Read settings how to connect to server. */
+  /* Read config options from mysqlrestore section. */
+  "mysqlrestore",
+  0
+};
+
+static Program program;
+
+int main(int argc, char **argv)
+{
+  ::program.run(argc, argv);
+  return 0;
+}
@@ -0,0 +1,130 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef PROGRAM_INCLUDED
+#define PROGRAM_INCLUDED
+
+#include "base/abstract_connection_program.h"
+#include "base/atomic.h"
+#include "base/mutex.h"
+#include "i_restore_job.h"
+#include "restore_checkpoint.h"
+#include "nullable.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Restores dump written by mysqlpump. Schema part of dump script is executed
+  serially, table data files written with --chunk-output-dir are loaded in
+  parallel with LOAD DATA LOCAL INFILE, and then deferred indexes are added
+  in parallel and triggers are created. Progress is kept in checkpoint file,
+  and that of data files in a table on server, so that interrupted restore
+  continues where it stopped.
+ */
+class Program : public Mysql::Tools::Base::Abstract_connection_program
+{
+public:
+  Program();
+
+  std::string get_version();
+
+  int get_first_release_year();
+
+  std::string get_description();
+
+  int execute(std::vector<std::string> positional_options);
+
+  void create_options();
+
+  void error(const Mysql::Tools::Base::Message_data& message);
+
+  void short_usage();
+
+  int get_error_code();
+
+private:
+  /**
+    Runs jobs on --parallelism connections, largest jobs first.
+   */
+  void run_jobs(std::vector<I_restore_job*>* jobs);
+
+  /**
+    Takes jobs from queue and runs them until queue is empty or error occurs.
+   */
+  void worker();
+
+  Mysql::Tools::Base::Mysql_query_runner* create_runner();
+
+  int64 message_handler(const Mysql::Tools::Base::Message_data& message);
+
+  /**
+    Executes schema statements of dump script, collecting statements to run
+    after data is loaded. Returns true on error.
+   */
+  bool restore_schema(Mysql::Tools::Base::Mysql_query_runner* runner,
+    const std::string& dump_file);
+
+  /**
+    Adds one data load job for each data file not loaded yet.
+    Returns true on error.
+   */
+  bool find_data_files(std::vector<I_restore_job*>* jobs);
+
+  class Worker_entry_point
+  {
+  public:
+    Worker_entry_point(Program* program);
+    void operator()();
+  private:
+    Program* m_program;
+  };
+
+  struct Deferred_indexes
+  {
+    std::string m_database;
+    std::string m_table;
+    std::vector<std::string> m_index_definitions;
+  };
+
+  Mysql::Nullable<std::string> m_data_dir;
+  Mysql::Nullable<std::string> m_checkpoint_file;
+  uint32 m_parallelism;
+  uint64 m_load_batch_size;
+
+  Restore_checkpoint m_checkpoint;
+  /* Session settings of dump script, executed on every worker connection. */
+  std::vector<std::string> m_session_statements;
+  std::vector<Deferred_indexes> m_deferred_indexes;
+  std::vector<std::pair<std::string, std::string> > m_triggers;
+  /* Bytes of data files of each table, for ordering of index jobs. */
+  std::map<std::string, uint64> m_table_data_sizes;
+
+  my_boost::mutex m_jobs_mutex;
+  std::vector<I_restore_job*>* m_jobs;
+  size_t m_next_job;
+  my_boost::atomic_uint32_t m_error_code;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "restore_checkpoint.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace Mysql::Tools::Restore;
+
+bool Restore_checkpoint::open(const std::string& file_name)
+{
+  FILE* existing= fopen(file_name.c_str(), "r");
+  if (existing != NULL)
+  {
+    char line[FN_REFLEN + 64];
+    while (fgets(line, sizeof(line), existing) != NULL)
+    {
+      /* Line which was not finished when restore was killed is ignored. */
+      size_t length= strlen(line);
+      if (length == 0 || line[length - 1] != '\n')
+        break;
+      line[length - 1]= 0;
+
+      char* value= strchr(line, ' ');
+      if (value == NULL)
+        continue;
+      *value++= 0;
+      if (strcmp(line, "schema") == 0)
+        m_schema_statements_done= strtoull(value, NULL, 10);
+      else if (strcmp(line, "post") == 0)
+        m_post_statements_done.insert(strtoull(value, NULL, 10));
+      else if (strcmp(line, "done") == 0)
+        m_data_files_done.insert(value);
+      else if (strcmp(line, "load") == 0)
+        m_data_load_started= true;
+    }
+    fclose(existing);
+  }
+  m_file= fopen(file_name.c_str(), "a");
+  return m_file == NULL;
+}
+
+bool Restore_checkpoint::append(const std::string& line)
+{
+  my_boost::mutex::scoped_lock lock(m_mutex);
+  return fputs((line + "\n").c_str(), m_file) < 0
+    || fflush(m_file) != 0
+    || fsync(fileno(m_file)) != 0;
+}
+
+uint64 Restore_checkpoint::get_schema_statements_done() const
+{
+  return m_schema_statements_done;
+}
+
+bool Restore_checkpoint::is_data_load_started() const
+{
+  return m_data_load_started;
+}
+
+bool Restore_checkpoint::is_data_file_done(const std::string& data_file) const
+{
+  return m_data_files_done.count(data_file) != 0;
+}
+
+bool Restore_checkpoint::is_post_statement_done(uint64 statement) const
+{
+  return m_post_statements_done.count(statement) != 0;
+}
+
+bool Restore_checkpoint::schema_statement_done(uint64 statement)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "schema %llu",
+    (unsigned long long)statement + 1);
+  return this->append(buffer);
+}
+
+bool Restore_checkpoint::data_load_started()
+{
+  return this->append("load started");
+}
+
+bool Restore_checkpoint::data_file_done(const std::string& data_file)
+{
+  return this->append("done " + data_file);
+}
+
+bool Restore_checkpoint::post_statement_done(uint64 statement)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "post %llu",
+    (unsigned long long)statement);
+  return this->append(buffer);
+}
+
+Restore_checkpoint::~Restore_checkpoint()
+{
+  if (m_file != NULL)
+    fclose(m_file);
+}
+
+Restore_checkpoint::Restore_checkpoint()
+  : m_file(NULL),
+  m_schema_statements_done(0),
+  m_data_load_started(false)
+{}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef RESTORE_CHECKPOINT_INCLUDED
+#define RESTORE_CHECKPOINT_INCLUDED
+
+#include "my_global.h"
+#include "base/mutex.h"
+#include <stdio.h>
+#include <set>
+#include <string>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Progress of restore, kept in checkpoint file so that interrupted restore
+  can be resumed. Every completed step is appended to the file as one line
+  and synced to disk before the next step starts:
+    schema <number of schema statements executed>
+    load started
+    done <data file name>
+    post <number of statement executed after data load>
+  Progress of every data file is kept on server instead, see
+  Data_file_loader, the checkpoint only records when its data load starts.
+ */
+class Restore_checkpoint
+{
+public:
+  Restore_checkpoint();
+
+  ~Restore_checkpoint();
+
+  /**
+    Reads progress recorded in specified file, if it exists, and opens it
+    for appending. Returns true on error.
+   */
+  bool open(const std::string& file_name);
+
+  uint64 get_schema_statements_done() const;
+
+  bool is_data_load_started() const;
+
+  bool is_data_file_done(const std::string& data_file) const;
+
+  bool is_post_statement_done(uint64 statement) const;
+
+  /**
+    Record completed steps, return true on error. Statements are counted
+    from 0, schema_statement_done() means all schema statements up to given
+    one are executed.
+   */
+  bool schema_statement_done(uint64 statement);
+  bool data_load_started();
+  bool data_file_done(const std::string& data_file);
+  bool post_statement_done(uint64 statement);
+
+private:
+  bool append(const std::string& line);
+
+  FILE* m_file;
+  my_boost::mutex m_mutex;
+  uint64 m_schema_statements_done;
+  bool m_data_load_started;
+  std::set<std::string> m_data_files_done;
+  std::set<uint64> m_post_statements_done;
+};
+
+}
+}
+}
+
+#endif
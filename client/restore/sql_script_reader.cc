@@ -0,0 +1,272 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "sql_script_reader.h"
+#include <ctype.h>
+#include <string.h>
+
+using namespace Mysql::Tools::Restore;
+
+/**
+  Returns upper cased bare words of statement, i.e. words outside of quoted
+  strings, identifiers and comment markers, up to given count.
+ */
+static std::vector<std::string> get_leading_words(const std::string& statement,
+  size_t count)
+{
+  std::vector<std::string> words;
+  std::string word;
+  char quote= 0;
+  for (size_t i= 0; i <= statement.size() && words.size() < count; ++i)
+  {
+    char c= i < statement.size() ? statement[i] : ' ';
+    if (quote != 0)
+    {
+      if (c == quote)
+        quote= 0;
+      continue;
+    }
+    if (c == '`' || c == '\'' || c == '"')
+      quote= c;
+    if (isalnum((uchar)c) || c == '_')
+    {
+      word+= (char)toupper((uchar)c);
+      continue;
+    }
+    /* Skip version number of executable comments. */
+    if (!word.empty() && !isdigit((uchar)word[0]))
+      words.push_back(word);
+    word.clear();
+  }
+  return words;
+}
+
+bool Sql_script_reader::is_use_statement(const std::string& statement,
+  std::string* database)
+{
+  if (statement.size() < 5 || strncasecmp(statement.c_str(), "USE ", 4) != 0)
+    return false;
+  *database= statement.substr(4);
+  return true;
+}
+
+bool Sql_script_reader::is_deferred_index_statement(
+  const std::string& statement, std::string* table,
+  std::string* index_definition)
+{
+  static const char prefix[]= "ALTER TABLE `";
+  if (strncmp(statement.c_str(), prefix, sizeof(prefix) - 2) != 0)
+    return false;
+
+  /* Table name is `schema`.`table`, with backticks doubled inside. */
+  size_t pos= sizeof(prefix) - 2;
+  for (int part= 0; part < 2; ++part)
+  {
+    if (pos >= statement.size() || statement[pos] != '`')
+      return false;
+    for (++pos; pos < statement.size(); ++pos)
+    {
+      if (statement[pos] == '`')
+      {
+        if (pos + 1 < statement.size() && statement[pos + 1] == '`')
+          ++pos;
+        else
+          break;
+      }
+    }
+    ++pos;
+    if (part == 0)
+    {
+      if (pos >= statement.size() || statement[pos] != '.')
+        return false;
+      ++pos;
+    }
+  }
+  if (statement.compare(pos, 5, " ADD ") != 0)
+    return false;
+  *table= statement.substr(sizeof(prefix) - 2, pos - (sizeof(prefix) - 2));
+  *index_definition= statement.substr(pos + 5);
+  return true;
+}
+
+bool Sql_script_reader::is_create_trigger_statement(
+  const std::string& statement)
+{
+  /*
+    CREATE [DEFINER=user] TRIGGER, with DEFINER user name being at most
+    two more words.
+   */
+  std::vector<std::string> words= get_leading_words(statement, 5);
+  if (words.empty() || words[0] != "CREATE")
+    return false;
+  for (size_t i= 1; i < words.size(); ++i)
+  {
+    if (words[i] == "TRIGGER")
+      return true;
+  }
+  return false;
+}
+
+int Sql_script_reader::next_char()
+{
+  int c= this->peek_char();
+  if (c >= 0)
+    ++m_buffer_pos;
+  return c;
+}
+
+int Sql_script_reader::peek_char()
+{
+  if (m_buffer_pos == m_buffer_end && !this->fill_buffer(1))
+    return -1;
+  return (uchar)m_buffer[m_buffer_pos];
+}
+
+bool Sql_script_reader::fill_buffer(size_t needed)
+{
+  if (m_buffer_end - m_buffer_pos >= needed)
+    return true;
+  memmove(&m_buffer[0], &m_buffer[m_buffer_pos], m_buffer_end - m_buffer_pos);
+  m_buffer_end-= m_buffer_pos;
+  m_buffer_pos= 0;
+  while (m_buffer_end < needed)
+  {
+    int64 bytes= m_input->read(&m_buffer[m_buffer_end],
+      m_buffer.size() - m_buffer_end);
+    if (bytes <= 0)
+    {
+      m_error|= (bytes < 0);
+      return false;
+    }
+    m_buffer_end+= (size_t)bytes;
+  }
+  return true;
+}
+
+bool Sql_script_reader::starts_with_ci(const char* prefix)
+{
+  size_t length= strlen(prefix);
+  return this->fill_buffer(length)
+    && strncasecmp(&m_buffer[m_buffer_pos], prefix, length) == 0;
+}
+
+bool Sql_script_reader::read_statement(std::string* statement)
+{
+  statement->clear();
+  char quote= 0;
+  bool in_comment= false;
+  int c;
+  while ((c= this->next_char()) >= 0)
+  {
+    bool at_line_start= statement->empty()
+      || (*statement)[statement->size() - 1] == '\n';
+
+    if (quote != 0)
+    {
+      *statement+= (char)c;
+      if (c == '\\' && quote != '`')
+      {
+        if ((c= this->next_char()) < 0)
+          break;
+        *statement+= (char)c;
+      }
+      else if (c == quote)
+        quote= 0;
+      continue;
+    }
+    if (in_comment)
+    {
+      *statement+= (char)c;
+      if (c == '*' && this->peek_char() == '/')
+      {
+        *statement+= (char)this->next_char();
+        in_comment= false;
+      }
+      continue;
+    }
+
+    /* Whitespace between statements is dropped. */
+    if (statement->empty() && isspace(c))
+      continue;
+
+    if (at_line_start
+      && (c == '#' || (c == '-' && this->starts_with_ci("- "))))
+    {
+      while ((c= this->next_char()) >= 0 && c != '\n')
+      {}
+      if (!statement->empty())
+        *statement+= '\n';
+      continue;
+    }
+
+    /* DELIMITER command takes the rest of line. */
+    if (statement->empty() && (c == 'D' || c == 'd')
+      && this->starts_with_ci("ELIMITER "))
+    {
+      std::string delimiter;
+      while (this->peek_char() >= 0 && this->peek_char() != '\n')
+        delimiter+= (char)this->next_char();
+      delimiter.erase(0, delimiter.find_first_not_of(" \t", 8));
+      delimiter.erase(delimiter.find_last_not_of(" \t\r") + 1);
+      if (!delimiter.empty())
+        m_delimiter= delimiter;
+      continue;
+    }
+
+    *statement+= (char)c;
+    if (c == '\'' || c == '"' || c == '`')
+      quote= (char)c;
+    else if (c == '/' && this->peek_char() == '*')
+    {
+      *statement+= (char)this->next_char();
+      in_comment= true;
+    }
+    else if (statement->size() >= m_delimiter.size()
+      && statement->compare(statement->size() - m_delimiter.size(),
+      m_delimiter.size(), m_delimiter) == 0)
+    {
+      statement->erase(statement->size() - m_delimiter.size());
+      while (!statement->empty()
+        && isspace((uchar)(*statement)[statement->size() - 1]))
+      {
+        statement->erase(statement->size() - 1);
+      }
+      if (!statement->empty())
+        return true;
+    }
+  }
+  /* Last statement may have no delimiter. */
+  while (!statement->empty()
+    && isspace((uchar)(*statement)[statement->size() - 1]))
+  {
+    statement->erase(statement->size() - 1);
+  }
+  return !m_error && !statement->empty();
+}
+
+bool Sql_script_reader::has_error() const
+{
+  return m_error;
+}
+
+Sql_script_reader::Sql_script_reader(Compressed_file_reader* input)
+  : m_input(input),
+  m_buffer(64 * 1024),
+  m_buffer_pos(0),
+  m_buffer_end(0),
+  m_error(false),
+  m_delimiter(";")
+{}
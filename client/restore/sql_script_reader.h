@@ -0,0 +1,99 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef SQL_SCRIPT_READER_INCLUDED
+#define SQL_SCRIPT_READER_INCLUDED
+
+#include "compressed_file_reader.h"
+#include <string>
+#include <vector>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Splits SQL script written by mysqlpump into single statements. Handles
+  DELIMITER commands, quoted strings and identifiers, and comments the same
+  way as mysql client does: "--" and "#" comments are removed, other
+  comments are kept as they can be executable.
+ */
+class Sql_script_reader
+{
+public:
+  Sql_script_reader(Compressed_file_reader* input);
+
+  /**
+    Reads next statement, without delimiter. Returns false at the end of
+    script or on error, which is then set in has_error().
+   */
+  bool read_statement(std::string* statement);
+
+  bool has_error() const;
+
+  /**
+    Returns true if statement is USE, and sets name of database as written
+    in statement.
+   */
+  static bool is_use_statement(const std::string& statement,
+    std::string* database);
+
+  /**
+    Returns true if statement is deferred index creation statement
+    "ALTER TABLE <table> ADD <index>" written by mysqlpump
+    --defer-table-indexes, and sets both its parts.
+   */
+  static bool is_deferred_index_statement(const std::string& statement,
+    std::string* table, std::string* index_definition);
+
+  /**
+    Returns true if statement creates trigger.
+   */
+  static bool is_create_trigger_statement(const std::string& statement);
+
+private:
+  /**
+    Returns next character of script, or -1 at the end of script.
+   */
+  int next_char();
+
+  int peek_char();
+
+  /**
+    Makes sure at least needed bytes are buffered, returns false if script
+    ends before.
+   */
+  bool fill_buffer(size_t needed);
+
+  /**
+    Returns true if unread part of script starts with prefix, case
+    insensitively.
+   */
+  bool starts_with_ci(const char* prefix);
+
+  Compressed_file_reader* m_input;
+  std::vector<char> m_buffer;
+  size_t m_buffer_pos;
+  size_t m_buffer_end;
+  bool m_error;
+  std::string m_delimiter;
+};
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,42 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "sql_statement_job.h"
+
+using namespace Mysql::Tools::Restore;
+
+bool Sql_statement_job::run(Mysql::Tools::Base::Mysql_query_runner* runner)
+{
+  if (!m_database.empty() && runner->run_query("USE " + m_database) != 0)
+    return true;
+  return runner->run_query(m_statement) != 0
+    || m_checkpoint->post_statement_done(m_number);
+}
+
+uint64 Sql_statement_job::get_size() const
+{
+  return m_size;
+}
+
+Sql_statement_job::Sql_statement_job(uint64 number,
+  const std::string& database, const std::string& statement, uint64 size,
+  Restore_checkpoint* checkpoint)
+  : m_number(number),
+  m_database(database),
+  m_statement(statement),
+  m_size(size),
+  m_checkpoint(checkpoint)
+{}
@@ -0,0 +1,55 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef SQL_STATEMENT_JOB_INCLUDED
+#define SQL_STATEMENT_JOB_INCLUDED
+
+#include "i_restore_job.h"
+#include "restore_checkpoint.h"
+#include <string>
+
+namespace Mysql{
+namespace Tools{
+namespace Restore{
+
+/**
+  Runs single statement deferred until after the data load, like creation
+  of secondary indexes of one table, in given default database.
+ */
+class Sql_statement_job : public I_restore_job
+{
+public:
+  Sql_statement_job(uint64 number, const std::string& database,
+    const std::string& statement, uint64 size,
+    Restore_checkpoint* checkpoint);
+
+  bool run(Mysql::Tools::Base::Mysql_query_runner* runner);
+
+  uint64 get_size() const;
+
+private:
+  uint64 m_number;
+  std::string m_database;
+  std::string m_statement;
+  uint64 m_size;
+  Restore_checkpoint* m_checkpoint;
+};
+
+}
+}
+}
+
+#endif
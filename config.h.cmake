@@ -86,6 +86,7 @@
 #cmakedefine HAVE_DIRECTIO 1
 #cmakedefine HAVE_FTRUNCATE 1
 #cmakedefine HAVE_COMPRESS 1
+#cmakedefine HAVE_ZSTD 1
 #cmakedefine HAVE_CRYPT 1
 #cmakedefine HAVE_DLOPEN 1
 #cmakedefine HAVE_FCHMOD 1
@@ -125,6 +126,7 @@
 #cmakedefine HAVE_PTHREAD_SIGMASK 1
 #cmakedefine HAVE_READLINK 1
 #cmakedefine HAVE_REALPATH 1
+#cmakedefine HAVE_SCHED_GETCPU 1
 #cmakedefine HAVE_SETFD 1
 #cmakedefine HAVE_SIGACTION 1
 #cmakedefine HAVE_SLEEP 1
@@ -470,6 +472,9 @@
 #cmakedefine DEFAULT_SECURE_FILE_PRIV_EMBEDDED_DIR @DEFAULT_SECURE_FILE_PRIV_EMBEDDED_DIR@
 #cmakedefine HAVE_LIBNUMA 1
 
+/* io_uring for the thread pool */
+#cmakedefine HAVE_LIBURING 1
+
 /* For default value of --early_plugin_load */
 #cmakedefine DEFAULT_EARLY_PLUGIN_LOAD @DEFAULT_EARLY_PLUGIN_LOAD@
 
@@ -322,6 +322,7 @@ CHECK_FUNCTION_EXISTS (pthread_condattr_setclock HAVE_PTHREAD_CONDATTR_SETCLOCK)
 CHECK_FUNCTION_EXISTS (pthread_sigmask HAVE_PTHREAD_SIGMASK)
 CHECK_FUNCTION_EXISTS (readlink HAVE_READLINK)
 CHECK_FUNCTION_EXISTS (realpath HAVE_REALPATH)
+CHECK_FUNCTION_EXISTS (sched_getcpu HAVE_SCHED_GETCPU)
 CHECK_FUNCTION_EXISTS (setfd HAVE_SETFD)
 CHECK_FUNCTION_EXISTS (sigaction HAVE_SIGACTION)
 CHECK_FUNCTION_EXISTS (sleep HAVE_SLEEP)
@@ -809,6 +810,30 @@ IF(HAVE_LIBNUMA AND NOT WITH_NUMA)
    MESSAGE(STATUS "Disabling NUMA on user's request")
 ENDIF()
 
+IF(CMAKE_SYSTEM_NAME MATCHES "Linux")
+  OPTION(WITH_LIBURING "Use io_uring in the thread pool if available" ON)
+  IF(WITH_LIBURING)
+    CHECK_INCLUDE_FILES(liburing.h HAVE_LIBURING_H)
+    IF(HAVE_LIBURING_H)
+      CHECK_LIBRARY_EXISTS(uring io_uring_queue_init "" HAVE_LIBURING)
+    ENDIF()
+  ENDIF()
+  IF(NOT HAVE_LIBURING)
+    MESSAGE(STATUS "liburing missing, thread pool will use epoll only")
+  ENDIF()
+ENDIF()
+
+OPTION(WITH_ZSTD "Offer zstd for the compressed client/server protocol" ON)
+IF(WITH_ZSTD)
+  CHECK_INCLUDE_FILES(zstd.h HAVE_ZSTD_H)
+  IF(HAVE_ZSTD_H)
+    CHECK_LIBRARY_EXISTS(zstd ZSTD_compressCCtx "" HAVE_ZSTD)
+  ENDIF()
+ENDIF()
+IF(NOT HAVE_ZSTD)
+  MESSAGE(STATUS "libzstd missing, protocol compression will use zlib only")
+ENDIF()
+
 # needed for libevent
 CHECK_TYPE_SIZE("socklen_t" SIZEOF_SOCKLEN_T)
 IF(SIZEOF_SOCKLEN_T)
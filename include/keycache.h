@@ -51,6 +51,7 @@ typedef struct st_keycache_wqueue
 } KEYCACHE_WQUEUE;
 
 #define CHANGED_BLOCKS_HASH 128             /* must be power of 2 */
+#define MAX_KEY_CACHE_PARTITIONS 64
 
 /*
   The key cache structure
@@ -97,6 +98,10 @@ typedef struct st_key_cache
   KEYCACHE_WQUEUE waiting_for_block;    /* requests waiting for a free block */
   BLOCK_LINK *changed_blocks[CHANGED_BLOCKS_HASH]; /* hash for dirty file bl.*/
   BLOCK_LINK *file_blocks[CHANGED_BLOCKS_HASH];    /* hash for other file bl.*/
+  uint partitions;               /* number of partitions, 0 if not partitioned*/
+  struct st_key_cache *partition_array; /* the partitions, each a key cache */
+  volatile int32 partition_requests; /* partitioned requests in progress   */
+  volatile int32 partition_resizing; /* partitioned resize in progress     */
 
   /*
     The following variables are and variables used to hold parameters for
@@ -107,8 +112,12 @@ typedef struct st_key_cache
   ulonglong param_block_size;     /* size of the blocks in the key cache      */
   ulonglong param_division_limit; /* min. percentage of warm blocks           */
   ulonglong param_age_threshold;  /* determines when hot block is downgraded  */
+  ulonglong param_partitions;     /* number of partitions, 0 or 1 for none    */
 
-  /* Statistics variables. These are reset in reset_key_cache_counters(). */
+  /*
+    Statistics variables. These are reset in reset_key_cache_counters().
+    For a partitioned key cache they are summed by update_key_cache_stats().
+  */
   ulong global_blocks_changed;	/* number of currently dirty blocks         */
   ulonglong global_cache_w_requests;/* number of write requests (write hits) */
   ulonglong global_cache_write;     /* number of writes from cache to files  */
@@ -148,6 +157,7 @@ extern int flush_key_blocks(KEY_CACHE *keycache,
                             st_keycache_thread_var *thread_var,
                             int file, enum flush_type type);
 extern void end_key_cache(KEY_CACHE *keycache, my_bool cleanup);
+extern void update_key_cache_stats(KEY_CACHE *keycache);
 
 /* Functions to handle multiple key caches */
 extern my_bool multi_keycache_init(void);
@@ -59,6 +59,15 @@ int lf_dynarray_iterate(LF_DYNARRAY *array, lf_dynarray_func func, void *arg);
 #define LF_PINBOX_PINS 4
 #define LF_PURGATORY_SIZE 10
 
+/*
+  Epoch based reclamation, see lf_alloc-pin.c.
+  Freed objects are collected in batches of LF_EPOCH_BATCH_SIZE,
+  every LF_PINS keeps up to LF_EPOCH_SEALED batches waiting for
+  the global epoch to move on.
+*/
+#define LF_EPOCH_BATCH_SIZE 64
+#define LF_EPOCH_SEALED 2
+
 typedef void lf_pinbox_free_func(void *, void *, void*);
 
 typedef struct {
@@ -66,19 +75,36 @@ typedef struct {
   lf_pinbox_free_func *free_func;
   void *free_func_arg;
   uint free_ptr_offset;
+  my_bool epoch_mode;                       /* epoch based reclamation */
   uint64 volatile pinstack_top_ver;         /* this is a versioned pointer */
   uint64 volatile pins_in_array;            /* number of elements in array */
+  uint64 volatile global_epoch;             /* epoch mode only */
+  void * volatile orphans;                  /* batches of released LF_PINS */
 } LF_PINBOX;
 
+/*
+  LF_PINS takes two cache lines. The first one is read by threads
+  scanning pins or epochs to free memory, the second one is private
+  to the owner, so that filling the purgatory does not invalidate
+  the line other threads scan.
+*/
 typedef struct st_lf_pins {
   void * volatile pin[LF_PINBOX_PINS];
+  uint64 volatile epoch;      /* epoch mode: epoch entered, 0 if none */
+  uint32 epoch_depth;         /* epoch mode: nesting of lf_epoch_enter() */
+  my_bool epoch_mode;         /* copy of LF_PINBOX::epoch_mode */
+  char pad1[64-sizeof(uint64)-sizeof(uint32)-sizeof(my_bool)-
+            sizeof(void*)*LF_PINBOX_PINS];
   LF_PINBOX *pinbox;
   void  *purgatory;
   uint64 purgatory_count;
   uint64 volatile link;
-/* we want sizeof(LF_PINS) to be 64 to avoid false sharing */
-#if 2*8+SIZEOF_CHARP*(LF_PINBOX_PINS+2) != 64
-  char pad[64-sizeof(uint64)*2-sizeof(void*)*(LF_PINBOX_PINS+2)];
+  void  *sealed[LF_EPOCH_SEALED];          /* epoch mode: full batches */
+  uint64 sealed_epoch[LF_EPOCH_SEALED];    /* epoch mode: when sealed */
+/* we want sizeof(LF_PINS) to be 128 to avoid false sharing */
+#if 8*(2+LF_EPOCH_SEALED)+SIZEOF_CHARP*(2+LF_EPOCH_SEALED) != 64
+  char pad2[64-sizeof(uint64)*(2+LF_EPOCH_SEALED)-
+            sizeof(void*)*(2+LF_EPOCH_SEALED)];
 #endif
 } LF_PINS;
 
@@ -96,12 +122,17 @@ typedef struct st_lf_pins {
 #define LF_REQUIRE_PINS(N)
 #endif
 
+/*
+  In epoch mode objects are protected by the epoch entered by
+  lf_epoch_enter(), and pins are not needed.
+*/
 static inline void lf_pin(LF_PINS *pins, int pin, void *addr)
 {
 #if defined(__GNUC__) && defined(MY_LF_EXTRA_DEBUG)
   assert(pin < LF_NUM_PINS_IN_THIS_FILE);
 #endif
-  my_atomic_storeptr(&pins->pin[pin], addr);
+  if (!pins->epoch_mode)
+    my_atomic_storeptr(&pins->pin[pin], addr);
 }
 
 static inline void lf_unpin(LF_PINS *pins, int pin)
@@ -109,11 +140,32 @@ static inline void lf_unpin(LF_PINS *pins, int pin)
 #if defined(__GNUC__) && defined(MY_LF_EXTRA_DEBUG)
   assert(pin < LF_NUM_PINS_IN_THIS_FILE);
 #endif
-  my_atomic_storeptr(&pins->pin[pin], NULL);
+  if (!pins->epoch_mode)
+    my_atomic_storeptr(&pins->pin[pin], NULL);
+}
+
+/*
+  Enter the current epoch. Objects freed by other threads after this
+  call are not reused until the matching lf_epoch_exit().
+  Calls can be nested. No-op unless the pinbox is in epoch mode.
+*/
+static inline void lf_epoch_enter(LF_PINS *pins)
+{
+  if (pins->epoch_mode && pins->epoch_depth++ == 0)
+    my_atomic_store64((int64 volatile*) &pins->epoch,
+                      my_atomic_load64((int64 volatile*)
+                                       &pins->pinbox->global_epoch));
+}
+
+static inline void lf_epoch_exit(LF_PINS *pins)
+{
+  if (pins->epoch_mode && pins->epoch_depth && --pins->epoch_depth == 0)
+    my_atomic_store64((int64 volatile*) &pins->epoch, 0);
 }
 
 void lf_pinbox_init(LF_PINBOX *pinbox, uint free_ptr_offset,
                     lf_pinbox_free_func *free_func, void * free_func_arg);
+void lf_pinbox_set_epoch_mode(LF_PINBOX *pinbox);
 void lf_pinbox_destroy(LF_PINBOX *pinbox);
 LF_PINS *lf_pinbox_get_pins(LF_PINBOX *pinbox);
 void lf_pinbox_put_pins(LF_PINS *pins);
@@ -154,6 +206,12 @@ typedef uint lf_hash_func(const struct st_lf_hash *, const uchar *, size_t);
 typedef void lf_hash_init_func(uchar *dst, const uchar* src);
 
 #define LF_HASH_UNIQUE 1
+/*
+  Use epoch based reclamation instead of pins. Cheaper per operation,
+  but an element found by lf_hash_search() and not yet released by
+  lf_hash_search_unpin() holds back the reuse of all deleted elements.
+*/
+#define LF_HASH_EPOCH  2
 
 /* lf_hash overhead per element (that is, sizeof(LF_SLIST) */
 extern MYSQL_PLUGIN_IMPORT const int LF_HASH_OVERHEAD;
@@ -207,6 +265,7 @@ static inline void lf_hash_put_pins(LF_PINS *pins)
 static inline void lf_hash_search_unpin(LF_PINS *pins)
 {
   lf_unpin(pins, 2);
+  lf_epoch_exit(pins);
 }
 
 typedef int lf_hash_match_func(const uchar *el);
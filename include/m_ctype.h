@@ -116,6 +116,12 @@ typedef struct my_uca_level_info_st
   uchar   *lengths;
   uint16  **weights;
   MY_CONTRACTIONS contractions;
+  /*
+    Weights of U+0000..U+007F for the UCA scanner fast path, or NULL.
+    Zero for characters that need the full scanner: ignorables,
+    expansions, contraction and previous context parts.
+  */
+  uint16  *ascii_weights;
 } MY_UCA_WEIGHT_LEVEL;
 
 
@@ -626,6 +632,7 @@ int my_wildcmp_mb(const CHARSET_INFO *,
 		  const char *str,const char *str_end,
 		  const char *wildstr,const char *wildend,
 		  int escape, int w_one, int w_many);
+size_t my_ascii_prefix_len(const uchar *s, const uchar *e);
 size_t my_numchars_mb(const CHARSET_INFO *, const char *b, const char *e);
 size_t my_numcells_mb(const CHARSET_INFO *, const char *b, const char *e);
 size_t my_charpos_mb(const CHARSET_INFO *, const char *b, const char *e,
@@ -78,6 +78,16 @@ typedef struct st_mem_root
   /* Enable this for error reporting if capacity is exceeded */
   my_bool error_for_capacity_exceeded;
 
+  /*
+    Upper bound on the bytes of blocks free_root(MY_KEEP_PREALLOC) keeps
+    for the next round of allocations instead of releasing them.
+    A value of 0 disables recycling.
+  */
+  size_t recycle_limit;
+
+  /* Decaying high-water mark of allocated_size, kept by free_root() */
+  size_t high_water;
+
   void (*error_handler)(void);
 
   PSI_memory_key m_psi_key;
@@ -211,8 +211,24 @@ extern void (*debug_sync_C_callback_ptr)(const char *, size_t);
 extern uint my_get_large_page_size(void);
 extern uchar * my_large_malloc(PSI_memory_key key, size_t size, myf my_flags);
 extern void my_large_free(uchar *ptr);
+extern void *my_large_mmap(size_t *size, my_bool populate);
+extern int my_large_munmap(void *ptr, size_t size);
 extern my_bool my_use_large_pages;
 extern uint    my_large_page_size;
+
+/* Memory policies of my_large_mmap(), see my_largepage.c */
+enum my_large_numa_policy
+{
+  MY_LARGE_NUMA_DEFAULT, MY_LARGE_NUMA_INTERLEAVE, MY_LARGE_NUMA_LOCAL
+};
+extern my_bool my_large_pages_thp;
+extern ulong   my_large_pages_numa;
+extern my_bool my_large_pages_prefault;
+
+/* Bytes currently mapped by my_large_mmap(), in total and per kind */
+extern ulonglong my_large_mmap_bytes;
+extern ulonglong my_large_mmap_hugetlb_bytes;
+extern ulonglong my_large_mmap_thp_bytes;
 #else
 #define my_get_large_page_size() (0)
 #define my_large_malloc(A,B,C) my_malloc((A),(B),(C))
@@ -344,6 +360,7 @@ typedef struct st_dynamic_string
 } DYNAMIC_STRING;
 
 struct st_io_cache;
+struct st_io_cache_aio;
 typedef int (*IO_CACHE_CALLBACK)(struct st_io_cache*);
 
 typedef struct st_io_cache_share
@@ -415,6 +432,13 @@ typedef struct st_io_cache		/* Used when cacheing files */
     READ_CACHE mode is supported.
   */
   IO_CACHE_SHARE *share;
+  /*
+    Read-ahead state of a READ_CACHE opened or reinitialized with
+    use_async_io. The next block of the file is read by a background
+    thread into a second buffer, while the caller consumes this one.
+    NULL if read-ahead is not used.
+  */
+  struct st_io_cache_aio *aio;
 
   /*
     A caller will use my_b_read() macro to read from the cache
@@ -908,10 +932,58 @@ extern void *memdup_root(MEM_ROOT *root,const void *str, size_t len);
 extern void set_memroot_max_capacity(MEM_ROOT *mem_root, size_t size);
 extern void set_memroot_error_reporting(MEM_ROOT *mem_root,
                                        my_bool report_error);
+extern void set_memroot_recycle_limit(MEM_ROOT *mem_root, size_t size);
+extern void my_root_pool_init(void);
+extern void my_root_pool_end(void);
+extern void my_root_pool_stats(ulonglong *hits, ulonglong *misses,
+                               ulonglong *bytes);
+extern ulong my_root_pool_size;
 extern my_bool my_compress(uchar *, size_t *, size_t *);
 extern my_bool my_uncompress(uchar *, size_t , size_t *);
 extern uchar *my_compress_alloc(const uchar *packet, size_t *len,
                                 size_t *complen);
+
+/* Compression algorithms of the client/server protocol */
+enum enum_compression_algorithm
+{
+  MYSQL_ZLIB,
+  MYSQL_ZSTD
+};
+
+#define MYSQL_ZSTD_MIN_LEVEL 1
+#define MYSQL_ZSTD_MAX_LEVEL 22
+#define MYSQL_ZSTD_DEFAULT_LEVEL 3
+
+/*
+  Packets sent uncompressed after one which barely compressed, and size
+  of the largest scratch buffer kept between packets.
+*/
+#define COMPRESS_BYPASS_PACKETS 16
+#define COMPRESS_KEEP_BUFFER_LENGTH (64 * 1024)
+
+/*
+  Per connection compression state, reused for every packet: library
+  contexts, a scratch buffer and the adaptive bypass of packets that
+  do not compress.
+*/
+typedef struct st_compress_context
+{
+  enum enum_compression_algorithm algorithm;
+  int level;
+  uint bypass;                                  /* Packets left to skip */
+  void *zstd_cctx;                              /* ZSTD_CCtx */
+  void *zstd_dctx;                              /* ZSTD_DCtx */
+  uchar *buffer;
+  size_t buffer_length;
+} COMPRESS_CONTEXT;
+
+extern COMPRESS_CONTEXT *
+my_compress_context_new(enum enum_compression_algorithm algorithm, int level);
+extern void my_compress_context_free(COMPRESS_CONTEXT *ctx);
+extern my_bool my_compress_ctx(COMPRESS_CONTEXT *ctx, uchar *packet,
+                               size_t *len, size_t *complen);
+extern my_bool my_uncompress_ctx(COMPRESS_CONTEXT *ctx, uchar *packet,
+                                 size_t len, size_t *complen);
 extern int packfrm(uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
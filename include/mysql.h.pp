@@ -83,7 +83,7 @@ typedef struct st_net {
   my_bool unused2;
   my_bool compress;
   my_bool unused3;
-  unsigned char *unused;
+  void *compress_ctx;
   unsigned int last_errno;
   unsigned char error;
   my_bool unused4;
@@ -305,6 +305,8 @@ typedef struct st_mem_root
   size_t max_capacity;
   size_t allocated_size;
   my_bool error_for_capacity_exceeded;
+  size_t recycle_limit;
+  size_t high_water;
   void (*error_handler)(void);
   PSI_memory_key m_psi_key;
 } MEM_ROOT;
@@ -366,7 +368,9 @@ enum mysql_option
   MYSQL_OPT_MAX_ALLOWED_PACKET, MYSQL_OPT_NET_BUFFER_LENGTH,
   MYSQL_OPT_TLS_VERSION,
   MYSQL_OPT_SSL_MODE,
-  MYSQL_OPT_GET_SERVER_PUBLIC_KEY
+  MYSQL_OPT_GET_SERVER_PUBLIC_KEY,
+  MYSQL_OPT_COMPRESSION_ALGORITHMS,
+  MYSQL_OPT_ZSTD_COMPRESSION_LEVEL
 };
 struct st_mysql_options_extention;
 struct st_mysql_options {
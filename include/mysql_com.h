@@ -220,6 +220,11 @@
 #define CLIENT_SESSION_TRACK (1UL << 23)
 /* Client no longer needs EOF packet */
 #define CLIENT_DEPRECATE_EOF (1UL << 24)
+/*
+  Compression protocol using zstd instead of zlib. The client sends its
+  compression level as one byte after the connection attributes.
+*/
+#define CLIENT_ZSTD_COMPRESSION_ALGORITHM (1UL << 26)
 
 #define CLIENT_SSL_VERIFY_SERVER_CERT (1UL << 30)
 #define CLIENT_REMEMBER_OPTIONS (1UL << 31)
@@ -230,6 +235,12 @@
 #define CAN_CLIENT_COMPRESS 0
 #endif
 
+#if defined(HAVE_COMPRESS) && defined(HAVE_ZSTD)
+#define CAN_CLIENT_ZSTD_COMPRESS CLIENT_ZSTD_COMPRESSION_ALGORITHM
+#else
+#define CAN_CLIENT_ZSTD_COMPRESS 0
+#endif
+
 /* Gather all possible capabilites (flags) supported by the server */
 #define CLIENT_ALL_FLAGS  (CLIENT_LONG_PASSWORD \
                            | CLIENT_FOUND_ROWS \
@@ -258,6 +269,7 @@
                            | CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS \
                            | CLIENT_SESSION_TRACK \
                            | CLIENT_DEPRECATE_EOF \
+                           | CLIENT_ZSTD_COMPRESSION_ALGORITHM \
 )
 
 /*
@@ -265,8 +277,9 @@
   If any of the optional flags is supported by the build it will be switched
   on before sending to the client during the connection handshake.
 */
-#define CLIENT_BASIC_FLAGS (((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
+#define CLIENT_BASIC_FLAGS ((((CLIENT_ALL_FLAGS & ~CLIENT_SSL) \
                                                & ~CLIENT_COMPRESS) \
+                                               & ~CLIENT_ZSTD_COMPRESSION_ALGORITHM) \
                                                & ~CLIENT_SSL_VERIFY_SERVER_CERT)
 
 /**
@@ -385,9 +398,10 @@ typedef struct st_net {
     queries in cache that have not stored its results yet
   */
   /*
-    Unused, please remove with the next incompatible ABI change.
+    Per connection compression state (COMPRESS_CONTEXT), NULL when
+    compress_packet()/my_net_read() should use the stateless zlib calls.
   */
-  unsigned char *unused;
+  void *compress_ctx;
   unsigned int last_errno;
   unsigned char error; 
   my_bool unused4; /* Please remove with the next incompatible ABI change. */
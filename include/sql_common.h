@@ -82,6 +82,10 @@ struct st_mysql_trace_info;
 typedef struct st_mysql_extension {
   struct st_mysql_trace_info *trace_data;
   struct st_session_track_info state_change;
+  /* SSL_SESSION of the last TLS connection, offered when reconnecting */
+  void *ssl_session;
+  /* Whether the server of the TLS connection is verified yet */
+  my_bool ssl_session_verified;
 } MYSQL_EXTENSION;
 
 /* "Constructor/destructor" for MYSQL extension structure. */
@@ -114,6 +118,8 @@ struct st_mysql_options_extention {
   char *tls_version; /* TLS version option */
   long ssl_ctx_flags; /* SSL ctx options flag */
   unsigned int ssl_mode;
+  char *compression_algorithms; /* e.g. "zstd,zlib" */
+  unsigned int zstd_compression_level;
 };
 
 typedef struct st_mysql_methods
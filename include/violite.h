@@ -155,6 +155,10 @@ my_bool vio_reset(Vio* vio, enum enum_vio_type type,
 size_t  vio_read(Vio *vio, uchar *	buf, size_t size);
 size_t  vio_read_buff(Vio *vio, uchar * buf, size_t size);
 size_t  vio_write(Vio *vio, const uchar * buf, size_t size);
+#ifndef _WIN32
+/* Gathering write, only provided by plain socket based transports */
+size_t  vio_writev(Vio *vio, const struct iovec *iov, int iovcnt);
+#endif
 /* setsockopt TCP_NODELAY at IPPROTO_TCP level, when possible */
 int vio_fastsend(Vio *vio);
 /* setsockopt SO_KEEPALIVE at SOL_SOCKET level, when possible */
@@ -230,6 +234,9 @@ struct st_VioSSLFd
 
 int sslaccept(struct st_VioSSLFd*, Vio *, long timeout, unsigned long *errptr);
 int sslconnect(struct st_VioSSLFd*, Vio *, long timeout, unsigned long *errptr);
+/* As sslconnect(), resuming the given session if the server allows it */
+int sslconnect_with_session(struct st_VioSSLFd*, Vio *, long timeout,
+                            SSL_SESSION *session, unsigned long *errptr);
 
 struct st_VioSSLFd
 *new_VioSSLConnectorFd(const char *key_file, const char *cert_file,
@@ -263,6 +270,7 @@ void vio_end(void);
 #define vio_errno(vio)                          (vio)->vioerrno(vio)
 #define vio_read(vio, buf, size)                ((vio)->read)(vio,buf,size)
 #define vio_write(vio, buf, size)               ((vio)->write)(vio, buf, size)
+#define vio_writev(vio, iov, iovcnt)            ((vio)->writev)(vio, iov, iovcnt)
 #define vio_fastsend(vio)                       (vio)->fastsend(vio)
 #define vio_keepalive(vio, set_keep_alive)  (vio)->viokeepalive(vio, set_keep_alive)
 #define vio_should_retry(vio)                   (vio)->should_retry(vio)
@@ -333,6 +341,10 @@ struct st_vio
   int     (*vioerrno)(Vio*);
   size_t  (*read)(Vio*, uchar *, size_t);
   size_t  (*write)(Vio*, const uchar *, size_t);
+#ifndef _WIN32
+  /* NULL if the transport can't do gathering writes */
+  size_t  (*writev)(Vio*, const struct iovec *, int);
+#endif
   int     (*timeout)(Vio*, uint, my_bool);
   int     (*viokeepalive)(Vio*, my_bool);
   int     (*fastsend)(Vio*);
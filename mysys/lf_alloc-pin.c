@@ -106,13 +106,46 @@
   as necessary, old are pushed in the stack for reuse. ABA is solved by
   versioning a pointer - because we use an array, a pointer to pins is 32 bit,
   upper 32 bits are used for a version.
+
+  Epoch based reclamation
+
+  A pinbox can instead work in epoch mode, see lf_pinbox_set_epoch_mode().
+  Then lf_pin() and lf_unpin() do nothing, and a thread protects all the
+  objects it reads by entering the global epoch (lf_epoch_enter()) for the
+  duration of an operation. Freed objects are collected in the purgatory as
+  usual; every LF_EPOCH_BATCH_SIZE free() the purgatory is sealed with the
+  current global epoch, and the global epoch is advanced if no thread is
+  still in an older one. A sealed batch is freed when the global epoch is
+  two steps ahead of it: by then every thread that could have seen its
+  objects has left its epoch.
+
+  This replaces scanning all pins against the purgatory every
+  LF_PURGATORY_SIZE free() with a scan of one word per thread every
+  LF_EPOCH_BATCH_SIZE free(), and removes the memory barriers of pinning
+  from list traversals. The price is that a thread staying in its epoch
+  holds back the reuse of all freed objects, not just the few it pinned.
+
+  lf_pinbox_put_pins() does not wait for the batches of a thread to become
+  free in epoch mode, it hands them over to the pinbox ("orphans"), where
+  other threads free them later.
 */
 #include "lf.h"
 #include "mysys_priv.h" /* key_memory_lf_node */
 
 #define LF_PINBOX_MAX_PINS (65536ULL*65536ULL)
 
+/* A batch of freed objects left by lf_pinbox_put_pins() in epoch mode */
+typedef struct st_lf_orphan {
+  struct st_lf_orphan *next;
+  void *first;
+  uint64 epoch;
+} LF_ORPHAN;
+
 static void lf_pinbox_real_free(LF_PINS *pins);
+static void lf_epoch_real_free(LF_PINS *pins);
+static void lf_epoch_put_pins(LF_PINS *pins);
+static void lf_epoch_free_orphans(LF_PINBOX *pinbox, uint64 global_epoch,
+                                  my_bool all);
 
 /*
   Initialize a pinbox. Normally called from lf_alloc_init.
@@ -122,17 +155,35 @@ void lf_pinbox_init(LF_PINBOX *pinbox, uint free_ptr_offset,
                     lf_pinbox_free_func *free_func, void *free_func_arg)
 {
   assert(free_ptr_offset % sizeof(void *) == 0);
-  compile_time_assert(sizeof(LF_PINS) == 64);
+  compile_time_assert(sizeof(LF_PINS) == 128);
   lf_dynarray_init(&pinbox->pinarray, sizeof(LF_PINS));
   pinbox->pinstack_top_ver= 0;
   pinbox->pins_in_array= 0;
   pinbox->free_ptr_offset= free_ptr_offset;
   pinbox->free_func= free_func;
   pinbox->free_func_arg= free_func_arg;
+  pinbox->epoch_mode= FALSE;
+  pinbox->global_epoch= 1;
+  pinbox->orphans= NULL;
+}
+
+/*
+  Switch a pinbox to epoch based reclamation.
+  Must be called before any pins are taken from the pinbox.
+*/
+void lf_pinbox_set_epoch_mode(LF_PINBOX *pinbox)
+{
+  assert(pinbox->pins_in_array == 0);
+  pinbox->epoch_mode= TRUE;
 }
 
+/*
+  Free what is left in the pinbox, and destroy it.
+  The caller guarantees that no other thread uses the pinbox.
+*/
 void lf_pinbox_destroy(LF_PINBOX *pinbox)
 {
+  lf_epoch_free_orphans(pinbox, 0, TRUE);
   lf_dynarray_destroy(&pinbox->pinarray);
 }
 
@@ -189,6 +240,8 @@ LF_PINS *lf_pinbox_get_pins(LF_PINBOX *pinbox)
   el->link= pins;
   el->purgatory_count= 0;
   el->pinbox= pinbox;
+  el->epoch_mode= pinbox->epoch_mode;
+  el->epoch_depth= 0;
   return el;
 }
 
@@ -220,6 +273,8 @@ void lf_pinbox_put_pins(LF_PINS *pins)
     and they would have pinned addresses that the caller wants to free.
     Thus: only free pins when all work is done and nobody can wait for you!!!
   */
+  if (pins->epoch_mode)
+    lf_epoch_put_pins(pins);
   while (pins->purgatory_count)
   {
     lf_pinbox_real_free(pins);
@@ -260,7 +315,12 @@ static inline void add_to_purgatory(LF_PINS *pins, void *addr)
 void lf_pinbox_free(LF_PINS *pins, void *addr)
 {
   add_to_purgatory(pins, addr);
-  if (pins->purgatory_count % LF_PURGATORY_SIZE == 0)
+  if (pins->epoch_mode)
+  {
+    if (pins->purgatory_count % LF_EPOCH_BATCH_SIZE == 0)
+      lf_epoch_real_free(pins);
+  }
+  else if (pins->purgatory_count % LF_PURGATORY_SIZE == 0)
     lf_pinbox_real_free(pins);
 }
 
@@ -339,6 +399,170 @@ static void lf_pinbox_real_free(LF_PINS *pins)
   }
 }
 
+/* Epoch based reclamation */
+
+/* Give a list of objects linked through the purgatory link to free_func */
+static void lf_epoch_free_list(LF_PINBOX *pinbox, void *first)
+{
+  void *last= first;
+  while (pnext_node(pinbox, last))
+    last= pnext_node(pinbox, last);
+  pinbox->free_func(first, last, pinbox->free_func_arg);
+}
+
+/*
+  Callback for lf_dynarray_iterate:
+  stop on a thread which is in an epoch other than the global one.
+*/
+static int check_epoch(LF_PINS *el, uint64 *global_epoch)
+{
+  LF_PINS *el_end= el + LF_DYNARRAY_LEVEL_LENGTH;
+  for (; el < el_end; el++)
+  {
+    uint64 epoch= my_atomic_load64((int64 volatile*) &el->epoch);
+    if (epoch && epoch != *global_epoch)
+      return 1;
+  }
+  return 0;
+}
+
+/*
+  Advance the global epoch if every thread is either outside
+  of any epoch or in the current one.
+
+  RETURN
+    the global epoch
+*/
+static uint64 lf_epoch_try_advance(LF_PINBOX *pinbox)
+{
+  int64 global_epoch=
+    my_atomic_load64((int64 volatile*) &pinbox->global_epoch);
+
+  if (!lf_dynarray_iterate(&pinbox->pinarray,
+                           (lf_dynarray_func) check_epoch, &global_epoch) &&
+      my_atomic_cas64((int64 volatile*) &pinbox->global_epoch,
+                      &global_epoch, global_epoch + 1))
+    return global_epoch + 1;
+  return my_atomic_load64((int64 volatile*) &pinbox->global_epoch);
+}
+
+static void lf_epoch_add_orphan(LF_PINBOX *pinbox, LF_ORPHAN *orphan)
+{
+  void *top= my_atomic_loadptr(&pinbox->orphans);
+  do
+  {
+    orphan->next= top;
+  } while (!my_atomic_casptr(&pinbox->orphans, &top, orphan));
+}
+
+/*
+  Free the orphan batches which are old enough, or all of them.
+  The whole list is detached first, so that every batch has one owner.
+*/
+static void lf_epoch_free_orphans(LF_PINBOX *pinbox, uint64 global_epoch,
+                                  my_bool all)
+{
+  LF_ORPHAN *orphan, *next;
+
+  orphan= (LF_ORPHAN *) my_atomic_fasptr(&pinbox->orphans, NULL);
+  for (; orphan; orphan= next)
+  {
+    next= orphan->next;
+    if (all || orphan->epoch + 2 <= global_epoch)
+    {
+      lf_epoch_free_list(pinbox, orphan->first);
+      my_free(orphan);
+    }
+    else
+      lf_epoch_add_orphan(pinbox, orphan);
+  }
+}
+
+/*
+  Seal the purgatory, and free the batches nobody can see any more.
+*/
+static void lf_epoch_real_free(LF_PINS *pins)
+{
+  LF_PINBOX *pinbox= pins->pinbox;
+  uint64 global_epoch= lf_epoch_try_advance(pinbox);
+  int i;
+
+  for (i= 0; i < LF_EPOCH_SEALED; i++)
+  {
+    if (pins->sealed[i] && pins->sealed_epoch[i] + 2 <= global_epoch)
+    {
+      lf_epoch_free_list(pinbox, pins->sealed[i]);
+      pins->sealed[i]= NULL;
+    }
+  }
+
+  /*
+    Objects in the purgatory were freed in the global epoch or before,
+    so it is a safe epoch for the batch. If all slots are busy,
+    the purgatory keeps growing until the next attempt.
+  */
+  for (i= 0; i < LF_EPOCH_SEALED; i++)
+  {
+    if (!pins->sealed[i])
+    {
+      pins->sealed[i]= pins->purgatory;
+      pins->sealed_epoch[i]= global_epoch;
+      pins->purgatory= NULL;
+      pins->purgatory_count= 0;
+      break;
+    }
+  }
+
+  if (my_atomic_loadptr(&pinbox->orphans))
+    lf_epoch_free_orphans(pinbox, global_epoch, FALSE);
+}
+
+/*
+  Hand a batch over to the pinbox. If there is no memory for that,
+  wait until the batch can be freed, like lf_pinbox_put_pins() does
+  in pin mode.
+*/
+static void lf_epoch_release_batch(LF_PINBOX *pinbox, void *first,
+                                   uint64 epoch)
+{
+  LF_ORPHAN *orphan;
+
+  if (!first)
+    return;
+  if ((orphan= (LF_ORPHAN *) my_malloc(key_memory_lf_node,
+                                       sizeof(LF_ORPHAN), MYF(0))))
+  {
+    orphan->first= first;
+    orphan->epoch= epoch;
+    lf_epoch_add_orphan(pinbox, orphan);
+    return;
+  }
+  while (lf_epoch_try_advance(pinbox) < epoch + 2)
+    my_thread_yield();
+  lf_epoch_free_list(pinbox, first);
+}
+
+static void lf_epoch_put_pins(LF_PINS *pins)
+{
+  LF_PINBOX *pinbox= pins->pinbox;
+  uint64 global_epoch;
+  int i;
+
+  assert(pins->epoch_depth == 0);
+  pins->epoch_depth= 0;
+  my_atomic_store64((int64 volatile*) &pins->epoch, 0);
+
+  global_epoch= lf_epoch_try_advance(pinbox);
+  for (i= 0; i < LF_EPOCH_SEALED; i++)
+  {
+    lf_epoch_release_batch(pinbox, pins->sealed[i], pins->sealed_epoch[i]);
+    pins->sealed[i]= NULL;
+  }
+  lf_epoch_release_batch(pinbox, pins->purgatory, global_epoch);
+  pins->purgatory= NULL;
+  pins->purgatory_count= 0;
+}
+
 #define next_node(P, X) (*((uchar * volatile *)(((uchar *)(X)) + (P)->free_ptr_offset)))
 #define anext_node(X) next_node(&allocator->pinbox, (X))
 
@@ -413,7 +637,10 @@ void lf_alloc_init2(LF_ALLOCATOR *allocator, uint size, uint free_ptr_offset,
 */
 void lf_alloc_destroy(LF_ALLOCATOR *allocator)
 {
-  uchar *node= allocator->top;
+  uchar *node;
+  /* Orphan batches go back to the allocator stack first */
+  lf_pinbox_destroy(&allocator->pinbox);
+  node= allocator->top;
   while (node)
   {
     uchar *tmp= anext_node(node);
@@ -422,7 +649,6 @@ void lf_alloc_destroy(LF_ALLOCATOR *allocator)
     my_free(node);
     node= tmp;
   }
-  lf_pinbox_destroy(&allocator->pinbox);
   allocator->top= 0;
 }
 
@@ -431,12 +657,14 @@ void lf_alloc_destroy(LF_ALLOCATOR *allocator)
 
   DESCRIPTION
     Pop an unused object from the stack or malloc it is the stack is empty.
-    pin[0] is used, it's removed on return.
+    pin[0] is used, it's removed on return. In epoch mode the epoch
+    protects the top of the stack instead.
 */
 void *lf_alloc_new(LF_PINS *pins)
 {
   LF_ALLOCATOR *allocator= (LF_ALLOCATOR *)(pins->pinbox->free_func_arg);
   uchar *node;
+  lf_epoch_enter(pins);
   for (;;)
   {
     do
@@ -461,6 +689,7 @@ void *lf_alloc_new(LF_PINS *pins)
       break;
   }
   lf_unpin(pins, 0);
+  lf_epoch_exit(pins);
   return node;
 }
 
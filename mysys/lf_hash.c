@@ -457,6 +457,8 @@ void lf_hash_init2(LF_HASH *hash, uint element_size, uint flags,
   hash->get_key= get_key;
   hash->hash_function= hash_function ? hash_function : cset_hash_sort_adapter;
   hash->initialize= init;
+  if (flags & LF_HASH_EPOCH)
+    lf_pinbox_set_epoch_mode(&hash->alloc.pinbox);
   assert(get_key ? !key_offset && !key_length : key_length);
 }
 
@@ -494,7 +496,7 @@ void lf_hash_destroy(LF_HASH *hash)
   NOTE
     see linsert() for pin usage notes
 */
-int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
+static int lf_hash_insert_int(LF_HASH *hash, LF_PINS *pins, const void *data)
 {
   int csize, bucket, hashnr;
   LF_SLIST *node, * volatile *el;
@@ -526,6 +528,15 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   return 0;
 }
 
+int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
+{
+  int res;
+  lf_epoch_enter(pins);
+  res= lf_hash_insert_int(hash, pins, data);
+  lf_epoch_exit(pins);
+  return res;
+}
+
 /*
   DESCRIPTION
     deletes an element with the given key from the hash (if a hash is
@@ -538,7 +549,8 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   NOTE
     see ldelete() for pin usage notes
 */
-int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
+static int lf_hash_delete_int(LF_HASH *hash, LF_PINS *pins,
+                              const void *key, uint keylen)
 {
   LF_SLIST * volatile *el;
   uint bucket, hashnr= calc_hash(hash, (uchar *)key, keylen);
@@ -564,6 +576,15 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
   return 0;
 }
 
+int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
+{
+  int res;
+  lf_epoch_enter(pins);
+  res= lf_hash_delete_int(hash, pins, key, keylen);
+  lf_epoch_exit(pins);
+  return res;
+}
+
 
 /**
   Find hash element corresponding to the key.
@@ -586,6 +607,7 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
         this case.
         So calling lf_hash_unpin() is mandatory after call to this function
         in case of both success and failure.
+        In epoch mode the thread stays in its epoch until then.
         @sa my_lsearch().
 */
 
@@ -594,6 +616,8 @@ void *lf_hash_search(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
   LF_SLIST * volatile *el, *found;
   uint bucket, hashnr= calc_hash(hash, (uchar *)key, keylen);
 
+  lf_epoch_enter(pins);
+
   bucket= hashnr % hash->size;
   el= lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
@@ -646,6 +670,7 @@ void *lf_hash_random_match(LF_HASH *hash, LF_PINS *pins,
   CURSOR cursor;
   int res;
 
+  lf_epoch_enter(pins);
   bucket= hashnr % hash->size;
   rev_hashnr= my_reverse_bits(hashnr);
 
@@ -697,6 +722,19 @@ void *lf_hash_random_match(LF_HASH *hash, LF_PINS *pins,
 
 static const uchar *dummy_key= (uchar*)"";
 
+#ifdef CPU_LEVEL1_DCACHE_LINESIZE
+#define LF_CACHE_LINE_SIZE CPU_LEVEL1_DCACHE_LINESIZE
+#else
+#define LF_CACHE_LINE_SIZE 64
+#endif
+
+/*
+  Dummy nodes are read by every search through their bucket,
+  they get a cache line of their own, so that writes to whatever
+  malloc puts next to them do not invalidate it.
+*/
+#define LF_DUMMY_SIZE MY_ALIGN(sizeof(LF_SLIST), LF_CACHE_LINE_SIZE)
+
 /*
   RETURN
     0 - ok
@@ -707,7 +745,7 @@ static int initialize_bucket(LF_HASH *hash, LF_SLIST * volatile *node,
 {
   uint parent= my_clear_highest_bit(bucket);
   LF_SLIST *dummy= (LF_SLIST *)my_malloc(key_memory_lf_slist,
-                                         sizeof(LF_SLIST), MYF(MY_WME));
+                                         LF_DUMMY_SIZE, MYF(MY_WME));
   LF_SLIST **tmp= 0, *cur;
   LF_SLIST * volatile *el= lf_dynarray_lvalue(&hash->array, parent);
   if (unlikely(!el || !dummy))
@@ -51,6 +51,13 @@
   my_b_append !  This is needed because we need to lock the mutex
   every time we access the write buffer.
 
+  A READ_CACHE initialized or reinitialized with use_async_io reads ahead:
+  while the caller consumes the buffer, a background thread reads the
+  next block of the file into a second buffer of the same size, and the
+  two buffers are swapped on the next refill. Read-ahead blocks start
+  small and double while the file is read sequentially, up to the
+  buffer size; a seek discards the block read ahead and starts over.
+
 TODO:
   When one SEQ_READ_APPEND and we are reading and writing at the same time,
   each time the write buffer gets full and it's written to disk, we will
@@ -85,6 +92,8 @@ static int _my_b_cache_read_r(IO_CACHE *info, uchar *Buffer, size_t Count);
 MY_NODISCARD
 static int _my_b_seq_read(IO_CACHE *info, uchar *Buffer, size_t Count);
 MY_NODISCARD
+static int _my_b_async_read(IO_CACHE *info, uchar *Buffer, size_t Count);
+MY_NODISCARD
 static int _my_b_cache_write(IO_CACHE *info, const uchar *Buffer,
                              size_t Count);
 MY_NODISCARD
@@ -165,7 +174,9 @@ init_functions(IO_CACHE* info)
     case WRITE_CACHE:
     case READ_FIFO:
       info->read_function=
-        info->share ? _my_b_cache_read_r : _my_b_cache_read;
+        info->share ? _my_b_cache_read_r :
+        (info->aio && type == READ_CACHE) ? _my_b_async_read :
+        _my_b_cache_read;
       info->write_function=
         info->share ? _my_b_cache_write_r : _my_b_cache_write;
       break;
@@ -177,6 +188,200 @@ init_functions(IO_CACHE* info)
 }
 
 
+/*
+  Read-ahead of READ_CACHE, see the comment at the top of the file.
+
+  The background thread only ever touches IO_CACHE_AIO, never the
+  IO_CACHE, which the owner may copy or move. Read-ahead is done with
+  pread(), so it does not change the file position; after using it the
+  cache sets seek_not_done, for the synchronous code paths.
+*/
+
+/* First read-ahead block size; it doubles up to buffer_length */
+#define IO_CACHE_AIO_MIN_BLOCK (IO_SIZE*16)
+
+enum io_cache_aio_state
+{
+  AIO_IDLE,                               /* spare buffer is free */
+  AIO_QUEUED,                             /* read requested or running */
+  AIO_DONE                                /* spare buffer has a block */
+};
+
+typedef struct st_io_cache_aio
+{
+  mysql_mutex_t mutex;
+  mysql_cond_t cond;
+  my_thread_handle thread;
+  uchar *buffer;                          /* spare buffer */
+  File file;
+  my_off_t pos;                           /* file offset of the block */
+  size_t length;                          /* bytes requested */
+  size_t result;                          /* bytes read, or -1 */
+  size_t block_length;                    /* size of the next block */
+  enum io_cache_aio_state state;
+  my_bool thread_started, no_thread, stop;
+} IO_CACHE_AIO;
+
+static void *io_cache_aio_thread(void *arg)
+{
+  IO_CACHE_AIO *aio= (IO_CACHE_AIO *) arg;
+  my_thread_init();
+
+  mysql_mutex_lock(&aio->mutex);
+  for (;;)
+  {
+    File file;
+    my_off_t pos;
+    size_t length, result;
+
+    while (aio->state != AIO_QUEUED && !aio->stop)
+      mysql_cond_wait(&aio->cond, &aio->mutex);
+    if (aio->stop)
+      break;
+    file= aio->file;
+    pos= aio->pos;
+    length= aio->length;
+    mysql_mutex_unlock(&aio->mutex);
+
+    /* Errors are reported by the synchronous read which follows a miss */
+    result= mysql_file_pread(file, aio->buffer, length, pos, MYF(0));
+
+    mysql_mutex_lock(&aio->mutex);
+    aio->result= result;
+    aio->state= AIO_DONE;
+    mysql_cond_broadcast(&aio->cond);
+  }
+  mysql_mutex_unlock(&aio->mutex);
+
+  my_thread_end();
+  return NULL;
+}
+
+/* Enable read-ahead for a READ_CACHE. Nothing happens on failure. */
+static void io_cache_aio_init(IO_CACHE *info)
+{
+  IO_CACHE_AIO *aio;
+
+  if (!(aio= (IO_CACHE_AIO *) my_malloc(key_memory_IO_CACHE,
+                                        sizeof(IO_CACHE_AIO),
+                                        MYF(MY_ZEROFILL))))
+    return;
+  if (!(aio->buffer= (uchar *) my_malloc(key_memory_IO_CACHE,
+                                         info->buffer_length, MYF(0))))
+  {
+    my_free(aio);
+    return;
+  }
+  mysql_mutex_init(key_IO_CACHE_AIO_mutex, &aio->mutex, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_IO_CACHE_AIO_cond, &aio->cond);
+  aio->state= AIO_IDLE;
+  aio->block_length= MY_MIN(IO_CACHE_AIO_MIN_BLOCK, info->buffer_length);
+  info->aio= aio;
+}
+
+static void io_cache_aio_end(IO_CACHE *info)
+{
+  IO_CACHE_AIO *aio= info->aio;
+
+  if (aio->thread_started)
+  {
+    mysql_mutex_lock(&aio->mutex);
+    /* A running read finishes first, it uses aio->buffer */
+    aio->stop= 1;
+    mysql_cond_broadcast(&aio->cond);
+    mysql_mutex_unlock(&aio->mutex);
+    my_thread_join(&aio->thread, NULL);
+  }
+  mysql_cond_destroy(&aio->cond);
+  mysql_mutex_destroy(&aio->mutex);
+  my_free(aio->buffer);
+  my_free(aio);
+  info->aio= NULL;
+}
+
+/*
+  Wait for the read-ahead to finish, and either swap its buffer in
+  (if it has the block at pos) or discard it.
+
+  RETURN
+    number of bytes now in info->buffer, 0 if the block at pos
+    was not read ahead.
+*/
+static size_t io_cache_aio_take(IO_CACHE *info, my_off_t pos)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  size_t length= 0;
+
+  mysql_mutex_lock(&aio->mutex);
+  while (aio->state == AIO_QUEUED)
+    mysql_cond_wait(&aio->cond, &aio->mutex);
+  if (aio->state == AIO_DONE && aio->pos == pos && aio->file == info->file &&
+      aio->result != (size_t) -1 && aio->result != 0)
+  {
+    uchar *tmp= info->buffer;
+    info->buffer= info->write_buffer= aio->buffer;
+    aio->buffer= tmp;
+    length= aio->result;
+  }
+  aio->state= AIO_IDLE;
+  mysql_mutex_unlock(&aio->mutex);
+  return length;
+}
+
+/* Drop any read-ahead, the file or the cache is going to change */
+static void io_cache_aio_discard(IO_CACHE *info)
+{
+  (void) io_cache_aio_take(info, ~(my_off_t) 0);
+  info->aio->block_length= MY_MIN(IO_CACHE_AIO_MIN_BLOCK,
+                                  info->buffer_length);
+}
+
+/*
+  Length of the block to read at pos: ends on an IO_SIZE boundary,
+  and not after the end of file.
+*/
+static size_t io_cache_aio_length(IO_CACHE *info, my_off_t pos)
+{
+  size_t length= info->aio->block_length - (size_t) (pos & (IO_SIZE-1));
+  if ((my_off_t) length > info->end_of_file - pos)
+    length= (size_t) (info->end_of_file - pos);
+  return length;
+}
+
+/* Start reading the block at pos in the background */
+static void io_cache_aio_request(IO_CACHE *info, my_off_t pos)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  size_t length;
+
+  if (aio->no_thread || info->end_of_file <= pos ||
+      !(length= io_cache_aio_length(info, pos)))
+    return;
+
+  mysql_mutex_lock(&aio->mutex);
+  assert(aio->state == AIO_IDLE);
+  if (!aio->thread_started)
+  {
+    my_thread_attr_t attr;
+    my_thread_attr_init(&attr);
+    if (my_thread_create(&aio->thread, &attr, io_cache_aio_thread, aio))
+      aio->no_thread= 1;
+    else
+      aio->thread_started= 1;
+    my_thread_attr_destroy(&attr);
+  }
+  if (aio->thread_started)
+  {
+    aio->file= info->file;
+    aio->pos= pos;
+    aio->length= length;
+    aio->state= AIO_QUEUED;
+    mysql_cond_broadcast(&aio->cond);
+  }
+  mysql_mutex_unlock(&aio->mutex);
+}
+
+
 /*
   Initialize IO_CACHE encryption subsystem
 
@@ -243,6 +448,7 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
   size_t min_cache;
   my_off_t pos;
   my_off_t end_of_file= ~(my_off_t) 0;
+  my_bool seekable= TRUE;
   DBUG_ENTER("init_io_cache_ext");
   DBUG_PRINT("enter",("cache: 0x%lx  type: %d  pos: %ld",
              (ulong) info, (int) type, (ulong) seek_offset));
@@ -268,6 +474,7 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
          flag that will make us again try to seek() later and fail.
       */
       info->seek_not_done= 0;
+      seekable= FALSE;
       /*
         Additionally, if we're supposed to start somewhere other than the
         the beginning of whatever this file is, then somebody made a bad
@@ -287,6 +494,7 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
 
   info->disk_writes= 0;
   info->share=0;
+  info->aio= NULL;
 
   if (!cachesize && !(cachesize= my_default_record_cache_size))
     DBUG_RETURN(1);        /* No cache requested */
@@ -382,6 +590,9 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
   info->end_of_file= end_of_file;
   info->error=0;
   info->type= type;
+  if (use_async_io && type == READ_CACHE && file >= 0 && seekable &&
+      !(cache_myflags & MY_ENCRYPT))
+    io_cache_aio_init(info);
   init_functions(info);
   DBUG_RETURN(0);
 }  /* init_io_cache_ext */
@@ -413,7 +624,7 @@ int init_io_cache(IO_CACHE *info, File file, size_t cachesize,
 
 my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
                         my_off_t seek_offset,
-                        my_bool use_async_io MY_ATTRIBUTE((unused)),
+                        my_bool use_async_io,
                         my_bool clear_cache)
 {
   DBUG_ENTER("reinit_io_cache");
@@ -424,6 +635,9 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   assert(type == READ_CACHE || type == WRITE_CACHE);
   assert(info->type == READ_CACHE || info->type == WRITE_CACHE);
 
+  if (info->aio)
+    io_cache_aio_discard(info);
+
   /* If the whole file is in memory, avoid flushing to disk */
   if (! clear_cache &&
       seek_offset >= info->pos_in_file &&
@@ -498,6 +712,10 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   }
   info->type=type;
   info->error=0;
+  /* Read-ahead, once enabled, stays for the life of the cache */
+  if (use_async_io && type == READ_CACHE && !info->aio && !info->share &&
+      info->alloced_buffer && !(info->myflags & MY_ENCRYPT))
+    io_cache_aio_init(info);
   init_functions(info);
 
   DBUG_RETURN(0);
@@ -736,6 +954,142 @@ static int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
 }
 
 
+/*
+  Read buffered, with read-ahead.
+
+  SYNOPSIS
+    _my_b_async_read()
+      info                      IO_CACHE pointer
+      Buffer                    Buffer to retrieve count bytes from file
+      Count                     Number of bytes to read into Buffer
+
+  NOTE
+    Used instead of _my_b_cache_read() for a READ_CACHE with read-ahead.
+    Takes the block read ahead if it is the one wanted, otherwise reads
+    it synchronously, and then starts reading the following block.
+    Requests of a full buffer or more go to _my_b_cache_read().
+
+  RETURN
+    Same as _my_b_cache_read()
+*/
+
+static int _my_b_async_read(IO_CACHE *info, uchar *Buffer, size_t Count)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  size_t length, max_length, left_length= 0;
+  my_off_t pos_in_file;
+  DBUG_ENTER("_my_b_async_read");
+
+  pos_in_file= info->pos_in_file + (size_t) (info->read_end - info->buffer);
+
+  /* No file yet, everything is in the buffer */
+  if (info->file < 0)
+    DBUG_RETURN(_my_b_cache_read(info, Buffer, Count));
+
+  if (Count >= info->buffer_length)
+  {
+    /*
+      Read most of a big request directly, without filling the buffer.
+      The read ends aligned on a block, like in _my_b_cache_read().
+    */
+    size_t read_length;
+    io_cache_aio_discard(info);
+    if (info->end_of_file <= pos_in_file)
+    {
+      info->error= 0;
+      DBUG_RETURN(1);
+    }
+    length= IO_ROUND_DN(Count) - (size_t) (pos_in_file & (IO_SIZE-1));
+    if ((my_off_t) length > info->end_of_file - pos_in_file)
+      length= (size_t) (info->end_of_file - pos_in_file);
+    read_length= mysql_file_pread(info->file, Buffer, length, pos_in_file,
+                                  info->myflags);
+    info->seek_not_done= 1;
+    info->request_pos= info->read_pos= info->read_end= info->buffer;
+    if (read_length == (size_t) -1)
+    {
+      info->pos_in_file= pos_in_file;
+      info->error= -1;
+      DBUG_RETURN(1);
+    }
+    pos_in_file+= read_length;
+    info->pos_in_file= pos_in_file;
+    if (read_length != length)
+    {
+      info->error= (int) read_length;
+      DBUG_RETURN(1);
+    }
+    Buffer+= read_length;
+    Count-= read_length;
+    left_length= read_length;
+  }
+
+  for (;;)
+  {
+    max_length= 0;
+    if (info->end_of_file > pos_in_file)
+      max_length= io_cache_aio_length(info, pos_in_file);
+    if (!max_length)
+    {
+      io_cache_aio_discard(info);
+      info->error= (int) left_length;
+      DBUG_RETURN(Count != 0);
+    }
+
+    if ((length= io_cache_aio_take(info, pos_in_file)))
+    {
+      /* Sequential read: read ahead more next time */
+      if (aio->block_length < info->buffer_length)
+        aio->block_length= MY_MIN(aio->block_length * 2,
+                                  info->buffer_length);
+    }
+    else
+    {
+      aio->block_length= MY_MIN(IO_CACHE_AIO_MIN_BLOCK,
+                                info->buffer_length);
+      max_length= io_cache_aio_length(info, pos_in_file);
+      length= mysql_file_pread(info->file, info->buffer, max_length,
+                               pos_in_file, info->myflags);
+      if (length == (size_t) -1)
+      {
+        info->pos_in_file= pos_in_file;
+        info->read_pos= info->read_end= info->buffer;
+        info->error= -1;
+        info->seek_not_done= 1;
+        DBUG_RETURN(1);
+      }
+    }
+    info->seek_not_done= 1;
+    info->pos_in_file= pos_in_file;
+    info->request_pos= info->read_pos= info->buffer;
+    info->read_end= info->buffer + length;
+
+    /* A short read means end of file, there is nothing to read ahead */
+    if (length >= max_length)
+      io_cache_aio_request(info, pos_in_file + length);
+
+    if (length >= Count)
+    {
+      if (Count)
+        memcpy(Buffer, info->buffer, Count);
+      info->read_pos+= Count;
+      DBUG_RETURN(0);
+    }
+    if (length == 0)
+    {
+      info->error= (int) left_length;
+      DBUG_RETURN(1);
+    }
+    memcpy(Buffer, info->buffer, length);
+    info->read_pos= info->read_end;
+    Buffer+= length;
+    Count-= length;
+    left_length+= length;
+    pos_in_file+= length;
+  }
+}
+
+
 /*
   Prepare IO_CACHE for shared use.
 
@@ -1768,6 +2122,8 @@ int end_io_cache(IO_CACHE *info)
   if (info->alloced_buffer)
   {
     info->alloced_buffer=0;
+    if (info->aio)
+      io_cache_aio_end(info);
     if (info->file != -1)			/* File doesn't exist */
       error= my_b_flush_io_cache(info,1);
     my_free(info->buffer);
@@ -217,7 +217,8 @@ size_t my_b_fill(IO_CACHE *info)
   my_off_t pos_in_file;
   size_t diff_length, length, max_length;
 
-  if (info->myflags & MY_ENCRYPT)
+  /* Encrypted caches and caches with read-ahead use their read function */
+  if ((info->myflags & MY_ENCRYPT) || info->aio)
   {
     assert(info->read_pos == info->read_end);
     return _my_b_read(info, 0, 0) ? 0 : info->read_end - info->read_pos;
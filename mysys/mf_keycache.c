@@ -60,6 +60,10 @@
   when executing code in this file (mf_keycache.c).
   However it is released for I/O and some copy operations.
 
+  A partitioned key cache is a set of such key caches, one per partition,
+  see partitioned_init_key_cache(). Its own cache_lock is only taken to
+  resize it, see partitioned_resize_key_cache().
+
   The cache_lock is also released when waiting for some event. Waiting
   and signalling is done via condition variables. In most cases the
   thread waits on its thread->suspend condition variable. Every thread
@@ -126,6 +130,7 @@
 #include <stdarg.h>
 #include "probes_mysql.h"
 #include "my_thread_local.h"
+#include "my_atomic.h"
 
 #define STRUCT_PTR(TYPE, MEMBER, a)                                           \
           (TYPE *) ((char *) (a) - offsetof(TYPE, MEMBER))
@@ -214,6 +219,7 @@ static void release_whole_queue(KEYCACHE_WQUEUE *wqueue);
 static void free_block(KEY_CACHE *keycache,
                        st_keycache_thread_var *thread_var,
                        BLOCK_LINK *block);
+static void simple_end_key_cache(KEY_CACHE *keycache, my_bool cleanup);
 
 #define KEYCACHE_HASH(f, pos)                                                 \
 (((ulong) ((pos) / keycache->key_cache_block_size) +                          \
@@ -241,7 +247,7 @@ static inline uint next_power(uint value)
   Initialize a key cache
 
   SYNOPSIS
-    init_key_cache()
+    simple_init_key_cache()
     keycache			pointer to a key cache data structure
     key_cache_block_size	size of blocks to keep cached data
     use_mem                 	total memory to use for the key cache
@@ -262,14 +268,15 @@ static inline uint next_power(uint value)
 
 */
 
-int init_key_cache(KEY_CACHE *keycache, ulonglong key_cache_block_size,
-                   size_t use_mem, ulonglong division_limit,
-                   ulonglong age_threshold)
+static int simple_init_key_cache(KEY_CACHE *keycache,
+                                 ulonglong key_cache_block_size,
+                                 size_t use_mem, ulonglong division_limit,
+                                 ulonglong age_threshold)
 {
   ulong blocks, hash_links;
   size_t length;
   int error;
-  DBUG_ENTER("init_key_cache");
+  DBUG_ENTER("simple_init_key_cache");
   assert(key_cache_block_size >= 512);
 
   if (keycache->key_cache_inited && keycache->disk_blocks > 0)
@@ -425,55 +432,33 @@ err:
 
 
 /*
-  Resize a key cache
+  Prepare a key cache for resizing
 
   SYNOPSIS
-    resize_key_cache()
+    prepare_resize_key_cache()
     keycache     	        pointer to a key cache data structure
     thread_var                  pointer to thread specific variables
-    key_cache_block_size        size of blocks to keep cached data
-    use_mem			total memory to use for the new key cache
-    division_limit		new division limit (if not zero)
-    age_threshold		new age threshold (if not zero)
 
   RETURN VALUE
-    number of blocks in the key cache, if successful,
-    0 - otherwise.
+    0 - the old cache structures are freed, call simple_init_key_cache()
+    1 - the flush failed, the cache has been disabled
 
   NOTES.
-    The function first compares the memory size and the block size parameters
-    with the key cache values.
-
-    If they differ the function free the the memory allocated for the
-    old key cache blocks by calling the end_key_cache function and
-    then rebuilds the key cache with new blocks by calling
-    init_key_cache.
+    Must be called with keycache->cache_lock locked, and must be followed
+    by finish_resize_key_cache() in both cases. In between, in_resize is
+    set and new read/write requests wait on the resize_queue, also while
+    the cache_lock is temporarily released.
 
     The function starts the operation only when all other threads
     performing operations with the key cache let her to proceed
     (when cnt_for_resize=0).
 */
 
-int resize_key_cache(KEY_CACHE *keycache,
-                     st_keycache_thread_var *thread_var,
-                     ulonglong key_cache_block_size,
-                     size_t use_mem, ulonglong division_limit,
-                     ulonglong age_threshold)
+static int prepare_resize_key_cache(KEY_CACHE *keycache,
+                                    st_keycache_thread_var *thread_var)
 {
-  int blocks;
-  DBUG_ENTER("resize_key_cache");
-
-  if (!keycache->key_cache_inited)
-    DBUG_RETURN(keycache->disk_blocks);
-
-  if(key_cache_block_size == keycache->key_cache_block_size &&
-     use_mem == keycache->key_cache_mem_size)
-  {
-    change_key_cache_param(keycache, division_limit, age_threshold);
-    DBUG_RETURN(keycache->disk_blocks);
-  }
-
-  mysql_mutex_lock(&keycache->cache_lock);
+  DBUG_ENTER("prepare_resize_key_cache");
+  mysql_mutex_assert_owner(&keycache->cache_lock);
 
   /*
     We may need to wait for another thread which is doing a resize
@@ -506,9 +491,8 @@ int resize_key_cache(KEY_CACHE *keycache,
     {
       /* TODO: if this happens, we should write a warning in the log file ! */
       keycache->resize_in_flush= 0;
-      blocks= 0;
       keycache->can_be_used= 0;
-      goto finish;
+      DBUG_RETURN(1);
     }
     assert(cache_empty(keycache));
 
@@ -532,17 +516,29 @@ int resize_key_cache(KEY_CACHE *keycache,
                   thread_var);
 
   /*
-    Free old cache structures, allocate new structures, and initialize
-    them. Note that the cache_lock mutex and the resize_queue are left
-    untouched. We do not lose the cache_lock and will release it only at
-    the end of this function.
+    Free old cache structures. Note that the cache_lock mutex and the
+    resize_queue are left untouched.
   */
-  end_key_cache(keycache, 0);			/* Don't free mutex */
-  /* The following will work even if use_mem is 0 */
-  blocks= init_key_cache(keycache, key_cache_block_size, use_mem,
-			 division_limit, age_threshold);
+  simple_end_key_cache(keycache, 0);		/* Don't free mutex */
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Finish the resizing of a key cache
+
+  SYNOPSIS
+    finish_resize_key_cache()
+    keycache     	        pointer to a key cache data structure
+
+  NOTES.
+    Must be called with keycache->cache_lock locked.
+*/
+
+static void finish_resize_key_cache(KEY_CACHE *keycache)
+{
+  mysql_mutex_assert_owner(&keycache->cache_lock);
 
-finish:
   /*
     Mark the resize finished. This allows other threads to start a
     resize or to request new cache blocks.
@@ -551,6 +547,70 @@ finish:
 
   /* Signal waiting threads. */
   release_whole_queue(&keycache->resize_queue);
+}
+
+
+/*
+  Resize a key cache
+
+  SYNOPSIS
+    simple_resize_key_cache()
+    keycache     	        pointer to a key cache data structure
+    thread_var                  pointer to thread specific variables
+    key_cache_block_size        size of blocks to keep cached data
+    use_mem			total memory to use for the new key cache
+    division_limit		new division limit (if not zero)
+    age_threshold		new age threshold (if not zero)
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+
+  NOTES.
+    The function first compares the memory size and the block size parameters
+    with the key cache values.
+
+    If they differ the function free the the memory allocated for the
+    old key cache blocks by calling the simple_end_key_cache function and
+    then rebuilds the key cache with new blocks by calling
+    simple_init_key_cache.
+*/
+
+static int simple_resize_key_cache(KEY_CACHE *keycache,
+                                   st_keycache_thread_var *thread_var,
+                                   ulonglong key_cache_block_size,
+                                   size_t use_mem, ulonglong division_limit,
+                                   ulonglong age_threshold)
+{
+  int blocks;
+  DBUG_ENTER("simple_resize_key_cache");
+
+  if (!keycache->key_cache_inited)
+    DBUG_RETURN(keycache->disk_blocks);
+
+  if(key_cache_block_size == keycache->key_cache_block_size &&
+     use_mem == keycache->key_cache_mem_size)
+  {
+    change_key_cache_param(keycache, division_limit, age_threshold);
+    DBUG_RETURN(keycache->disk_blocks);
+  }
+
+  mysql_mutex_lock(&keycache->cache_lock);
+
+  if (prepare_resize_key_cache(keycache, thread_var))
+    blocks= 0;
+  else
+  {
+    /*
+      Allocate new structures, and initialize them. We do not lose the
+      cache_lock and will release it only at the end of this function.
+      The following will work even if use_mem is 0.
+    */
+    blocks= simple_init_key_cache(keycache, key_cache_block_size, use_mem,
+                                  division_limit, age_threshold);
+  }
+
+  finish_resize_key_cache(keycache);
 
   mysql_mutex_unlock(&keycache->cache_lock);
   DBUG_RETURN(blocks);
@@ -616,7 +676,7 @@ static void change_key_cache_param(KEY_CACHE *keycache,
   Remove key_cache from memory
 
   SYNOPSIS
-    end_key_cache()
+    simple_end_key_cache()
     keycache		key cache handle
     cleanup		Complete free (Free also mutex for key cache)
 
@@ -624,9 +684,9 @@ static void change_key_cache_param(KEY_CACHE *keycache,
     none
 */
 
-void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
+static void simple_end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
 {
-  DBUG_ENTER("end_key_cache");
+  DBUG_ENTER("simple_end_key_cache");
   DBUG_PRINT("enter", ("key_cache: 0x%lx", (long) keycache));
 
   if (!keycache->key_cache_inited)
@@ -667,7 +727,7 @@ void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
     keycache->key_cache_inited= keycache->can_be_used= 0;
   }
   DBUG_VOID_RETURN;
-} /* end_key_cache */
+} /* simple_end_key_cache */
 
 
 /**
@@ -2259,7 +2319,7 @@ static void read_block(KEY_CACHE *keycache,
 
   SYNOPSIS
 
-    key_cache_read()
+    simple_key_cache_read()
       keycache            pointer to a key cache data structure
       thread_var          pointer to thread specific variables
       file                handler for the file for the block of data to be read
@@ -2283,17 +2343,17 @@ static void read_block(KEY_CACHE *keycache,
     have to be a multiple of key_cache_block_size;
 */
 
-uchar *key_cache_read(KEY_CACHE *keycache,
-                      st_keycache_thread_var *thread_var,
-                      File file, my_off_t filepos, int level,
-                      uchar *buff, uint length,
-                      uint block_length MY_ATTRIBUTE((unused)),
-                      int return_buffer MY_ATTRIBUTE((unused)))
+static uchar *simple_key_cache_read(KEY_CACHE *keycache,
+                                    st_keycache_thread_var *thread_var,
+                                    File file, my_off_t filepos, int level,
+                                    uchar *buff, uint length,
+                                    uint block_length MY_ATTRIBUTE((unused)),
+                                    int return_buffer MY_ATTRIBUTE((unused)))
 {
   my_bool locked_and_incremented= FALSE;
   int error=0;
   uchar *start= buff;
-  DBUG_ENTER("key_cache_read");
+  DBUG_ENTER("simple_key_cache_read");
   DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
                (uint) file, (ulong) filepos, length));
 
@@ -2498,7 +2558,7 @@ end:
   Insert a block of file data from a buffer into key cache
 
   SYNOPSIS
-    key_cache_insert()
+    simple_key_cache_insert()
     keycache            pointer to a key cache data structure
     thread_var          pointer to thread specific variables
     file                handler for the file to insert data from
@@ -2515,13 +2575,13 @@ end:
     0 if a success, 1 - otherwise.
 */
 
-int key_cache_insert(KEY_CACHE *keycache,
-                     st_keycache_thread_var *thread_var,
-                     File file, my_off_t filepos, int level,
-                     uchar *buff, uint length)
+static int simple_key_cache_insert(KEY_CACHE *keycache,
+                                   st_keycache_thread_var *thread_var,
+                                   File file, my_off_t filepos, int level,
+                                   uchar *buff, uint length)
 {
   int error= 0;
-  DBUG_ENTER("key_cache_insert");
+  DBUG_ENTER("simple_key_cache_insert");
   DBUG_PRINT("enter", ("fd: %u  pos: %lu  length: %u",
                (uint) file,(ulong) filepos, length));
 
@@ -2735,7 +2795,7 @@ int key_cache_insert(KEY_CACHE *keycache,
 
   SYNOPSIS
 
-    key_cache_write()
+    simple_key_cache_write()
       keycache            pointer to a key cache data structure
       thread_var          pointer to thread specific variables
       file                handler for the file to write data to
@@ -2760,16 +2820,16 @@ int key_cache_insert(KEY_CACHE *keycache,
     dont_write is always TRUE in the server (info->lock_type is never F_UNLCK).
 */
 
-int key_cache_write(KEY_CACHE *keycache,
-                    st_keycache_thread_var *thread_var,
-                    File file, my_off_t filepos, int level,
-                    uchar *buff, uint length,
-                    uint block_length  MY_ATTRIBUTE((unused)),
-                    int dont_write)
+static int simple_key_cache_write(KEY_CACHE *keycache,
+                                  st_keycache_thread_var *thread_var,
+                                  File file, my_off_t filepos, int level,
+                                  uchar *buff, uint length,
+                                  uint block_length  MY_ATTRIBUTE((unused)),
+                                  int dont_write)
 {
   my_bool locked_and_incremented= FALSE;
   int error=0;
-  DBUG_ENTER("key_cache_write");
+  DBUG_ENTER("simple_key_cache_write");
   DBUG_PRINT("enter",
              ("fd: %u  pos: %lu  length: %u  block_length: %u"
               "  key_block_length: %u",
@@ -3787,7 +3847,7 @@ err:
 
   SYNOPSIS
 
-    flush_key_blocks()
+    simple_flush_key_blocks()
       keycache            pointer to a key cache data structure
       thread_var          pointer to thread specific variables
       file                handler for the file to flush to
@@ -3798,12 +3858,12 @@ err:
     1  error
 */
 
-int flush_key_blocks(KEY_CACHE *keycache,
-                     st_keycache_thread_var *thread_var,
-                     File file, enum flush_type type)
+static int simple_flush_key_blocks(KEY_CACHE *keycache,
+                                   st_keycache_thread_var *thread_var,
+                                   File file, enum flush_type type)
 {
   int res= 0;
-  DBUG_ENTER("flush_key_blocks");
+  DBUG_ENTER("simple_flush_key_blocks");
   DBUG_PRINT("enter", ("keycache: 0x%lx", (long) keycache));
 
   if (!keycache->key_cache_inited)
@@ -3960,6 +4020,518 @@ static int flush_all_key_blocks(KEY_CACHE *keycache,
 }
 
 
+/*
+  Partitioned key cache
+
+  A key cache with param_partitions > 1 is split into that many simple
+  key caches, each with its own cache_lock, LRU chain and hash table.
+  A key cache block is cached in exactly one partition, chosen from the
+  file and the block number, so that concurrent requests for different
+  blocks mostly lock different mutexes. The KEY_CACHE passed by the
+  callers holds only the partition array, the parameters and the summed
+  statistics, see update_key_cache_stats().
+
+  The partition of a block depends on the block size. Requests are
+  counted in partition_requests, without locking, and a resize waits for
+  the requests in progress to end before it changes the block size.
+  Requests starting during a resize wait for it to end, see
+  partitioned_request_begin().
+*/
+
+/*
+  Get the partition caching the block at filepos
+
+  The block number is mixed with a multiplicative hash, so that the
+  blocks of one partition are still spread over all the buckets of its
+  KEYCACHE_HASH.
+*/
+
+static inline KEY_CACHE *get_key_cache_partition(KEY_CACHE *keycache,
+                                                 uint block_size,
+                                                 File file, my_off_t filepos)
+{
+  ulonglong hash= ((ulonglong) (filepos / block_size) + (ulonglong) file) *
+                  0x9E3779B97F4A7C15ULL;
+  return keycache->partition_array + (hash >> 32) % keycache->partitions;
+}
+
+
+/*
+  Count a request that is done when partitioned_request_end() is called
+
+  A request finding a resize in progress takes its count back, and
+  waits on the resize_queue of the partitioned key cache for the resize
+  to end.
+*/
+
+static void partitioned_request_end(KEY_CACHE *keycache);
+
+static void partitioned_request_begin(KEY_CACHE *keycache,
+                                      st_keycache_thread_var *thread_var)
+{
+  for (;;)
+  {
+    my_atomic_add32(&keycache->partition_requests, 1);
+    if (likely(!my_atomic_load32(&keycache->partition_resizing)))
+      return;
+
+    partitioned_request_end(keycache);
+    mysql_mutex_lock(&keycache->cache_lock);
+    while (my_atomic_load32(&keycache->partition_resizing))
+      wait_on_queue(&keycache->resize_queue, &keycache->cache_lock,
+                    thread_var);
+    mysql_mutex_unlock(&keycache->cache_lock);
+  }
+}
+
+
+/*
+  End a request counted by partitioned_request_begin()
+
+  The last request to end during a resize wakes the resizing thread up.
+*/
+
+static void partitioned_request_end(KEY_CACHE *keycache)
+{
+  if (my_atomic_add32(&keycache->partition_requests, -1) == 1 &&
+      my_atomic_load32(&keycache->partition_resizing))
+  {
+    mysql_mutex_lock(&keycache->cache_lock);
+    release_whole_queue(&keycache->waiting_for_resize_cnt);
+    mysql_mutex_unlock(&keycache->cache_lock);
+  }
+}
+
+
+/*
+  Set the size of a partitioned key cache to the sum of its partitions
+*/
+
+static void sum_key_cache_partitions(KEY_CACHE *keycache)
+{
+  uint i;
+  int blocks= 0;
+
+  for (i= 0; i < keycache->partitions; i++)
+  {
+    KEY_CACHE *partition= keycache->partition_array + i;
+    if (partition->disk_blocks > 0)
+      blocks+= partition->disk_blocks;
+  }
+  keycache->disk_blocks= blocks ? blocks : -1;
+  keycache->blocks= blocks;
+  keycache->can_be_used= (blocks > 0);
+}
+
+
+/*
+  Initialize a partitioned key cache
+
+  use_mem is divided evenly between the partitions. A partition that
+  cannot allocate its memory is disabled, see simple_init_key_cache(),
+  and its blocks are read and written directly.
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+*/
+
+static int partitioned_init_key_cache(KEY_CACHE *keycache,
+                                      ulonglong key_cache_block_size,
+                                      size_t use_mem,
+                                      ulonglong division_limit,
+                                      ulonglong age_threshold)
+{
+  uint i;
+  my_bool error= FALSE;
+  DBUG_ENTER("partitioned_init_key_cache");
+
+  if (!keycache->partition_array)
+  {
+    uint partitions= (uint) keycache->param_partitions;
+    if (!(keycache->partition_array=
+          (KEY_CACHE*) my_malloc(key_memory_KEY_CACHE,
+                                 partitions * sizeof(KEY_CACHE),
+                                 MYF(MY_ZEROFILL))))
+      DBUG_RETURN(0);
+    keycache->partitions= partitions;
+    keycache->partition_requests= 0;
+    keycache->partition_resizing= 0;
+    keycache->resize_queue.last_thread= NULL;
+    keycache->waiting_for_resize_cnt.last_thread= NULL;
+    mysql_mutex_init(key_KEY_CACHE_cache_lock,
+                     &keycache->cache_lock, MY_MUTEX_INIT_FAST);
+  }
+
+  keycache->key_cache_inited= 1;
+  keycache->key_cache_mem_size= use_mem;
+  keycache->key_cache_block_size= (uint) key_cache_block_size;
+  keycache->global_cache_w_requests= keycache->global_cache_r_requests= 0;
+  keycache->global_cache_read= keycache->global_cache_write= 0;
+
+  for (i= 0; i < keycache->partitions; i++)
+  {
+    if (!simple_init_key_cache(keycache->partition_array + i,
+                               key_cache_block_size,
+                               use_mem / keycache->partitions,
+                               division_limit, age_threshold))
+      error= TRUE;
+  }
+
+  sum_key_cache_partitions(keycache);
+  DBUG_RETURN(error ? 0 : keycache->disk_blocks);
+}
+
+
+/*
+  Resize a partitioned key cache
+
+  NOTES.
+    The partition of a block depends on the block size. The resize first
+    waits for the requests in progress to end, new requests wait for the
+    resize to end. Then each partition is resized as a simple key cache
+    would be: flushed, freed and re-initialized. A partition which fails
+    to flush keeps its blocks and stays disabled, its requests bypass it.
+*/
+
+static int partitioned_resize_key_cache(KEY_CACHE *keycache,
+                                        st_keycache_thread_var *thread_var,
+                                        ulonglong key_cache_block_size,
+                                        size_t use_mem,
+                                        ulonglong division_limit,
+                                        ulonglong age_threshold)
+{
+  uint i;
+  my_bool error= FALSE;
+  DBUG_ENTER("partitioned_resize_key_cache");
+
+  if (key_cache_block_size == keycache->key_cache_block_size &&
+      use_mem == keycache->key_cache_mem_size)
+  {
+    for (i= 0; i < keycache->partitions; i++)
+      change_key_cache_param(keycache->partition_array + i,
+                             division_limit, age_threshold);
+    DBUG_RETURN(keycache->disk_blocks);
+  }
+
+  /* Wait for the requests in progress, which use the old block size. */
+  mysql_mutex_lock(&keycache->cache_lock);
+  my_atomic_store32(&keycache->partition_resizing, 1);
+  while (my_atomic_load32(&keycache->partition_requests))
+    wait_on_queue(&keycache->waiting_for_resize_cnt, &keycache->cache_lock,
+                  thread_var);
+  mysql_mutex_unlock(&keycache->cache_lock);
+
+  keycache->key_cache_mem_size= use_mem;
+  keycache->key_cache_block_size= (uint) key_cache_block_size;
+
+  for (i= 0; i < keycache->partitions; i++)
+  {
+    KEY_CACHE *partition= keycache->partition_array + i;
+    mysql_mutex_lock(&partition->cache_lock);
+    if (prepare_resize_key_cache(partition, thread_var))
+      error= TRUE;
+    else if (!simple_init_key_cache(partition, key_cache_block_size,
+                                    use_mem / keycache->partitions,
+                                    division_limit, age_threshold))
+      error= TRUE;
+    finish_resize_key_cache(partition);
+    mysql_mutex_unlock(&partition->cache_lock);
+  }
+
+  sum_key_cache_partitions(keycache);
+
+  mysql_mutex_lock(&keycache->cache_lock);
+  my_atomic_store32(&keycache->partition_resizing, 0);
+  release_whole_queue(&keycache->resize_queue);
+  mysql_mutex_unlock(&keycache->cache_lock);
+
+  DBUG_RETURN(error ? 0 : keycache->disk_blocks);
+}
+
+
+/*
+  Initialize a key cache
+
+  SYNOPSIS
+    init_key_cache()
+    keycache			pointer to a key cache data structure
+    key_cache_block_size	size of blocks to keep cached data
+    use_mem                 	total memory to use for the key cache
+    division_limit		division limit (may be zero)
+    age_threshold		age threshold (may be zero)
+
+  RETURN VALUE
+    number of blocks in the key cache, if successful,
+    0 - otherwise.
+
+  NOTES.
+    The key cache is partitioned if keycache->param_partitions > 1.
+    See simple_init_key_cache() for the rest.
+*/
+
+int init_key_cache(KEY_CACHE *keycache, ulonglong key_cache_block_size,
+                   size_t use_mem, ulonglong division_limit,
+                   ulonglong age_threshold)
+{
+  DBUG_ENTER("init_key_cache");
+
+  if (keycache->partitions ||
+      (!keycache->key_cache_inited && keycache->param_partitions > 1))
+  {
+    assert(key_cache_block_size >= 512);
+    if (keycache->key_cache_inited && keycache->disk_blocks > 0)
+    {
+      DBUG_PRINT("warning",("key cache already in use"));
+      DBUG_RETURN(0);
+    }
+    DBUG_RETURN(partitioned_init_key_cache(keycache, key_cache_block_size,
+                                           use_mem, division_limit,
+                                           age_threshold));
+  }
+  DBUG_RETURN(simple_init_key_cache(keycache, key_cache_block_size, use_mem,
+                                    division_limit, age_threshold));
+}
+
+
+/*
+  Resize a key cache, see simple_resize_key_cache()
+*/
+
+int resize_key_cache(KEY_CACHE *keycache,
+                     st_keycache_thread_var *thread_var,
+                     ulonglong key_cache_block_size,
+                     size_t use_mem, ulonglong division_limit,
+                     ulonglong age_threshold)
+{
+  if (keycache->partitions)
+    return partitioned_resize_key_cache(keycache, thread_var,
+                                        key_cache_block_size, use_mem,
+                                        division_limit, age_threshold);
+  return simple_resize_key_cache(keycache, thread_var, key_cache_block_size,
+                                 use_mem, division_limit, age_threshold);
+}
+
+
+/*
+  Remove key_cache from memory, see simple_end_key_cache()
+*/
+
+void end_key_cache(KEY_CACHE *keycache, my_bool cleanup)
+{
+  uint i;
+
+  if (!keycache->partitions)
+  {
+    simple_end_key_cache(keycache, cleanup);
+    return;
+  }
+
+  for (i= 0; i < keycache->partitions; i++)
+    simple_end_key_cache(keycache->partition_array + i, cleanup);
+  keycache->disk_blocks= -1;
+  keycache->blocks_used= 0;
+  keycache->blocks_unused= 0;
+
+  if (cleanup)
+  {
+    my_free(keycache->partition_array);
+    keycache->partition_array= NULL;
+    keycache->partitions= 0;
+    mysql_mutex_destroy(&keycache->cache_lock);
+    keycache->key_cache_inited= keycache->can_be_used= 0;
+  }
+}
+
+
+/*
+  Read a block of data from a cached file into a buffer,
+  see simple_key_cache_read().
+
+  A partitioned key cache reads every key cache block from its own
+  partition.
+*/
+
+uchar *key_cache_read(KEY_CACHE *keycache,
+                      st_keycache_thread_var *thread_var,
+                      File file, my_off_t filepos, int level,
+                      uchar *buff, uint length,
+                      uint block_length, int return_buffer)
+{
+  uint block_size;
+  uchar *start= buff;
+
+  if (!keycache->partitions)
+    return simple_key_cache_read(keycache, thread_var, file, filepos, level,
+                                 buff, length, block_length, return_buffer);
+
+  partitioned_request_begin(keycache, thread_var);
+  block_size= keycache->key_cache_block_size;
+  do
+  {
+    uint offset= (uint) (filepos % block_size);
+    uint read_length= MY_MIN(length, block_size - offset);
+    KEY_CACHE *partition= get_key_cache_partition(keycache, block_size,
+                                                  file, filepos);
+    if (!simple_key_cache_read(partition, thread_var, file, filepos, level,
+                               buff, read_length, block_length, 0))
+    {
+      start= NULL;
+      break;
+    }
+    filepos+= read_length;
+    buff+= read_length;
+    length-= read_length;
+  } while (length);
+  partitioned_request_end(keycache);
+  return start;
+}
+
+
+/*
+  Insert a block of file data from a buffer into key cache,
+  see simple_key_cache_insert().
+*/
+
+int key_cache_insert(KEY_CACHE *keycache,
+                     st_keycache_thread_var *thread_var,
+                     File file, my_off_t filepos, int level,
+                     uchar *buff, uint length)
+{
+  uint block_size;
+  int error= 0;
+
+  if (!keycache->partitions)
+    return simple_key_cache_insert(keycache, thread_var, file, filepos, level,
+                                   buff, length);
+
+  partitioned_request_begin(keycache, thread_var);
+  block_size= keycache->key_cache_block_size;
+  do
+  {
+    uint offset= (uint) (filepos % block_size);
+    uint read_length= MY_MIN(length, block_size - offset);
+    KEY_CACHE *partition= get_key_cache_partition(keycache, block_size,
+                                                  file, filepos);
+    if ((error= simple_key_cache_insert(partition, thread_var, file, filepos,
+                                        level, buff, read_length)))
+      break;
+    filepos+= read_length;
+    buff+= read_length;
+    length-= read_length;
+  } while (length);
+  partitioned_request_end(keycache);
+  return error;
+}
+
+
+/*
+  Write a buffer into a cached file, see simple_key_cache_write().
+*/
+
+int key_cache_write(KEY_CACHE *keycache,
+                    st_keycache_thread_var *thread_var,
+                    File file, my_off_t filepos, int level,
+                    uchar *buff, uint length,
+                    uint block_length, int dont_write)
+{
+  uint block_size;
+  int error= 0;
+
+  if (!keycache->partitions)
+    return simple_key_cache_write(keycache, thread_var, file, filepos, level,
+                                  buff, length, block_length, dont_write);
+
+  partitioned_request_begin(keycache, thread_var);
+  block_size= keycache->key_cache_block_size;
+  do
+  {
+    uint offset= (uint) (filepos % block_size);
+    uint write_length= MY_MIN(length, block_size - offset);
+    KEY_CACHE *partition= get_key_cache_partition(keycache, block_size,
+                                                  file, filepos);
+    error|= simple_key_cache_write(partition, thread_var, file, filepos,
+                                   level, buff, write_length, block_length,
+                                   dont_write);
+    filepos+= write_length;
+    buff+= write_length;
+    length-= write_length;
+  } while (length);
+  partitioned_request_end(keycache);
+  return error;
+}
+
+
+/*
+  Flush all blocks for a file to disk, see simple_flush_key_blocks().
+*/
+
+int flush_key_blocks(KEY_CACHE *keycache,
+                     st_keycache_thread_var *thread_var,
+                     File file, enum flush_type type)
+{
+  uint i;
+  int res= 0;
+
+  if (!keycache->partitions)
+    return simple_flush_key_blocks(keycache, thread_var, file, type);
+
+  partitioned_request_begin(keycache, thread_var);
+  for (i= 0; i < keycache->partitions; i++)
+    res|= simple_flush_key_blocks(keycache->partition_array + i, thread_var,
+                                  file, type);
+  partitioned_request_end(keycache);
+  return res;
+}
+
+
+/*
+  Sum the statistics of the partitions of a key cache
+
+  SYNOPSIS
+    update_key_cache_stats()
+    keycache    pointer to the key cache
+
+  DESCRIPTION
+    The statistics of a partitioned key cache are counted per partition.
+    This must be called before reading them from the KEY_CACHE, as done
+    for the Key_% status variables. Nothing is done for a key cache that
+    is not partitioned. The partitions are read without locking them.
+*/
+
+void update_key_cache_stats(KEY_CACHE *keycache)
+{
+  uint i;
+  ulong blocks_used= 0, blocks_unused= 0, blocks_changed= 0;
+  ulong global_blocks_changed= 0;
+  ulonglong w_requests= 0, writes= 0, r_requests= 0, reads= 0;
+
+  if (!keycache->partitions)
+    return;
+
+  for (i= 0; i < keycache->partitions; i++)
+  {
+    KEY_CACHE *partition= keycache->partition_array + i;
+    blocks_used+= partition->blocks_used;
+    blocks_unused+= partition->blocks_unused;
+    blocks_changed+= partition->blocks_changed;
+    global_blocks_changed+= partition->global_blocks_changed;
+    w_requests+= partition->global_cache_w_requests;
+    writes+= partition->global_cache_write;
+    r_requests+= partition->global_cache_r_requests;
+    reads+= partition->global_cache_read;
+  }
+  keycache->blocks_used= blocks_used;
+  keycache->blocks_unused= blocks_unused;
+  keycache->blocks_changed= blocks_changed;
+  keycache->global_blocks_changed= global_blocks_changed;
+  keycache->global_cache_w_requests= w_requests;
+  keycache->global_cache_write= writes;
+  keycache->global_cache_r_requests= r_requests;
+  keycache->global_cache_read= reads;
+}
+
+
 /*
   Reset the counters of a key cache.
 
@@ -3987,6 +4559,13 @@ int reset_key_cache_counters(const char *name MY_ATTRIBUTE((unused)),
   }
   DBUG_PRINT("info", ("Resetting counters for key cache %s.", name));
 
+  if (key_cache->partitions)
+  {
+    uint i;
+    for (i= 0; i < key_cache->partitions; i++)
+      reset_key_cache_counters(name, key_cache->partition_array + i);
+  }
+
   key_cache->global_blocks_changed= 0;   /* Key_blocks_not_flushed */
   key_cache->global_cache_r_requests= 0; /* Key_read_requests */
   key_cache->global_cache_read= 0;       /* Key_reads */
@@ -27,10 +27,13 @@
 
 /* Routines to handle mallocing of results which will be freed the same time */
 
-#include <my_global.h>
-#include <my_sys.h>
+#include "mysys_priv.h"
+#include "my_sys.h"
 #include <m_string.h>
 #include "mysys_err.h"
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
 
 static inline my_bool is_mem_available(MEM_ROOT *mem_root, size_t size);
 
@@ -43,6 +46,215 @@ static inline my_bool is_mem_available(MEM_ROOT *mem_root, size_t size);
 #endif
 
 
+/*
+  Process wide pool of free MEM_ROOT blocks.
+
+  Blocks from 4K to 512K are allocated in power of two sizes, and when a
+  memory root releases one it is parked here instead of being returned
+  to malloc. The pool is split in shards, one per CPU where
+  sched_getcpu() is available, so that threads on different CPUs do not
+  contend on the same mutex; a thread whose own shard is empty looks at
+  the others with a trylock before falling back to my_malloc(). Each
+  shard holds at most my_root_pool_size / ROOT_POOL_SHARDS bytes, and
+  the pool is disabled while my_root_pool_size is 0.
+*/
+
+#define ROOT_POOL_SHARDS      16
+#define ROOT_POOL_MIN_SHIFT   12
+#define ROOT_POOL_CLASSES     8
+
+typedef struct st_root_pool_shard
+{
+  native_mutex_t lock;
+  USED_MEM *blocks[ROOT_POOL_CLASSES];
+  size_t bytes;
+  ulonglong hits;
+  ulonglong misses;
+  char pad[64];
+} ROOT_POOL_SHARD;
+
+ulong my_root_pool_size= 0;
+static ROOT_POOL_SHARD root_pool[ROOT_POOL_SHARDS];
+static my_bool root_pool_inited= FALSE;
+
+void my_root_pool_init(void)
+{
+  uint i;
+  if (root_pool_inited)
+    return;
+  for (i= 0; i < ROOT_POOL_SHARDS; i++)
+  {
+    memset(&root_pool[i], 0, sizeof(root_pool[i]));
+    native_mutex_init(&root_pool[i].lock, NULL);
+  }
+  root_pool_inited= TRUE;
+}
+
+void my_root_pool_end(void)
+{
+  uint i, cls;
+  if (!root_pool_inited)
+    return;
+  root_pool_inited= FALSE;
+  for (i= 0; i < ROOT_POOL_SHARDS; i++)
+  {
+    for (cls= 0; cls < ROOT_POOL_CLASSES; cls++)
+    {
+      USED_MEM *next, *old;
+      for (next= root_pool[i].blocks[cls]; next ;)
+      {
+        old= next; next= next->next;
+        my_free(old);
+      }
+    }
+    native_mutex_destroy(&root_pool[i].lock);
+  }
+}
+
+/**
+  Sum the pool counters over all shards, for SHOW STATUS.
+*/
+void my_root_pool_stats(ulonglong *hits, ulonglong *misses, ulonglong *bytes)
+{
+  uint i;
+  *hits= *misses= *bytes= 0;
+  if (!root_pool_inited)
+    return;
+  for (i= 0; i < ROOT_POOL_SHARDS; i++)
+  {
+    native_mutex_lock(&root_pool[i].lock);
+    *hits+= root_pool[i].hits;
+    *misses+= root_pool[i].misses;
+    *bytes+= root_pool[i].bytes;
+    native_mutex_unlock(&root_pool[i].lock);
+  }
+}
+
+/**
+  Size class of a block of the given size, or -1 if the pool does not
+  handle it. With round_up set, sizes are rounded up to the next class,
+  otherwise only exact class sizes qualify. Blocks below the smallest
+  class are left alone so that roots with small blocks do not grow.
+*/
+static inline int root_pool_class(size_t size, my_bool round_up)
+{
+#if defined(PREALLOCATE_MEMORY_CHUNKS)
+  int cls= 0;
+  size_t class_size= (size_t) 1 << ROOT_POOL_MIN_SHIFT;
+
+  if (!root_pool_inited || !my_root_pool_size || size < class_size)
+    return -1;
+  while (class_size < size && cls < ROOT_POOL_CLASSES)
+  {
+    class_size<<= 1;
+    cls++;
+  }
+  if (cls == ROOT_POOL_CLASSES || (!round_up && class_size != size))
+    return -1;
+  return cls;
+#else
+  return -1;
+#endif
+}
+
+static inline ROOT_POOL_SHARD *root_pool_shard(void)
+{
+#ifdef HAVE_SCHED_GETCPU
+  int cpu= sched_getcpu();
+  if (cpu >= 0)
+    return &root_pool[cpu % ROOT_POOL_SHARDS];
+#endif
+  return &root_pool[((((ulonglong) (size_t) my_thread_self()) *
+                      0x9E3779B97F4A7C15ULL) >> 32) % ROOT_POOL_SHARDS];
+}
+
+static USED_MEM *root_pool_get(int cls)
+{
+  ROOT_POOL_SHARD *home= root_pool_shard(), *shard= home;
+  USED_MEM *block= NULL;
+  uint i;
+
+  native_mutex_lock(&home->lock);
+  if ((block= home->blocks[cls]))
+  {
+    home->blocks[cls]= block->next;
+    home->bytes-= block->size;
+    home->hits++;
+  }
+  else
+    home->misses++;
+  native_mutex_unlock(&home->lock);
+
+  for (i= 1; !block && i < ROOT_POOL_SHARDS; i++)
+  {
+    shard= &root_pool[(home - root_pool + i) % ROOT_POOL_SHARDS];
+    if (native_mutex_trylock(&shard->lock))
+      continue;
+    if ((block= shard->blocks[cls]))
+    {
+      shard->blocks[cls]= block->next;
+      shard->bytes-= block->size;
+    }
+    native_mutex_unlock(&shard->lock);
+  }
+  return block;
+}
+
+static my_bool root_pool_put(USED_MEM *block, int cls)
+{
+  ROOT_POOL_SHARD *shard= root_pool_shard();
+  my_bool stored= FALSE;
+
+  native_mutex_lock(&shard->lock);
+  if (shard->bytes + block->size <= my_root_pool_size / ROOT_POOL_SHARDS)
+  {
+    block->next= shard->blocks[cls];
+    shard->blocks[cls]= block;
+    shard->bytes+= block->size;
+    stored= TRUE;
+  }
+  native_mutex_unlock(&shard->lock);
+  return stored;
+}
+
+/**
+  Round a new block size up to what root_block_alloc() will allocate.
+*/
+static inline size_t root_block_size(size_t size)
+{
+  int cls= root_pool_class(size, TRUE);
+  return cls < 0 ? size : (size_t) 1 << (ROOT_POOL_MIN_SHIFT + cls);
+}
+
+static inline USED_MEM *root_block_alloc(MEM_ROOT *mem_root, size_t size)
+{
+  int cls= root_pool_class(size, FALSE);
+  USED_MEM *block;
+
+  if (cls >= 0 && (block= root_pool_get(cls)))
+  {
+    my_memory_rekey(mem_root->m_psi_key, block);
+    return block;
+  }
+  return (USED_MEM*) my_malloc(mem_root->m_psi_key, size,
+                               MYF(MY_WME | ME_FATALERROR));
+}
+
+static void root_block_free(USED_MEM *block)
+{
+  int cls= root_pool_class(block->size, FALSE);
+
+  if (cls >= 0)
+  {
+    /* Pooled blocks belong to nobody until they are taken again */
+    my_memory_rekey(PSI_NOT_INSTRUMENTED, block);
+    if (root_pool_put(block, cls))
+      return;
+  }
+  my_free(block);
+}
+
+
 /*
   Initialize memory root
 
@@ -81,6 +293,8 @@ void init_alloc_root(PSI_memory_key key,
   mem_root->max_capacity= 0;
   mem_root->allocated_size= 0;
   mem_root->error_for_capacity_exceeded= FALSE;
+  mem_root->recycle_limit= 0;
+  mem_root->high_water= 0;
 
 #if defined(PREALLOCATE_MEMORY_CHUNKS)
   if (pre_alloc_size)
@@ -155,7 +369,7 @@ void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
             mem->left= mem->size;
             mem_root->allocated_size-= mem->size;
             TRASH_MEM(mem);
-            my_free(mem);
+            root_block_free(mem);
           }
         }
         else
@@ -278,7 +492,7 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
   {						/* Time to alloc new block */
     block_size= mem_root->block_size * (mem_root->block_num >> 2);
     get_size= length+ALIGN_SIZE(sizeof(USED_MEM));
-    get_size= MY_MAX(get_size, block_size);
+    get_size= root_block_size(MY_MAX(get_size, block_size));
 
     if (!is_mem_available(mem_root, get_size))
     {
@@ -288,8 +502,7 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
       else
         DBUG_RETURN(NULL);
     }
-    if (!(next = (USED_MEM*) my_malloc(mem_root->m_psi_key,
-                                       get_size,MYF(MY_WME | ME_FATALERROR))))
+    if (!(next= root_block_alloc(mem_root, get_size)))
     {
       if (mem_root->error_handler)
 	(*mem_root->error_handler)();
@@ -398,6 +611,57 @@ static inline void mark_blocks_free(MEM_ROOT* root)
   root->first_block_usage= 0;
 }
 
+/*
+  Release what the last round of allocations needed beyond the decaying
+  high-water mark of the root (capped by recycle_limit), and keep the
+  other blocks as free blocks for the next round. The preallocated block
+  is always kept.
+*/
+
+static void recycle_blocks(MEM_ROOT *root)
+{
+  USED_MEM *next, *old, *keep= NULL;
+  USED_MEM *lists[2];
+  size_t keep_size, kept= 0;
+  uint i;
+
+  /* Follow growth at once, shrink by an eighth of the gap per round */
+  if (root->allocated_size >= root->high_water)
+    root->high_water= root->allocated_size;
+  else
+    root->high_water-= (root->high_water - root->allocated_size) / 8;
+  keep_size= MY_MIN(root->high_water, root->recycle_limit);
+
+  lists[0]= root->used;
+  lists[1]= root->free;
+  for (i= 0; i < 2; i++)
+  {
+    for (next= lists[i]; next ;)
+    {
+      old= next; next= next->next;
+      if (old == root->pre_alloc || kept + old->size <= keep_size)
+      {
+        old->left= old->size - (uint)ALIGN_SIZE(sizeof(USED_MEM));
+        TRASH_MEM(old);
+        old->next= keep;
+        keep= old;
+        kept+= old->size;
+      }
+      else
+      {
+        old->left= old->size;
+        TRASH_MEM(old);
+        root_block_free(old);
+      }
+    }
+  }
+  root->used= 0;
+  root->free= keep;
+  root->allocated_size= kept;
+  root->block_num= 4;
+  root->first_block_usage= 0;
+}
+
 void claim_root(MEM_ROOT *root)
 {
   USED_MEM *next,*old;
@@ -431,7 +695,9 @@ void claim_root(MEM_ROOT *root)
 
         MY_MARK_BLOCKS_FREED	Don't free blocks, just mark them free
         MY_KEEP_PREALLOC	If this is not set, then free also the
-        		        preallocated block
+        		        preallocated block. If it is set and the
+                                root has a recycle limit, blocks up to
+                                that limit are kept as well.
 
   NOTES
     One can call this function either with root block initialised with
@@ -450,6 +716,11 @@ void free_root(MEM_ROOT *root, myf MyFlags)
     mark_blocks_free(root);
     DBUG_VOID_RETURN;
   }
+  if ((MyFlags & MY_KEEP_PREALLOC) && root->recycle_limit)
+  {
+    recycle_blocks(root);
+    DBUG_VOID_RETURN;
+  }
   if (!(MyFlags & MY_KEEP_PREALLOC))
     root->pre_alloc=0;
 
@@ -460,7 +731,7 @@ void free_root(MEM_ROOT *root, myf MyFlags)
     {
       old->left= old->size;
       TRASH_MEM(old);
-      my_free(old);
+      root_block_free(old);
     }
   }
   for (next=root->free ; next ;)
@@ -470,7 +741,7 @@ void free_root(MEM_ROOT *root, myf MyFlags)
     {
       old->left= old->size;
       TRASH_MEM(old);
-      my_free(old);
+      root_block_free(old);
     }
   }
   root->used=root->free=0;
@@ -567,3 +838,22 @@ void set_memroot_error_reporting(MEM_ROOT *mem_root, my_bool report_error)
   mem_root->error_for_capacity_exceeded= report_error;
 }
 
+/**
+  Let free_root(MY_KEEP_PREALLOC) keep up to the given number of bytes
+  of blocks for reuse, following the recent high-water mark of the root.
+  Useful for roots that are emptied after every statement. Ignored in
+  builds for Valgrind and ASAN, where every block is freed to catch
+  accesses to released memory.
+
+  @param mem_root        memory root
+  @param size            bytes to keep, 0 to free all but the prealloc block
+*/
+void set_memroot_recycle_limit(MEM_ROOT *mem_root,
+                               size_t size MY_ATTRIBUTE((unused)))
+{
+  assert(alloc_root_inited(mem_root));
+#if defined(PREALLOCATE_MEMORY_CHUNKS)
+  mem_root->recycle_limit= size;
+#endif
+}
+
@@ -33,6 +33,9 @@
 #include <my_sys.h>
 #include <m_string.h>
 #include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 /*
    This replaces the packet with a compressed packet
@@ -149,6 +152,260 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
   DBUG_RETURN(0);
 }
 
+/*
+  After a packet saved less than 1/COMPRESS_POOR_RATIO of its size,
+  COMPRESS_BYPASS_PACKETS packets are sent without trying to compress them.
+*/
+#define COMPRESS_POOR_RATIO 16
+
+/*
+  Create a compression context
+
+   SYNOPSIS
+     my_compress_context_new()
+     algorithm	Algorithm to use
+     level	Compression level, only used by zstd
+
+   RETURN
+     The context, or NULL if out of memory or the algorithm is not
+     available in this build
+*/
+
+COMPRESS_CONTEXT *
+my_compress_context_new(enum enum_compression_algorithm algorithm, int level)
+{
+  COMPRESS_CONTEXT *ctx;
+  DBUG_ENTER("my_compress_context_new");
+
+#ifndef HAVE_ZSTD
+  if (algorithm == MYSQL_ZSTD)
+    DBUG_RETURN(NULL);
+#endif
+
+  if (!(ctx= (COMPRESS_CONTEXT *) my_malloc(key_memory_my_compress_alloc,
+                                            sizeof(COMPRESS_CONTEXT),
+                                            MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(NULL);
+  ctx->algorithm= algorithm;
+  ctx->level= level;
+
+#ifdef HAVE_ZSTD
+  if (algorithm == MYSQL_ZSTD)
+  {
+    ctx->level= MY_MAX(MYSQL_ZSTD_MIN_LEVEL,
+                       MY_MIN(level, MYSQL_ZSTD_MAX_LEVEL));
+    ctx->zstd_cctx= ZSTD_createCCtx();
+    ctx->zstd_dctx= ZSTD_createDCtx();
+    if (!ctx->zstd_cctx || !ctx->zstd_dctx)
+    {
+      my_compress_context_free(ctx);
+      DBUG_RETURN(NULL);
+    }
+  }
+#endif
+  DBUG_RETURN(ctx);
+}
+
+
+void my_compress_context_free(COMPRESS_CONTEXT *ctx)
+{
+  if (!ctx)
+    return;
+#ifdef HAVE_ZSTD
+  ZSTD_freeCCtx((ZSTD_CCtx *) ctx->zstd_cctx);
+  ZSTD_freeDCtx((ZSTD_DCtx *) ctx->zstd_dctx);
+#endif
+  my_free(ctx->buffer);
+  my_free(ctx);
+}
+
+
+/* Make sure the scratch buffer of the context has room for length bytes */
+
+static my_bool compress_context_reserve(COMPRESS_CONTEXT *ctx, size_t length)
+{
+  uchar *buffer;
+  if (length <= ctx->buffer_length)
+    return 0;
+  if (!(buffer= (uchar *) my_malloc(key_memory_my_compress_alloc,
+                                    length, MYF(MY_WME))))
+    return 1;
+  my_free(ctx->buffer);
+  ctx->buffer= buffer;
+  ctx->buffer_length= length;
+  return 0;
+}
+
+
+/*
+  Free a scratch buffer grown beyond COMPRESS_KEEP_BUFFER_LENGTH for a
+  large packet, so that a connection does not keep memory for the
+  largest packet it ever saw.
+*/
+
+static void compress_context_release(COMPRESS_CONTEXT *ctx)
+{
+  if (ctx->buffer_length <= COMPRESS_KEEP_BUFFER_LENGTH)
+    return;
+  my_free(ctx->buffer);
+  ctx->buffer= NULL;
+  ctx->buffer_length= 0;
+}
+
+
+/*
+  This replaces the packet with a compressed packet, using a context
+
+   SYNOPSIS
+     my_compress_ctx()
+     ctx	Compression context of the connection
+     packet	Data to compress. This is is replaced with the compressed data.
+     len	Length of data to compress at 'packet'
+     complen	out: 0 if packet was not compressed
+
+   NOTES
+     Same as my_compress(), but without memory allocation per packet.
+     Packets that do not get smaller by at least 1/COMPRESS_POOR_RATIO
+     make the next COMPRESS_BYPASS_PACKETS packets go out uncompressed
+     without spending CPU on them, as long runs of incompressible data,
+     like already compressed blobs, are common. The scratch buffer is
+     kept between packets only up to COMPRESS_KEEP_BUFFER_LENGTH.
+
+   RETURN
+     1   error. 'len' is not changed'
+     0   ok.  In this case 'len' contains the size of the compressed packet
+*/
+
+my_bool my_compress_ctx(COMPRESS_CONTEXT *ctx, uchar *packet, size_t *len,
+                        size_t *complen)
+{
+  size_t bound, result;
+  DBUG_ENTER("my_compress_ctx");
+
+  if (*len < MIN_COMPRESS_LENGTH || ctx->bypass)
+  {
+    if (ctx->bypass)
+      ctx->bypass--;
+    *complen= 0;
+    DBUG_RETURN(0);
+  }
+
+#ifdef HAVE_ZSTD
+  if (ctx->algorithm == MYSQL_ZSTD)
+    bound= ZSTD_compressBound(*len);
+  else
+#endif
+    bound= compressBound((uLong) *len);
+
+  if (compress_context_reserve(ctx, bound))
+    DBUG_RETURN(1);
+
+#ifdef HAVE_ZSTD
+  if (ctx->algorithm == MYSQL_ZSTD)
+  {
+    result= ZSTD_compressCCtx((ZSTD_CCtx *) ctx->zstd_cctx,
+                              ctx->buffer, bound, packet, *len, ctx->level);
+    if (ZSTD_isError(result))
+    {
+      compress_context_release(ctx);
+      DBUG_RETURN(1);
+    }
+  }
+  else
+#endif
+  {
+    uLongf tmp_complen= (uLongf) bound;
+    if (compress((Bytef*) ctx->buffer, &tmp_complen, (Bytef*) packet,
+                 (uLong) *len) != Z_OK)
+    {
+      compress_context_release(ctx);
+      DBUG_RETURN(1);
+    }
+    result= tmp_complen;
+  }
+
+  if (result + *len / COMPRESS_POOR_RATIO >= *len)
+    ctx->bypass= COMPRESS_BYPASS_PACKETS;
+
+  if (result >= *len)
+  {
+    *complen= 0;
+    DBUG_PRINT("note",("Packet got longer on compression; Not compressed"));
+  }
+  else
+  {
+    memcpy(packet, ctx->buffer, result);
+    *complen= *len;
+    *len= result;
+  }
+  compress_context_release(ctx);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Uncompress packet, using a context
+
+   SYNOPSIS
+     my_uncompress_ctx()
+     ctx	Compression context of the connection
+     packet	Compressed data. This is is replaced with the orignal data.
+     len	Length of compressed data
+     complen	Length of the packet buffer (must be enough for the original
+	        data)
+
+   RETURN
+     1   error
+     0   ok.  In this case 'complen' contains the updated size of the
+              real data.
+*/
+
+my_bool my_uncompress_ctx(COMPRESS_CONTEXT *ctx, uchar *packet, size_t len,
+                          size_t *complen)
+{
+  DBUG_ENTER("my_uncompress_ctx");
+
+  if (!*complen)
+  {
+    *complen= len;
+    DBUG_RETURN(0);
+  }
+
+  if (compress_context_reserve(ctx, *complen))
+    DBUG_RETURN(1);
+
+#ifdef HAVE_ZSTD
+  if (ctx->algorithm == MYSQL_ZSTD)
+  {
+    size_t result= ZSTD_decompressDCtx((ZSTD_DCtx *) ctx->zstd_dctx,
+                                       ctx->buffer, *complen, packet, len);
+    if (ZSTD_isError(result) || result != *complen)
+    {
+      DBUG_PRINT("error",("Can't uncompress packet, error: %s",
+                          ZSTD_getErrorName(result)));
+      compress_context_release(ctx);
+      DBUG_RETURN(1);
+    }
+  }
+  else
+#endif
+  {
+    uLongf tmp_complen= (uLongf) *complen;
+    int error= uncompress((Bytef*) ctx->buffer, &tmp_complen, (Bytef*) packet,
+                          (uLong) len);
+    if (error != Z_OK || tmp_complen != *complen)
+    {
+      DBUG_PRINT("error",("Can't uncompress packet, error: %d",error));
+      compress_context_release(ctx);
+      DBUG_RETURN(1);
+    }
+  }
+
+  memcpy(packet, ctx->buffer, *complen);
+  compress_context_release(ctx);
+  DBUG_RETURN(0);
+}
+
 /*
   Internal representation of the frm blob is:
 
@@ -130,6 +130,8 @@ my_bool my_init()
   if (my_thread_init())
     return TRUE;
 
+  my_root_pool_init();
+
   /* $HOME is needed early to parse configuration files located in ~/ */
   if ((home_dir= getenv("HOME")) != 0)
     home_dir= intern_filename(home_dir_buff, home_dir);
@@ -178,6 +180,7 @@ void my_end(int infoflag)
   free_charsets();
   my_error_unregister_all();
   my_once_free();
+  my_root_pool_end();
 
   if ((infoflag & MY_GIVE_INFO) || (info_file != stderr))
   {
@@ -458,7 +461,7 @@ PSI_stage_info stage_waiting_for_table_level_lock=
 #ifdef HAVE_PSI_INTERFACE
 
 PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
-  key_IO_CACHE_SHARE_mutex, key_KEY_CACHE_cache_lock,
+  key_IO_CACHE_SHARE_mutex, key_IO_CACHE_AIO_mutex, key_KEY_CACHE_cache_lock,
   key_THR_LOCK_charset, key_THR_LOCK_heap,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
@@ -470,6 +473,7 @@ static PSI_mutex_info all_mysys_mutexes[]=
   { &key_BITMAP_mutex, "BITMAP::mutex", 0},
   { &key_IO_CACHE_append_buffer_lock, "IO_CACHE::append_buffer_lock", 0},
   { &key_IO_CACHE_SHARE_mutex, "IO_CACHE::SHARE_mutex", 0},
+  { &key_IO_CACHE_AIO_mutex, "IO_CACHE::AIO_mutex", 0},
   { &key_KEY_CACHE_cache_lock, "KEY_CACHE::cache_lock", 0},
   { &key_THR_LOCK_charset, "THR_LOCK_charset", PSI_FLAG_GLOBAL},
   { &key_THR_LOCK_heap, "THR_LOCK_heap", PSI_FLAG_GLOBAL},
@@ -492,13 +496,14 @@ static PSI_rwlock_info all_mysys_rwlocks[]=
 };
 
 PSI_cond_key key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer,
+  key_IO_CACHE_SHARE_cond_writer, key_IO_CACHE_AIO_cond,
   key_THR_COND_threads;
 
 static PSI_cond_info all_mysys_conds[]=
 {
   { &key_IO_CACHE_SHARE_cond, "IO_CACHE_SHARE::cond", 0},
   { &key_IO_CACHE_SHARE_cond_writer, "IO_CACHE_SHARE::cond_writer", 0},
+  { &key_IO_CACHE_AIO_cond, "IO_CACHE::AIO_cond", 0},
   { &key_THR_COND_threads, "THR_COND_threads", 0}
 };
 
@@ -28,9 +28,14 @@
 #include "mysys_priv.h"
 #include "my_sys.h"
 #include "mysql/psi/mysql_file.h"
+#include "hash.h"
+#include "m_ctype.h"
 
 #include <sys/ipc.h>
 #include <sys/shm.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 
 static uint my_get_large_page_size_int(void);
 static uchar* my_large_malloc_int(size_t size, myf my_flags);
@@ -92,6 +97,246 @@ void my_large_free(uchar* ptr)
   DBUG_VOID_RETURN;
 }
 
+/*
+  Large memory mappings, for the caches of the storage engines.
+
+  my_large_mmap() maps anonymous memory of at least *size bytes, and
+  sets *size to the mapped size, to be passed to my_large_munmap().
+  The memory is zero-filled. It is tried, in this order:
+
+  - MAP_HUGETLB pages of my_large_page_size, if large pages are enabled.
+  - Regular pages aligned to MY_THP_SIZE and madvise(MADV_HUGEPAGE), if
+    my_large_pages_thp is set and the size is at least MY_THP_SIZE, so
+    that the kernel can back them with transparent huge pages.
+  - Regular pages.
+
+  The NUMA policy my_large_pages_numa is then applied to the mapping:
+  pages interleaved over the allowed nodes, or allocated on the node of
+  the thread that touches them first. The memory is pre-faulted if
+  populate or my_large_pages_prefault is set, after the policy is set,
+  so that pre-faulting does not defeat it.
+
+  The mappings are registered, so that my_large_munmap() can keep the
+  per kind statistics my_large_mmap_*_bytes up to date.
+*/
+
+#define MY_THP_SIZE (2UL * 1024 * 1024)
+
+enum large_mapping_kind
+{
+  LARGE_MAPPING_REGULAR, LARGE_MAPPING_HUGETLB, LARGE_MAPPING_THP
+};
+
+typedef struct st_large_mapping
+{
+  void *ptr;
+  size_t size;
+  enum large_mapping_kind kind;
+} LARGE_MAPPING;
+
+/*
+  Registered mappings by address, protected by THR_LOCK_malloc. A hash,
+  as caches may map and unmap many blocks while holding many mappings.
+*/
+static HASH large_mappings;
+
+static ulonglong *large_mapping_counter(enum large_mapping_kind kind)
+{
+  switch (kind)
+  {
+  case LARGE_MAPPING_HUGETLB:
+    return &my_large_mmap_hugetlb_bytes;
+  case LARGE_MAPPING_THP:
+    return &my_large_mmap_thp_bytes;
+  default:
+    return NULL;
+  }
+}
+
+static my_bool register_large_mapping(void *ptr, size_t size,
+                                      enum large_mapping_kind kind)
+{
+  ulonglong *counter= large_mapping_counter(kind);
+  LARGE_MAPPING *mapping;
+
+  if (!(mapping= (LARGE_MAPPING*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                            sizeof(LARGE_MAPPING), MYF(0))))
+    return TRUE;
+  mapping->ptr= ptr;
+  mapping->size= size;
+  mapping->kind= kind;
+
+  mysql_mutex_lock(&THR_LOCK_malloc);
+  if (my_hash_init_opt(&large_mappings, &my_charset_bin, 64,
+                       offsetof(LARGE_MAPPING, ptr), sizeof(void*),
+                       NULL, my_free, 0, PSI_NOT_INSTRUMENTED) ||
+      my_hash_insert(&large_mappings, (uchar*) mapping))
+  {
+    mysql_mutex_unlock(&THR_LOCK_malloc);
+    my_free(mapping);
+    return TRUE;
+  }
+  my_large_mmap_bytes+= size;
+  if (counter)
+    *counter+= size;
+  mysql_mutex_unlock(&THR_LOCK_malloc);
+  return FALSE;
+}
+
+static void unregister_large_mapping(void *ptr)
+{
+  LARGE_MAPPING *mapping;
+
+  mysql_mutex_lock(&THR_LOCK_malloc);
+  if (my_hash_inited(&large_mappings) &&
+      (mapping= (LARGE_MAPPING*) my_hash_search(&large_mappings,
+                                                (uchar*) &ptr,
+                                                sizeof(void*))))
+  {
+    ulonglong *counter= large_mapping_counter(mapping->kind);
+    my_large_mmap_bytes-= mapping->size;
+    if (counter)
+      *counter-= mapping->size;
+    my_hash_delete(&large_mappings, (uchar*) mapping);
+    if (!large_mappings.records)
+      my_hash_free(&large_mappings);
+  }
+  mysql_mutex_unlock(&THR_LOCK_malloc);
+}
+
+/* Map regular pages aligned to MY_THP_SIZE, and advise huge pages */
+
+static void *large_mmap_thp(size_t size)
+{
+  size_t length= size + MY_THP_SIZE;
+  uchar *ptr, *aligned;
+
+  ptr= (uchar*) mmap(NULL, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == (uchar*) MAP_FAILED)
+    return MAP_FAILED;
+
+  /* Unmap the unaligned head and the tail */
+  aligned= (uchar*) MY_ALIGN((size_t) ptr, MY_THP_SIZE);
+  if (aligned != ptr)
+    munmap(ptr, aligned - ptr);
+  if (aligned + size != ptr + length)
+    munmap(aligned + size, ptr + length - (aligned + size));
+
+#ifdef MADV_HUGEPAGE
+  if (madvise(aligned, size, MADV_HUGEPAGE))
+    my_message_local(WARNING_LEVEL, "madvise(MADV_HUGEPAGE) failed,"
+                     " errno %d", errno);
+#endif
+  return aligned;
+}
+
+/* Apply my_large_pages_numa to a fresh mapping */
+
+static void large_mmap_set_numa_policy(void *ptr, size_t size)
+{
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+  unsigned long nodes[16];
+  int mode;
+
+  switch (my_large_pages_numa)
+  {
+  case MY_LARGE_NUMA_INTERLEAVE:
+    memset(nodes, 0, sizeof(nodes));
+    if (syscall(SYS_get_mempolicy, NULL, nodes, sizeof(nodes) * 8, NULL,
+                MPOL_F_MEMS_ALLOWED))
+    {
+      my_message_local(WARNING_LEVEL, "get_mempolicy() failed, errno %d",
+                       errno);
+      return;
+    }
+    mode= MPOL_INTERLEAVE;
+    break;
+  case MY_LARGE_NUMA_LOCAL:
+    /* Preferred with an empty node set means the local node */
+    memset(nodes, 0, sizeof(nodes));
+    mode= MPOL_PREFERRED;
+    break;
+  default:
+    return;
+  }
+
+  if (syscall(SYS_mbind, ptr, size, mode, nodes, sizeof(nodes) * 8, 0))
+    my_message_local(WARNING_LEVEL, "mbind() of %lu bytes failed, errno %d",
+                     (ulong) size, errno);
+#endif
+}
+
+void *my_large_mmap(size_t *size, my_bool populate)
+{
+  size_t page_size= (size_t) my_getpagesize();
+  size_t length;
+  void *ptr= MAP_FAILED;
+  enum large_mapping_kind kind= LARGE_MAPPING_REGULAR;
+  DBUG_ENTER("my_large_mmap");
+
+  if (my_use_large_pages && my_large_page_size)
+  {
+    length= MY_ALIGN(*size, (size_t) my_large_page_size);
+#ifdef MAP_HUGETLB
+    ptr= mmap(NULL, length, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (ptr != MAP_FAILED)
+      kind= LARGE_MAPPING_HUGETLB;
+    else
+      my_message_local(WARNING_LEVEL,
+                       "Failed to allocate %lu bytes from HugeTLB memory,"
+                       " errno %d. Using conventional memory pool",
+                       (ulong) length, errno);
+  }
+
+  if (ptr == MAP_FAILED)
+  {
+    length= MY_ALIGN(*size, page_size);
+    if (my_large_pages_thp && length >= MY_THP_SIZE)
+    {
+      length= MY_ALIGN(length, MY_THP_SIZE);
+      if ((ptr= large_mmap_thp(length)) != MAP_FAILED)
+        kind= LARGE_MAPPING_THP;
+    }
+    else
+      ptr= mmap(NULL, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+
+  if (ptr == MAP_FAILED)
+  {
+    set_my_errno(errno);
+    DBUG_RETURN(NULL);
+  }
+
+  large_mmap_set_numa_policy(ptr, length);
+
+  if (populate || my_large_pages_prefault)
+  {
+    volatile uchar *pos;
+    for (pos= (uchar*) ptr; pos < (uchar*) ptr + length; pos+= page_size)
+      *pos= 0;
+  }
+
+  if (register_large_mapping(ptr, length, kind))
+  {
+    munmap(ptr, length);
+    set_my_errno(ENOMEM);
+    DBUG_RETURN(NULL);
+  }
+  *size= length;
+  DBUG_RETURN(ptr);
+}
+
+int my_large_munmap(void *ptr, size_t size)
+{
+  DBUG_ENTER("my_large_munmap");
+  unregister_large_mapping(ptr);
+  DBUG_RETURN(munmap(ptr, size));
+}
+
 /* Linux-specific function to determine the size of large pages */
 
 uint my_get_large_page_size_int(void)
@@ -129,6 +129,21 @@ void my_claim(void *ptr)
   mh->m_key= PSI_MEMORY_CALL(memory_claim)(mh->m_key, mh->m_size, & mh->m_owner);
 }
 
+/**
+  Account a live block to another memory key, as if it had been freed
+  and allocated again. Used when MEM_ROOT blocks move through the
+  shared block pool.
+*/
+void my_memory_rekey(PSI_memory_key key, void *ptr)
+{
+  my_memory_header *mh;
+
+  mh= USER_TO_HEADER(ptr);
+  assert(mh->m_magic == MAGIC);
+  PSI_MEMORY_CALL(memory_free)(mh->m_key, mh->m_size, mh->m_owner);
+  mh->m_key= PSI_MEMORY_CALL(memory_alloc)(key, mh->m_size, & mh->m_owner);
+}
+
 void my_free(void *ptr)
 {
   my_memory_header *mh;
@@ -166,6 +181,12 @@ void my_claim(void *ptr MY_ATTRIBUTE((unused)))
   /* Empty */
 }
 
+void my_memory_rekey(PSI_memory_key key MY_ATTRIBUTE((unused)),
+                     void *ptr MY_ATTRIBUTE((unused)))
+{
+  /* Empty */
+}
+
 void my_free(void *ptr)
 {
   my_raw_free(ptr);
@@ -90,6 +90,12 @@ uint	  my_once_extra=ONCE_ALLOC_INIT;	/* Memory to alloc / block */
 #ifdef HAVE_LINUX_LARGE_PAGES
 my_bool my_use_large_pages= 0;
 uint    my_large_page_size= 0;
+my_bool my_large_pages_thp= 0;
+ulong   my_large_pages_numa= MY_LARGE_NUMA_DEFAULT;
+my_bool my_large_pages_prefault= 0;
+ulonglong my_large_mmap_bytes= 0;
+ulonglong my_large_mmap_hugetlb_bytes= 0;
+ulonglong my_large_mmap_thp_bytes= 0;
 #endif
 
 	/* from errors.c */
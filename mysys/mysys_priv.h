@@ -39,7 +39,7 @@
 C_MODE_START
 
 extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
-  key_IO_CACHE_SHARE_mutex, key_KEY_CACHE_cache_lock,
+  key_IO_CACHE_SHARE_mutex, key_IO_CACHE_AIO_mutex, key_KEY_CACHE_cache_lock,
   key_THR_LOCK_charset, key_THR_LOCK_heap,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
@@ -49,7 +49,7 @@ extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
 extern PSI_rwlock_key key_SAFE_HASH_lock;
 
 extern PSI_cond_key key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer,
+  key_IO_CACHE_SHARE_cond_writer, key_IO_CACHE_AIO_cond,
   key_THR_COND_threads;
 
 #endif /* HAVE_PSI_INTERFACE */
@@ -113,6 +113,7 @@ C_MODE_END
 #endif
 
 void my_error_unregister_all(void);
+void my_memory_rekey(PSI_memory_key key, void *ptr);
 
 #ifdef _WIN32
 #include <sys/stat.h>
@@ -21,11 +21,42 @@
 #include "audit_log.h"
 #include <my_atomic.h>
 
+/*
+  The buffer is a ring of size bytes addressed by monotonically growing
+  positions. Writers don't take the mutex: a record is placed by
+  reserving [write_pos, write_pos + len) with compare-and-swap, copying
+  it in and then publishing it by advancing commit_pos, which writers do
+  in reservation order. Only the flush worker reads the committed range
+  and advances flush_pos. The mutex serializes the flush worker with
+  audit_log_buffer_pause() and lets writers wait for free space when the
+  buffer is full.
+
+  A writer whose turn to publish does not come after a short spin
+  sleeps on committed_cond, under commit_mutex, until commit_pos reaches
+  its position. commit_waiters tells publishers whether anybody sleeps.
+*/
+
+/* Busy-wait rounds before a writer sleeps waiting for its turn */
+#define AUDIT_LOG_COMMIT_SPINS 200
+
+#if defined(HAVE_PAUSE_INSTRUCTION)
+#define AUDIT_LOG_RELAX_CPU() __asm__ __volatile__ ("pause")
+#elif defined(HAVE_FAKE_PAUSE_INSTRUCTION)
+#define AUDIT_LOG_RELAX_CPU() __asm__ __volatile__ ("rep; nop")
+#elif defined(_WIN32)
+#define AUDIT_LOG_RELAX_CPU() YieldProcessor()
+#else
+#define AUDIT_LOG_RELAX_CPU() __asm__ __volatile__ ("":::"memory")
+#endif
+
 struct audit_log_buffer {
   char *buf;
   size_t size;
-  size_t write_pos;
-  size_t flush_pos;
+  volatile int64 write_pos;
+  volatile int64 commit_pos;
+  volatile int64 flush_pos;
+  volatile int32 flush_requested;
+  volatile int32 commit_waiters;
   pthread_t flush_worker_thread;
   int stop;
   int drop_if_full;
@@ -34,19 +65,25 @@ struct audit_log_buffer {
   mysql_mutex_t mutex;
   mysql_cond_t flushed_cond;
   mysql_cond_t written_cond;
+  mysql_mutex_t commit_mutex;
+  mysql_cond_t committed_cond;
   log_record_state_t state;
 };
 
 #if defined(HAVE_PSI_INTERFACE)
 /* These belong to the service initialization */
-static PSI_mutex_key key_log_mutex;
+static PSI_mutex_key key_log_mutex, key_log_commit_mutex;
 static PSI_mutex_info mutex_key_list[]=
-{{ &key_log_mutex, "audit_log_buffer::mutex", PSI_FLAG_GLOBAL}};
+{{ &key_log_mutex, "audit_log_buffer::mutex", PSI_FLAG_GLOBAL},
+ { &key_log_commit_mutex, "audit_log_buffer::commit_mutex", PSI_FLAG_GLOBAL}};
 
-static PSI_cond_key key_log_written_cond, key_log_flushed_cond;
+static PSI_cond_key key_log_written_cond, key_log_flushed_cond,
+                    key_log_committed_cond;
 static PSI_cond_info cond_key_list[]=
 {{ &key_log_written_cond, "audit_log_buffer::written_cond", PSI_FLAG_GLOBAL },
- { &key_log_flushed_cond, "audit_log_buffer::flushed_cond", PSI_FLAG_GLOBAL }};
+ { &key_log_flushed_cond, "audit_log_buffer::flushed_cond", PSI_FLAG_GLOBAL },
+ { &key_log_committed_cond, "audit_log_buffer::committed_cond",
+   PSI_FLAG_GLOBAL }};
 
 #endif
 
@@ -58,8 +95,12 @@ static PSI_cond_info cond_key_list[]=
 static
 void audit_log_flush(audit_log_buffer_t *log)
 {
+  int64 flush_pos, commit_pos;
+  size_t flush_offs, flushlen;
+
   mysql_mutex_lock(&log->mutex);
-  while (log->flush_pos == log->write_pos)
+  flush_pos= my_atomic_load64(&log->flush_pos);
+  while ((commit_pos= my_atomic_load64(&log->commit_pos)) == flush_pos)
   {
     struct timespec abstime;
     if (log->stop)
@@ -70,32 +111,31 @@ void audit_log_flush(audit_log_buffer_t *log)
     set_timespec(&abstime, 1);
     mysql_cond_timedwait(&log->written_cond, &log->mutex, &abstime);
   }
-
-  if (log->flush_pos >= log->write_pos % log->size)
+  my_atomic_store32(&log->flush_requested, 0);
+
+  /*
+    Write out everything committed so far, up to the end of the ring.
+    A range which wraps around is written in two passes, the record
+    crossing the end of the ring is incomplete after the first one.
+  */
+  flush_offs= (size_t) (flush_pos % log->size);
+  flushlen= (size_t) (commit_pos - flush_pos);
+  if (flushlen > log->size - flush_offs)
   {
-    log->state = (log->write_pos % log->size == 0)
-                    ? LOG_RECORD_COMPLETE : LOG_RECORD_INCOMPLETE;
-    mysql_mutex_unlock(&log->mutex);
-    log->write_func(log->write_func_data,
-                    log->buf + log->flush_pos,
-                    log->size - log->flush_pos,
-                    log->state);
-    mysql_mutex_lock(&log->mutex);
-    log->flush_pos= 0;
-    log->write_pos%= log->size;
+    flushlen= log->size - flush_offs;
+    log->state= LOG_RECORD_INCOMPLETE;
   }
   else
-  {
-    size_t flushlen= log->write_pos - log->flush_pos;
-    mysql_mutex_unlock(&log->mutex);
-    log->write_func(log->write_func_data,
-                    log->buf + log->flush_pos, flushlen,
-                    LOG_RECORD_COMPLETE);
-    mysql_mutex_lock(&log->mutex);
-    log->flush_pos+= flushlen;
     log->state= LOG_RECORD_COMPLETE;
-  }
-  assert(log->write_pos >= log->flush_pos);
+
+  mysql_mutex_unlock(&log->mutex);
+  log->write_func(log->write_func_data,
+                  log->buf + flush_offs, flushlen,
+                  log->state);
+  mysql_mutex_lock(&log->mutex);
+
+  my_atomic_store64(&log->flush_pos, flush_pos + flushlen);
+  assert(my_atomic_load64(&log->commit_pos) >= flush_pos + (int64) flushlen);
   mysql_cond_broadcast(&log->flushed_cond);
   mysql_mutex_unlock(&log->mutex);
 }
@@ -107,7 +147,8 @@ void *audit_log_flush_worker(void *arg)
   audit_log_buffer_t *log= (audit_log_buffer_t*) arg;
 
   my_thread_init();
-  while (!(log->stop && log->flush_pos == log->write_pos))
+  while (!(log->stop && my_atomic_load64(&log->flush_pos) ==
+                        my_atomic_load64(&log->commit_pos)))
   {
     audit_log_flush(log);
   }
@@ -143,6 +184,9 @@ audit_log_buffer_t *audit_log_buffer_init(size_t size, int drop_if_full,
     mysql_mutex_init(key_log_mutex, &log->mutex, MY_MUTEX_INIT_FAST);
     mysql_cond_init(key_log_flushed_cond, &log->flushed_cond);
     mysql_cond_init(key_log_written_cond, &log->written_cond);
+    mysql_mutex_init(key_log_commit_mutex, &log->commit_mutex,
+                     MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_log_committed_cond, &log->committed_cond);
     pthread_create(&log->flush_worker_thread, NULL,
                             audit_log_flush_worker, log);
 
@@ -160,6 +204,8 @@ void audit_log_buffer_shutdown(audit_log_buffer_t *log)
   mysql_cond_destroy(&log->flushed_cond);
   mysql_cond_destroy(&log->written_cond);
   mysql_mutex_destroy(&log->mutex);
+  mysql_cond_destroy(&log->committed_cond);
+  mysql_mutex_destroy(&log->commit_mutex);
 
   my_free(log);
 }
@@ -181,11 +227,81 @@ void audit_log_buffer_resume(audit_log_buffer_t *log)
 }
 
 
+/**
+  Wait until the flush worker frees enough space for len bytes
+  after write position pos, or the buffer is shut down.
+*/
+
+static
+void audit_log_buffer_wait_space(audit_log_buffer_t *log, int64 pos,
+                                 size_t len)
+{
+  mysql_mutex_lock(&log->mutex);
+  while (pos + (int64) len > my_atomic_load64(&log->flush_pos) +
+                             (int64) log->size && !log->stop)
+  {
+    mysql_cond_signal(&log->written_cond);
+    mysql_cond_wait(&log->flushed_cond, &log->mutex);
+  }
+  mysql_mutex_unlock(&log->mutex);
+}
+
+
+/**
+  Wait until all the records reserved before position pos are published,
+  so that the flush worker never sees a gap. Writers are only a memcpy()
+  apart, so spin a little before going to sleep.
+*/
+
+static
+void audit_log_buffer_wait_commit(audit_log_buffer_t *log, int64 pos)
+{
+  uint spins;
+
+  for (spins= 0; spins < AUDIT_LOG_COMMIT_SPINS; spins++)
+  {
+    if (my_atomic_load64(&log->commit_pos) == pos)
+      return;
+    AUDIT_LOG_RELAX_CPU();
+  }
+
+  mysql_mutex_lock(&log->commit_mutex);
+  /* Announce the sleeper before checking, see audit_log_buffer_commit() */
+  my_atomic_add32(&log->commit_waiters, 1);
+  while (my_atomic_load64(&log->commit_pos) != pos)
+    mysql_cond_wait(&log->committed_cond, &log->commit_mutex);
+  my_atomic_add32(&log->commit_waiters, -1);
+  mysql_mutex_unlock(&log->commit_mutex);
+}
+
+
+/**
+  Publish the record ending at position end and wake up the writers
+  sleeping for their turn, if any.
+*/
+
+static
+void audit_log_buffer_commit(audit_log_buffer_t *log, int64 end)
+{
+  my_atomic_store64(&log->commit_pos, end);
+  if (my_atomic_load32(&log->commit_waiters) > 0)
+  {
+    mysql_mutex_lock(&log->commit_mutex);
+    mysql_cond_broadcast(&log->committed_cond);
+    mysql_mutex_unlock(&log->commit_mutex);
+  }
+}
+
+
 int audit_log_buffer_write(audit_log_buffer_t *log, const char *buf, size_t len)
 {
+  int64 pos;
+  size_t offs, wrlen;
+
   DBUG_EXECUTE_IF("audit_log_write_full_buffer", {
     if (len > log->size) {
-      len = log->size - log->write_pos;
+      len = log->size - (size_t) (my_atomic_load64(&log->write_pos) %
+                                  log->size);
     }
     else {
       return 0;
@@ -205,31 +321,44 @@ int audit_log_buffer_write(audit_log_buffer_t *log, const char *buf, size_t len)
     return(0);
   }
 
-  mysql_mutex_lock(&log->mutex);
-loop:
-  if (log->write_pos + len <= log->flush_pos + log->size)
-  {
-    size_t wrlen= min(len, log->size -
-                              (log->write_pos % log->size));
-    memcpy(log->buf + (log->write_pos % log->size), buf, wrlen);
-    if (wrlen < len)
-      memcpy(log->buf, buf + wrlen, len - wrlen);
-    log->write_pos= log->write_pos + len;
-    assert(log->write_pos >= log->flush_pos);
-  }
-  else
+  /* Reserve space for the record */
+  pos= my_atomic_load64(&log->write_pos);
+  for (;;)
   {
-    if (!log->drop_if_full)
+    if (pos + (int64) len > my_atomic_load64(&log->flush_pos) +
+                            (int64) log->size)
     {
-      mysql_cond_wait(&log->flushed_cond, &log->mutex);
-      goto loop;
+      if (log->drop_if_full)
+        return(0);
+      audit_log_buffer_wait_space(log, pos, len);
+      if (log->stop)
+        return(0);
+      pos= my_atomic_load64(&log->write_pos);
+      continue;
     }
+    if (my_atomic_cas64(&log->write_pos, &pos, pos + len))
+      break;
   }
-  if (log->write_pos > log->flush_pos + log->size / 2)
+
+  offs= (size_t) (pos % log->size);
+  wrlen= min(len, log->size - offs);
+  memcpy(log->buf + offs, buf, wrlen);
+  if (wrlen < len)
+    memcpy(log->buf, buf + wrlen, len - wrlen);
+
+  audit_log_buffer_wait_commit(log, pos);
+  audit_log_buffer_commit(log, pos + len);
+
+  /* Wake the flush worker up once the buffer gets half full */
+  if (pos + (int64) len > my_atomic_load64(&log->flush_pos) +
+                          (int64) log->size / 2 &&
+      !my_atomic_load32(&log->flush_requested) &&
+      my_atomic_fas32(&log->flush_requested, 1) == 0)
   {
+    mysql_mutex_lock(&log->mutex);
     mysql_cond_signal(&log->written_cond);
+    mysql_mutex_unlock(&log->mutex);
   }
-  mysql_mutex_unlock(&log->mutex);
 
   return(0);
 }
@@ -27,6 +27,7 @@
 
 
 ulong opt_query_response_time_range_base= QRT_DEFAULT_BASE;
+ulong opt_query_response_time_hdr_precision= QRT_DEFAULT_HDR_PRECISION;
 static my_bool opt_query_response_time_stats= FALSE;
 static my_bool opt_query_response_time_flush= FALSE;
 
@@ -74,6 +75,14 @@ static MYSQL_SYSVAR_ULONG(range_base, opt_query_response_time_range_base,
        "WARNING: change of this variable take effect only after next "
        "FLUSH QUERY_RESPONSE_TIME execution.",
        NULL, NULL, QRT_DEFAULT_BASE, 2, QRT_MAXIMUM_BASE, 1);
+static MYSQL_SYSVAR_ULONG(hdr_precision,
+       opt_query_response_time_hdr_precision,
+       PLUGIN_VAR_RQCMDARG,
+       "Number of significant decimal digits of query times kept for "
+       "INFORMATION_SCHEMA.QUERY_RESPONSE_TIME_PERCENTILES. "
+       "WARNING: change of this variable take effect only after next "
+       "FLUSH QUERY_RESPONSE_TIME execution.",
+       NULL, NULL, QRT_DEFAULT_HDR_PRECISION, 1, QRT_MAXIMUM_HDR_PRECISION, 1);
 static MYSQL_SYSVAR_BOOL(stats, opt_query_response_time_stats,
        PLUGIN_VAR_OPCMDARG,
        "Enable and disable collection of query times.",
@@ -110,6 +119,7 @@ static MYSQL_THDVAR_ENUM(session_stats, PLUGIN_VAR_RQCMDARG,
 static struct st_mysql_sys_var *query_response_time_info_vars[]=
 {
   MYSQL_SYSVAR(range_base),
+  MYSQL_SYSVAR(hdr_precision),
   MYSQL_SYSVAR(stats),
   MYSQL_SYSVAR(flush),
 #ifndef NDEBUG
@@ -147,6 +157,40 @@ ST_FIELD_INFO query_response_time_fields_info[] =
 };
 
 
+ST_FIELD_INFO query_response_time_percentiles_fields_info[] =
+{
+  { "QUERY_TYPE",
+    5,
+    MYSQL_TYPE_STRING,
+    0,
+    0,
+    "",
+    SKIP_OPEN_TABLE },
+  { "PERCENTILE",
+    7,
+    MYSQL_TYPE_DOUBLE,
+    0,
+    0,
+    "",
+    SKIP_OPEN_TABLE },
+  { "COUNT",
+    MY_INT64_NUM_DECIMAL_DIGITS,
+    MYSQL_TYPE_LONGLONG,
+    0,
+    MY_I_S_UNSIGNED,
+    "",
+    SKIP_OPEN_TABLE },
+  { "TIME",
+    QRT_TIME_STRING_LENGTH,
+    MYSQL_TYPE_STRING,
+    0,
+    0,
+    "",
+    SKIP_OPEN_TABLE },
+  { 0, 0, MYSQL_TYPE_NULL, 0, 0, 0, 0 }
+};
+
+
 static int query_response_time_info_init(void *p)
 {
   ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
@@ -168,6 +212,16 @@ static int query_response_time_info_init(void *p)
   return 0;
 }
 
+static int query_response_time_percentiles_init(void *p)
+{
+  ST_SCHEMA_TABLE *i_s_query_response_time= (ST_SCHEMA_TABLE *) p;
+  i_s_query_response_time->fields_info=
+    query_response_time_percentiles_fields_info;
+  i_s_query_response_time->fill_table= query_response_time_fill_percentiles;
+  query_response_time_init();
+  return 0;
+}
+
 static int query_response_time_info_init_main(void *p)
 {
   int res= query_response_time_info_init(p);
@@ -321,6 +375,21 @@ mysql_declare_plugin(query_response_time)
   (void *)"1.0",
   0,
 },
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &query_response_time_info_descriptor,
+  "QUERY_RESPONSE_TIME_PERCENTILES",
+  "Percona and Sergey Vojtovich",
+  "Query Response Time Percentiles INFORMATION_SCHEMA Plugin",
+  PLUGIN_LICENSE_GPL,
+  query_response_time_percentiles_init,
+  query_response_time_info_deinit,
+  0x0100,
+  NULL,
+  NULL,
+  (void *)"1.0",
+  0,
+},
 {
   MYSQL_AUDIT_PLUGIN,
   &query_response_time_audit_descriptor,
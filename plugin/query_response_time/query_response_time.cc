@@ -22,6 +22,10 @@
 #include "sql_show.h"
 #include "query_response_time.h"
 
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
+
 #define TIME_STRING_POSITIVE_POWER_LENGTH QRT_TIME_STRING_POSITIVE_POWER_LENGTH
 #define TIME_STRING_NEGATIVE_POWER_LENGTH 6
 #define TOTAL_STRING_POSITIVE_POWER_LENGTH QRT_TOTAL_STRING_POSITIVE_POWER_LENGTH
@@ -81,6 +85,29 @@
 
 #define MILLION ((unsigned long)1000 * 1000)
 
+/*
+  Statistics are accumulated in per-CPU shards, so that concurrent
+  queries don't bounce the same cache lines between CPUs and sockets,
+  and are summed up when the INFORMATION_SCHEMA tables are filled.
+*/
+#define SHARD_COUNT 16
+
+/*
+  High dynamic range histogram of query times in microseconds. Values
+  below 2 ^ HDR_MAX_VALUE_BITS (about 12 days) are recorded with the
+  configured number of significant decimal digits, larger ones go to
+  an overflow bucket after the others. HDR_MAX_SUB_BUCKET_BITS is
+  enough for QRT_MAXIMUM_HDR_PRECISION digits.
+*/
+#define HDR_MAX_VALUE_BITS 40
+#define HDR_MAX_SUB_BUCKET_BITS 8
+#define HDR_MAX_BUCKET_COUNT \
+  (((HDR_MAX_VALUE_BITS - HDR_MAX_SUB_BUCKET_BITS + 2) << \
+    (HDR_MAX_SUB_BUCKET_BITS - 1)) + 1)
+
+/* Percentile value of queries in the overflow bucket */
+#define HDR_OVERFLOW_VALUE (~0ULL)
+
 namespace query_response_time
 {
 
@@ -159,56 +186,208 @@ void print_time(char* buffer, std::size_t buffer_size, const char* format,
   my_snprintf(buffer, buffer_size, format, second, microsecond);
 }
 
+/*
+  Layout of the high dynamic range histogram: values below
+  2 ^ sub_bucket_bits are counted exactly, above that every power
+  of two range is split into 2 ^ (sub_bucket_bits - 1) buckets. The
+  last bucket counts the values of HDR_MAX_VALUE_BITS bits and more.
+*/
+class hdr_layout
+{
+public:
+  hdr_layout() : m_precision(0)
+  {
+    setup(QRT_DEFAULT_HDR_PRECISION);
+  }
+public:
+  uint precision()      const { return m_precision; }
+  uint bucket_count()   const { return m_bucket_count; }
+  uint overflow_index() const { return m_bucket_count - 1; }
+public:
+  void setup(uint precision)
+  {
+    /* Smallest power of two above 2 * 10 ^ precision */
+    static const uint bits[]= { 0, 5, 8 };
+    assert(precision >= 1 && precision < array_elements(bits));
+    m_precision= precision;
+    m_sub_bucket_bits= bits[precision];
+    m_bucket_count= ((HDR_MAX_VALUE_BITS - m_sub_bucket_bits + 2) <<
+                     (m_sub_bucket_bits - 1)) + 1;
+    assert(m_bucket_count <= HDR_MAX_BUCKET_COUNT);
+  }
+  uint index(ulonglong value) const
+  {
+    if (value < (1ULL << m_sub_bucket_bits))
+      return static_cast<uint>(value);
+    if (value >> HDR_MAX_VALUE_BITS)
+      return overflow_index();
+    uint shift= log2(value) - m_sub_bucket_bits + 1;
+    return (shift << (m_sub_bucket_bits - 1)) +
+           static_cast<uint>(value >> shift);
+  }
+  /* Highest value counted in the bucket */
+  ulonglong highest_value(uint index) const
+  {
+    if (index == overflow_index())
+      return HDR_OVERFLOW_VALUE;
+    if (index < (1U << m_sub_bucket_bits))
+      return index;
+    uint shift= (index >> (m_sub_bucket_bits - 1)) - 1;
+    ulonglong mantissa= index - (shift << (m_sub_bucket_bits - 1));
+    return ((mantissa + 1) << shift) - 1;
+  }
+private:
+  static uint log2(ulonglong value)
+  {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    uint result= 0;
+    while (value >>= 1)
+      result++;
+    return result;
+#endif
+  }
+private:
+  uint m_precision;
+  uint m_sub_bucket_bits;
+  uint m_bucket_count;
+};
+
 class time_collector
 {
 public:
-  time_collector(utility& u) : m_utility(&u)
+  time_collector(utility& u, hdr_layout& h) : m_utility(&u), m_hdr(&h)
   {
   }
   uint32 count(QUERY_TYPE type, uint index)
   {
-    return my_atomic_load32((int32*)&m_count[type][index]);
+    if (type == ANY)
+      return count(READ, index) + count(WRITE, index);
+    uint32 result= 0;
+    for (uint i= 0; i < SHARD_COUNT; ++i)
+      result+= my_atomic_load32(
+                 (int32*)&m_shard[i].m_count[type - READ][index]);
+    return result;
   }
   uint64 total(QUERY_TYPE type, uint index)
   {
-    return my_atomic_load64((int64*)&m_total[type][index]);
+    if (type == ANY)
+      return total(READ, index) + total(WRITE, index);
+    uint64 result= 0;
+    for (uint i= 0; i < SHARD_COUNT; ++i)
+      result+= my_atomic_load64(
+                 (int64*)&m_shard[i].m_total[type - READ][index]);
+    return result;
+  }
+  ulonglong hdr_count(QUERY_TYPE type, uint index)
+  {
+    if (type == ANY)
+      return hdr_count(READ, index) + hdr_count(WRITE, index);
+    ulonglong result= 0;
+    for (uint i= 0; i < SHARD_COUNT; ++i)
+      result+= my_atomic_load64(
+                 (int64*)&m_shard[i].m_hdr[type - READ][index]);
+    return result;
   }
 public:
   void flush()
   {
-    memset((void*)&m_count,0,sizeof(m_count));
-    memset((void*)&m_total,0,sizeof(m_total));
+    memset((void*)&m_shard,0,sizeof(m_shard));
   }
   void collect(QUERY_TYPE type, uint64 time)
   {
+    record(type, time, current_shard());
+  }
+  /* Record in the given shard, for unit tests */
+  void collect(QUERY_TYPE type, uint64 time, uint shard_number)
+  {
+    record(type, time, &m_shard[shard_number % SHARD_COUNT]);
+  }
+  /*
+    Values at the given increasing percentiles of the query times, as
+    the highest value of their histogram bucket, or HDR_OVERFLOW_VALUE.
+    counts must have room for the buckets of the histogram. Returns the
+    number of queries.
+  */
+  ulonglong percentiles(QUERY_TYPE type, const double *percentiles,
+                        uint percentile_count, ulonglong *values,
+                        ulonglong *counts)
+  {
+    uint bucket_count= m_hdr->bucket_count();
+
+    /* Take a snapshot first so that percentiles are consistent */
+    ulonglong total_count= 0;
+    for (uint i= 0; i < bucket_count; ++i)
+    {
+      counts[i]= hdr_count(type, i);
+      total_count+= counts[i];
+    }
+
+    ulonglong seen= 0;
+    uint bucket= 0;
+    for (uint p= 0; p < percentile_count; ++p)
+    {
+      /* Rank of the first query at or above the percentile */
+      ulonglong rank=
+        static_cast<ulonglong>(percentiles[p] * total_count / 100.0 + 0.5);
+      if (rank == 0)
+        rank= 1;
+      while (bucket < bucket_count - 1 && seen + counts[bucket] < rank)
+        seen+= counts[bucket++];
+      values[p]= total_count ? m_hdr->highest_value(bucket) : 0;
+    }
+    return total_count;
+  }
+private:
+  struct shard
+  {
+    /*
+     The first row is for 'read' queries,
+     the second row is for 'write' queries.
+     Overall statistics are the sum of both.
+    */
+    uint32   m_count[2][OVERALL_POWER_COUNT + 1];
+    uint64   m_total[2][OVERALL_POWER_COUNT + 1];
+    uint64   m_hdr[2][HDR_MAX_BUCKET_COUNT];
+    /* Keep neighbour shards off each other's cache lines */
+    char     m_pad[64];
+  };
+  shard *current_shard()
+  {
+#ifdef HAVE_SCHED_GETCPU
+    int cpu= sched_getcpu();
+    if (cpu >= 0)
+      return &m_shard[cpu % SHARD_COUNT];
+#endif
+    return &m_shard[((((ulonglong) (size_t) my_thread_self()) *
+                      0x9E3779B97F4A7C15ULL) >> 32) % SHARD_COUNT];
+  }
+  void record(QUERY_TYPE type, uint64 time, shard *sh)
+  {
+    assert(type == READ || type == WRITE);
     int i= 0;
     for(int count= m_utility->bound_count(); count > i; ++i)
     {
       if(m_utility->bound(i) > time)
       {
-        my_atomic_add32((int32*)(&m_count[0][i]), 1);
-        my_atomic_add64((int64*)(&m_total[0][i]), time);
-        my_atomic_add32((int32*)(&m_count[type][i]), 1);
-        my_atomic_add64((int64*)(&m_total[type][i]), time);
+        my_atomic_add32((int32*)(&sh->m_count[type - READ][i]), 1);
+        my_atomic_add64((int64*)(&sh->m_total[type - READ][i]), time);
         break;
       }
     }
+    my_atomic_add64((int64*)(&sh->m_hdr[type - READ][m_hdr->index(time)]), 1);
   }
 private:
-  utility* m_utility;
-  /*
-   The first row is for overall statistics,
-   the second row is for 'read' queries,
-   the third row is for 'write' queries.
-  */
-  uint32   m_count[3][OVERALL_POWER_COUNT + 1];
-  uint64   m_total[3][OVERALL_POWER_COUNT + 1];
+  utility*   m_utility;
+  hdr_layout* m_hdr;
+  shard      m_shard[SHARD_COUNT];
 };
 
 class collector
 {
 public:
-  collector() : m_time(m_utility)
+  collector() : m_time(m_utility, m_hdr)
   {
     m_utility.setup(DEFAULT_BASE);
     m_time.flush();
@@ -217,6 +396,7 @@ public:
   void flush()
   {
     m_utility.setup(opt_query_response_time_range_base);
+    m_hdr.setup(opt_query_response_time_hdr_precision);
     m_time.flush();
   }
   int fill(QUERY_TYPE type,
@@ -252,6 +432,52 @@ public:
     }
     DBUG_RETURN(0);
   }
+  int fill_percentiles(THD* thd, TABLE_LIST *tables, COND *cond)
+  {
+    DBUG_ENTER("fill_schema_query_response_time_percentiles");
+    static const char *type_names[]= { "ALL", "READ", "WRITE" };
+    static const double percentiles[]=
+      { 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 99.99, 100.0 };
+    TABLE        *table= static_cast<TABLE*>(tables->table);
+    Field        **fields= table->field;
+    ulonglong    values[array_elements(percentiles)];
+    ulonglong    *counts= static_cast<ulonglong*>(
+                   my_malloc(PSI_NOT_INSTRUMENTED,
+                             m_hdr.bucket_count() * sizeof(ulonglong),
+                             MYF(MY_WME)));
+    int          result= 0;
+
+    if (counts == NULL)
+      DBUG_RETURN(1);
+
+    for (uint type= ANY; type <= WRITE && !result; ++type)
+    {
+      ulonglong total_count=
+        m_time.percentiles(static_cast<QUERY_TYPE>(type), percentiles,
+                           array_elements(percentiles), values, counts);
+      for (uint p= 0; p < array_elements(percentiles) && !result; ++p)
+      {
+        char time[TIME_STRING_BUFFER_LENGTH];
+        if (values[p] == HDR_OVERFLOW_VALUE)
+        {
+          assert(sizeof(TIME_OVERFLOW) <= TIME_STRING_BUFFER_LENGTH);
+          memcpy(time,TIME_OVERFLOW,sizeof(TIME_OVERFLOW));
+        }
+        else
+          print_time(time, sizeof(time), TIME_STRING_FORMAT, values[p]);
+
+        fields[0]->store(type_names[type], strlen(type_names[type]),
+                         system_charset_info);
+        fields[1]->store(percentiles[p]);
+        fields[2]->store(total_count, true);
+        fields[3]->store(time, strlen(time), system_charset_info);
+        if (schema_table_store_record(thd, table))
+          result= 1;
+      }
+    }
+    my_free(counts);
+    DBUG_RETURN(result);
+  }
   void collect(QUERY_TYPE type, ulonglong time)
   {
     m_time.collect(type, time);
@@ -274,6 +500,7 @@ public:
   }
 private:
   utility          m_utility;
+  hdr_layout       m_hdr;
   time_collector   m_time;
 };
 
@@ -316,3 +543,9 @@ int query_response_time_fill_rw(THD* thd, TABLE_LIST *tables, COND *cond)
 {
   return query_response_time::g_collector.fill(WRITE, thd, tables, cond);
 }
+
+int query_response_time_fill_percentiles(THD* thd, TABLE_LIST *tables,
+                                         COND *cond)
+{
+  return query_response_time::g_collector.fill_percentiles(thd, tables, cond);
+}
@@ -58,6 +58,13 @@
 
 #define QRT_DEFAULT_BASE 10
 
+/*
+  Number of significant decimal digits kept by the high dynamic range
+  histogram used for percentiles
+*/
+#define QRT_DEFAULT_HDR_PRECISION 2
+#define QRT_MAXIMUM_HDR_PRECISION 2
+
 #define QRT_TIME_STRING_LENGTH				\
   MY_MAX( (QRT_TIME_STRING_POSITIVE_POWER_LENGTH + 1 /* '.' */ + 6 /*QRT_TIME_STRING_NEGATIVE_POWER_LENGTH*/), \
        (sizeof(QRT_TIME_OVERFLOW) - 1) )
@@ -85,7 +92,10 @@ extern int  query_response_time_fill_ro(THD* thd, TABLE_LIST *tables,
                                         COND *cond);
 extern int  query_response_time_fill_rw(THD* thd, TABLE_LIST *tables,
                                         COND *cond);
+extern int  query_response_time_fill_percentiles(THD* thd, TABLE_LIST *tables,
+                                                 COND *cond);
 
 extern ulong   opt_query_response_time_range_base;
+extern ulong   opt_query_response_time_hdr_precision;
 
 #endif // QUERY_RESPONSE_TIME_H
@@ -112,6 +112,12 @@ namespace ngs
     // add the buffer contents to the output queue... thread-safe
     bool enqueue_buffer(Output_buffer *buffer, bool force_flush); // ownership of buffer is taken
 
+    // while set, replies are kept in the buffer until it fills up or
+    // an explicit flush, so pipelined requests get one write
+    void set_flush_deferred(const bool deferred) { m_flush_deferred = deferred; }
+    bool has_deferred_data();
+    bool flush_deferred();
+
     virtual bool send_message(int8_t type, const Message &message, bool force_buffer_flush = false);
     virtual void on_error(int error);
 
@@ -143,6 +149,7 @@ namespace ngs
     Protocol_monitor_interface *m_protocol_monitor;
 
     Output_buffer_unique_ptr m_buffer;
+    bool m_flush_deferred;
 
     Row_builder       m_row_builder;
     Metadata_builder  m_metadata_builder;
@@ -59,6 +59,7 @@ public:
   virtual IOptions_session_ptr options();
 
   ssize_t read(char *buffer, const std::size_t buffer_size);
+  bool has_pending_input();
   ssize_t write(const Const_buffer_sequence &data);
   ssize_t write(const char *buffer, const std::size_t buffer_size);
 
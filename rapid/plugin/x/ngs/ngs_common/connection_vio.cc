@@ -154,6 +154,16 @@ ssize_t Connection_vio::read(char *buffer, const std::size_t buffer_size)
   return buffer_size;
 }
 
+/*
+  Check if the client already sent more data which is waiting in the
+  read buffer of the vio (or the TLS layer), without a system call.
+*/
+bool Connection_vio::has_pending_input()
+{
+  return m_vio->has_data(m_vio);
+}
+
+
 int Connection_vio::shutdown(Shutdown_type how_to_shutdown)
 {
   Mutex_lock lock(m_shutdown_mutex);
@@ -484,6 +484,10 @@ void Client::run(const bool skip_name_resolve) {
 
     while (m_state != Client_closing && m_session) {
       Error_code error;
+
+      // replies of a pipelined batch must go out before we wait for more
+      if (!m_connection->has_pending_input()) m_encoder->flush_deferred();
+
       Request_unique_ptr message(read_one_message(error));
 
       // read could took some time, thus lets recheck the state
@@ -491,10 +495,21 @@ void Client::run(const bool skip_name_resolve) {
 
       if (error || !message) {
         // !message and !error = EOF
+        m_encoder->set_flush_deferred(false);
         if (error) m_encoder->send_result(ngs::Fatal(error));
         disconnect_and_trigger_close();
         break;
       }
+      // more requests already buffered: the client pipelines, so reply
+      // to the whole batch with one write instead of one per message.
+      // Replies before authentication (TLS switch) and to close requests
+      // must not wait.
+      m_encoder->set_flush_deferred(
+          m_state == Client_running &&
+          message->get_type() != Mysqlx::ClientMessages::SESS_CLOSE &&
+          message->get_type() != Mysqlx::ClientMessages::CON_CLOSE &&
+          m_connection->has_pending_input());
+
       ngs::shared_ptr<Session_interface> s(session());
       if (m_state != Client_accepted && s) {
         // pass the message to the session
@@ -502,6 +517,7 @@ void Client::run(const bool skip_name_resolve) {
       } else
         handle_message(*message);
     }
+    m_encoder->flush_deferred();
   } catch (std::exception &e) {
     log_error("%s: Force stopping client because exception occurred: %s",
               client_id(), e.what());
@@ -50,7 +50,8 @@ Protocol_encoder::Protocol_encoder(const ngs::shared_ptr<Connection_vio> &socket
 : m_pool(m_default_pool_config),
   m_socket(socket),
   m_error_handler(ehandler),
-  m_protocol_monitor(&pmon)
+  m_protocol_monitor(&pmon),
+  m_flush_deferred(false)
 {
   m_buffer.reset(ngs::allocate_object<Output_buffer>(ngs::ref(m_pool)));
 }
@@ -361,6 +362,23 @@ bool Protocol_encoder::flush_buffer()
 }
 
 
+bool Protocol_encoder::has_deferred_data()
+{
+  return m_buffer->ByteCount() > 0;
+}
+
+
+bool Protocol_encoder::flush_deferred()
+{
+  m_flush_deferred = false;
+
+  if (!has_deferred_data())
+    return true;
+
+  return flush_buffer();
+}
+
+
 bool Protocol_encoder::send_raw_buffer(int8_t type)
 {
   log_raw_message_send(type);
@@ -374,6 +392,7 @@ bool Protocol_encoder::enqueue_buffer(int8_t type, bool force_flush)
 
   bool can_buffer = (!force_flush) &&
     (
+    m_flush_deferred ||
     (type == Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA) ||
     (type == Mysqlx::ServerMessages::RESULTSET_ROW) ||
     (type == Mysqlx::ServerMessages::NOTICE) ||
@@ -70,7 +70,9 @@ public:
     }
 
     const bool is_tcpip = (accept_address.ss_family == AF_INET || accept_address.ss_family == AF_INET6);
-    vio = mysql_socket_vio_new(sock, is_tcpip ? VIO_TYPE_TCPIP : VIO_TYPE_SOCKET, 0);
+    // buffered reads let pipelined messages arrive with one recv()
+    vio = mysql_socket_vio_new(sock, is_tcpip ? VIO_TYPE_TCPIP : VIO_TYPE_SOCKET,
+                               VIO_BUFFERED_READ);
     if (!vio)
       throw std::bad_alloc();
 
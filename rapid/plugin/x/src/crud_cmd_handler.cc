@@ -42,16 +42,104 @@
 namespace xpl
 {
 
+const Crud_command_handler::Statement_cache::Entry *
+Crud_command_handler::Statement_cache::find(const std::string &shape)
+{
+  Entry_index::iterator i = m_index.find(shape);
+  if (i == m_index.end())
+    return NULL;
+
+  m_entries.splice(m_entries.begin(), m_entries, i->second);
+  return &i->second->second;
+}
+
+
+void Crud_command_handler::Statement_cache::insert(
+    const std::string &shape, const ngs::PFS_string &query,
+    const Expression_generator::Placeholder_positions &positions)
+{
+  if (m_index.count(shape))
+    return;
+
+  if (m_entries.size() >= m_max_entries)
+  {
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+
+  m_entries.push_front(std::make_pair(shape, Entry()));
+  Entry &entry = m_entries.front().second;
+  entry.query = query;
+  entry.placeholders = positions.list;
+  m_index[shape] = m_entries.begin();
+}
+
+
+template <typename B, typename M>
+void Crud_command_handler::build(
+    Session & /*session*/, const Expression_generator & /*gen*/,
+    const B &builder, const M &msg)
+{
+  builder.build(msg);
+}
+
+
+template <typename B, typename M>
+void Crud_command_handler::build_cached(
+    Session &session, const Expression_generator &gen, const B &builder,
+    const M &msg)
+{
+  M shape_msg(msg);
+  shape_msg.clear_args();
+  std::string shape(shape_msg.GetTypeName());
+  shape_msg.AppendToString(&shape);
+
+  const Statement_cache::Entry *entry = m_statement_cache.find(shape);
+  if (entry)
+  {
+    session.update_status<&Common_status_variables::m_crud_cache_hit>();
+    std::size_t offset = 0;
+    for (std::vector<Expression_generator::Placeholder_position>::
+         const_iterator p = entry->placeholders.begin();
+         p != entry->placeholders.end(); ++p)
+    {
+      m_qb.put(entry->query.data() + offset, p->begin - offset);
+      gen.feed_placeholder(p->index);
+      offset = p->end;
+    }
+    m_qb.put(entry->query.data() + offset, entry->query.length() - offset);
+    return;
+  }
+
+  Expression_generator::Placeholder_positions positions;
+  gen.record_placeholders(&positions);
+  try
+  {
+    builder.build(msg);
+  }
+  catch (...)
+  {
+    gen.record_placeholders(NULL);
+    throw;
+  }
+  gen.record_placeholders(NULL);
+
+  if (positions.complete)
+    m_statement_cache.insert(shape, m_qb.get(), positions);
+}
+
+
 template <typename B, typename M>
 ngs::Error_code Crud_command_handler::execute(
-    Session &session, const B &builder, const M &msg, Status_variable variable,
+    Session &session, const Expression_generator &gen, const B &builder,
+    const M &msg, Status_variable variable,
     bool (ngs::Protocol_encoder::*send_ok)())
 {
   session.update_status(variable);
   m_qb.clear();
   try
   {
-    builder.build(msg);
+    build(session, gen, builder, msg);
   }
   catch (const Expression_generator::Error &exc)
   {
@@ -108,7 +196,7 @@ ngs::Error_code Crud_command_handler::execute_crud_insert(
 {
   Expression_generator gen(m_qb, msg.args(), msg.collection().schema(),
                            is_table_data_model(msg));
-  return execute(session, Insert_statement_builder(gen), msg,
+  return execute(session, gen, Insert_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_insert,
                  &ngs::Protocol_encoder::send_exec_ok);
 }
@@ -159,7 +247,7 @@ ngs::Error_code Crud_command_handler::execute_crud_update(
 {
   Expression_generator gen(m_qb, msg.args(), msg.collection().schema(),
                            is_table_data_model(msg));
-  return execute(session, Update_statement_builder(gen), msg,
+  return execute(session, gen, Update_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_update,
                  &ngs::Protocol_encoder::send_exec_ok);
 }
@@ -199,7 +287,7 @@ ngs::Error_code Crud_command_handler::execute_crud_delete(
 {
   Expression_generator gen(m_qb, msg.args(), msg.collection().schema(),
                            is_table_data_model(msg));
-  return execute(session, Delete_statement_builder(gen), msg,
+  return execute(session, gen, Delete_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_delete,
                  &ngs::Protocol_encoder::send_exec_ok);
 }
@@ -221,7 +309,7 @@ ngs::Error_code Crud_command_handler::execute_crud_find(
 {
   Expression_generator gen(m_qb, msg.args(), msg.collection().schema(),
                            is_table_data_model(msg));
-  return execute(session, Find_statement_builder(gen), msg,
+  return execute(session, gen, Find_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_find,
                  &ngs::Protocol_encoder::send_exec_ok);
 }
@@ -278,7 +366,7 @@ ngs::Error_code Crud_command_handler::execute_create_view(
 {
   Expression_generator gen(m_qb, Expression_generator::Args(),
                            msg.collection().schema(), true);
-  return execute(session, View_statement_builder(gen), msg,
+  return execute(session, gen, View_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_create_view,
                  &ngs::Protocol_encoder::send_ok);
 }
@@ -289,7 +377,7 @@ ngs::Error_code Crud_command_handler::execute_modify_view(
 {
   Expression_generator gen(m_qb, Expression_generator::Args(),
                            msg.collection().schema(), true);
-  return execute(session, View_statement_builder(gen), msg,
+  return execute(session, gen, View_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_modify_view,
                  &ngs::Protocol_encoder::send_ok);
 }
@@ -300,7 +388,7 @@ ngs::Error_code Crud_command_handler::execute_drop_view(
 {
   Expression_generator gen(m_qb, Expression_generator::Args(),
                            msg.collection().schema(), true);
-  return execute(session, View_statement_builder(gen), msg,
+  return execute(session, gen, View_statement_builder(gen), msg,
                  &Common_status_variables::m_crud_drop_view,
                  &ngs::Protocol_encoder::send_ok);
 }
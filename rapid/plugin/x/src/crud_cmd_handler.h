@@ -28,10 +28,15 @@
 
 #include "ngs/error_code.h"
 #include "ngs/protocol_fwd.h"
+#include "expr_generator.h"
 #include "query_string_builder.h"
 #include "sql_data_context.h"
 #include "xpl_session_status_variables.h"
 
+#include <list>
+#include <map>
+#include <string>
+
 
 namespace xpl
 {
@@ -40,7 +45,9 @@ class Session;
 class Crud_command_handler
 {
 public:
-  Crud_command_handler() : m_qb(1024) {}
+  Crud_command_handler()
+  : m_qb(1024), m_statement_cache(k_statement_cache_size)
+  {}
 
   ngs::Error_code execute_crud_insert(Session &session,
                                       const Mysqlx::Crud::Insert &msg);
@@ -62,11 +69,74 @@ private:
  typedef Common_status_variables::Variable
      Common_status_variables::*Status_variable;
 
+  /*
+    Queries generated for find, update and delete, with the values of
+    placeholders cut out. Clients repeat the same CRUD shape with other
+    arguments, which then only needs the arguments to be generated.
+  */
+  class Statement_cache
+  {
+  public:
+    struct Entry
+    {
+      ngs::PFS_string query;
+      std::vector<Expression_generator::Placeholder_position> placeholders;
+    };
+
+    explicit Statement_cache(const std::size_t max_entries)
+    : m_max_entries(max_entries)
+    {}
+
+    const Entry *find(const std::string &shape);
+    void insert(const std::string &shape, const ngs::PFS_string &query,
+                const Expression_generator::Placeholder_positions &positions);
+
+  private:
+    typedef std::list<std::pair<std::string, Entry> > Entry_list;
+    typedef std::map<std::string, Entry_list::iterator> Entry_index;
+
+    const std::size_t m_max_entries;
+    Entry_list m_entries; // most recently used first
+    Entry_index m_index;
+  };
+
+  static const std::size_t k_statement_cache_size = 64;
+
   template <typename B, typename M>
-  ngs::Error_code execute(Session &session, const B &builder, const M &msg,
+  ngs::Error_code execute(Session &session, const Expression_generator &gen,
+                          const B &builder, const M &msg,
                           Status_variable variable,
                           bool (ngs::Protocol_encoder::*send_ok)());
 
+  template <typename B, typename M>
+  void build(Session &session, const Expression_generator &gen,
+             const B &builder, const M &msg);
+
+  template <typename B>
+  void build(Session &session, const Expression_generator &gen,
+             const B &builder, const Mysqlx::Crud::Find &msg)
+  {
+    build_cached(session, gen, builder, msg);
+  }
+
+  template <typename B>
+  void build(Session &session, const Expression_generator &gen,
+             const B &builder, const Mysqlx::Crud::Update &msg)
+  {
+    build_cached(session, gen, builder, msg);
+  }
+
+  template <typename B>
+  void build(Session &session, const Expression_generator &gen,
+             const B &builder, const Mysqlx::Crud::Delete &msg)
+  {
+    build_cached(session, gen, builder, msg);
+  }
+
+  template <typename B, typename M>
+  void build_cached(Session &session, const Expression_generator &gen,
+                    const B &builder, const M &msg);
+
   template <typename M>
   ngs::Error_code error_handling(const ngs::Error_code &error,
                                  const M & /*msg*/) const
@@ -87,6 +157,7 @@ private:
                               Sql_data_context::Result_info &info) const;
 
   Query_string_builder m_qb;
+  Statement_cache m_statement_cache;
 };
 
 } // namespace xpl
@@ -290,10 +290,17 @@ void Expression_generator::generate(const Mysqlx::Datatypes::Scalar::Octets &arg
 
 void Expression_generator::generate(const Placeholder &arg) const
 {
-  if (arg < static_cast<Placeholder>(m_args.size()))
-    generate(m_args.Get(arg));
-  else
+  if (arg >= static_cast<Placeholder>(m_args.size()))
     throw Error(ER_X_EXPR_BAD_VALUE, "Invalid value of placeholder");
+
+  const std::size_t begin = m_qb.get().length();
+  generate(m_args.Get(arg));
+
+  if (m_placeholder_positions)
+  {
+    const Placeholder_position position = {begin, m_qb.get().length(), arg};
+    m_placeholder_positions->list.push_back(position);
+  }
 }
 
 
@@ -727,6 +734,10 @@ void Expression_generator::nullary_operator(const Mysqlx::Expr::Operator &arg, c
 
 Expression_generator Expression_generator::clone(Query_string_builder &qb) const
 {
+  // positions in the other builder can't be mapped to the final query
+  if (m_placeholder_positions)
+    m_placeholder_positions->complete = false;
+
   return Expression_generator(qb, m_args, m_default_schema, m_is_relational);
 }
 
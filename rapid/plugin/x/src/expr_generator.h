@@ -29,6 +29,7 @@
 #include "query_string_builder.h"
 #include "ngs_common/protocol_protobuf.h"
 #include <stdexcept>
+#include <vector>
 
 
 namespace xpl
@@ -58,19 +59,42 @@ public:
     CT_XML = 0x0003          //   BYTES  0x0003 XML (text encoding)
   };
 
+  typedef ::google::protobuf::uint32 Placeholder;
+
+  // where the value of a placeholder was put in the generated query
+  struct Placeholder_position
+  {
+    std::size_t begin;
+    std::size_t end;
+    Placeholder index;
+  };
+
+  struct Placeholder_positions
+  {
+    Placeholder_positions() : complete(true) {}
+
+    std::vector<Placeholder_position> list;
+    bool complete; // false if a value went to another query builder
+  };
+
   Expression_generator(Query_string_builder &qb, const Args &args, const std::string &default_schema, const bool &is_relational)
-  : m_qb(qb), m_args(args), m_default_schema(default_schema), m_is_relational(is_relational)
+  : m_qb(qb), m_args(args), m_default_schema(default_schema), m_is_relational(is_relational),
+    m_placeholder_positions(NULL)
   {}
 
   template<typename T>
   inline void feed(const T &expr) const { generate(expr); }
+  void feed_placeholder(const Placeholder &arg) const { generate(arg); }
+
+  // collect positions of placeholder values, so the query can be reused
+  // as a template for other values of the arguments
+  void record_placeholders(Placeholder_positions *positions) const { m_placeholder_positions = positions; }
 
   Expression_generator clone(Query_string_builder &qb) const;
   Query_string_builder &query_string_builder() const { return m_qb; }
 
 private:
   typedef ::google::protobuf::RepeatedPtrField< ::Mysqlx::Expr::DocumentPathItem > Document_path;
-  typedef ::google::protobuf::uint32 Placeholder;
 
   void generate(const Mysqlx::Expr::Expr &arg) const;
   void generate(const Mysqlx::Expr::Identifier &arg, const bool is_function=false) const;
@@ -107,6 +131,7 @@ private:
   const Args &m_args;
   const std::string &m_default_schema;
   const bool &m_is_relational;
+  mutable Placeholder_positions *m_placeholder_positions;
 };
 
 
@@ -80,6 +80,7 @@ public:
   Variable m_crud_create_view;
   Variable m_crud_modify_view;
   Variable m_crud_drop_view;
+  Variable m_crud_cache_hit;
 
 private:
   Common_status_variables(const Common_status_variables &);
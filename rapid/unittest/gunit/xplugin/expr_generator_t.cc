@@ -982,5 +982,46 @@ TEST(xpl_expr_generator, scalar_octets_unknown)
                Expression_generator::Error);
 }
 
+
+TEST(xpl_expr_generator, placeholder_positions)
+{
+  Query_string_builder qb;
+  const Expression_args args = Expression_args(42)("foo");
+  const std::string schema("xschema");
+  const bool is_relational = true;
+  Expression_generator gen(qb, args, schema, is_relational);
+  Expression_generator::Placeholder_positions positions;
+
+  gen.record_placeholders(&positions);
+  gen.feed(FunctionCall("bar", Placeholder(1), Placeholder(0)));
+
+  EXPECT_EQ("xschema.bar('foo',42)", qb.get());
+  EXPECT_TRUE(positions.complete);
+  ASSERT_EQ(2u, positions.list.size());
+  EXPECT_EQ(12u, positions.list[0].begin);
+  EXPECT_EQ(17u, positions.list[0].end);
+  EXPECT_EQ(1u, positions.list[0].index);
+  EXPECT_EQ(18u, positions.list[1].begin);
+  EXPECT_EQ(20u, positions.list[1].end);
+  EXPECT_EQ(0u, positions.list[1].index);
+}
+
+
+TEST(xpl_expr_generator, placeholder_positions_clone)
+{
+  Query_string_builder qb, other;
+  const Expression_args args = Expression_args(42);
+  const bool is_relational = true;
+  Expression_generator gen(qb, args, EMPTY_SCHEMA, is_relational);
+  Expression_generator::Placeholder_positions positions;
+
+  gen.record_placeholders(&positions);
+  gen.clone(other).feed(Expr(Placeholder(0)));
+
+  EXPECT_EQ("42", other.get());
+  EXPECT_FALSE(positions.complete);
+  EXPECT_TRUE(positions.list.empty());
+}
+
 } // namespace test
 } // namespace xpl
@@ -2112,6 +2112,26 @@ PREPARE stmt FROM @str;
 EXECUTE stmt;
 DROP PREPARE stmt;
 
+--
+-- TABLE EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_statements_histogram_by_digest("
+  "SCHEMA_NAME VARCHAR(64),"
+  "DIGEST VARCHAR(32),"
+  "BUCKET_NUMBER INTEGER unsigned not null,"
+  "BUCKET_TIMER_LOW BIGINT unsigned not null,"
+  "BUCKET_TIMER_HIGH BIGINT unsigned not null,"
+  "COUNT_BUCKET BIGINT unsigned not null,"
+  "COUNT_BUCKET_AND_LOWER BIGINT unsigned not null,"
+  "BUCKET_QUANTILE DOUBLE(7,6) not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
 --
 -- TABLE EVENTS_STATEMENTS_SUMMARY_BY_PROGRAM
 --
@@ -2156,6 +2176,23 @@ PREPARE stmt FROM @str;
 EXECUTE stmt;
 DROP PREPARE stmt;
 
+--
+-- TABLE EVENTS_SAMPLES_SUMMARY_BY_STACK
+--
+
+SET @cmd="CREATE TABLE performance_schema.events_samples_summary_by_stack("
+  "DIGEST VARCHAR(32),"
+  "STAGE_NAME VARCHAR(128),"
+  "WAIT_NAME VARCHAR(128),"
+  "STACK VARCHAR(512) not null,"
+  "COUNT_STAR BIGINT unsigned not null"
+  ")ENGINE=PERFORMANCE_SCHEMA;";
+
+SET @str = IF(@have_pfs = 1, @cmd, 'SET @dummy = 0');
+PREPARE stmt FROM @str;
+EXECUTE stmt;
+DROP PREPARE stmt;
+
 --
 -- TABLE PREPARED_STATEMENT_INSTANCES
 --
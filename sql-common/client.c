@@ -2529,6 +2529,11 @@ void mysql_extension_free(struct st_mysql_extension *ext) {
   // free state change related resources.
   free_state_change_info(ext);
 
+#if defined(HAVE_OPENSSL) && !defined(EMBEDDED_LIBRARY)
+  if (ext->ssl_session)
+    SSL_SESSION_free((SSL_SESSION *)ext->ssl_session);
+#endif
+
   my_free(ext);
 }
 
@@ -3583,6 +3588,31 @@ static char *mysql_fill_packet_header(MYSQL *mysql, char *buff,
   return end;
 }
 
+/**
+  Check if a compression algorithm is in a comma separated list of
+  algorithm names.
+*/
+static my_bool compression_algorithm_listed(const char *list,
+                                           const char *name) {
+  size_t name_length = strlen(name);
+  while (list && *list) {
+    const char *next = strchr(list, ',');
+    size_t length = next ? (size_t)(next - list) : strlen(list);
+    if (length == name_length && !native_strncasecmp(list, name, length))
+      return TRUE;
+    list = next ? next + 1 : NULL;
+  }
+  return FALSE;
+}
+
+/** The zstd compression level requested by the connection options. */
+static uint zstd_compression_level(MYSQL *mysql) {
+  return (mysql->options.extension &&
+          mysql->options.extension->zstd_compression_level)
+             ? mysql->options.extension->zstd_compression_level
+             : MYSQL_ZSTD_DEFAULT_LEVEL;
+}
+
 /**
   Calcualtes client capabilities in effect (mysql->client_flag)
 
@@ -3592,7 +3622,6 @@ static char *mysql_fill_packet_header(MYSQL *mysql, char *buff,
   @param  db      The database specified by the client app
   @param  db      The client flag as specified by the client app
   */
-
 static void cli_calculate_client_flag(MYSQL *mysql, const char *db,
                                       ulong client_flag) {
   mysql->client_flag = client_flag;
@@ -3627,6 +3656,17 @@ static void cli_calculate_client_flag(MYSQL *mysql, const char *db,
 #ifndef HAVE_COMPRESS
   mysql->client_flag &= ~CLIENT_COMPRESS;
 #endif
+
+  /* Prefer zstd over zlib when both sides can use it */
+  if (CAN_CLIENT_ZSTD_COMPRESS &&
+      (mysql->server_capabilities & CLIENT_ZSTD_COMPRESSION_ALGORITHM) &&
+      mysql->options.extension &&
+      compression_algorithm_listed(
+          mysql->options.extension->compression_algorithms, "zstd")) {
+    mysql->client_flag |= CLIENT_ZSTD_COMPRESSION_ALGORITHM;
+    mysql->client_flag &= ~CLIENT_COMPRESS;
+  } else
+    mysql->client_flag &= ~CLIENT_ZSTD_COMPRESSION_ALGORITHM;
 }
 
 /**
@@ -3659,6 +3699,39 @@ int embedded_ssl_check(MYSQL *mysql) {
 }
 #endif
 
+#ifdef HAVE_OPENSSL
+/**
+  Replace the session kept in the handle for the next connect.
+
+  @param  ext       extension of the connection handle
+  @param  session   a session the caller holds a reference to
+*/
+
+static void keep_ssl_session(MYSQL_EXTENSION *ext, SSL_SESSION *session) {
+  if (ext->ssl_session) SSL_SESSION_free((SSL_SESSION *)ext->ssl_session);
+  ext->ssl_session = session;
+}
+
+/**
+  New session callback of the SSL_CTX of a connection. Under TLS 1.3 the
+  server sends its tickets after the handshake, so they can only be
+  caught here. Sessions that arrive before the server certificate is
+  verified are not kept.
+
+  @retval 1   the reference to the session is taken
+  @retval 0   the session is not kept
+*/
+
+static int ssl_session_new(SSL *ssl, SSL_SESSION *session) {
+  MYSQL_EXTENSION *ext =
+      (MYSQL_EXTENSION *)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl));
+
+  if (!ext || !ext->ssl_session_verified) return 0;
+  keep_ssl_session(ext, session);
+  return 1;
+}
+#endif /* HAVE_OPENSSL */
+
 /**
 Establishes SSL if requested and supported.
 
@@ -3712,6 +3785,7 @@ static int cli_establish_ssl(MYSQL *mysql) {
     enum enum_ssl_init_error ssl_init_error;
     const char *cert_error;
     unsigned long ssl_error;
+    MYSQL_EXTENSION *ext;
     char buff[33], *end;
 
     end = mysql_fill_packet_header(mysql, buff, sizeof(buff));
@@ -3746,11 +3820,23 @@ static int cli_establish_ssl(MYSQL *mysql) {
     }
     mysql->connector_fd = (unsigned char *)ssl_fd;
 
+    /* Catch the sessions the server issues, see ssl_session_new() */
+    ext = MYSQL_EXTENSION_PTR(mysql);
+    if (ext) {
+      ext->ssl_session_verified = FALSE;
+      SSL_CTX_set_app_data(ssl_fd->ssl_context, ext);
+      SSL_CTX_set_session_cache_mode(
+          ssl_fd->ssl_context,
+          SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+      SSL_CTX_sess_set_new_cb(ssl_fd->ssl_context, ssl_session_new);
+    }
+
     /* Connect to the server */
     DBUG_PRINT("info", ("IO layer change in progress..."));
     MYSQL_TRACE(SSL_CONNECT, mysql, ());
-    if (sslconnect(ssl_fd, net->vio, (long)(mysql->options.connect_timeout),
-                   &ssl_error)) {
+    if (sslconnect_with_session(
+            ssl_fd, net->vio, (long)(mysql->options.connect_timeout),
+            ext ? (SSL_SESSION *)ext->ssl_session : NULL, &ssl_error)) {
       char buf[512];
       ERR_error_string_n(ssl_error, buf, 512);
       buf[511] = 0;
@@ -3768,6 +3854,23 @@ static int cli_establish_ssl(MYSQL *mysql) {
       goto error;
     }
 
+    /*
+      Keep the session for the next connect of the handle. A TLS 1.2
+      session is complete after the handshake, a TLS 1.3 one only gets
+      its ticket later, through ssl_session_new().
+    */
+    if (ext) {
+      SSL_SESSION *session = SSL_get1_session((SSL *)net->vio->ssl_arg);
+      ext->ssl_session_verified = TRUE;
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+      if (session && !SSL_SESSION_is_resumable(session)) {
+        SSL_SESSION_free(session);
+        session = NULL;
+      }
+#endif
+      if (session) keep_ssl_session(ext, session);
+    }
+
     MYSQL_TRACE(SSL_CONNECTED, mysql, ());
     MYSQL_TRACE_STAGE(mysql, AUTHENTICATE);
   }
@@ -3835,7 +3938,7 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio, const uchar *data,
     +9 because data is a length encoded binary where meta data size is max 9.
   */
   buff_size = 33 + USERNAME_LENGTH + data_len + 9 + NAME_LEN + NAME_LEN +
-              connect_attrs_len + 9;
+              connect_attrs_len + 9 + 1 /* zstd compression level */;
   buff = my_alloca(buff_size);
 
   /* The client_flags is already calculated. Just fill in the packet header */
@@ -3890,6 +3993,9 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio, const uchar *data,
 
   end = (char *)send_client_connect_attrs(mysql, (uchar *)end);
 
+  if (mysql->client_flag & CLIENT_ZSTD_COMPRESSION_ALGORITHM)
+    *end++ = (char)zstd_compression_level(mysql);
+
   /* Write authentication package */
   MYSQL_TRACE(SEND_AUTH_RESPONSE, mysql,
               (end - buff, (const unsigned char *)buff));
@@ -4872,8 +4978,20 @@ MYSQL *STDCALL CLI_MYSQL_REAL_CONNECT(MYSQL *mysql, const char *host,
     Part 3: authenticated, finish the initialization of the connection
   */
 
-  if (mysql->client_flag & CLIENT_COMPRESS) /* We will use compression */
+  if (mysql->client_flag & CLIENT_ZSTD_COMPRESSION_ALGORITHM) {
+    my_compress_context_free((COMPRESS_CONTEXT *)net->compress_ctx);
+    if (!(net->compress_ctx = my_compress_context_new(
+              MYSQL_ZSTD, zstd_compression_level(mysql)))) {
+      set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      goto error;
+    }
+    net->compress = 1;
+  } else if (mysql->client_flag & CLIENT_COMPRESS) /* We will use compression */
+  {
     net->compress = 1;
+    if (!net->compress_ctx)
+      net->compress_ctx = my_compress_context_new(MYSQL_ZLIB, 0);
+  }
 
 #ifdef CHECK_LICENSE
   if (check_license(mysql))
@@ -4958,6 +5076,16 @@ my_bool mysql_reconnect(MYSQL *mysql) {
   tmp_mysql.options = mysql->options;
   tmp_mysql.options.my_cnf_file = tmp_mysql.options.my_cnf_group = 0;
 
+#if defined(HAVE_OPENSSL) && !defined(EMBEDDED_LIBRARY)
+  /* Resume the TLS session of the lost connection */
+  if (mysql->extension && MYSQL_EXTENSION_PTR(mysql)->ssl_session &&
+      MYSQL_EXTENSION_PTR(&tmp_mysql)) {
+    MYSQL_EXTENSION_PTR(&tmp_mysql)->ssl_session =
+        MYSQL_EXTENSION_PTR(mysql)->ssl_session;
+    MYSQL_EXTENSION_PTR(mysql)->ssl_session = NULL;
+  }
+#endif
+
   if (!mysql_real_connect(&tmp_mysql, mysql->host, mysql->user, mysql->passwd,
                           mysql->db, mysql->port, mysql->unix_socket,
                           mysql->client_flag | CLIENT_REMEMBER_OPTIONS)) {
@@ -5052,6 +5180,7 @@ void mysql_close_free_options(MYSQL *mysql) {
     my_free(mysql->options.extension->plugin_dir);
     my_free(mysql->options.extension->default_auth);
     my_free(mysql->options.extension->server_public_key_path);
+    my_free(mysql->options.extension->compression_algorithms);
     my_hash_free(&mysql->options.extension->connection_attributes);
     my_free(mysql->options.extension);
   }
@@ -5639,6 +5768,19 @@ int STDCALL mysql_options(MYSQL *mysql, enum mysql_option option,
         (*(my_bool *)arg) ? TRUE : FALSE;
     break;
 
+  case MYSQL_OPT_COMPRESSION_ALGORITHMS:
+    EXTENSION_SET_STRING(&mysql->options, compression_algorithms, arg);
+    break;
+
+  case MYSQL_OPT_ZSTD_COMPRESSION_LEVEL: {
+    uint level = *(uint *)arg;
+    if (level < MYSQL_ZSTD_MIN_LEVEL || level > MYSQL_ZSTD_MAX_LEVEL)
+      DBUG_RETURN(1);
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    mysql->options.extension->zstd_compression_level = level;
+    break;
+  }
+
   case MYSQL_OPT_CONNECT_ATTR_RESET:
     ENSURE_EXTENSIONS_PRESENT(&mysql->options);
     if (my_hash_inited(&mysql->options.extension->connection_attributes)) {
@@ -5881,6 +6023,14 @@ int STDCALL mysql_get_option(MYSQL *mysql, enum mysql_option option,
                             ? TRUE
                             : FALSE;
     break;
+  case MYSQL_OPT_COMPRESSION_ALGORITHMS:
+    *((char **)arg) = mysql->options.extension
+                          ? mysql->options.extension->compression_algorithms
+                          : NULL;
+    break;
+  case MYSQL_OPT_ZSTD_COMPRESSION_LEVEL:
+    *((uint *)arg) = zstd_compression_level(mysql);
+    break;
   case MYSQL_ENABLE_CLEARTEXT_PLUGIN:
     *((my_bool *)arg) = (mysql->options.extension &&
                          mysql->options.extension->enable_cleartext_plugin)
@@ -1731,6 +1731,7 @@ static my_bool acl_load(THD *thd, TABLE_LIST *tables)
 
   
   acl_cache->clear(1);                          // Clear locked hostname cache
+  sha256_password_cache_clear();
 
   init_sql_alloc(key_memory_acl_mem,
                  &global_acl_memory, ACL_ALLOC_BLOCK_SIZE, 0);
@@ -2278,6 +2279,7 @@ void acl_free(bool end)
   delete acl_proxy_users;
   acl_proxy_users= NULL;
   my_hash_free(&acl_check_hosts);
+  sha256_password_cache_clear();
   if (!end)
     acl_cache->clear(1); /* purecov: inspected */
   else
@@ -42,6 +42,8 @@
 #include <algorithm>                    /* for_each */
 #include <stdexcept>                    /* Exception handling */
 #include <vector>                       /* std::vector */
+#include <map>                          /* std::map */
+#include <list>                         /* std::list */
 #include <stdint.h>
 
 #if defined(HAVE_OPENSSL)
@@ -49,6 +51,9 @@
 #include <openssl/pem.h>
 #include <openssl/err.h>
 #include <openssl/x509v3.h>
+#include <openssl/sha.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
 #endif /* HAVE OPENSSL */
 
 #include "auth_internal.h"
@@ -561,6 +566,7 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
     protocol->add_client_capability(CLIENT_TRANSACTIONS);
 
   protocol->add_client_capability(CAN_CLIENT_COMPRESS);
+  protocol->add_client_capability(CAN_CLIENT_ZSTD_COMPRESS);
 
   if (ssl_acceptor_fd)
   {
@@ -898,10 +904,49 @@ read_client_connect_attrs(char **ptr, size_t *max_bytes_available,
     sql_print_warning("Connection attributes of length %lu were truncated",
                       (unsigned long) length);
 #endif /* HAVE_PSI_THREAD_INTERFACE */
+  *ptr+= length;
+  *max_bytes_available-= length;
   return false;
 }
 
 
+/**
+  Read the zstd compression level that follows the connection attributes
+  when CLIENT_ZSTD_COMPRESSION_ALGORITHM is set, and set up the
+  compression context of the connection.
+
+  @retval true   malformed packet or out of memory
+  @retval false  ok
+*/
+
+static bool
+read_client_zstd_compression_level(Protocol_classic *protocol, char **ptr,
+                                   size_t *max_bytes_available)
+{
+  if (!protocol->has_client_capability(CLIENT_ZSTD_COMPRESSION_ALGORITHM))
+    return false;
+
+  if (!CAN_CLIENT_ZSTD_COMPRESS)
+  {
+    /* The flag was not offered to the client, fall back to zlib */
+    protocol->remove_client_capability(CLIENT_ZSTD_COMPRESSION_ALGORITHM);
+    return false;
+  }
+
+  if (*max_bytes_available < 1)
+    return true;
+
+  int level= (uchar) **ptr;
+  (*ptr)++;
+  (*max_bytes_available)--;
+
+  NET *net= protocol->get_net();
+  my_compress_context_free((COMPRESS_CONTEXT *) net->compress_ctx);
+  net->compress_ctx= my_compress_context_new(MYSQL_ZSTD, level);
+  return net->compress_ctx == NULL;
+}
+
+
 static bool acl_check_ssl(THD *thd, const ACL_USER *acl_user)
 {
 #if defined(HAVE_OPENSSL)
@@ -1648,6 +1693,10 @@ skip_to_ssl:
                                 mpvio->charset_adapter->charset()))
     return packet_error;
 
+  if (read_client_zstd_compression_level(protocol, &end,
+                                         &bytes_remaining_in_packet))
+    return packet_error;
+
   char db_buff[NAME_LEN + 1];           // buffer to store db in utf8
   char user_buff[USERNAME_LENGTH + 1];  // buffer to store user in utf8
   uint dummy_errors;
@@ -2907,9 +2956,172 @@ bool init_rsa_keys(void)
 
 static MYSQL_PLUGIN plugin_info_ptr;
 
+/**
+  Passwords that recently passed sha256_password authentication.
+
+  my_crypt_genhash() runs thousands of SHA256 rounds on purpose, which
+  makes connection storms of the same accounts CPU bound. After a
+  successful authentication a single salted SHA256 of the password is
+  kept, and the next authentication of the account compares against it
+  instead.
+
+  The key holds the user name, the client host and the authentication
+  string of the matched account, so a changed password or account never
+  matches an old entry. The salt is random per server start, so the
+  digests are useless outside of this process. The cache is also emptied
+  on every change of the ACLs, see sha256_password_cache_clear(). When
+  the cache is full, the least recently used account is dropped.
+*/
+
+class Sha256_auth_cache
+{
+  /** Keys, the least recently used first */
+  typedef std::list<std::string> Lru;
+  struct Entry
+  {
+    std::string hash;
+    Lru::iterator lru;
+  };
+  typedef std::map<std::string, Entry> Entries;
+
+  mysql_mutex_t m_lock;
+  Entries m_entries;
+  Lru m_lru;
+  unsigned char m_salt[SHA256_DIGEST_LENGTH];
+  bool m_initialized;
+
+  static std::string make_key(const MYSQL_SERVER_AUTH_INFO *info)
+  {
+    std::string key(info->user_name ? info->user_name : "",
+                    info->user_name_length);
+    key.append(1, '\0');
+    key.append(info->host_or_ip ? info->host_or_ip : "",
+               info->host_or_ip_length);
+    key.append(1, '\0');
+    key.append(info->auth_string, info->auth_string_length);
+    return key;
+  }
+
+  std::string digest(const unsigned char *password, size_t length) const
+  {
+    unsigned char md[SHA256_DIGEST_LENGTH];
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    SHA256_Update(&ctx, m_salt, sizeof(m_salt));
+    SHA256_Update(&ctx, password, length);
+    SHA256_Final(md, &ctx);
+    return std::string((const char *) md, sizeof(md));
+  }
+
+public:
+  Sha256_auth_cache() : m_initialized(false) {}
+
+  void init(PSI_mutex_key key)
+  {
+    if (RAND_bytes(m_salt, sizeof(m_salt)) != 1)
+      return;                                   /* Cache stays disabled */
+    mysql_mutex_init(key, &m_lock, MY_MUTEX_INIT_FAST);
+    m_initialized= true;
+  }
+
+  void destroy()
+  {
+    if (!m_initialized)
+      return;
+    m_entries.clear();
+    m_lru.clear();
+    mysql_mutex_destroy(&m_lock);
+    m_initialized= false;
+  }
+
+  /** @return true if the password matches the one cached for the account */
+  bool check(const MYSQL_SERVER_AUTH_INFO *info,
+             const unsigned char *password, size_t length)
+  {
+    if (!m_initialized)
+      return false;
+    const std::string key= make_key(info);
+    const std::string hash= digest(password, length);
+    Mutex_lock lock(&m_lock);
+    Entries::iterator it= m_entries.find(key);
+    if (it == m_entries.end() ||
+        CRYPTO_memcmp(it->second.hash.data(), hash.data(), hash.size()) != 0)
+      return false;
+    m_lru.splice(m_lru.end(), m_lru, it->second.lru);
+    return true;
+  }
+
+  void add(const MYSQL_SERVER_AUTH_INFO *info,
+           const unsigned char *password, size_t length, ulong max_entries)
+  {
+    if (!m_initialized || max_entries == 0)
+      return;
+    const std::string key= make_key(info);
+    const std::string hash= digest(password, length);
+    Mutex_lock lock(&m_lock);
+    Entries::iterator it= m_entries.find(key);
+    if (it != m_entries.end())
+    {
+      it->second.hash= hash;
+      m_lru.splice(m_lru.end(), m_lru, it->second.lru);
+      return;
+    }
+    /* The limit may have been lowered since the last add */
+    while (m_entries.size() >= max_entries)
+    {
+      m_entries.erase(m_lru.front());
+      m_lru.pop_front();
+    }
+    Entry &entry= m_entries[key];
+    entry.hash= hash;
+    entry.lru= m_lru.insert(m_lru.end(), key);
+  }
+
+  void clear()
+  {
+    if (!m_initialized)
+      return;
+    Mutex_lock lock(&m_lock);
+    m_entries.clear();
+    m_lru.clear();
+  }
+};
+
+static Sha256_auth_cache sha256_auth_cache;
+/** @@sha256_password_auth_cache_size */
+static ulong sha256_auth_cache_size;
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_sha256_auth_cache;
+
+static PSI_mutex_info all_sha256_password_mutexes[]=
+{
+  { &key_LOCK_sha256_auth_cache, "LOCK_sha256_auth_cache", PSI_FLAG_GLOBAL}
+};
+#endif /* HAVE_PSI_INTERFACE */
+
 int init_sha256_password_handler(MYSQL_PLUGIN plugin_ref)
 {
   plugin_info_ptr= plugin_ref;
+#ifdef HAVE_PSI_INTERFACE
+  mysql_mutex_register("sql", all_sha256_password_mutexes,
+                       array_elements(all_sha256_password_mutexes));
+  sha256_auth_cache.init(key_LOCK_sha256_auth_cache);
+#else
+  sha256_auth_cache.init(0);
+#endif /* HAVE_PSI_INTERFACE */
+  return 0;
+}
+
+void sha256_password_cache_clear()
+{
+  sha256_auth_cache.clear();
+}
+
+static int deinit_sha256_password_handler(MYSQL_PLUGIN plugin_ref
+                                          MY_ATTRIBUTE((unused)))
+{
+  sha256_auth_cache.destroy();
   return 0;
 }
 
@@ -3120,6 +3332,15 @@ http://dev.mysql.com/doc/internals/en/connection-phase-packets.html#packet-Proto
     DBUG_RETURN(CR_ERROR);
   }
 
+  /* The same account authenticated recently with this password */
+  if (sha256_auth_cache_size > 0 &&
+      sha256_auth_cache.check(info, pkt, pkt_len - 1))
+  {
+    if (sha256_password_proxy_users)
+      *info->authenticated_as= PROXY_FLAG;
+    DBUG_RETURN(CR_OK);
+  }
+
   /* Create hash digest */
   my_crypt_genhash(stage2,
                      CRYPT_MAX_PASSWORD_SIZE,
@@ -3135,6 +3356,7 @@ http://dev.mysql.com/doc/internals/en/connection-phase-packets.html#packet-Proto
 
   if (result == 0)
   {
+    sha256_auth_cache.add(info, pkt, pkt_len - 1, sha256_auth_cache_size);
     if (sha256_password_proxy_users)
     {
       *info->authenticated_as= PROXY_FLAG;
@@ -3161,11 +3383,19 @@ static MYSQL_SYSVAR_BOOL(auto_generate_rsa_keys, auth_rsa_auto_generate_rsa_keys
         "system variables are not specified and key files are not present "
         "at the default location.",
         NULL, NULL, TRUE);
+static MYSQL_SYSVAR_ULONG(auth_cache_size, sha256_auth_cache_size,
+        PLUGIN_VAR_RQCMDARG,
+        "Number of accounts whose last successful password is remembered "
+        "to skip the hash computation on their next authentication. The "
+        "least recently used accounts are dropped when it is full. "
+        "0 disables the cache",
+        NULL, NULL, 0, 0, 1024 * 1024, 0);
 
 static struct st_mysql_sys_var* sha256_password_sysvars[]= {
   MYSQL_SYSVAR(private_key_path),
   MYSQL_SYSVAR(public_key_path),
   MYSQL_SYSVAR(auto_generate_rsa_keys),
+  MYSQL_SYSVAR(auth_cache_size),
   0
 };
 
@@ -4184,6 +4414,12 @@ static bool do_auto_rsa_keys_generation()
     return true;
   }
 }
+#else /* HAVE_OPENSSL */
+
+void sha256_password_cache_clear()
+{
+}
+
 #endif /* HAVE_OPENSSL */
 
 bool MPVIO_EXT::can_authenticate()
@@ -4242,7 +4478,7 @@ mysql_declare_plugin(mysql_password)
   "SHA256 password authentication",             /* Description      */
   PLUGIN_LICENSE_GPL,                           /* License          */
   &init_sha256_password_handler,                /* Init function    */
-  NULL,                                         /* Deinit function  */
+  &deinit_sha256_password_handler,              /* Deinit function  */
   0x0101,                                       /* Version (1.0)    */
   NULL,                                         /* status variables */
   sha256_password_sysvars,                      /* system variables */
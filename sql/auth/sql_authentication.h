@@ -143,4 +143,7 @@ extern bool allow_all_hosts;
 
 extern plugin_ref native_password_plugin;
 
+/* Forget the passwords cached by sha256_password, on ACL changes */
+void sha256_password_cache_clear();
+
 #endif /* SQL_AUTHENTICATION_INCLUDED */
@@ -1655,6 +1655,7 @@ bool mysql_drop_user(THD *thd, List <LEX_USER> &list, bool if_exists)
 
   /* Rebuild 'acl_check_hosts' since 'acl_users' has been modified */
   rebuild_check_host();
+  sha256_password_cache_clear();
 
   mysql_mutex_unlock(&acl_cache->lock);
 
@@ -1794,6 +1795,7 @@ bool mysql_rename_user(THD *thd, List <LEX_USER> &list)
   
   /* Rebuild 'acl_check_hosts' since 'acl_users' has been modified */
   rebuild_check_host();
+  sha256_password_cache_clear();
 
   mysql_mutex_unlock(&acl_cache->lock);
 
@@ -2013,6 +2015,7 @@ bool mysql_alter_user(THD *thd, List <LEX_USER> &list, bool if_exists)
   }
 
   acl_cache->clear(1);                          // Clear locked hostname cache
+  sha256_password_cache_clear();
   mysql_mutex_unlock(&acl_cache->lock);
 
   if (result && !rollback_whole_statement)
@@ -1245,6 +1245,7 @@ end:
     else
       password_change_time.time_type= MYSQL_TIMESTAMP_ERROR;
     acl_cache->clear(1);			// Clear privilege cache
+    sha256_password_cache_clear();
     if (old_row_exists)
       acl_update_user(combo->user.str, combo->host.str,
 		      lex->ssl_type,
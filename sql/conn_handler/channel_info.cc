@@ -26,6 +26,7 @@
 
 #include "my_stacktrace.h"              // my_safe_snprintf
 #include "sql_class.h"                  // THD
+#include "thd_pool.h"                   // Thd_pool
 
 
 THD* Channel_info::create_thd()
@@ -36,7 +37,9 @@ THD* Channel_info::create_thd()
   if (vio_tmp == NULL)
     return NULL;
 
-  THD* thd= new (std::nothrow) THD;
+  THD* thd= Thd_pool::get();
+  if (thd == NULL)
+    thd= new (std::nothrow) THD;
   if (thd == NULL)
   {
     vio_delete(vio_tmp);
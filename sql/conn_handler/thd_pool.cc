@@ -0,0 +1,206 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#include "thd_pool.h"
+
+#include "log.h"                         // sql_print_error
+#include "sql_class.h"                   // THD
+
+
+// Initialize static members
+mysql_mutex_t Thd_pool::LOCK_thd_pool;
+mysql_cond_t Thd_pool::COND_thd_pool;
+std::vector<THD*> *Thd_pool::m_thds= NULL;
+my_thread_handle Thd_pool::m_thread;
+bool Thd_pool::m_started= false;
+bool Thd_pool::m_shutdown= false;
+bool Thd_pool::m_enable_plugins= true;
+ulong Thd_pool::pool_size= 0;
+ulong Thd_pool::hits= 0;
+ulong Thd_pool::misses= 0;
+
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_LOCK_thd_pool;
+
+static PSI_mutex_info all_thd_pool_mutexes[]=
+{
+  { &key_LOCK_thd_pool, "LOCK_thd_pool", PSI_FLAG_GLOBAL}
+};
+
+static PSI_cond_key key_COND_thd_pool;
+
+static PSI_cond_info all_thd_pool_conds[]=
+{
+  { &key_COND_thd_pool, "COND_thd_pool", PSI_FLAG_GLOBAL}
+};
+
+static PSI_thread_key key_thread_thd_pool;
+
+static PSI_thread_info all_thd_pool_threads[]=
+{
+  { &key_thread_thd_pool, "thd_pool", PSI_FLAG_GLOBAL}
+};
+#endif
+
+
+bool Thd_pool::init(bool enable_plugins)
+{
+#ifdef HAVE_PSI_INTERFACE
+  int count= array_elements(all_thd_pool_mutexes);
+  mysql_mutex_register("sql", all_thd_pool_mutexes, count);
+
+  count= array_elements(all_thd_pool_conds);
+  mysql_cond_register("sql", all_thd_pool_conds, count);
+
+  count= array_elements(all_thd_pool_threads);
+  mysql_thread_register("sql", all_thd_pool_threads, count);
+#endif
+
+  mysql_mutex_init(key_LOCK_thd_pool, &LOCK_thd_pool, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_thd_pool, &COND_thd_pool);
+  m_enable_plugins= enable_plugins;
+  m_shutdown= false;
+  m_thds= new (std::nothrow) std::vector<THD*>;
+  if (m_thds == NULL)
+    return true;
+
+  my_thread_attr_t attr;
+  my_thread_attr_init(&attr);
+  int error= mysql_thread_create(key_thread_thd_pool, &m_thread, &attr,
+                                 refill, NULL);
+  (void) my_thread_attr_destroy(&attr);
+  if (error)
+  {
+    sql_print_error("Can't create the THD pool thread (errno= %d)", error);
+    return true;
+  }
+  m_started= true;
+  return false;
+}
+
+
+void Thd_pool::destroy()
+{
+  if (m_thds == NULL)
+    return;
+
+  if (m_started)
+  {
+    mysql_mutex_lock(&LOCK_thd_pool);
+    m_shutdown= true;
+    mysql_cond_signal(&COND_thd_pool);
+    mysql_mutex_unlock(&LOCK_thd_pool);
+    my_thread_join(&m_thread, NULL);
+    m_started= false;
+  }
+
+  for (std::vector<THD*>::iterator it= m_thds->begin();
+       it != m_thds->end(); ++it)
+    delete *it;
+  delete m_thds;
+  m_thds= NULL;
+  mysql_mutex_destroy(&LOCK_thd_pool);
+  mysql_cond_destroy(&COND_thd_pool);
+}
+
+
+THD *Thd_pool::get()
+{
+  THD *thd= NULL;
+
+  if (m_thds == NULL)
+    return NULL;
+
+  mysql_mutex_lock(&LOCK_thd_pool);
+  if (m_thds->empty())
+    misses++;
+  else
+  {
+    thd= m_thds->back();
+    m_thds->pop_back();
+    hits++;
+    mysql_cond_signal(&COND_thd_pool);
+  }
+  mysql_mutex_unlock(&LOCK_thd_pool);
+
+  if (thd != NULL)
+  {
+    /* Memory of the THD was allocated by the pool thread */
+    thd->claim_memory_ownership();
+    /* Global variables may have changed since the THD was constructed */
+    thd->reinit_for_connection();
+  }
+  return thd;
+}
+
+
+void Thd_pool::resize()
+{
+  if (m_thds == NULL)
+    return;
+
+  mysql_mutex_lock(&LOCK_thd_pool);
+  mysql_cond_signal(&COND_thd_pool);
+  mysql_mutex_unlock(&LOCK_thd_pool);
+}
+
+
+/**
+  Thread that keeps pool_size THDs in the pool. THDs are constructed
+  and deleted without holding LOCK_thd_pool.
+*/
+
+void *Thd_pool::refill(void *arg MY_ATTRIBUTE((unused)))
+{
+  my_thread_init();
+
+  mysql_mutex_lock(&LOCK_thd_pool);
+  while (!m_shutdown)
+  {
+    if (m_thds->size() < pool_size)
+    {
+      mysql_mutex_unlock(&LOCK_thd_pool);
+      THD *thd= new (std::nothrow) THD(m_enable_plugins);
+      mysql_mutex_lock(&LOCK_thd_pool);
+      if (thd == NULL)
+      {
+        /* Out of memory, connections construct their THDs meanwhile */
+        struct timespec abstime;
+        set_timespec(&abstime, 1);
+        mysql_cond_timedwait(&COND_thd_pool, &LOCK_thd_pool, &abstime);
+      }
+      else
+        m_thds->push_back(thd);
+    }
+    else if (m_thds->size() > pool_size)
+    {
+      THD *thd= m_thds->back();
+      m_thds->pop_back();
+      mysql_mutex_unlock(&LOCK_thd_pool);
+      delete thd;
+      mysql_mutex_lock(&LOCK_thd_pool);
+    }
+    else
+      mysql_cond_wait(&COND_thd_pool, &LOCK_thd_pool);
+  }
+  mysql_mutex_unlock(&LOCK_thd_pool);
+
+  my_thread_end();
+  my_thread_exit(0);
+  return NULL;
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+
+#ifndef THD_POOL_INCLUDED
+#define THD_POOL_INCLUDED
+
+#include "my_global.h"               // ulong
+#include "mysql/psi/mysql_thread.h"  // mysql_mutex_t
+#include <vector>
+
+class THD;
+
+
+/**
+  Pool of THD objects constructed ahead of the connections that will use
+  them.
+
+  Constructing a THD (memory roots, mutexes, transaction context, protocol
+  objects, instrumentation) is a noticeable part of the connection setup,
+  and in the thread pool it is done by the single listener thread. A
+  background thread keeps up to pool_size THDs ready, so that
+  Channel_info::create_thd() only has to take one and load the current
+  global system variables into it.
+*/
+class Thd_pool
+{
+  static mysql_mutex_t LOCK_thd_pool;
+  static mysql_cond_t COND_thd_pool;
+
+  // THDs ready for new connections, protected by LOCK_thd_pool
+  static std::vector<THD*> *m_thds;
+  static my_thread_handle m_thread;
+  static bool m_started;
+  static bool m_shutdown;
+  static bool m_enable_plugins;
+
+  static void *refill(void *arg);
+
+public:
+  // Number of THDs to keep ready, @@thd_pool_size
+  static ulong pool_size;
+
+  // Status variables
+  static ulong hits;
+  static ulong misses;
+
+  /**
+    Start the thread that fills the pool.
+
+    @param enable_plugins  Passed to the THD constructor. Unit tests,
+                           which run without plugins, use false.
+
+    @retval false  Success.
+    @retval true   Failure.
+  */
+  static bool init(bool enable_plugins= true);
+
+  /**
+    Stop the pool thread and delete the THDs in the pool. Must be
+    called before the plugins are shut down.
+  */
+  static void destroy();
+
+  /**
+    Take a THD from the pool.
+
+    @retval NULL   The pool is empty.
+    @retval !NULL  THD that is initialized with the current global
+                   system variables and owned by the calling thread.
+  */
+  static THD *get();
+
+  /** Wake up the pool thread after thd_pool_size changed. */
+  static void resize();
+};
+
+#endif // THD_POOL_INCLUDED.
@@ -39,6 +39,12 @@
 
 static PSI_memory_key key_memory_MDL_context_acquire_locks;
 
+#ifdef CPU_LEVEL1_DCACHE_LINESIZE
+#define MDL_CACHE_LINE_SIZE CPU_LEVEL1_DCACHE_LINESIZE
+#else
+#define MDL_CACHE_LINE_SIZE 64
+#endif
+
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_MDL_wait_LOCK_wait_status;
 
@@ -537,6 +543,12 @@ public:
 public:
   /** The key of the object (data) being protected. */
   MDL_key key;
+  /**
+    Number of times this object has been (re-)initialized by MDL_map for
+    some key. Allows MDL_context::try_acquire_lock_cached() to tell the
+    object it has cached from one which was destroyed and reused since.
+  */
+  volatile int32 m_version;
   /**
     Read-write lock protecting this lock context.
 
@@ -813,7 +825,7 @@ public:
     MDL_lock::reinit(). So @sa MDL_lock::reiniti()
   */
   MDL_lock()
-    : m_obtrusive_locks_granted_waiting_count(0)
+    : m_version(0), m_obtrusive_locks_granted_waiting_count(0)
   {
     mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
   }
@@ -914,8 +926,15 @@ public:
 
     @note Needs to be volatile in order to be compatible with our
           my_atomic_*() API.
+
+    @note Lives on its own cache line, so that the stream of atomic
+          updates from concurrent "fast path" lock requests does not
+          keep invalidating the key and strategy which all of them read.
   */
+  char m_pad_before_fast_path_state[MDL_CACHE_LINE_SIZE];
   volatile fast_path_state_t m_fast_path_state;
+  char m_pad_after_fast_path_state[MDL_CACHE_LINE_SIZE -
+                                   sizeof(fast_path_state_t)];
 
   /**
     Wrapper for my_atomic_cas64 operation on m_fast_path_state member
@@ -971,6 +990,8 @@ public:
     return old_state;
   }
 
+  inline bool fast_path_release(fast_path_state_t unobtrusive_lock_increment);
+
   /**
     Wrapper for resetting m_fast_path_state enforcing locking invariants.
   */
@@ -1178,7 +1199,12 @@ void MDL_map::init()
 
   m_unused_lock_objects= 0;
 
-  lf_hash_init2(&m_locks, sizeof(MDL_lock), LF_HASH_UNIQUE,
+  /*
+    Every look-up is paired with lf_hash_search_unpin() shortly after,
+    so epoch based reclamation holds back little memory, and saves the
+    memory barriers of pinning on each step of the bucket list.
+  */
+  lf_hash_init2(&m_locks, sizeof(MDL_lock), LF_HASH_UNIQUE | LF_HASH_EPOCH,
                 0, 0, mdl_locks_key, &my_charset_bin, &murmur3_adapter,
                 &mdl_lock_cons, &mdl_lock_dtor, &mdl_lock_reinit);
 }
@@ -1500,6 +1526,7 @@ MDL_context::MDL_context()
   m_pins(NULL),
   m_rand_state(UINT_MAX32)
 {
+  memset(m_lock_cache, 0, sizeof(m_lock_cache));
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
 }
 
@@ -1656,6 +1683,12 @@ inline void MDL_lock::reinit(const MDL_key *mdl_key)
   m_hog_lock_count= 0;
   m_piglet_lock_count= 0;
   m_current_waiting_incompatible_idx= 0;
+  /*
+    Bump the version before the state is reset, so that a context which
+    manages to take a "fast path" lock on the reused object through a
+    stale cache entry sees the new version (@sa m_version).
+  */
+  my_atomic_add32(&m_version, 1);
   m_fast_path_state= 0;
   /*
     Check that we have clean "m_granted" and "m_waiting" sets/lists in both
@@ -1667,6 +1700,81 @@ inline void MDL_lock::reinit(const MDL_key *mdl_key)
 }
 
 
+/**
+  Release one "fast path" lock represented by the given increment of
+  m_fast_path_state.
+
+  @return true if this was the last lock on the object, so that it has
+          become unused and should be counted as such by the caller.
+*/
+
+inline bool
+MDL_lock::fast_path_release(fast_path_state_t unobtrusive_lock_increment)
+{
+  /*
+    We need decrement part of m_fast_path_state which holds number of
+    acquired "fast path" locks of this type. This needs to be done
+    by atomic compare-and-swap.
+
+    The same atomic compare-and-swap needs to check:
+
+    *) If HAS_OBSTRUSIVE flag is set. In this case we need to acquire
+       MDL_lock::m_rwlock before changing m_fast_path_state. This is
+       needed to enforce invariant [INV1] and also because we might
+       have to atomically wake-up some waiters for our "unobtrusive"
+       lock to go away.
+    *) If we are about to release last "fast path" lock and there
+       are no "slow path" locks. In this case we need to count
+       MDL_lock object as unused and maybe even delete some
+       unused MDL_lock objects eventually.
+
+    Similarly to the case with "fast path" acquisition it is OK to
+    perform ordinary read of MDL_lock::m_fast_path_state as correctness
+    of value returned by it will be validated by atomic compare-and-swap.
+    Again, in theory, this algorithm will work correctly if the read will
+    return random values.
+  */
+  fast_path_state_t old_state= m_fast_path_state;
+  bool last_use;
+
+  do
+  {
+    if (old_state & HAS_OBTRUSIVE)
+    {
+      mysql_prlock_wrlock(&m_rwlock);
+      /*
+        It is possible that obtrusive lock has gone away since we have
+        read m_fast_path_state value. This means that there is possibility
+        that there are no "slow path" locks (HAS_SLOW_PATH is not set) and
+        we are about to release last "fast path" lock. In this case MDL_lock
+        will become unused and needs to be counted as such eventually.
+      */
+      last_use= (fast_path_state_add(-unobtrusive_lock_increment) ==
+                 unobtrusive_lock_increment);
+      /*
+        There might be some lock requests waiting for ticket being released
+        to go away. Since this is "fast path" ticket it represents
+        "unobtrusive" type of lock. In this case if there are any waiters
+        for it there should be "obtrusive" type of request among them.
+      */
+      if (m_obtrusive_locks_granted_waiting_count)
+        reschedule_waiters();
+      mysql_prlock_unlock(&m_rwlock);
+      return last_use;
+    }
+    /*
+      If there are no "slow path" locks (HAS_SLOW_PATH is not set) and
+      we are about to release last "fast path" lock - MDL_lock object
+      will become unused and needs to be counted as such.
+    */
+    last_use= (old_state == unobtrusive_lock_increment);
+  }
+  while (! fast_path_state_cas(&old_state,
+                               old_state - unobtrusive_lock_increment));
+  return last_use;
+}
+
+
 /**
   @returns "Fast path" increment for request for "unobtrusive" type
             of lock, 0 - if it is request for "obtrusive" type of
@@ -2836,6 +2944,94 @@ MDL_context::find_ticket(MDL_request *mdl_request,
 }
 
 
+/**
+  Slot of MDL_context::m_lock_cache for the key.
+*/
+
+inline MDL_context::Lock_cache_entry *
+MDL_context::lock_cache_entry(const MDL_key *key)
+{
+  return &m_lock_cache[murmur3_32(key->ptr(), key->length(), 0) %
+                       LOCK_CACHE_SIZE];
+}
+
+
+/**
+  Try to acquire "unobtrusive" lock using "fast path" on MDL_lock object
+  from this context's cache, without look-up in MDL_map.
+
+  The cached pointer is not pinned, so the object might have been
+  destroyed and returned to the allocator, or even reused for another
+  key, since it was cached. LF_ALLOCATOR never frees memory before
+  MDL_map is destroyed, so reading the object is safe, and:
+
+  - If it is destroyed and not reused yet, IS_DESTROYED flag is set and
+    we give up.
+  - If it was reused, MDL_lock::m_version has changed. Once our increment
+    of m_fast_path_state is in, the object can't be destroyed or reused
+    any longer, so checking the version after the compare-and-swap tells
+    whether we have locked the object we wanted. If not, we give the
+    increment back as if releasing the lock.
+
+  @retval TRUE  - Lock was acquired, ticket is filled and registered.
+  @retval FALSE - Cache miss or the lock needs to be acquired normally.
+*/
+
+bool
+MDL_context::try_acquire_lock_cached(MDL_request *mdl_request,
+                                     MDL_ticket *ticket,
+                                     longlong unobtrusive_lock_increment)
+{
+  Lock_cache_entry *entry= lock_cache_entry(&mdl_request->key);
+  MDL_lock *lock= entry->m_lock;
+  MDL_lock::fast_path_state_t old_state;
+  bool first_use;
+
+  if (lock == NULL || ! lock->key.is_equal(&mdl_request->key))
+    return FALSE;
+
+  old_state= lock->m_fast_path_state;
+  do
+  {
+    /* Leave destroyed objects and "obtrusive" locks to the usual path. */
+    if (old_state & (MDL_lock::IS_DESTROYED | MDL_lock::HAS_OBTRUSIVE))
+      return FALSE;
+    first_use= (old_state == 0);
+  }
+  while (! lock->fast_path_state_cas(&old_state,
+                                     old_state + unobtrusive_lock_increment));
+
+  if (my_atomic_load32(&lock->m_version) != entry->m_version)
+  {
+    /*
+      Not the object we have cached. Take our increment back. Counting
+      of unused objects only needs adjustment if somebody else started
+      or stopped using the object while we had it.
+    */
+    bool last_use= lock->fast_path_release(unobtrusive_lock_increment);
+    if (first_use && ! last_use)
+      mdl_locks.lock_object_used();
+    else if (! first_use && last_use)
+      mdl_locks.lock_object_unused(this, m_pins);
+    entry->m_lock= NULL;
+    return FALSE;
+  }
+
+  if (first_use)
+    mdl_locks.lock_object_used();
+
+  ticket->m_lock= lock;
+  ticket->m_is_fast_path= true;
+
+  m_tickets[mdl_request->duration].push_front(ticket);
+
+  mdl_request->ticket= ticket;
+
+  mysql_mdl_set_status(ticket->m_psi, MDL_ticket::GRANTED);
+  return TRUE;
+}
+
+
 /**
   Try to acquire one lock.
 
@@ -3119,6 +3315,10 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
     mysql_mdl_set_status(ticket->m_psi, MDL_ticket::PENDING);
   }
 
+  if (! force_slow && ! mdl_locks.is_lock_object_singleton(key) &&
+      try_acquire_lock_cached(mdl_request, ticket, unobtrusive_lock_increment))
+    return FALSE;
+
 retry:
   /*
     The below call pins pointer to returned MDL_lock object (unless
@@ -3244,6 +3444,17 @@ retry:
     ticket->m_lock= lock;
     ticket->m_is_fast_path= true;
 
+    /*
+      Our lock keeps the object from being destroyed, so its version
+      can't change while we remember it.
+    */
+    if (pinned)
+    {
+      Lock_cache_entry *entry= lock_cache_entry(key);
+      entry->m_lock= lock;
+      entry->m_version= my_atomic_load32(&lock->m_version);
+    }
+
     m_tickets[mdl_request->duration].push_front(ticket);
 
     mdl_request->ticket= ticket;
@@ -4353,68 +4564,8 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
     /* We should not have "fast path" tickets for "obtrusive" lock types. */
     assert(unobtrusive_lock_increment != 0);
 
-    /*
-      We need decrement part of m_fast_path_state which holds number of
-      acquired "fast path" locks of this type. This needs to be done
-      by atomic compare-and-swap.
-
-      The same atomic compare-and-swap needs to check:
-
-      *) If HAS_OBSTRUSIVE flag is set. In this case we need to acquire
-         MDL_lock::m_rwlock before changing m_fast_path_state. This is
-         needed to enforce invariant [INV1] and also because we might
-         have to atomically wake-up some waiters for our "unobtrusive"
-         lock to go away.
-      *) If we are about to release last "fast path" lock and there
-         are no "slow path" locks. In this case we need to count
-         MDL_lock object as unused and maybe even delete some
-         unused MDL_lock objects eventually.
-
-      Similarly to the case with "fast path" acquisition it is OK to
-      perform ordinary read of MDL_lock::m_fast_path_state as correctness
-      of value returned by it will be validated by atomic compare-and-swap.
-      Again, in theory, this algorithm will work correctly if the read will
-      return random values.
-    */
-    MDL_lock::fast_path_state_t old_state= lock->m_fast_path_state;
-    bool last_use;
-
-    do
-    {
-      if (old_state & MDL_lock::HAS_OBTRUSIVE)
-      {
-        mysql_prlock_wrlock(&lock->m_rwlock);
-        /*
-          It is possible that obtrusive lock has gone away since we have
-          read m_fast_path_state value. This means that there is possibility
-          that there are no "slow path" locks (HAS_SLOW_PATH is not set) and
-          we are about to release last "fast path" lock. In this case MDL_lock
-          will become unused and needs to be counted as such eventually.
-        */
-        last_use= (lock->fast_path_state_add(-unobtrusive_lock_increment) ==
-                   unobtrusive_lock_increment);
-        /*
-          There might be some lock requests waiting for ticket being released
-          to go away. Since this is "fast path" ticket it represents
-          "unobtrusive" type of lock. In this case if there are any waiters
-          for it there should be "obtrusive" type of request among them.
-        */
-        if (lock->m_obtrusive_locks_granted_waiting_count)
-          lock->reschedule_waiters();
-        mysql_prlock_unlock(&lock->m_rwlock);
-        goto end_fast_path;
-      }
-      /*
-        If there are no "slow path" locks (HAS_SLOW_PATH is not set) and
-        we are about to release last "fast path" lock - MDL_lock object
-        will become unused and needs to be counted as such.
-      */
-      last_use= (old_state == unobtrusive_lock_increment);
-    }
-    while (! lock->fast_path_state_cas(&old_state,
-                                       old_state - unobtrusive_lock_increment));
+    bool last_use= lock->fast_path_release(unobtrusive_lock_increment);
 
-end_fast_path:
     /* Don't count singleton MDL_lock objects as unused. */
     if (last_use && ! is_singleton)
       mdl_locks.lock_object_unused(this, m_pins);
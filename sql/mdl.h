@@ -1122,6 +1122,23 @@ private:
     when searching for unused objects to free.
   */
   uint m_rand_state;
+  /**
+    Small direct-mapped cache of MDL_lock objects on which this context
+    has recently acquired "fast path" locks, indexed by hash of the key.
+    Lets statements which keep using the same hot tables skip the
+    look-up in MDL_map and the pinning it involves.
+
+    Entries are only hints: the object may have been destroyed and
+    reused for another key since it was cached, which is detected by
+    comparing its MDL_lock::m_version with the cached one.
+  */
+  struct Lock_cache_entry
+  {
+    MDL_lock *m_lock;
+    int32 m_version;
+  };
+  static const uint LOCK_CACHE_SIZE= 16;
+  Lock_cache_entry m_lock_cache[LOCK_CACHE_SIZE];
 
 private:
   MDL_ticket *find_ticket(MDL_request *mdl_req,
@@ -1130,6 +1147,9 @@ private:
   void release_lock(enum_mdl_duration duration, MDL_ticket *ticket);
   bool try_acquire_lock_impl(MDL_request *mdl_request,
                              MDL_ticket **out_ticket);
+  bool try_acquire_lock_cached(MDL_request *mdl_request, MDL_ticket *ticket,
+                               longlong unobtrusive_lock_increment);
+  inline Lock_cache_entry *lock_cache_entry(const MDL_key *key);
   void materialize_fast_path_locks();
   inline bool fix_pins();
 
@@ -152,6 +152,7 @@
 #include "connection_handler_impl.h"    // *_connection_handler
 #include "connection_handler_manager.h" // Connection_handler_manager
 #include "socket_connection.h"          // Mysqld_socket_listener
+#include "thd_pool.h"                   // Thd_pool
 #include "mysqld_thd_manager.h"         // Global_THD_manager
 #include "my_getopt.h"
 #include "partitioning/partition_handler.h" // partitioning_init
@@ -478,6 +479,7 @@ ulong back_log, connect_timeout, server_id;
 ulong table_cache_size, table_def_size;
 ulong table_cache_instances;
 ulong table_cache_size_per_instance;
+my_bool table_cache_cpu_affinity= TRUE;
 ulong what_to_log;
 ulong slow_launch_time;
 Atomic_int32 slave_open_temp_tables;
@@ -518,6 +520,7 @@ ulong binlog_cache_use= 0, binlog_cache_disk_use= 0;
 ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
 ulong max_connections, max_connect_errors;
 ulong extra_max_connections;
+ulong load_data_parallel_max_threads;
 ulong rpl_stop_slave_timeout= LONG_TIMEOUT;
 my_bool log_bin_use_v1_row_events= 0;
 bool thread_cache_size_specified= false;
@@ -544,6 +547,12 @@ ulong max_prepared_stmt_count;
   statements.
 */
 ulong prepared_stmt_count=0;
+/**
+  Limit of the memory held by closed prepared statements that are kept
+  for reuse (see Prepared_statement_map::park()), and the memory held.
+*/
+ulong prepared_stmt_cache_size;
+volatile int64 prepared_stmt_cache_memory= 0;
 ulong current_pid;
 uint sync_binlog_period= 0, sync_relaylog_period= 0,
      sync_relayloginfo_period= 0, sync_masterinfo_period= 0,
@@ -1149,6 +1158,8 @@ static void close_connections(void)
   */
   Connection_handler_manager::wait_till_no_connection();
 
+  Thd_pool::destroy();
+
   delete_slave_info_objects();
   DBUG_PRINT("quit",("close_connections thread"));
 
@@ -5506,6 +5517,9 @@ int mysqld_main(int argc, char **argv)
 #endif
   start_handle_manager();
 
+  if (!opt_bootstrap && Thd_pool::init())
+    sql_print_warning("New connections will not use pre-constructed THDs.");
+
   create_compress_gtid_table_thread();
 
   sql_print_information(ER_DEFAULT(ER_STARTUP),
@@ -6858,6 +6872,31 @@ static int show_open_tables(THD *thd, SHOW_VAR *var, char *buff)
   return 0;
 }
 
+static int show_query_alloc_pool(SHOW_VAR *var, char *buff, int which)
+{
+  ulonglong values[3];
+  var->type= SHOW_LONGLONG;
+  var->value= buff;
+  my_root_pool_stats(&values[0], &values[1], &values[2]);
+  *((longlong *)buff)= (longlong) values[which];
+  return 0;
+}
+
+static int show_query_alloc_pool_hits(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_query_alloc_pool(var, buff, 0);
+}
+
+static int show_query_alloc_pool_misses(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_query_alloc_pool(var, buff, 1);
+}
+
+static int show_query_alloc_pool_bytes(THD *thd, SHOW_VAR *var, char *buff)
+{
+  return show_query_alloc_pool(var, buff, 2);
+}
+
 static int show_prepared_stmt_count(THD *thd, SHOW_VAR *var, char *buff)
 {
   var->type= SHOW_LONG;
@@ -7399,6 +7438,11 @@ SHOW_VAR status_vars[]= {
   {"Key_reads",                (char*) offsetof(KEY_CACHE, global_cache_read),        SHOW_KEY_CACHE_LONGLONG, SHOW_SCOPE_GLOBAL},
   {"Key_write_requests",       (char*) offsetof(KEY_CACHE, global_cache_w_requests),  SHOW_KEY_CACHE_LONGLONG, SHOW_SCOPE_GLOBAL},
   {"Key_writes",               (char*) offsetof(KEY_CACHE, global_cache_write),       SHOW_KEY_CACHE_LONGLONG, SHOW_SCOPE_GLOBAL},
+#ifdef HAVE_LINUX_LARGE_PAGES
+  {"Large_memory_hugetlb",     (char*) &my_large_mmap_hugetlb_bytes,                  SHOW_LONGLONG,           SHOW_SCOPE_GLOBAL},
+  {"Large_memory_mapped",      (char*) &my_large_mmap_bytes,                          SHOW_LONGLONG,           SHOW_SCOPE_GLOBAL},
+  {"Large_memory_thp",         (char*) &my_large_mmap_thp_bytes,                      SHOW_LONGLONG,           SHOW_SCOPE_GLOBAL},
+#endif
   {"Last_query_cost",          (char*) offsetof(STATUS_VAR, last_query_cost),         SHOW_DOUBLE_STATUS,      SHOW_SCOPE_SESSION},
   {"Last_query_partial_plans", (char*) offsetof(STATUS_VAR, last_query_partial_plans),SHOW_LONGLONG_STATUS,    SHOW_SCOPE_SESSION},
 #ifndef EMBEDDED_LIBRARY
@@ -7417,6 +7461,9 @@ SHOW_VAR status_vars[]= {
   {"Opened_files",             (char*) &my_file_total_opened,                         SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
   {"Opened_tables",            (char*) offsetof(STATUS_VAR, opened_tables),           SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Opened_table_definitions", (char*) offsetof(STATUS_VAR, opened_shares),           SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
+  {"Prepared_stmt_cache_hits", (char*) offsetof(STATUS_VAR, prepared_stmt_cache_hits), SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
+  {"Prepared_stmt_cache_memory", (char*) &prepared_stmt_cache_memory,                 SHOW_LONGLONG,           SHOW_SCOPE_GLOBAL},
+  {"Prepared_stmt_cache_misses", (char*) offsetof(STATUS_VAR, prepared_stmt_cache_misses), SHOW_LONGLONG_STATUS, SHOW_SCOPE_ALL},
   {"Prepared_stmt_count",      (char*) &show_prepared_stmt_count,                     SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
   {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks,               SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
   {"Qcache_free_memory",       (char*) &query_cache.free_memory,                      SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
@@ -7427,6 +7474,9 @@ SHOW_VAR status_vars[]= {
   {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache,                 SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
   {"Qcache_total_blocks",      (char*) &query_cache.total_blocks,                     SHOW_LONG_NOFLUSH,       SHOW_SCOPE_GLOBAL},
   {"Queries",                  (char*) &show_queries,                                 SHOW_FUNC,               SHOW_SCOPE_ALL},
+  {"Query_alloc_pool_bytes",   (char*) &show_query_alloc_pool_bytes,                  SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
+  {"Query_alloc_pool_hits",    (char*) &show_query_alloc_pool_hits,                   SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
+  {"Query_alloc_pool_misses",  (char*) &show_query_alloc_pool_misses,                 SHOW_FUNC,               SHOW_SCOPE_GLOBAL},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions),               SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Select_full_join",         (char*) offsetof(STATUS_VAR, select_full_join_count),  SHOW_LONGLONG_STATUS,    SHOW_SCOPE_ALL},
   {"Select_full_range_join",   (char*) offsetof(STATUS_VAR, select_full_range_join_count), SHOW_LONGLONG_STATUS, SHOW_SCOPE_ALL},
@@ -7492,9 +7542,12 @@ SHOW_VAR status_vars[]= {
   {"Tc_log_page_waits",        (char*) &tc_log_page_waits,                             SHOW_LONG,              SHOW_SCOPE_GLOBAL},
 #ifdef HAVE_POOL_OF_THREADS
   {"Threadpool_idle_threads",  (char *) &show_threadpool_idle_threads,                 SHOW_FUNC,              SHOW_SCOPE_GLOBAL},
+  {"Threadpool_stolen_events", (char *) &tp_stats.num_stolen_events,                   SHOW_LONGLONG,          SHOW_SCOPE_GLOBAL},
   {"Threadpool_threads",       (char *) &tp_stats.num_worker_threads,                  SHOW_INT,               SHOW_SCOPE_GLOBAL},
 #endif
 #ifndef EMBEDDED_LIBRARY
+  {"Thd_pool_hits",            (char*) &Thd_pool::hits,                                SHOW_LONG,              SHOW_SCOPE_GLOBAL},
+  {"Thd_pool_misses",          (char*) &Thd_pool::misses,                              SHOW_LONG,              SHOW_SCOPE_GLOBAL},
   {"Threads_cached",           (char*) &Per_thread_connection_handler::blocked_pthread_count, SHOW_LONG_NOFLUSH, SHOW_SCOPE_GLOBAL},
 #endif
   {"Threads_connected",        (char*) &Connection_handler_manager::connection_count,  SHOW_INT,               SHOW_SCOPE_GLOBAL},
@@ -8296,6 +8349,7 @@ mysql_getopt_value(const char *keyname, size_t key_length,
   case OPT_KEY_CACHE_BLOCK_SIZE:
   case OPT_KEY_CACHE_DIVISION_LIMIT:
   case OPT_KEY_CACHE_AGE_THRESHOLD:
+  case OPT_KEY_CACHE_PARTITIONS:
   {
     KEY_CACHE *key_cache;
     if (!(key_cache= get_or_create_key_cache(keyname, key_length)))
@@ -8313,6 +8367,8 @@ mysql_getopt_value(const char *keyname, size_t key_length,
       return &key_cache->param_division_limit;
     case OPT_KEY_CACHE_AGE_THRESHOLD:
       return &key_cache->param_age_threshold;
+    case OPT_KEY_CACHE_PARTITIONS:
+      return &key_cache->param_partitions;
     }
   }
   }
@@ -9238,6 +9294,7 @@ PSI_mutex_key
   key_LOCK_log_throttle_qni, key_LOCK_query_plan, key_LOCK_thd_query,
   key_LOCK_cost_const, key_LOCK_current_cond,
   key_LOCK_keyring_operations;
+PSI_mutex_key key_LOCK_load_data_parallel;
 PSI_mutex_key key_RELAYLOG_LOCK_commit;
 PSI_mutex_key key_RELAYLOG_LOCK_commit_queue;
 PSI_mutex_key key_RELAYLOG_LOCK_done;
@@ -9325,6 +9382,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_thd_sysvar, "THD::LOCK_thd_sysvar", PSI_FLAG_VOLATILITY_SESSION},
   { &key_LOCK_user_conn, "LOCK_user_conn", PSI_FLAG_GLOBAL},
   { &key_LOCK_uuid_generator, "LOCK_uuid_generator", PSI_FLAG_GLOBAL},
+  { &key_LOCK_load_data_parallel, "Load_data_parallel::m_lock", 0},
   { &key_LOCK_sql_rand, "LOCK_sql_rand", PSI_FLAG_GLOBAL},
   { &key_LOG_LOCK_log, "LOG::LOCK_log", 0},
   { &key_master_info_data_lock, "Master_info::data_lock", 0},
@@ -9424,6 +9482,7 @@ PSI_cond_key key_RELAYLOG_prep_xids_cond;
 PSI_cond_key key_gtid_ensure_index_cond;
 PSI_cond_key key_COND_compress_gtid_table;
 PSI_cond_key key_COND_thr_lock;
+PSI_cond_key key_COND_load_data_parallel;
 #ifdef HAVE_REPLICATION
 PSI_cond_key key_commit_order_manager_cond;
 PSI_cond_key key_cond_slave_worker_hash;
@@ -9451,6 +9510,7 @@ static PSI_cond_info all_server_conds[]=
   { &key_COND_start_signal_handler, "COND_start_signal_handler", PSI_FLAG_GLOBAL},
 #endif
   { &key_COND_thr_lock, "COND_thr_lock", 0 },
+  { &key_COND_load_data_parallel, "Load_data_parallel::m_cond", 0},
   { &key_item_func_sleep_cond, "Item_func_sleep::cond", 0},
   { &key_master_info_data_cond, "Master_info::data_cond", 0},
   { &key_master_info_start_cond, "Master_info::start_cond", 0},
@@ -9479,6 +9539,7 @@ PSI_thread_key key_thread_bootstrap, key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
   key_thread_compress_gtid_table, key_thread_parser_service;
 PSI_thread_key key_thread_timer_notifier;
+PSI_thread_key key_thread_load_data_parser;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -9496,6 +9557,7 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_compress_gtid_table, "compress_gtid_table", PSI_FLAG_GLOBAL},
   { &key_thread_parser_service, "parser_service", PSI_FLAG_GLOBAL},
+  { &key_thread_load_data_parser, "load_data_parser", 0},
 };
 
 PSI_file_key key_file_map;
@@ -110,6 +110,9 @@ extern void thd_increment_bytes_received(size_t length);
 #define VIO_SOCKET_ERROR  ((size_t) -1)
 
 static my_bool net_write_buff(NET *, const uchar *, size_t);
+#ifndef _WIN32
+static my_bool net_write_buff_and_packet(NET *, const uchar *, size_t);
+#endif
 
 /** Init with packet info. */
 
@@ -131,7 +134,7 @@ my_bool my_net_init(NET *net, Vio* vio)
   net->compress=0; net->reading_or_writing=0;
   net->where_b = net->remain_in_buf=0;
   net->last_errno=0;
-  net->unused= 0;
+  net->compress_ctx= NULL;
 #ifdef MYSQL_SERVER
   net->extension= NULL;
 #endif
@@ -151,6 +154,8 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+  my_compress_context_free((COMPRESS_CONTEXT *) net->compress_ctx);
+  net->compress_ctx= NULL;
   DBUG_VOID_RETURN;
 }
 
@@ -476,6 +481,16 @@ net_write_buff(NET *net, const uchar *packet, size_t len)
 #endif
   if (len > left_length)
   {
+#ifndef _WIN32
+    /*
+      Without compression, packets go to the network as they are, so send
+      the cached data and the packet together, instead of copying the
+      packet into the cache first.
+    */
+    if (!net->compress && net->write_pos != net->buff && net->vio &&
+        net->vio->writev)
+      return net_write_buff_and_packet(net, packet, len);
+#endif
     if (net->write_pos != net->buff)
     {
       /* Fill up already used packet and write it */
@@ -512,6 +527,27 @@ net_write_buff(NET *net, const uchar *packet, size_t len)
 }
 
 
+/**
+  Set the error state of a network handler after a failed write.
+*/
+
+static void net_write_error(NET *net)
+{
+  /* Socket should be closed. */
+  net->error= 2;
+
+  /* Interrupted by a timeout? */
+  if (vio_was_timeout(net->vio))
+    net->last_errno= ER_NET_WRITE_INTERRUPTED;
+  else
+    net->last_errno= ER_NET_ERROR_ON_WRITE;
+
+#ifdef MYSQL_SERVER
+  my_error(net->last_errno, MYF(0));
+#endif
+}
+
+
 /**
   Write a determined number of bytes to a network handler.
 
@@ -550,23 +586,111 @@ net_write_raw_loop(NET *net, const uchar *buf, size_t count)
 
   /* On failure, propagate the error code. */
   if (count)
+    net_write_error(net);
+
+  return MY_TEST(count);
+}
+
+
+#ifndef _WIN32
+/**
+  Write the contents of a scatter/gather array to a network handler.
+
+  @param  net     NET handler.
+  @param  iov     Array of buffers, modified to track partial writes.
+  @param  iovcnt  Number of elements in the array.
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_writev_raw_loop(NET *net, struct iovec *iov, int iovcnt)
+{
+  unsigned int retry_count= 0;
+
+  while (iovcnt)
   {
-    /* Socket should be closed. */
-    net->error= 2;
+    size_t sentcnt= vio_writev(net->vio, iov, iovcnt);
 
-    /* Interrupted by a timeout? */
-    if (vio_was_timeout(net->vio))
-      net->last_errno= ER_NET_WRITE_INTERRUPTED;
-    else
-      net->last_errno= ER_NET_ERROR_ON_WRITE;
+    /* VIO_SOCKET_ERROR (-1) indicates an error. */
+    if (sentcnt == VIO_SOCKET_ERROR)
+    {
+      /* A recoverable I/O error occurred? */
+      if (net_should_retry(net, &retry_count))
+        continue;
+      else
+        break;
+    }
 
 #ifdef MYSQL_SERVER
-    my_error(net->last_errno, MYF(0));
+    thd_increment_bytes_sent(sentcnt);
 #endif
+
+    /* Skip what was sent, the last buffer might be sent partially. */
+    while (iovcnt && sentcnt >= iov->iov_len)
+    {
+      sentcnt-= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt)
+    {
+      iov->iov_base= (char *) iov->iov_base + sentcnt;
+      iov->iov_len-= sentcnt;
+    }
   }
 
-  return MY_TEST(count);
+  /* On failure, propagate the error code. */
+  if (iovcnt)
+    net_write_error(net);
+
+  return MY_TEST(iovcnt);
+}
+
+
+/**
+  Send the cached data followed by a packet with a single gathering write.
+
+  This is the uncompressed counterpart of filling up the cache, writing it
+  and then writing or caching the rest of the packet in net_write_buff().
+  It saves copying the packet, which matters for big result set rows.
+
+  @param net		Network handler
+  @param packet	Data to send after the cached data
+  @param len		Length of packet
+
+  @return TRUE on error, FALSE on success.
+*/
+
+static my_bool
+net_write_buff_and_packet(NET *net, const uchar *packet, size_t len)
+{
+  my_bool res;
+  struct iovec iov[2];
+  DBUG_ENTER("net_write_buff_and_packet");
+
+  iov[0].iov_base= (char *) net->buff;
+  iov[0].iov_len= (size_t) (net->write_pos - net->buff);
+  iov[1].iov_base= (char *) packet;
+  iov[1].iov_len= len;
+  net->write_pos= net->buff;
+
+#if defined(MYSQL_SERVER)
+  query_cache_insert((char *) iov[0].iov_base, iov[0].iov_len, net->pkt_nr);
+  query_cache_insert((char *) packet, len, net->pkt_nr);
+#endif
+
+  /* Socket can't be used */
+  if (net->error == 2)
+    DBUG_RETURN(TRUE);
+
+  net->reading_or_writing= 2;
+  res= net_writev_raw_loop(net, iov, 2);
+  net->reading_or_writing= 0;
+
+  DBUG_RETURN(res);
 }
+#endif /* !_WIN32 */
 
 
 /**
@@ -599,7 +723,10 @@ compress_packet(NET *net, const uchar *packet, size_t *length)
   memcpy(compr_packet + header_length, packet, *length);
 
   /* Compress the encapsulated packet. */
-  if (my_compress(compr_packet + header_length, length, &compr_length))
+  if (net->compress_ctx ?
+      my_compress_ctx((COMPRESS_CONTEXT *) net->compress_ctx,
+                      compr_packet + header_length, length, &compr_length) :
+      my_compress(compr_packet + header_length, length, &compr_length))
   {
     /*
       If the length of the compressed packet is larger than the
@@ -1059,8 +1186,10 @@ my_net_read(NET *net)
         MYSQL_NET_READ_DONE(1, 0);
         return packet_error;
       }
-      if (my_uncompress(net->buff + net->where_b, packet_len,
-                        &complen))
+      if (net->compress_ctx ?
+          my_uncompress_ctx((COMPRESS_CONTEXT *) net->compress_ctx,
+                            net->buff + net->where_b, packet_len, &complen) :
+          my_uncompress(net->buff + net->where_b, packet_len, &complen))
       {
         net->error= 2;			/* caller will close socket */
         net->last_errno= ER_NET_UNCOMPRESS_ERROR;
@@ -252,8 +252,15 @@ bool init_read_record(READ_RECORD *info,THD *thd,
     }
 
     info->io_cache=tempfile;
-    if (reinit_io_cache(info->io_cache, READ_CACHE, 0L, 0, 0))
-      goto err;
+    /* A large sort result is read sequentially, let it read ahead */
+    {
+      my_off_t length= tempfile->type == READ_CACHE ?
+        tempfile->end_of_file : my_b_tell(tempfile);
+      my_bool read_ahead= length / MIN_CACHES_TO_READ_AHEAD_SORT_RESULT >
+        (my_off_t) tempfile->buffer_length;
+      if (reinit_io_cache(info->io_cache, READ_CACHE, 0L, read_ahead, 0))
+        goto err;
+    }
     info->ref_pos=table->file->ref;
     if (!table->file->inited &&
         (error= table->file->ha_rnd_init(0)))
@@ -1793,7 +1793,7 @@ void close_thread_table(THD *thd, TABLE **table_ptr)
   if (table->file != NULL)
     table->file->unbind_psi();
 
-  Table_cache *tc= table_cache_manager.get_cache(thd);
+  Table_cache *tc= table_cache_manager.get_cache(table);
 
   tc->lock();
 
@@ -3735,7 +3735,7 @@ table_found:
         thd->backup_tables_lock.acquire_protection(thd, MDL_STATEMENT,
                                                    ot_ctx->get_timeout()))
     {
-      Table_cache *tc= table_cache_manager.get_cache(thd);
+      Table_cache *tc= table_cache_manager.get_cache(table);
 
       tc->lock();
 
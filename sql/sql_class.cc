@@ -1818,6 +1818,7 @@ void THD::init_for_queries(Relay_log_info *rli)
 
   reset_root_defaults(mem_root, variables.query_alloc_block_size,
                       variables.query_prealloc_size);
+  set_memroot_recycle_limit(mem_root, variables.query_alloc_recycle_size);
   get_transaction()->init_mem_root_defaults(variables.trans_alloc_block_size,
                                             variables.trans_prealloc_size);
   get_transaction()->xid_state()->reset();
@@ -1844,6 +1845,17 @@ void THD::set_new_thread_id()
 }
 
 
+void THD::reinit_for_connection(void)
+{
+  /* Undo what init() did in the constructor before running it again */
+  session_tracker.deinit();
+#if defined(ENABLED_DEBUG_SYNC)
+  debug_sync_end_thread(this);
+#endif /* defined(ENABLED_DEBUG_SYNC) */
+  init();
+}
+
+
 /*
   Do what's needed when one invokes change user
 
@@ -3706,9 +3718,12 @@ get_statement_id_as_hash_key(const uchar *record, size_t *key_length,
   return (uchar *) &(statement)->id;
 }
 
-static void delete_statement_as_hash_key(void *key)
+static uchar *get_stmt_cache_hash_key(Prepared_statement *entry,
+                                      size_t *length,
+                                      my_bool not_used MY_ATTRIBUTE((unused)))
 {
-  delete (Prepared_statement *) key;
+  *length= entry->cache_key().length;
+  return reinterpret_cast<uchar *>(const_cast<char *>(entry->cache_key().str));
 }
 
 static uchar *get_stmt_name_hash_key(Prepared_statement *entry, size_t *length,
@@ -3721,21 +3736,27 @@ static uchar *get_stmt_name_hash_key(Prepared_statement *entry, size_t *length,
 C_MODE_END
 
 Prepared_statement_map::Prepared_statement_map()
- :m_last_found_statement(NULL)
+ :m_park_clock(0), m_last_found_statement(NULL)
 {
   enum
   {
     START_STMT_HASH_SIZE = 16,
-    START_NAME_HASH_SIZE = 16
+    START_NAME_HASH_SIZE = 16,
+    START_PARKED_HASH_SIZE = 16
   };
+  /* Statements are deleted explicitly, they may move to parked_hash */
   my_hash_init(&st_hash, &my_charset_bin, START_STMT_HASH_SIZE, 0, 0,
                get_statement_id_as_hash_key,
-               delete_statement_as_hash_key, MYF(0),
+               NULL, MYF(0),
                key_memory_prepared_statement_map);
   my_hash_init(&names_hash, system_charset_info, START_NAME_HASH_SIZE, 0, 0,
                (my_hash_get_key) get_stmt_name_hash_key,
                NULL, MYF(0),
                key_memory_prepared_statement_map);
+  my_hash_init(&parked_hash, &my_charset_bin, START_PARKED_HASH_SIZE, 0, 0,
+               (my_hash_get_key) get_stmt_cache_hash_key,
+               NULL, MYF(0),
+               key_memory_prepared_statement_map);
 }
 
 
@@ -3782,6 +3803,7 @@ err_max:
     my_hash_delete(&names_hash, (uchar*) statement);
 err_names_hash:
   my_hash_delete(&st_hash, (uchar*) statement);
+  delete statement;
 err_st_hash:
   return 1;
 }
@@ -3810,7 +3832,7 @@ Prepared_statement *Prepared_statement_map::find(ulong id)
 }
 
 
-void Prepared_statement_map::erase(Prepared_statement *statement)
+void Prepared_statement_map::unlink(Prepared_statement *statement)
 {
   if (statement == m_last_found_statement)
     m_last_found_statement= NULL;
@@ -3824,10 +3846,89 @@ void Prepared_statement_map::erase(Prepared_statement *statement)
   mysql_mutex_unlock(&LOCK_prepared_stmt_count);
 }
 
+
+void Prepared_statement_map::erase(Prepared_statement *statement)
+{
+  unlink(statement);
+  delete statement;
+}
+
+
+void Prepared_statement_map::evict_parked(Prepared_statement *statement)
+{
+  my_hash_delete(&parked_hash, (uchar *) statement);
+  my_atomic_add64(&prepared_stmt_cache_memory,
+                  -(int64) statement->memory_used());
+  delete statement;
+}
+
+
+void Prepared_statement_map::park(Prepared_statement *statement)
+{
+  const int64 size= (int64) statement->memory_used();
+  const int64 limit= (int64) prepared_stmt_cache_size;
+
+  unlink(statement);
+
+  if (size > limit)
+  {
+    delete statement;
+    return;
+  }
+
+  /*
+    Reserve the memory before checking the limit, so that sessions
+    parking at the same time can not pass it together.
+  */
+  my_atomic_add64(&prepared_stmt_cache_memory, size);
+
+  /* Make room by dropping the least recently parked statements */
+  while (parked_hash.records > 0 &&
+         my_atomic_load64(&prepared_stmt_cache_memory) > limit)
+  {
+    Prepared_statement *oldest= NULL;
+    for (uint i= 0; i < parked_hash.records; i++)
+    {
+      Prepared_statement *stmt=
+        reinterpret_cast<Prepared_statement *>(my_hash_element(&parked_hash, i));
+      if (!oldest || stmt->parked_at() < oldest->parked_at())
+        oldest= stmt;
+    }
+    evict_parked(oldest);
+  }
+
+  if (my_atomic_load64(&prepared_stmt_cache_memory) > limit ||
+      my_hash_insert(&parked_hash, (uchar *) statement))
+  {
+    my_atomic_add64(&prepared_stmt_cache_memory, -size);
+    delete statement;
+    return;
+  }
+  statement->set_parked_at(++m_park_clock);
+}
+
+
+Prepared_statement *
+Prepared_statement_map::unpark(const char *key, size_t key_length)
+{
+  Prepared_statement *statement=
+    reinterpret_cast<Prepared_statement *>
+    (my_hash_search(&parked_hash, (const uchar *) key, key_length));
+  if (statement)
+  {
+    my_hash_delete(&parked_hash, (uchar *) statement);
+    my_atomic_add64(&prepared_stmt_cache_memory,
+                    -(int64) statement->memory_used());
+  }
+  return statement;
+}
+
+
 void Prepared_statement_map::claim_memory_ownership()
 {
   my_hash_claim(&names_hash);
   my_hash_claim(&st_hash);
+  my_hash_claim(&parked_hash);
 }
 
 void Prepared_statement_map::reset()
@@ -3835,19 +3936,21 @@ void Prepared_statement_map::reset()
   /* Must be first, hash_free will reset st_hash.records */
   if (st_hash.records > 0)
   {
-#ifdef HAVE_PSI_PS_INTERFACE
     for (uint i=0 ; i < st_hash.records ; i++)
     {
       Prepared_statement *stmt=
         reinterpret_cast<Prepared_statement *>(my_hash_element(&st_hash, i));
       MYSQL_DESTROY_PS(stmt->get_PS_prepared_stmt());
+      delete stmt;
     }
-#endif
     mysql_mutex_lock(&LOCK_prepared_stmt_count);
     assert(prepared_stmt_count >= st_hash.records);
     prepared_stmt_count-= st_hash.records;
     mysql_mutex_unlock(&LOCK_prepared_stmt_count);
   }
+  while (parked_hash.records > 0)
+    evict_parked(reinterpret_cast<Prepared_statement *>
+                 (my_hash_element(&parked_hash, 0)));
   my_hash_reset(&names_hash);
   my_hash_reset(&st_hash);
   m_last_found_statement= NULL;
@@ -3861,9 +3964,11 @@ Prepared_statement_map::~Prepared_statement_map()
     reset() should already have been called to maintain prepared_stmt_count.
    */
   assert(st_hash.records == 0);
+  assert(parked_hash.records == 0);
 
   my_hash_free(&names_hash);
   my_hash_free(&st_hash);
+  my_hash_free(&parked_hash);
 }
 
 
@@ -487,6 +487,7 @@ typedef struct system_variables
   ulong bulk_insert_buff_size;
   uint  eq_range_index_dive_limit;
   ulong join_buff_size;
+  ulong load_data_parallel_threads;
   ulong lock_wait_timeout;
   ulong max_allowed_packet;
   ulong max_error_count;
@@ -522,6 +523,7 @@ typedef struct system_variables
   ulong range_alloc_block_size;
   ulong query_alloc_block_size;
   ulong query_prealloc_size;
+  ulong query_alloc_recycle_size;
   ulong trans_alloc_block_size;
   ulong trans_prealloc_size;
   ulong group_concat_max_len;
@@ -700,6 +702,8 @@ typedef struct system_status_var
   ulonglong com_stmt_fetch;
   ulonglong com_stmt_reset;
   ulonglong com_stmt_close;
+  ulonglong prepared_stmt_cache_hits;
+  ulonglong prepared_stmt_cache_misses;
 
   ulonglong bytes_received;
   ulonglong bytes_sent;
@@ -885,6 +889,12 @@ class Prepared_statement;
 
   Prepared statements are auto-deleted when they are removed from the map
   and when the map is deleted.
+
+  Statements closed with COM_STMT_CLOSE can be parked instead: they stay
+  prepared, out of the id/name hashes, until a COM_STMT_PREPARE of the
+  same text takes them back (see Prepared_statement::cache_key()). The
+  memory of parked statements of all sessions is limited by
+  prepared_stmt_cache_size.
 */
 
 class Prepared_statement_map
@@ -921,14 +931,32 @@ public:
   /** Erase all prepared statements (calls Prepared_statement destructor). */
   void erase(Prepared_statement *statement);
 
+  /**
+    Remove a closed statement from the map and keep it for reuse.
+    The statement is deleted if it does not fit in the cache.
+  */
+  void park(Prepared_statement *statement);
+
+  /**
+    Take back a parked statement with the given cache key. The caller
+    has to insert() it again or delete it.
+  */
+  Prepared_statement *unpark(const char *key, size_t key_length);
+
   void claim_memory_ownership();
 
   void reset();
 
   ~Prepared_statement_map();
 private:
+  void unlink(Prepared_statement *statement);
+  void evict_parked(Prepared_statement *statement);
+
   HASH st_hash;
   HASH names_hash;
+  HASH parked_hash;
+  /* Clock for the LRU order of parked statements */
+  ulonglong m_park_clock;
   Prepared_statement *m_last_found_statement;
 };
 
@@ -3453,6 +3481,11 @@ private:
 
 public:
   void init(void);
+  /*
+    Take the current global system variables into a THD that was
+    constructed ahead of its connection, see Thd_pool.
+  */
+  void reinit_for_connection(void);
   /*
     Initialize memory roots necessary for query processing and (!)
     pre-allocate memory for it. We can't do that in THD constructor because
@@ -1464,8 +1464,15 @@ static void prepare_new_connection_state(THD* thd)
   NET *net= thd->get_protocol_classic()->get_net();
   Security_context *sctx= thd->security_context();
 
-  if (thd->get_protocol()->has_client_capability(CLIENT_COMPRESS))
+  if (thd->get_protocol()->has_client_capability(
+        CLIENT_ZSTD_COMPRESSION_ALGORITHM))
+    net->compress=1;        // Context was set up during authentication
+  else if (thd->get_protocol()->has_client_capability(CLIENT_COMPRESS))
+  {
     net->compress=1;        // Use compression
+    if (!net->compress_ctx)
+      net->compress_ctx= my_compress_context_new(MYSQL_ZLIB, 0);
+  }
 
   // Initializing session system variables.
   alloc_and_copy_thd_dynamic_variables(thd, true);
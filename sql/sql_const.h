@@ -166,6 +166,15 @@
 
 #define QUERY_ALLOC_BLOCK_SIZE		8192
 #define QUERY_ALLOC_PREALLOC_SIZE   	8192
+/*
+  The parse and execution memory of a short statement fits in the
+  preallocated block and a few more blocks of QUERY_ALLOC_BLOCK_SIZE,
+  which a session keeps without going to the pool or malloc. Sessions
+  running only smaller statements keep less, as the kept size follows
+  their recent peak.
+*/
+#define QUERY_ALLOC_RECYCLE_SIZE	(32*1024L)
+#define QUERY_ALLOC_POOL_SIZE		(32*1024*1024L)
 #define TRANS_ALLOC_BLOCK_SIZE		4096
 #define TRANS_ALLOC_PREALLOC_SIZE	4096
 #define RANGE_ALLOC_BLOCK_SIZE		4096
@@ -181,6 +190,12 @@
 #define MIN_FILE_LENGTH_TO_USE_ROW_CACHE (10L*1024*1024)
 #define MIN_ROWS_TO_USE_TABLE_CACHE	 100
 #define MIN_ROWS_TO_USE_BULK_INSERT	 100
+/*
+  A sorted result is read ahead in the background only when it is at
+  least this many times larger than its IO_CACHE buffer. Smaller results
+  are read in a few reads, not worth a read-ahead thread.
+*/
+#define MIN_CACHES_TO_READ_AHEAD_SORT_RESULT 4
 
 /*
   For sequential disk seeks the cost formula is:
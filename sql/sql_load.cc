@@ -48,8 +48,10 @@
 
 #include "pfs_file_provider.h"
 #include "mysql/psi/mysql_file.h"
+#include "my_atomic.h"
 
 #include <algorithm>
+#include <new>
 
 using std::min;
 using std::max;
@@ -74,6 +76,8 @@ XML_TAG::XML_TAG(int l, String f, String v)
 #define GET (stack_pos != stack ? *--stack_pos : my_b_get(&cache))
 #define PUSH(A) *(stack_pos++)=(A)
 
+class Load_data_parallel;
+
 class READ_INFO {
   File	file;
   uchar	*buffer,			/* Buffer for read text */
@@ -88,6 +92,19 @@ class READ_INFO {
   bool  need_end_io_cache;
   IO_CACHE cache;
   int level; /* for load xml */
+  /*
+    Bytes which read_field() stores as they are: not a terminator,
+    enclosing or escape character, and a complete character by itself.
+    Runs of these are copied from the IO_CACHE buffer at once.
+  */
+  uchar plain_char[256];
+  /* Replay fields parsed by worker threads, see Load_data_parallel. */
+  Load_data_parallel *parallel;
+  /*
+    False in parser threads, which must not call my_error(), and read
+    the file of the statement with pread().
+  */
+  bool report_errors;
 
 public:
   bool error,line_cuted,found_null,enclosed;
@@ -100,7 +117,8 @@ public:
             const String &line_start,
             const String &line_term,
 	    const String &enclosed,
-            int escape,bool get_it_from_net, bool is_fifo);
+            int escape,bool get_it_from_net, bool is_fifo,
+            bool parser_thread= false);
   ~READ_INFO();
   int read_field();
   int read_fixed_length(void);
@@ -108,6 +126,13 @@ public:
   char unescape(char chr);
   int terminator(const uchar *ptr, size_t length);
   bool find_start_of_fields();
+  /* For parallel parsing */
+  my_off_t position() const
+  { return my_b_tell(&cache) - (stack_pos - stack); }
+  bool seek(my_off_t pos);
+  bool has_line_terminator() const { return line_term_length != 0; }
+  int escape() const { return escape_char; }
+  void set_parallel(Load_data_parallel *arg) { parallel= arg; }
   /* load xml */
   List<XML_TAG> taglist;
   int read_value(int delim, String *val);
@@ -141,6 +166,117 @@ public:
   }
 };
 
+
+/**
+  Parallel parsing for LOAD DATA INFILE with FIELDS TERMINATED BY.
+
+  The file is cut into chunks of CHUNK_SIZE bytes (of any size in the
+  unit tests). Parser threads read whole chunks with private READ_INFO
+  instances, which share the file descriptor of the statement and read
+  it with pread(). They log the outcome of every read_field() and
+  next_line() call the way read_sep_field() makes them. The statement
+  thread replays the logs in file order through its own READ_INFO, so
+  the field conversions, triggers and write_record() still run on the
+  statement thread, in its transaction.
+
+  A chunk holds the lines starting inside its byte range. The parser of
+  a chunk guesses where the first of these lines starts by looking for
+  the line terminator; an enclosed or escaped line terminator makes the
+  guess wrong. This is found when the previous chunk has been replayed,
+  as its last line then does not end where the guess starts, and the
+  chunk is parsed again by the statement thread from the right offset.
+*/
+class Load_data_parallel
+{
+public:
+  static const my_off_t CHUNK_SIZE= 8 * 1024 * 1024;
+
+  Load_data_parallel()
+    : m_threads(NULL), m_thread_count(0), m_reserved(0), m_readers(NULL),
+      m_reader_count(0), m_chunks(NULL), m_slot_count(0), m_inited(false)
+  {}
+  ~Load_data_parallel() { end(); }
+
+  bool start(File file, uint threads, uint fields,
+             my_off_t start_pos, my_off_t file_size, my_off_t chunk_size,
+             uint tot_length, const CHARSET_INFO *cs,
+             const String &field_term, const String &line_term,
+             const String &enclosed, int escape);
+  void end();
+
+  int read_field(READ_INFO *info);
+  int next_line(READ_INFO *info);
+
+  /* Parser thread body */
+  void run();
+
+private:
+  /* Records of the parse log */
+  enum log_type
+  {
+    LOG_FIELD,                       // read_field() returned 0
+    LOG_FIELD_END,                   // read_field() returned 1
+    LOG_NEXT_LINE,                   // next_line() was called
+    LOG_BAD_CHARACTER                // ER_INVALID_CHARACTER_STRING
+  };
+  enum log_flags
+  {
+    LOG_ENCLOSED= 1, LOG_FOUND_NULL= 2, LOG_LINE_CUTED= 4, LOG_END_OF_FILE= 8
+  };
+
+  struct Chunk
+  {
+    my_off_t start;                  // First line starts here
+    my_off_t end;                    // Lines starting here are not ours
+    my_off_t next_start;             // Where the last line ended
+    uchar *log;
+    size_t log_length, log_size;
+    bool failed;                     // Out of memory at next_start
+    bool ready;                      // Parsed, protected by m_lock
+  };
+
+  my_off_t find_line_start(my_off_t pos);
+  void parse_chunk(READ_INFO *reader, Chunk *chunk);
+  bool log_append(Chunk *chunk, uchar type, uchar flags,
+                  const uchar *data, size_t length);
+  void reparse(Chunk *chunk, my_off_t start);
+  uchar *next_record();
+
+  my_thread_handle *m_threads;
+  uint m_thread_count;
+  /* Taken from load_data_parallel_max_threads */
+  uint m_reserved;
+  /* One per parser thread, and the last one for reparsing */
+  READ_INFO **m_readers;
+  uint m_reader_count;
+  Chunk *m_chunks;                   // Ring of m_slot_count chunks
+  uint m_slot_count;
+  bool m_inited;
+
+  File m_file;
+  uint m_fields;
+  const uchar *m_line_term;
+  size_t m_line_term_length;
+  my_off_t m_start, m_file_size, m_chunk_size;
+  ulonglong m_chunk_count;
+
+  mysql_mutex_t m_lock;
+  mysql_cond_t m_cond;
+  uint m_started;                    // Parser threads started
+  ulonglong m_next_chunk;            // Next chunk to hand to a parser
+  ulonglong m_current_chunk;         // Chunk being replayed
+  volatile bool m_stop;
+
+  /* Replay position in the log of m_current_chunk */
+  Chunk *m_chunk;
+  uchar *m_log_pos;
+  bool m_reparsed;
+  my_off_t m_prev_next_start;
+};
+
+const my_off_t Load_data_parallel::CHUNK_SIZE;
+
+
 static int read_fixed_length(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
                              List<Item> &fields_vars, List<Item> &set_fields,
                              List<Item> &set_values, READ_INFO &read_info,
@@ -165,6 +301,48 @@ static bool write_execute_load_query_log_event(THD *thd, sql_exchange* ex,
                                                int errocode);
 #endif /* EMBEDDED_LIBRARY */
 
+/**
+  Let parser threads parse the rest of the file, if that is possible and
+  the file is large enough for it to be worth it.
+
+  Not done for named pipes and files sent by the client, which can only be
+  read once, with LINES STARTING BY, which makes lines start in the middle
+  of other lines, and when the file blocks go to the binary log.
+*/
+static void start_parallel_parse(THD *thd, const sql_exchange *ex,
+                                 File file,
+                                 bool is_fifo, uint fields, uint tot_length,
+                                 READ_INFO &read_info,
+                                 Load_data_parallel &parallel)
+{
+  MY_STAT stat_info;
+  my_off_t start_pos;
+
+  if (thd->variables.load_data_parallel_threads == 0 || file < 0 ||
+      is_fifo || ex->line.line_start->length() ||
+      !read_info.has_line_terminator())
+    return;
+#ifndef EMBEDDED_LIBRARY
+  if (mysql_bin_log.is_open() && !thd->is_current_stmt_binlog_format_row())
+    return;
+#endif
+
+  start_pos= read_info.position();
+  if (my_fstat(file, &stat_info, MYF(0)) ||
+      static_cast<my_off_t>(stat_info.st_size) <
+      start_pos + 2 * Load_data_parallel::CHUNK_SIZE)
+    return;
+
+  if (!parallel.start(file, thd->variables.load_data_parallel_threads,
+                      fields, start_pos, stat_info.st_size,
+                      Load_data_parallel::CHUNK_SIZE, tot_length,
+                      read_info.read_charset, *ex->field.field_term,
+                      *ex->line.line_term, *ex->field.enclosed,
+                      read_info.escape()))
+    read_info.set_parallel(&parallel);
+}
+
+
 /*
   Execute LOAD DATA query
 
@@ -521,6 +699,7 @@ int mysql_load(THD *thd,sql_exchange *ex,TABLE_LIST *table_list,
       mysql_file_close(file, MYF(0));           // no files in net reading
     DBUG_RETURN(TRUE);				// Can't allocate buffers
   }
+  Load_data_parallel parallel;
 
 #ifndef EMBEDDED_LIBRARY
   if (mysql_bin_log.is_open())
@@ -571,9 +750,16 @@ int mysql_load(THD *thd,sql_exchange *ex,TABLE_LIST *table_list,
                                set_fields, set_values, read_info,
 			       skip_lines);
     else
+    {
+      start_parallel_parse(thd, ex, file, is_fifo,
+                           fields_vars.elements, tot_length,
+                           read_info, parallel);
       error= read_sep_field(thd, info, insert_table_ref, fields_vars,
                             set_fields, set_values, read_info,
 			    *enclosed, skip_lines);
+      parallel.end();
+      read_info.set_parallel(NULL);
+    }
     if (thd->locked_tables_mode <= LTM_LOCK_TABLES &&
         table->file->ha_end_bulk_insert() && !error)
     {
@@ -1459,6 +1645,58 @@ READ_INFO::unescape(char chr)
 }
 
 
+/**
+  IO_CACHE read function of the READ_INFO of a parser thread. Reads like
+  the one of a READ_CACHE, but with pread(), so that the parser threads
+  can share the file descriptor of the statement: it does not move the
+  file position.
+
+  @retval 0  ok
+  @retval 1  error or end of file, see _my_b_read()
+*/
+static int parser_read(IO_CACHE *info, uchar *Buffer, size_t Count)
+{
+  my_off_t pos_in_file= info->pos_in_file +
+    static_cast<size_t>(info->read_end - info->buffer);
+  size_t left_length= 0;
+
+  for (;;)
+  {
+    /* Up to a full buffer, ending on a block boundary */
+    const size_t max_length= info->read_length -
+      static_cast<size_t>(pos_in_file & (IO_SIZE - 1));
+    const size_t length= mysql_file_pread(info->file, info->buffer,
+                                          max_length, pos_in_file, MYF(0));
+    info->pos_in_file= pos_in_file;
+    info->read_pos= info->read_end= info->buffer;
+    if (length == MY_FILE_ERROR)
+    {
+      info->error= -1;
+      return 1;
+    }
+    info->read_end= info->buffer + length;
+    if (length >= Count)
+    {
+      memcpy(Buffer, info->buffer, Count);
+      info->read_pos+= Count;
+      return 0;
+    }
+    memcpy(Buffer, info->buffer, length);
+    info->read_pos= info->read_end;
+    left_length+= length;
+    if (length < max_length)
+    {
+      /* End of file */
+      info->error= static_cast<int>(left_length);
+      return 1;
+    }
+    Buffer+= length;
+    Count-= length;
+    pos_in_file+= length;
+  }
+}
+
+
 /*
   Read a line using buffering
   If last line is empty (in line mode) then it isn't outputed
@@ -1470,9 +1708,11 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
                      const String &line_start,
                      const String &line_term,
                      const String &enclosed_par,
-                     int escape, bool get_it_from_net, bool is_fifo)
+                     int escape, bool get_it_from_net, bool is_fifo,
+                     bool parser_thread)
   :file(file_par), buff_length(tot_length), escape_char(escape),
    found_end_of_line(false), eof(false), need_end_io_cache(false),
+   parallel(NULL), report_errors(!parser_thread),
    error(false), line_cuted(false), found_null(false), read_charset(cs)
 {
   /*
@@ -1511,6 +1751,15 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
   field_term_char= field_term_length ? field_term_ptr[0] : INT_MAX;
   line_term_char= line_term_length ? line_term_ptr[0] : INT_MAX;
 
+  for (uint i= 0; i < 256; i++)
+    plain_char[i]= my_mbcharlen(cs, i) == 1;
+  const int special_chars[]=
+    { escape_char, enclosed_char, field_term_char, line_term_char };
+  for (uint i= 0; i < array_elements(special_chars); i++)
+  {
+    if (special_chars[i] >= 0 && special_chars[i] < 256)
+      plain_char[special_chars[i]]= 0;
+  }
 
   /* Set of a stack for unget if long terminators */
   size_t length= max<size_t>(cs->mbmaxlen, max(field_term_length, line_term_length)) + 1;
@@ -1523,10 +1772,12 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
   else
   {
     end_of_buff=buffer+buff_length;
+    /* Parser threads must not move the file position, even to stat it */
     if (init_io_cache(&cache,(get_it_from_net) ? -1 : file, 0,
 		      (get_it_from_net) ? READ_NET :
-		      (is_fifo ? READ_FIFO : READ_CACHE),0L,1,
-		      MYF(MY_WME)))
+		      (is_fifo ? READ_FIFO : READ_CACHE),0L,!parser_thread,
+		      MYF(MY_WME | (parser_thread ? MY_DONT_CHECK_FILESIZE :
+                                    0))))
     {
       my_free(buffer); /* purecov: inspected */
       buffer= NULL;
@@ -1541,11 +1792,13 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
       */
       need_end_io_cache = 1;
 
+      if (parser_thread)
+        cache.read_function= parser_read;
 #ifndef EMBEDDED_LIBRARY
-      if (get_it_from_net)
+      else if (get_it_from_net)
 	cache.read_function = _my_b_net_read;
 
-      if (mysql_bin_log.is_open())
+      if (mysql_bin_log.is_open() && !parser_thread)
 	cache.pre_read = cache.pre_close =
 	  (IO_CACHE_CALLBACK) log_loaded_block;
 #endif
@@ -1554,6 +1807,27 @@ READ_INFO::READ_INFO(File file_par, uint tot_length, const CHARSET_INFO *cs,
 }
 
 
+/**
+  Continue reading at file offset pos, which must be the start of a line.
+
+  @retval false  ok
+  @retval true   error
+*/
+bool READ_INFO::seek(my_off_t pos)
+{
+  stack_pos= stack;
+  found_end_of_line= eof= false;
+  error= line_cuted= found_null= false;
+  start_of_line= line_start_ptr != 0;
+  if (reinit_io_cache(&cache, READ_CACHE, pos, 0, 0))
+    return true;
+  /* reinit_io_cache() sets the read function of a READ_CACHE again */
+  if (!report_errors)
+    cache.read_function= parser_read;
+  return false;
+}
+
+
 READ_INFO::~READ_INFO()
 {
   if (need_end_io_cache)
@@ -1619,6 +1893,9 @@ int READ_INFO::read_field()
   int chr,found_enclosed_char;
   uchar *to,*new_buffer;
 
+  if (parallel)
+    return parallel->read_field(this);
+
   found_null=0;
   if (found_end_of_line)
     return 1;					// One have to call next_line
@@ -1653,6 +1930,23 @@ int READ_INFO::read_field()
     bool escaped_mb= false;
     while ( to < end_of_buff)
     {
+      if (stack_pos == stack)
+      {
+        /* Copy characters with no special meaning without looking back. */
+        const uchar *start= cache.read_pos;
+        const uchar *end= start + min<size_t>(cache.read_end - start,
+                                              end_of_buff - to);
+        const uchar *pos= start;
+        while (pos < end && plain_char[*pos])
+          pos++;
+        if (pos != start)
+        {
+          memcpy(to, start, pos - start);
+          to+= pos - start;
+          cache.read_pos= const_cast<uchar*>(pos);
+          continue;
+        }
+      }
       chr = GET;
       if (chr == my_b_EOF)
 	goto found_eof;
@@ -1755,8 +2049,11 @@ int READ_INFO::read_field()
       if (ml == 0)
       {
         *to= '\0';
-        my_error(ER_INVALID_CHARACTER_STRING, MYF(0),
-                 read_charset->csname, buffer);
+        if (report_errors)
+          my_error(ER_INVALID_CHARACTER_STRING, MYF(0),
+                   read_charset->csname, buffer);
+        row_start= buffer;
+        row_end= to;
         error= true;
         return 1;
       }
@@ -1811,8 +2108,11 @@ int READ_INFO::read_field()
     */
     if (!(new_buffer=(uchar*) my_realloc(key_memory_READ_INFO,
                                          (char*) buffer,buff_length+1+IO_SIZE,
-					MYF(MY_WME))))
+					MYF(report_errors ? MY_WME : 0))))
+    {
+      row_start= row_end= NULL;
       return (error= true);
+    }
     to=new_buffer + (to-buffer);
     buffer=new_buffer;
     buff_length+=IO_SIZE;
@@ -1895,6 +2195,9 @@ found_eof:
 
 int READ_INFO::next_line()
 {
+  if (parallel)
+    return parallel->next_line(this);
+
   line_cuted=0;
   start_of_line= line_start_ptr != 0;
   if (found_end_of_line || eof)
@@ -1972,6 +2275,489 @@ bool READ_INFO::find_start_of_fields()
 }
 
 
+/****************************************************************************
+** Parallel parsing of lines
+****************************************************************************/
+
+/* type, flags, 4 bytes of length; the data is followed by one spare byte */
+static const size_t LOAD_LOG_HEADER_SIZE= 6;
+
+/* Parser threads of all statements, see load_data_parallel_max_threads */
+static volatile int32 load_data_parser_threads= 0;
+
+/**
+  Take up to wanted parser threads from those the server allows.
+
+  @return the number of threads taken, 0 if there is none left
+*/
+static uint reserve_parser_threads(uint wanted)
+{
+  int32 running= my_atomic_load32(&load_data_parser_threads);
+
+  for (;;)
+  {
+    const int32 room=
+      static_cast<int32>(load_data_parallel_max_threads) - running;
+    if (room <= 0)
+      return 0;
+    const int32 reserved= min<int32>(room, static_cast<int32>(wanted));
+    if (my_atomic_cas32(&load_data_parser_threads, &running,
+                        running + reserved))
+      return static_cast<uint>(reserved);
+  }
+}
+
+
+extern "C" void *load_data_parser_thread(void *arg)
+{
+  my_thread_init();
+  static_cast<Load_data_parallel*>(arg)->run();
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Start parser threads for the lines from start_pos to the end of the file.
+  The threads read file with pread(), it must stay open until end().
+
+  @retval false  ok, the caller can replay lines through read_field() and
+                 next_line()
+  @retval true   the statement thread must parse the file itself
+*/
+bool Load_data_parallel::start(File file, uint threads, uint fields,
+                               my_off_t start_pos, my_off_t file_size,
+                               my_off_t chunk_size,
+                               uint tot_length, const CHARSET_INFO *cs,
+                               const String &field_term,
+                               const String &line_term,
+                               const String &enclosed, int escape)
+{
+  const String no_line_start;
+  DBUG_ENTER("Load_data_parallel::start");
+
+  m_file= file;
+  m_fields= fields;
+  m_line_term= static_cast<const uchar*>(
+    static_cast<const void*>(line_term.ptr()));
+  m_line_term_length= line_term.length();
+  m_start= start_pos;
+  m_file_size= file_size;
+  m_chunk_size= chunk_size;
+  m_chunk_count= (file_size - start_pos + chunk_size - 1) / chunk_size;
+  m_reserved= reserve_parser_threads(
+    static_cast<uint>(min<ulonglong>(threads, m_chunk_count)));
+  m_reader_count= m_reserved;
+  m_slot_count= 2 * m_reader_count;
+  m_next_chunk= m_current_chunk= 0;
+  m_started= 0;
+  m_stop= false;
+  m_chunk= NULL;
+  m_log_pos= NULL;
+  m_prev_next_start= start_pos;
+
+  if (!m_fields || !m_reader_count ||
+      !(m_threads= (my_thread_handle*)
+        my_malloc(key_memory_READ_INFO,
+                  m_reader_count * sizeof(my_thread_handle), MYF(MY_WME))) ||
+      !(m_readers= (READ_INFO**)
+        my_malloc(key_memory_READ_INFO,
+                  (m_reader_count + 1) * sizeof(READ_INFO*),
+                  MYF(MY_WME | MY_ZEROFILL))) ||
+      !(m_chunks= (Chunk*)
+        my_malloc(key_memory_READ_INFO, m_slot_count * sizeof(Chunk),
+                  MYF(MY_WME | MY_ZEROFILL))))
+    goto err;
+
+  /* One reader per parser thread, and the last one for reparsing. */
+  for (uint i= 0; i <= m_reader_count; i++)
+  {
+    if (!(m_readers[i]= new (std::nothrow) READ_INFO(file, tot_length, cs,
+                                                     field_term,
+                                                     no_line_start,
+                                                     line_term, enclosed,
+                                                     escape, false, false,
+                                                     true)) ||
+        m_readers[i]->error)
+      goto err;
+  }
+
+  mysql_mutex_init(key_LOCK_load_data_parallel, &m_lock, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_load_data_parallel, &m_cond);
+  m_inited= true;
+
+  for (; m_thread_count < m_reader_count; m_thread_count++)
+  {
+    if (mysql_thread_create(key_thread_load_data_parser,
+                            &m_threads[m_thread_count], NULL,
+                            load_data_parser_thread, this))
+      break;
+  }
+  if (m_thread_count == 0)
+    goto err;
+  DBUG_RETURN(false);
+
+err:
+  end();
+  DBUG_RETURN(true);
+}
+
+
+/** Stop the parser threads, and free everything. */
+void Load_data_parallel::end()
+{
+  if (m_inited)
+  {
+    mysql_mutex_lock(&m_lock);
+    m_stop= true;
+    mysql_cond_broadcast(&m_cond);
+    mysql_mutex_unlock(&m_lock);
+
+    for (uint i= 0; i < m_thread_count; i++)
+      my_thread_join(&m_threads[i], NULL);
+    m_thread_count= 0;
+
+    mysql_cond_destroy(&m_cond);
+    mysql_mutex_destroy(&m_lock);
+    m_inited= false;
+  }
+  for (uint i= 0; m_readers && i <= m_reader_count; i++)
+    delete m_readers[i];
+  for (uint i= 0; m_chunks && i < m_slot_count; i++)
+    my_free(m_chunks[i].log);
+  my_free(m_threads);
+  my_free(m_readers);
+  my_free(m_chunks);
+  m_threads= NULL;
+  m_readers= NULL;
+  m_chunks= NULL;
+  if (m_reserved)
+  {
+    my_atomic_add32(&load_data_parser_threads,
+                    -static_cast<int32>(m_reserved));
+    m_reserved= 0;
+  }
+}
+
+
+/** Parser thread: parse chunks in file order until all are taken. */
+void Load_data_parallel::run()
+{
+  mysql_mutex_lock(&m_lock);
+  const uint number= m_started++;
+  READ_INFO *reader= m_readers[number];
+
+  for (;;)
+  {
+    /* The statement thread must release the slot first. */
+    while (!m_stop && m_next_chunk < m_chunk_count &&
+           m_next_chunk >= m_current_chunk + m_slot_count)
+      mysql_cond_wait(&m_cond, &m_lock);
+    if (m_stop || m_next_chunk >= m_chunk_count)
+      break;
+    const ulonglong chunk_number= m_next_chunk++;
+    Chunk *chunk= &m_chunks[chunk_number % m_slot_count];
+    mysql_mutex_unlock(&m_lock);
+
+    chunk->start= chunk_number == 0 ? m_start :
+      find_line_start(m_start + chunk_number * m_chunk_size);
+    chunk->end= chunk_number + 1 == m_chunk_count ? MY_FILEPOS_ERROR :
+      m_start + (chunk_number + 1) * m_chunk_size;
+    parse_chunk(reader, chunk);
+    DBUG_EXECUTE_IF("load_data_parser_oom",
+                    {
+                      chunk->log_length= 0;
+                      chunk->next_start= chunk->start;
+                      chunk->failed= true;
+                    });
+
+    mysql_mutex_lock(&m_lock);
+    chunk->ready= true;
+    mysql_cond_broadcast(&m_cond);
+  }
+  mysql_mutex_unlock(&m_lock);
+}
+
+
+/**
+  Guess the offset of the first line starting at or after pos,
+  ignoring enclosing and escape characters.
+  Any guess is safe, see the class description.
+*/
+my_off_t Load_data_parallel::find_line_start(my_off_t pos)
+{
+  uchar buff[IO_SIZE * 4];
+
+  pos-= min<my_off_t>(pos - m_start, m_line_term_length);
+  for (;;)
+  {
+    size_t length= mysql_file_pread(m_file, buff, sizeof(buff), pos, MYF(0));
+    if (length == MY_FILE_ERROR || length < m_line_term_length)
+      return m_file_size;
+
+    const uchar *end= buff + length - m_line_term_length + 1;
+    const uchar *ptr= buff;
+    while ((ptr= static_cast<const uchar*>(memchr(ptr, m_line_term[0],
+                                                  end - ptr))))
+    {
+      if (!memcmp(ptr, m_line_term, m_line_term_length))
+        return pos + (ptr - buff) + m_line_term_length;
+      ptr++;
+    }
+    pos+= length - m_line_term_length + 1;
+  }
+}
+
+
+/**
+  Add a record to the log of a chunk.
+  Room for one more record without data is always kept.
+*/
+bool Load_data_parallel::log_append(Chunk *chunk, uchar type, uchar flags,
+                                    const uchar *data, size_t length)
+{
+  const size_t record_length= LOAD_LOG_HEADER_SIZE + length + 1;
+  const size_t needed= chunk->log_length + record_length +
+    LOAD_LOG_HEADER_SIZE + 1;
+
+  if (needed > chunk->log_size)
+  {
+    size_t size= max<size_t>(max<size_t>(needed, 2 * chunk->log_size),
+                             64 * 1024);
+    uchar *log= (uchar*) my_realloc(key_memory_READ_INFO, chunk->log, size,
+                                    MYF(MY_ALLOW_ZERO_PTR));
+    if (log == NULL)
+      return true;
+    chunk->log= log;
+    chunk->log_size= size;
+  }
+
+  uchar *pos= chunk->log + chunk->log_length;
+  pos[0]= type;
+  pos[1]= flags;
+  int4store(pos + 2, static_cast<uint32>(length));
+  if (length)
+    memcpy(pos + LOAD_LOG_HEADER_SIZE, data, length);
+  pos[LOAD_LOG_HEADER_SIZE + length]= 0;
+  chunk->log_length+= record_length;
+  return false;
+}
+
+
+/**
+  Parse the lines starting between chunk->start and chunk->end,
+  calling read_field() and next_line() the way read_sep_field() does.
+
+  If memory runs out, the log ends at the start of the line that could
+  not be parsed, and the chunk is marked as failed.
+*/
+void Load_data_parallel::parse_chunk(READ_INFO *reader, Chunk *chunk)
+{
+  my_off_t line_start= chunk->start;
+  size_t line_log_length= 0;
+
+  chunk->log_length= 0;
+  chunk->failed= false;
+  if (reader->seek(chunk->start))
+    goto failed;
+
+  for (;;)
+  {
+    uint i;
+    int res= 0;
+
+    line_start= reader->position();
+    line_log_length= chunk->log_length;
+    if (line_start >= chunk->end || m_stop)
+    {
+      chunk->next_start= line_start;
+      return;
+    }
+
+    for (i= 0; i < m_fields; i++)
+    {
+      if ((res= reader->read_field()))
+        break;
+      uchar flags= (reader->enclosed ? LOG_ENCLOSED : 0) |
+                   (reader->found_null ? LOG_FOUND_NULL : 0);
+      if (log_append(chunk, LOG_FIELD, flags, reader->row_start,
+                     reader->row_end - reader->row_start))
+        goto failed;
+    }
+    if (res)
+    {
+      if (reader->error)
+      {
+        if (reader->row_start == NULL ||
+            log_append(chunk, LOG_BAD_CHARACTER, 0, reader->row_start,
+                       reader->row_end - reader->row_start))
+          goto failed;
+        chunk->next_start= MY_FILEPOS_ERROR;
+        return;
+      }
+      if (log_append(chunk, LOG_FIELD_END, 0, NULL, 0))
+        goto failed;
+      if (i == 0)
+      {
+        /* End of file, read_sep_field() stops here. */
+        chunk->next_start= MY_FILEPOS_ERROR;
+        return;
+      }
+    }
+
+    res= reader->next_line();
+    if (log_append(chunk, LOG_NEXT_LINE,
+                   (reader->line_cuted ? LOG_LINE_CUTED : 0) |
+                   (res ? LOG_END_OF_FILE : 0), NULL, 0))
+      goto failed;
+    if (res)
+    {
+      chunk->next_start= MY_FILEPOS_ERROR;
+      return;
+    }
+  }
+
+failed:
+  chunk->log_length= line_log_length;
+  chunk->next_start= line_start;
+  chunk->failed= true;
+}
+
+
+/**
+  Parse a chunk again in the statement thread, from offset start.
+*/
+void Load_data_parallel::reparse(Chunk *chunk, my_off_t start)
+{
+  chunk->start= start;
+  parse_chunk(m_readers[m_reader_count], chunk);
+  DBUG_EXECUTE_IF("load_data_reparse_oom",
+                  {
+                    chunk->log_length= 0;
+                    chunk->next_start= start;
+                    chunk->failed= true;
+                  });
+  m_log_pos= chunk->log;
+  m_reparsed= true;
+}
+
+
+/**
+  Get the next record to replay, moving on to the next chunk when needed.
+
+  @return the record, or NULL on error
+*/
+uchar *Load_data_parallel::next_record()
+{
+  static uchar end_of_file[LOAD_LOG_HEADER_SIZE + 1]= { LOG_FIELD_END };
+
+  for (;;)
+  {
+    if (m_chunk != NULL)
+    {
+      if (m_log_pos < m_chunk->log + m_chunk->log_length)
+      {
+        uchar *record= m_log_pos;
+        m_log_pos+= LOAD_LOG_HEADER_SIZE + uint4korr(record + 2) + 1;
+        return record;
+      }
+      if (m_chunk->failed)
+      {
+        if (m_reparsed)
+        {
+          my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
+                   static_cast<int>(m_chunk->log_size));
+          return NULL;
+        }
+        reparse(m_chunk, m_chunk->next_start);
+        continue;
+      }
+
+      /* Done with this chunk, hand its slot over to the parsers. */
+      m_prev_next_start= m_chunk->next_start;
+      mysql_mutex_lock(&m_lock);
+      m_chunk->ready= false;
+      m_current_chunk++;
+      mysql_cond_broadcast(&m_cond);
+      mysql_mutex_unlock(&m_lock);
+      m_chunk= NULL;
+    }
+
+    if (m_current_chunk >= m_chunk_count)
+    {
+      /* The last chunk always ends with the end of file. */
+      assert(false);
+      return end_of_file;
+    }
+
+    Chunk *chunk= &m_chunks[m_current_chunk % m_slot_count];
+    mysql_mutex_lock(&m_lock);
+    while (!chunk->ready)
+      mysql_cond_wait(&m_cond, &m_lock);
+    mysql_mutex_unlock(&m_lock);
+
+    m_chunk= chunk;
+    m_log_pos= chunk->log;
+    m_reparsed= false;
+    /* The first line was not guessed right. */
+    if (chunk->start != m_prev_next_start)
+      reparse(chunk, m_prev_next_start);
+  }
+}
+
+
+int Load_data_parallel::read_field(READ_INFO *info)
+{
+  uchar *record= next_record();
+
+  if (record == NULL)
+  {
+    info->error= true;
+    return 1;
+  }
+
+  switch (record[0]) {
+  case LOG_FIELD:
+    info->enclosed= (record[1] & LOG_ENCLOSED) != 0;
+    info->found_null= (record[1] & LOG_FOUND_NULL) != 0;
+    info->row_start= record + LOAD_LOG_HEADER_SIZE;
+    info->row_end= info->row_start + uint4korr(record + 2);
+    return 0;
+  case LOG_FIELD_END:
+    return 1;
+  case LOG_BAD_CHARACTER:
+    my_error(ER_INVALID_CHARACTER_STRING, MYF(0),
+             info->read_charset->csname, record + LOAD_LOG_HEADER_SIZE);
+    info->error= true;
+    return 1;
+  default:
+    assert(false);
+    info->error= true;
+    return 1;
+  }
+}
+
+
+int Load_data_parallel::next_line(READ_INFO *info)
+{
+  uchar *record= next_record();
+
+  if (record == NULL)
+  {
+    info->error= true;
+    return 1;
+  }
+  if (record[0] != LOG_NEXT_LINE)
+  {
+    assert(false);
+    info->error= true;
+    return 1;
+  }
+  info->line_cuted= (record[1] & LOG_LINE_CUTED) != 0;
+  return (record[1] & LOG_END_OF_FILE) != 0;
+}
+
+
 /*
   Clear taglist from tags with a specified level
 */
@@ -388,8 +388,18 @@ static bool send_prep_stmt(Prepared_statement *stmt, uint columns)
   error= my_net_write(net, buff, sizeof(buff));
   if (stmt->param_count && ! error)
   {
-    error= thd->send_result_metadata((List<Item> *) &stmt->lex->param_list,
-                                     Protocol::SEND_EOF);
+    if (stmt->state == Query_arena::STMT_PREPARED)
+    {
+      /* A parked statement prepared again, see Prepared_statement::reuse() */
+      error= stmt->send_saved_metadata(false);
+    }
+    else
+    {
+      error= thd->send_result_metadata((List<Item> *) &stmt->lex->param_list,
+                                       Protocol::SEND_EOF);
+      if (!error)
+        stmt->save_metadata((List<Item> *) &stmt->lex->param_list, false);
+    }
   }
 
   if (!error)
@@ -1385,6 +1395,9 @@ static int mysql_test_select(Prepared_statement *stmt,
   THD *thd= stmt->thd;
   LEX *lex= stmt->lex;
   SELECT_LEX_UNIT *unit= lex->unit;
+  /* Only the metadata of a result set sent to the client can be saved */
+  const bool sends_result= lex->result == NULL &&
+                           lex->sql_command == SQLCOM_SELECT;
   DBUG_ENTER("mysql_test_select");
 
   lex->select_lex->context.resolve_in_select_list= true;
@@ -1451,6 +1464,10 @@ static int mysql_test_select(Prepared_statement *stmt,
               result->send_result_set_metadata(unit->types,
                                                Protocol::SEND_EOF) ||
               thd->get_protocol_classic()->flush());
+    if (sends_result && analyse_result == NULL)
+      stmt->save_metadata(&unit->types, true);
+    else
+      stmt->disable_reuse();
     delete analyse_result;
     if (rc)
       goto error;
@@ -2098,6 +2115,79 @@ static bool init_param_array(Prepared_statement *stmt)
 }
 
 
+#ifndef EMBEDDED_LIBRARY
+/**
+  Build the key under which a closed statement is parked: the statement
+  text and everything in the session the prepared tree and the metadata
+  sent to the client depend on.
+
+  @retval FALSE  success
+  @retval TRUE   out of memory
+*/
+
+static bool make_stmt_cache_key(THD *thd, const char *query, uint length,
+                                String *key)
+{
+  const struct system_variables &vars= thd->variables;
+  const uint charsets[]=
+  {
+    vars.character_set_client->number,
+    vars.collation_connection->number,
+    vars.character_set_results ? vars.character_set_results->number : 0
+  };
+  const ulonglong auto_is_null= vars.option_bits & OPTION_AUTO_IS_NULL;
+  const size_t db_length= thd->db().length;
+
+  key->length(0);
+  return (key->append((const char *) &vars.sql_mode, sizeof(vars.sql_mode)) ||
+          key->append((const char *) &vars.optimizer_switch,
+                      sizeof(vars.optimizer_switch)) ||
+          key->append((const char *) charsets, sizeof(charsets)) ||
+          key->append((const char *) &auto_is_null, sizeof(auto_is_null)) ||
+          key->append((const char *) &vars.div_precincrement,
+                      sizeof(vars.div_precincrement)) ||
+          key->append((const char *) &vars.group_concat_max_len,
+                      sizeof(vars.group_concat_max_len)) ||
+          key->append((const char *) &db_length, sizeof(db_length)) ||
+          key->append(thd->db().str, db_length) ||
+          key->append(query, length));
+}
+
+
+/**
+  Answer COM_STMT_PREPARE with a statement parked by an earlier
+  COM_STMT_CLOSE of the same text, if there is one.
+
+  @retval TRUE   the command is handled, the response or an error is sent
+  @retval FALSE  nothing to reuse, the statement has to be prepared
+*/
+
+static bool reuse_parked_statement(THD *thd, const String &key)
+{
+  Prepared_statement *stmt= thd->stmt_map.unpark(key.ptr(), key.length());
+
+  if (stmt == NULL || !stmt->tables_unchanged())
+  {
+    /* The metadata saved at prepare could be wrong for changed tables */
+    delete stmt;
+    thd->status_var.prepared_stmt_cache_misses++;
+    return FALSE;
+  }
+  thd->status_var.prepared_stmt_cache_hits++;
+
+  stmt->id= ++thd->statement_id_counter;
+  if (thd->stmt_map.insert(thd, stmt))
+    return TRUE; /* The error is set and the statement deleted in insert */
+  if (stmt->reuse())
+  {
+    MYSQL_DESTROY_PS(stmt->m_prepared_stmt);
+    thd->stmt_map.erase(stmt);
+  }
+  return TRUE;
+}
+#endif /* !EMBEDDED_LIBRARY */
+
+
 /**
   COM_STMT_PREPARE handler.
 
@@ -2129,6 +2219,8 @@ void mysqld_stmt_prepare(THD *thd, const char *query, uint length)
 {
   Protocol *save_protocol= thd->get_protocol();
   Prepared_statement *stmt;
+  char key_buff[STRING_BUFFER_USUAL_SIZE];
+  String cache_key(key_buff, sizeof(key_buff), &my_charset_bin);
   DBUG_ENTER("mysqld_stmt_prepare");
 
   DBUG_PRINT("prep_query", ("%s", query));
@@ -2136,9 +2228,25 @@ void mysqld_stmt_prepare(THD *thd, const char *query, uint length)
   /* First of all clear possible warnings from the previous command */
   mysql_reset_thd_for_next_command(thd);
 
+#ifndef EMBEDDED_LIBRARY
+  if (prepared_stmt_cache_size > 0)
+  {
+    if (make_stmt_cache_key(thd, query, length, &cache_key))
+      goto end;
+    if (reuse_parked_statement(thd, cache_key))
+      goto end;
+  }
+#endif
+
   if (! (stmt= new Prepared_statement(thd)))
     goto end; /* out of memory: error is set in Sql_alloc */
 
+  if (cache_key.length() && stmt->set_cache_key(cache_key))
+  {
+    delete stmt;
+    goto end;
+  }
+
   if (thd->stmt_map.insert(thd, stmt))
   {
     /*
@@ -2167,6 +2275,8 @@ void mysqld_stmt_prepare(THD *thd, const char *query, uint length)
     /* Statement map deletes statement on erase */
     thd->stmt_map.erase(stmt);
   }
+  else if (!stmt->is_reusable())
+    stmt->disable_reuse();
 
   thd->set_protocol(save_protocol);
 
@@ -2794,7 +2904,17 @@ void mysqld_stmt_close(THD *thd, ulong stmt_id)
   */
   assert(! stmt->is_in_use());
   MYSQL_DESTROY_PS(stmt->m_prepared_stmt);
-  stmt->deallocate();
+  if (stmt->cache_key().str && stmt->last_errno == 0)
+  {
+    /* Keep the prepared tree for the next prepare of the same text */
+    stmt->close_cursor();
+    reset_stmt_params(stmt);
+    stmt->m_prepared_stmt= NULL;
+    thd->status_var.com_stmt_close++;
+    thd->stmt_map.park(stmt);
+  }
+  else
+    stmt->deallocate();
   query_logger.general_log_print(thd, thd->get_command(), NullS);
 
   DBUG_VOID_RETURN;
@@ -3083,7 +3203,12 @@ Prepared_statement::Prepared_statement(THD *thd_arg)
   flags((uint) IS_IN_USE),
   with_log(false),
   m_name(NULL_CSTR),
-  m_db(NULL_CSTR)
+  m_db(NULL_CSTR),
+  m_cache_key(NULL_CSTR),
+  m_saved_params(NULL),
+  m_saved_columns(NULL),
+  m_saved_column_count(0),
+  m_parked_at(0)
 {
   init_sql_alloc(key_memory_prepared_statement_main_mem_root,
                  &main_mem_root, thd_arg->variables.query_alloc_block_size,
@@ -3823,6 +3948,8 @@ Prepared_statement::swap_prepared_statement(Prepared_statement *copy)
   assert(thd == copy->thd);
   last_error[0]= '\0';
   last_errno= 0;
+  /* The saved metadata was allocated in the old memory root */
+  disable_reuse();
 }
 
 
@@ -4065,6 +4192,214 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
 }
 
 
+/**
+  Remember the key of this statement, see make_stmt_cache_key().
+  Statements with a key are parked on COM_STMT_CLOSE unless
+  disable_reuse() is called.
+*/
+
+bool Prepared_statement::set_cache_key(const String &key)
+{
+  char *str= (char *) memdup_root(&main_mem_root, key.ptr(), key.length());
+  if (str == NULL)
+    return true;
+  m_cache_key.str= str;
+  m_cache_key.length= key.length();
+  return false;
+}
+
+
+void Prepared_statement::disable_reuse()
+{
+  m_cache_key= NULL_CSTR;
+  m_saved_params= NULL;
+  m_saved_columns= NULL;
+  m_saved_column_count= 0;
+}
+
+
+/**
+  Copy the metadata of the placeholders or of the result set, as it is
+  sent to the client, so that reuse() can send it without the tables
+  being open. Names are copied as they may point into a TABLE_SHARE.
+*/
+
+void Prepared_statement::save_metadata(List<Item> *list, bool columns)
+{
+  List_iterator_fast<Item> it(*list);
+  Saved_field *fields;
+  Item *item;
+
+  if (m_cache_key.str == NULL)
+    return;
+  if (!(fields= (Saved_field *) alloc_root(&main_mem_root,
+                                           list->elements *
+                                           sizeof(Saved_field))))
+  {
+    disable_reuse();
+    return;
+  }
+
+  for (Saved_field *saved= fields; (item= it++); saved++)
+  {
+    Send_field *field= &saved->field;
+    item->make_field(field);
+    saved->charset= item->charset_for_protocol();
+    if ((field->db_name &&
+         !(field->db_name= strdup_root(&main_mem_root, field->db_name))) ||
+        (field->table_name &&
+         !(field->table_name= strdup_root(&main_mem_root,
+                                          field->table_name))) ||
+        (field->org_table_name &&
+         !(field->org_table_name= strdup_root(&main_mem_root,
+                                              field->org_table_name))) ||
+        (field->col_name &&
+         !(field->col_name= strdup_root(&main_mem_root, field->col_name))) ||
+        (field->org_col_name &&
+         !(field->org_col_name= strdup_root(&main_mem_root,
+                                            field->org_col_name))))
+    {
+      disable_reuse();
+      return;
+    }
+  }
+
+  if (columns)
+  {
+    m_saved_columns= fields;
+    m_saved_column_count= list->elements;
+  }
+  else
+    m_saved_params= fields;
+}
+
+
+/** Send the metadata copied by save_metadata(). */
+
+bool Prepared_statement::send_saved_metadata(bool columns)
+{
+  Protocol *protocol= thd->get_protocol();
+  const Saved_field *fields= columns ? m_saved_columns : m_saved_params;
+  const uint count= columns ? m_saved_column_count : param_count;
+
+  if (protocol->start_result_metadata(count, Protocol::SEND_EOF,
+                                      thd->variables.character_set_results))
+    goto err;
+
+  for (uint i= 0; i < count; i++)
+  {
+    Send_field field= fields[i].field;
+    protocol->start_row();
+    if (protocol->send_field_metadata(&field, fields[i].charset))
+      goto err;
+    if (protocol->end_row())
+      return true;
+  }
+  return protocol->end_result_metadata();
+
+err:
+  my_error(ER_OUT_OF_RESOURCES, MYF(0));
+  return true;
+}
+
+
+/**
+  Check if the statement may be parked on close: only plain DML whose
+  tables are all base tables, as their definition versions tell whether
+  the saved tree and metadata are still valid.
+*/
+
+bool Prepared_statement::is_reusable() const
+{
+  if (m_cache_key.str == NULL || is_sql_prepare() ||
+      lex->sroutines_list.elements || lex->result ||
+      (param_count && m_saved_params == NULL))
+    return false;
+
+  switch (lex->sql_command) {
+  case SQLCOM_SELECT:
+    if (m_saved_columns == NULL)
+      return false;
+    break;
+  case SQLCOM_INSERT:
+  case SQLCOM_INSERT_SELECT:
+  case SQLCOM_REPLACE:
+  case SQLCOM_REPLACE_SELECT:
+  case SQLCOM_UPDATE:
+  case SQLCOM_UPDATE_MULTI:
+  case SQLCOM_DELETE:
+  case SQLCOM_DELETE_MULTI:
+    break;
+  default:
+    return false;
+  }
+
+  for (TABLE_LIST *table= lex->query_tables; table; table= table->next_global)
+  {
+    if (table->get_table_ref_type() != TABLE_REF_BASE_TABLE)
+      return false;
+  }
+  return true;
+}
+
+
+/**
+  Check that the definitions of all tables are the ones seen at prepare.
+  A table that left the table definition cache counts as changed.
+*/
+
+bool Prepared_statement::tables_unchanged()
+{
+  bool unchanged= true;
+
+  mysql_mutex_lock(&LOCK_open);
+  for (TABLE_LIST *table= lex->query_tables; table && unchanged;
+       table= table->next_global)
+  {
+    TABLE_SHARE *share= get_cached_table_share(thd, table->db,
+                                               table->table_name);
+    unchanged= share != NULL && table->is_table_ref_id_equal(share);
+  }
+  mysql_mutex_unlock(&LOCK_open);
+  return unchanged;
+}
+
+
+/**
+  Answer COM_STMT_PREPARE for a parked statement that was inserted in the
+  statement map again: send the saved metadata under the new id.
+*/
+
+bool Prepared_statement::reuse()
+{
+  Protocol *save_protocol= thd->get_protocol();
+  bool error;
+
+  thd->status_var.com_stmt_prepare++;
+
+  thd->protocol_binary.set_client_capabilities(
+      thd->get_protocol()->get_client_capabilities());
+  thd->set_protocol(&thd->protocol_binary);
+
+  m_prepared_stmt= MYSQL_CREATE_PS(this, id, thd->m_statement_psi,
+                                   NULL, 0, NULL, 0);
+  MYSQL_SET_PS_TEXT(m_prepared_stmt, m_query_string.str,
+                    m_query_string.length);
+
+  error= (send_prep_stmt(this, m_saved_column_count) ||
+          (m_saved_column_count && send_saved_metadata(true)) ||
+          thd->get_protocol_classic()->flush());
+
+  thd->set_protocol(save_protocol);
+
+  if (!error)
+    query_logger.general_log_write(thd, COM_STMT_PREPARE,
+                                   m_query_string.str,
+                                   m_query_string.length);
+  return error;
+}
+
+
 /** Common part of DEALLOCATE PREPARE and mysqld_stmt_close. */
 
 void Prepared_statement::deallocate()
@@ -439,10 +439,10 @@ public:
   char last_error[MYSQL_ERRMSG_SIZE];
 
   /*
-    Uniquely identifies each statement object in thread scope; change during
-    statement lifetime.
+    Uniquely identifies each statement object in thread scope. A new id is
+    assigned when a parked statement is prepared again, see reuse().
   */
-  const ulong id;
+  ulong id;
 
   LEX *lex;                                     // parse tree descriptor
 
@@ -454,6 +454,13 @@ public:
   /* Performance Schema interface for a prepared statement. */
   PSI_prepared_stmt* m_prepared_stmt;
 
+  /** Result set or parameter metadata, saved to be resent on reuse. */
+  struct Saved_field
+  {
+    Send_field field;
+    const CHARSET_INFO *charset;
+  };
+
 private:
   Query_fetch_protocol_binary result;
   uint flags;
@@ -478,6 +485,17 @@ private:
     SELECT_LEX and other classes).
   */
   MEM_ROOT main_mem_root;
+
+  /**
+    Key to find this statement when it is parked, see cache_key().
+    NULL if the statement can not be reused.
+  */
+  LEX_CSTRING m_cache_key;
+  Saved_field *m_saved_params;
+  Saved_field *m_saved_columns;
+  uint m_saved_column_count;
+  /** Stamp of Prepared_statement_map::park(), for the LRU order. */
+  ulonglong m_parked_at;
 public:
   Prepared_statement(THD *thd_arg);
   virtual ~Prepared_statement();
@@ -498,6 +516,23 @@ public:
 #endif
   /* Destroy this statement */
   void deallocate();
+
+  /**
+    Statement text together with the session state the prepared tree
+    depends on. Empty if the statement can not be parked on close.
+  */
+  const LEX_CSTRING &cache_key() const { return m_cache_key; }
+  bool set_cache_key(const String &key);
+  void disable_reuse();
+  void save_metadata(List<Item> *list, bool columns);
+  bool send_saved_metadata(bool columns);
+  uint saved_column_count() const { return m_saved_column_count; }
+  bool is_reusable() const;
+  bool tables_unchanged();
+  bool reuse();
+  size_t memory_used() const { return main_mem_root.allocated_size; }
+  ulonglong parked_at() const { return m_parked_at; }
+  void set_parked_at(ulonglong stamp) { m_parked_at= stamp; }
 private:
   void setup_set_params();
   bool set_db(const LEX_CSTRING &db_length);
@@ -3107,12 +3107,14 @@ const char* get_one_variable_ext(THD *running_thd, THD *target_thd,
     }
 
     case SHOW_KEY_CACHE_LONG:
+      update_key_cache_stats(dflt_key_cache);
       value= (char*) dflt_key_cache + (ulong)value;
       end= int10_to_str(*(long*) value, buff, 10);
       value_charset= system_charset_info;
       break;
 
     case SHOW_KEY_CACHE_LONGLONG:
+      update_key_cache_stats(dflt_key_cache);
       value= (char*) dflt_key_cache + (ulong)value;
       end= longlong10_to_str(*(longlong*) value, buff, 10);
       value_charset= system_charset_info;
@@ -434,6 +434,7 @@ static int print_key_cache_status(const char *name, KEY_CACHE *key_cache)
   }
   else
   {
+    update_key_cache_stats(key_cache);
     printf("%s\n\
 Buffer_size:    %10lu\n\
 Block_size:     %10lu\n\
@@ -60,6 +60,7 @@
 #include "rpl_rli.h"                     // Relay_log_info
 #include "rpl_slave.h"                   // SLAVE_THD_TYPE
 #include "socket_connection.h"           // MY_BIND_ALL_ADDRESSES
+#include "thd_pool.h"                    // Thd_pool
 #include "sp_head.h"                     // SP_PSI_STATEMENT_INFO_COUNT
 #include "sql_parse.h"                   // killall_non_super_threads
 #include "sql_show.h"                    // opt_ignore_db_dirs
@@ -666,6 +667,33 @@ static Sys_var_long Sys_pfs_max_sql_text_length(
        DEFAULT(1024),
        BLOCK_SIZE(1), PFS_TRAILING_PROPERTIES);
 
+static Sys_var_ulong Sys_pfs_max_sample_stacks(
+       "performance_schema_max_sample_stacks",
+       "Maximum number of rows in EVENTS_SAMPLES_SUMMARY_BY_STACK."
+         " Use 0 to disable the statement sampling profiler.",
+       READ_ONLY GLOBAL_VAR(pfs_param.m_sample_stack_sizing),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1024 * 1024),
+       DEFAULT(1024),
+       BLOCK_SIZE(1), PFS_TRAILING_PROPERTIES);
+
+static bool fix_pfs_sampling_interval(sys_var *self, THD *thd,
+                                      enum_var_type type)
+{
+  pfs_sampling_interval_changed();
+  return false;
+}
+
+static Sys_var_ulong Sys_pfs_sampling_interval(
+       "performance_schema_sampling_interval",
+       "Interval in milliseconds between two samples of every instrumented"
+       " thread, aggregated in EVENTS_SAMPLES_SUMMARY_BY_STACK."
+       " Use 0 to disable sampling.",
+       GLOBAL_VAR(pfs_sampling_interval),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 60000),
+       DEFAULT(0), BLOCK_SIZE(1),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(NULL),
+       ON_UPDATE(fix_pfs_sampling_interval));
+
 #endif /* EMBEDDED_LIBRARY */
 #endif /* WITH_PERFSCHEMA_STORAGE_ENGINE */
 
@@ -1896,6 +1924,21 @@ static Sys_var_keycache Sys_key_cache_age_threshold(
        BLOCK_SIZE(100), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(update_keycache_param));
 
+static Sys_var_keycache Sys_key_cache_partitions(
+       "key_cache_partitions", "The number of partitions of a key cache, "
+       "each with its own lock and LRU chain. A key cache block is cached "
+       "in one partition, chosen from its file and position. Use more "
+       "than one partition to reduce the contention on the key cache "
+       "when many threads use MyISAM tables, including internal temporary "
+       "tables, concurrently",
+       sys_var::GLOBAL | sys_var::READONLY,
+       offsetof(KEY_CACHE, param_partitions),
+       sizeof(((KEY_CACHE *)0)->param_partitions),
+       CMD_LINE(REQUIRED_ARG, OPT_KEY_CACHE_PARTITIONS),
+       VALID_RANGE(1, MAX_KEY_CACHE_PARTITIONS), DEFAULT(1),
+       BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(0));
+
 static Sys_var_mybool Sys_large_files_support(
        "large_files_support",
        "Whether mysqld was compiled with options for large file support",
@@ -1913,12 +1956,55 @@ static Sys_var_mybool Sys_large_pages(
        READ_ONLY GLOBAL_VAR(opt_large_pages),
        IF_WIN(NO_CMD_LINE, CMD_LINE(OPT_ARG)), DEFAULT(FALSE));
 
+#ifdef HAVE_LINUX_LARGE_PAGES
+static Sys_var_mybool Sys_large_pages_thp(
+       "large_pages_thp", "Align the large memory areas of storage engine "
+       "caches, such as the InnoDB buffer pool, to huge pages and advise the "
+       "kernel to back them with transparent huge pages, when they cannot "
+       "be allocated from large pages",
+       READ_ONLY GLOBAL_VAR(my_large_pages_thp),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
+static const char *large_pages_numa_names[]=
+  {"DEFAULT", "INTERLEAVE", "LOCAL", NullS};
+static Sys_var_enum Sys_large_pages_numa(
+       "large_pages_numa", "NUMA memory policy of the large memory areas of "
+       "storage engine caches: DEFAULT keeps the policy of the process, "
+       "INTERLEAVE spreads the pages over all the allowed nodes, LOCAL "
+       "allocates every page on the node of the thread first touching it",
+       READ_ONLY GLOBAL_VAR(my_large_pages_numa), CMD_LINE(REQUIRED_ARG),
+       large_pages_numa_names, DEFAULT(MY_LARGE_NUMA_DEFAULT));
+
+static Sys_var_mybool Sys_large_pages_prefault(
+       "large_pages_prefault", "Touch every page of the large memory areas "
+       "of storage engine caches when they are allocated, so that the cost "
+       "of the page faults is paid at startup",
+       READ_ONLY GLOBAL_VAR(my_large_pages_prefault),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+#endif /* HAVE_LINUX_LARGE_PAGES */
+
 static Sys_var_charptr Sys_language(
        "lc_messages_dir", "Directory where error messages are",
        READ_ONLY GLOBAL_VAR(lc_messages_dir_ptr), 
        CMD_LINE(REQUIRED_ARG, OPT_LC_MESSAGES_DIRECTORY),
        IN_FS_CHARSET, DEFAULT(0));
 
+static Sys_var_ulong Sys_load_data_parallel_threads(
+       "load_data_parallel_threads",
+       "Number of threads parsing the file of a LOAD DATA INFILE statement "
+       "with FIELDS TERMINATED BY, while the statement thread inserts the "
+       "rows. 0 parses the file in the statement thread",
+       SESSION_VAR(load_data_parallel_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_load_data_parallel_max_threads(
+       "load_data_parallel_max_threads",
+       "Maximum number of threads parsing LOAD DATA INFILE files at the "
+       "same time in the server, see load_data_parallel_threads. A statement "
+       "gets fewer parser threads, or none, when they are all taken",
+       GLOBAL_VAR(load_data_parallel_max_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024), DEFAULT(64), BLOCK_SIZE(1));
+
 static Sys_var_mybool Sys_local_infile(
        "local_infile", "Enable LOAD DATA LOCAL INFILE",
        GLOBAL_VAR(opt_local_infile), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
@@ -2632,6 +2718,14 @@ static Sys_var_ulong Sys_max_prepared_stmt_count(
        /* max_prepared_stmt_count is used as a sizing hint by the performance schema. */
        sys_var::PARSE_EARLY);
 
+static Sys_var_ulong Sys_prepared_stmt_cache_size(
+       "prepared_stmt_cache_size",
+       "Memory in bytes that closed prepared statements may keep so that "
+       "preparing the same statement again in the session reuses them. "
+       "0 disables the reuse",
+       GLOBAL_VAR(prepared_stmt_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(16*1024*1024), BLOCK_SIZE(1024));
+
 static bool fix_max_relay_log_size(sys_var *self, THD *thd, enum_var_type type)
 {
 #ifdef HAVE_REPLICATION
@@ -3433,9 +3527,13 @@ static Sys_var_ulong Sys_multi_range_count(
 static bool fix_thd_mem_root(sys_var *self, THD *thd, enum_var_type type)
 {
   if (type != OPT_GLOBAL)
+  {
     reset_root_defaults(thd->mem_root,
                         thd->variables.query_alloc_block_size,
                         thd->variables.query_prealloc_size);
+    set_memroot_recycle_limit(thd->mem_root,
+                              thd->variables.query_alloc_recycle_size);
+  }
   return false;
 }
 static Sys_var_ulong Sys_query_alloc_block_size(
@@ -3455,6 +3553,25 @@ static Sys_var_ulong Sys_query_prealloc_size(
        BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_thd_mem_root));
 
+static Sys_var_ulong Sys_query_alloc_recycle_size(
+       "query_alloc_recycle_size",
+       "Upper bound on the memory for query parsing and execution that a "
+       "session keeps between statements, following the recent peak usage, "
+       "instead of freeing it. 0 frees everything but "
+       "query_prealloc_size after each statement",
+       SESSION_VAR(query_alloc_recycle_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(QUERY_ALLOC_RECYCLE_SIZE),
+       BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_thd_mem_root));
+
+static Sys_var_ulong Sys_query_alloc_pool_size(
+       "query_alloc_pool_size",
+       "Size of the server wide pool of free memory blocks shared by the "
+       "query memory of all sessions. 0 disables the pool",
+       GLOBAL_VAR(my_root_pool_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONG_MAX), DEFAULT(QUERY_ALLOC_POOL_SIZE),
+       BLOCK_SIZE(1024));
+
 #if defined (_WIN32) && !defined (EMBEDDED_LIBRARY)
 static Sys_var_mybool Sys_shared_memory(
        "shared_memory", "Enable the shared memory",
@@ -4296,6 +4413,13 @@ static Sys_var_ulong Sys_table_cache_instances(
        */
        sys_var::PARSE_EARLY);
 
+static Sys_var_mybool Sys_table_cache_cpu_affinity(
+       "table_open_cache_cpu_affinity",
+       "Pick the table cache instance by the CPU the connection runs on "
+       "rather than by its thread id",
+       GLOBAL_VAR(table_cache_cpu_affinity), CMD_LINE(OPT_ARG),
+       DEFAULT(TRUE));
+
 #ifndef EMBEDDED_LIBRARY
 static Sys_var_ulong Sys_thread_cache_size(
        "thread_cache_size",
@@ -4303,6 +4427,21 @@ static Sys_var_ulong Sys_thread_cache_size(
        GLOBAL_VAR(Per_thread_connection_handler::max_blocked_pthreads),
        CMD_LINE(REQUIRED_ARG, OPT_THREAD_CACHE_SIZE),
        VALID_RANGE(0, 16384), DEFAULT(0), BLOCK_SIZE(1));
+
+static bool fix_thd_pool_size(sys_var *, THD *, enum_var_type)
+{
+  Thd_pool::resize();
+  return false;
+}
+
+static Sys_var_ulong Sys_thd_pool_size(
+       "thd_pool_size",
+       "How many THD objects to construct ahead of new connections, "
+       "to shorten the connection setup",
+       GLOBAL_VAR(Thd_pool::pool_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 16384), DEFAULT(16), BLOCK_SIZE(1),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(NULL),
+       ON_UPDATE(fix_thd_pool_size));
 #endif // !EMBEDDED_LIBRARY
 
 #ifdef HAVE_POOL_OF_THREADS
@@ -4372,6 +4511,28 @@ static Sys_var_uint Sys_threadpool_oversubscribe(
   GLOBAL_VAR(threadpool_oversubscribe), CMD_LINE(REQUIRED_ARG),
   VALID_RANGE(1, 1000), DEFAULT(3), BLOCK_SIZE(1)
 );
+static Sys_var_mybool Sys_threadpool_work_stealing(
+  "thread_pool_work_stealing",
+  "Allow a thread group with no pending events to take queued events, "
+  "which no worker is going to pick up soon, from other thread groups.",
+  GLOBAL_VAR(threadpool_work_stealing), CMD_LINE(OPT_ARG), DEFAULT(TRUE)
+);
+static Sys_var_mybool Sys_threadpool_numa_affinity(
+  "thread_pool_numa_affinity",
+  "Distribute thread groups over NUMA nodes and bind the worker threads "
+  "of each group to the CPUs and memory of its node.",
+  READ_ONLY GLOBAL_VAR(threadpool_numa_affinity), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE)
+);
+static Sys_var_mybool Sys_threadpool_io_uring(
+  "thread_pool_io_uring",
+  "Wait for network events through io_uring instead of epoll. Requests "
+  "to poll a connection are batched, and wait_timeout is enforced by "
+  "timeouts linked to them. Falls back to epoll if io_uring is not "
+  "available.",
+  READ_ONLY GLOBAL_VAR(threadpool_io_uring), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE)
+);
 static Sys_var_uint Sys_threadpool_size(
  "thread_pool_size",
  "Number of thread groups in the pool. "
@@ -47,6 +47,7 @@ class COND_EQUAL;
 class Security_context;
 class ACL_internal_schema_access;
 class ACL_internal_table_access;
+class Table_cache;
 class Table_cache_element;
 class Table_trigger_dispatcher;
 class Query_result_union;
@@ -1029,11 +1030,20 @@ private:
   */
   TABLE *cache_next, **cache_prev;
 
+  /**
+     Table_cache instance which holds this TABLE object. Connections
+     pick the instance by CPU, so the object is not necessarily given
+     back to the instance the connection uses at the moment.
+  */
+  Table_cache *cache_instance;
+
   /*
     Give Table_cache_element access to the above two members to allow
     using them for linking TABLE objects in a list.
   */
   friend class Table_cache_element;
+  friend class Table_cache;
+  friend class Table_cache_manager;
 
 public:
 
@@ -2203,6 +2213,10 @@ struct TABLE_LIST
     m_table_ref_version= table_ref_version_arg;
   }
 
+  /** Type of the table definition recorded by set_table_ref_id(). */
+  enum_table_ref_type get_table_ref_type() const
+  { return m_table_ref_type; }
+
   /// returns query block id for derived table, and zero if not derived.
   uint query_block_id() const;
 
@@ -27,6 +27,10 @@
 #include "sql_class.h"
 #include "sql_base.h"
 
+#ifdef HAVE_SCHED_GETCPU
+#include <sched.h>
+#endif
+
 /**
   Cache for open TABLE objects.
 
@@ -34,8 +38,11 @@
   go to a central table definition cache to get a TABLE object and
   therefore don't need to lock LOCK_open mutex.
   Instead they only need to go to one Table_cache instance (the
-  specific instance is determined by thread id) and only lock the
-  mutex protecting this cache.
+  specific instance is determined by the CPU the connection runs on,
+  or by thread id where this is not known) and only lock the mutex
+  protecting this cache. TABLE objects remember the instance which
+  holds them, so they are given back to it even if the connection
+  has moved to another CPU since.
   DDL statements that need to remove all TABLE objects from all caches
   need to lock mutexes for all Table_cache instances, but they are rare.
 
@@ -162,12 +169,33 @@ public:
   bool init();
   void destroy();
 
-  /** Get instance of table cache to be used by particular connection. */
+  /**
+    Get instance of table cache to be used by particular connection.
+
+    Connections running on the same CPU share an instance, so its mutex
+    and hash stay in that CPU's cache instead of bouncing between CPUs
+    of connections which happen to have close thread ids.
+  */
   Table_cache* get_cache(THD *thd)
   {
+#ifdef HAVE_SCHED_GETCPU
+    if (table_cache_cpu_affinity)
+    {
+      int cpu= sched_getcpu();
+      if (cpu >= 0)
+        return &m_table_cache[static_cast<uint>(cpu) % table_cache_instances];
+    }
+#endif
     return &m_table_cache[thd->thread_id() % table_cache_instances];
   }
 
+  /** Get instance of table cache which holds the TABLE object. */
+  static Table_cache* get_cache(const TABLE *table)
+  {
+    assert(table->cache_instance);
+    return table->cache_instance;
+  }
+
   /** Get index for the table cache in container. */
   uint cache_index(Table_cache *cache) const
   {
@@ -395,6 +423,7 @@ bool Table_cache::add_used_table(THD *thd, TABLE *table)
 
   /* Add table to the used tables list */
   el->used_tables.push_front(table);
+  table->cache_instance= this;
 
   m_table_count++;
 
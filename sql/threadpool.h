@@ -34,6 +34,9 @@ extern uint threadpool_size; /* Number of parallel executing threads */
 extern uint threadpool_stall_limit;  /* time interval in 10 ms units for stall checks*/
 extern uint threadpool_max_threads;  /* Maximum threads in pool */
 extern uint threadpool_oversubscribe;  /* Maximum active threads in group */
+extern my_bool threadpool_work_stealing; /* Idle groups take queued events */
+extern my_bool threadpool_numa_affinity; /* Bind groups to NUMA nodes */
+extern my_bool threadpool_io_uring;      /* Poll through io_uring */
 
 /* Possible values for thread_pool_high_prio_mode */
 extern const char *threadpool_high_prio_mode_names[];
@@ -66,6 +69,8 @@ struct TP_STATISTICS
 {
   /* Current number of worker thread. */
   volatile int32 num_worker_threads;
+  /* Number of queued events taken over from another group. */
+  volatile int64 num_stolen_events;
 };
 
 extern TP_STATISTICS tp_stats;
@@ -25,10 +25,17 @@
 #include <mysql/thread_pool_priv.h>             // thd_is_transaction_active()
 #include <time.h>
 #include <mysqld_thd_manager.h>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
 #ifdef __linux__
 #include <sys/epoll.h>
 typedef struct epoll_event native_event;
 #endif
+#ifdef HAVE_LIBURING
+#include <poll.h>
+#include <liburing.h>
+#endif
 #if defined (__FreeBSD__) || defined (__APPLE__)
 #include <sys/event.h>
 typedef struct kevent native_event;
@@ -43,6 +50,12 @@ typedef port_event_t native_event;
 /** Maximum number of native events a listener can read in one go */
 #define MAX_EVENTS 1024
 
+/**
+ Number of connections a group may have above the least loaded group before
+ its connections are migrated away when they become idle.
+*/
+#define REBALANCE_CONNECTION_DIFF 2
+
 /** Define if wait_begin() should create threads if necessary without waiting
 for stall detection to kick in */
 #define THREADPOOL_CREATE_THREADS_ON_WAIT
@@ -64,10 +77,18 @@ static bool threadpool_started= false;
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_group_mutex;
 static PSI_mutex_key key_timer_mutex;
+#ifdef HAVE_LIBURING
+static PSI_mutex_key key_uring_sq_mutex;
+static PSI_mutex_key key_uring_cq_mutex;
+#endif
 static PSI_mutex_info mutex_list[]=
 {
   { &key_group_mutex, "group_mutex", 0},
   { &key_timer_mutex, "timer_mutex", PSI_FLAG_GLOBAL}
+#ifdef HAVE_LIBURING
+  ,{ &key_uring_sq_mutex, "uring_sq_mutex", 0},
+  { &key_uring_cq_mutex, "uring_cq_mutex", 0}
+#endif
 };
 
 static PSI_cond_key key_worker_cond;
@@ -119,6 +140,10 @@ struct connection_t
   connection_t *next_in_queue;
   connection_t **prev_in_queue;
   ulonglong abs_wait_timeout;
+#ifdef HAVE_LIBURING
+  /* wait_timeout of the linked timeout request, see set_wait_timeout() */
+  struct __kernel_timespec poll_timeout;
+#endif
   bool logged_in;
   bool bound_to_poll_descriptor;
   bool waiting;
@@ -133,6 +158,22 @@ typedef I_P_List<connection_t,
                      I_P_List_fast_push_back<connection_t> >
 connection_queue_t;
 
+#ifdef HAVE_LIBURING
+/**
+  io_uring variant of a thread group's poll descriptor, see group_poll_*().
+*/
+struct uring_poll_t
+{
+  struct io_uring ring;
+  /* Protects the submission queue */
+  mysql_mutex_t sq_mutex;
+  /* Held by the thread reaping completions */
+  mysql_mutex_t cq_mutex;
+  /* Someone sleeps in io_uring_wait_cqe(), submitters must enter the kernel */
+  bool listener_waiting;
+};
+#endif
+
 struct thread_group_t 
 {
   mysql_mutex_t mutex;
@@ -142,6 +183,10 @@ struct thread_group_t
   worker_thread_t *listener;
   pthread_attr_t *pthread_attr;
   int  pollfd;
+#ifdef HAVE_LIBURING
+  /* Set if the group polls through io_uring, pollfd is the ring then */
+  uring_poll_t *uring;
+#endif
   int  thread_count;
   int  active_thread_count;
   int  connection_count;
@@ -151,6 +196,8 @@ struct thread_group_t
   int queue_event_count;
   ulonglong last_thread_creation_time;
   int  shutdown_pipe[2];
+  /* NUMA node worker threads are bound to, or -1 if not bound */
+  int  numa_node;
   bool shutdown;
   bool stalled;
   
@@ -159,6 +206,15 @@ struct thread_group_t
 static thread_group_t all_groups[MAX_THREAD_GROUPS];
 static uint group_count;
 
+/** Set if the thread groups poll through io_uring instead of io_poll_*() */
+static bool use_io_uring= false;
+
+/**
+ Least loaded group as seen by the last timer tick. Connections going idle
+ in a noticeably busier group migrate here, see start_io().
+*/
+static thread_group_t * volatile rebalance_target;
+
 /**
  Used for printing "pool blocked" message, see
  print_pool_blocked_message();
@@ -397,6 +453,264 @@ static void* native_event_get_userdata(native_event *event)
 #error not ported yet to this OS
 #endif
 
+#ifdef HAVE_LIBURING
+/**
+ io_uring variant of the asynchronous network IO.
+
+ Sockets are armed with one-shot IORING_OP_POLL_ADD requests, so the
+ semantics are the same as with the native APIs above. The difference is in
+ the cost of re-arming: workers only put the request into the submission
+ queue, and it is handed to the kernel by the next thread entering it for
+ this ring anyway, usually the listener going back to wait. Only if the
+ listener already sleeps, the worker submits itself.
+
+ Each poll request is linked with a timeout of wait_timeout seconds. When it
+ expires, the poll completes with -ECANCELED and the connection is killed,
+ the timer thread does not need to scan for idle connections.
+*/
+
+#define URING_ENTRIES 4096
+
+/** user_data of linked timeout requests, their completions are skipped */
+static char uring_link_timeout_tag;
+
+/** Completion of a poll request */
+struct uring_event_t
+{
+  void *data;
+  int res;
+};
+
+static uring_poll_t *uring_poll_create()
+{
+  uring_poll_t *up= (uring_poll_t *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                               sizeof(uring_poll_t),
+                                               MYF(MY_ZEROFILL));
+  if (!up)
+    return NULL;
+
+  int err= io_uring_queue_init(URING_ENTRIES, &up->ring, 0);
+  if (err < 0)
+  {
+    my_free(up);
+    errno= -err;
+    return NULL;
+  }
+  mysql_mutex_init(key_uring_sq_mutex, &up->sq_mutex, NULL);
+  mysql_mutex_init(key_uring_cq_mutex, &up->cq_mutex, NULL);
+  up->listener_waiting= false;
+  return up;
+}
+
+static void uring_poll_destroy(uring_poll_t *up)
+{
+  io_uring_queue_exit(&up->ring);
+  mysql_mutex_destroy(&up->sq_mutex);
+  mysql_mutex_destroy(&up->cq_mutex);
+  my_free(up);
+}
+
+/**
+  Queue a one-shot read poll for the descriptor.
+
+  @param timeout - timeout linked to the poll request, or NULL. Must stay
+                   valid until the request completes.
+*/
+
+static int uring_poll_start_read(uring_poll_t *up, int fd, void *data,
+                                 struct __kernel_timespec *timeout)
+{
+  int ret= 0;
+  mysql_mutex_lock(&up->sq_mutex);
+
+  /* Linked requests must go to the kernel in the same batch */
+  if (io_uring_sq_space_left(&up->ring) < 2 &&
+      io_uring_submit(&up->ring) < 0)
+  {
+    ret= -1;
+  }
+  else
+  {
+    struct io_uring_sqe *sqe= io_uring_get_sqe(&up->ring);
+    io_uring_prep_poll_add(sqe, fd, POLLIN | POLLRDHUP);
+    io_uring_sqe_set_data(sqe, data);
+    if (timeout)
+    {
+      sqe->flags|= IOSQE_IO_LINK;
+      sqe= io_uring_get_sqe(&up->ring);
+      io_uring_prep_link_timeout(sqe, timeout, 0);
+      io_uring_sqe_set_data(sqe, &uring_link_timeout_tag);
+    }
+    if (up->listener_waiting && io_uring_submit(&up->ring) < 0)
+      ret= -1;
+  }
+
+  mysql_mutex_unlock(&up->sq_mutex);
+  return ret;
+}
+
+/**
+  Submit queued requests and reap poll completions.
+
+  Like io_poll_wait(), only infinite and zero timeouts are supported. A
+  zero-timeout call does not wait for another thread reaping completions.
+*/
+
+static int uring_poll_wait(uring_poll_t *up, uring_event_t *events,
+                           int maxevents, int timeout_ms)
+{
+  struct io_uring_cqe *cqe;
+  int count= 0;
+
+  if (timeout_ms == 0)
+  {
+    if (mysql_mutex_trylock(&up->cq_mutex) != 0)
+      return 0;
+  }
+  else
+    mysql_mutex_lock(&up->cq_mutex);
+
+  mysql_mutex_lock(&up->sq_mutex);
+  up->listener_waiting= (timeout_ms != 0);
+  io_uring_submit(&up->ring);
+  mysql_mutex_unlock(&up->sq_mutex);
+
+  for(;;)
+  {
+    while (count < maxevents && io_uring_peek_cqe(&up->ring, &cqe) == 0)
+    {
+      void *data= io_uring_cqe_get_data(cqe);
+      if (data != &uring_link_timeout_tag)
+      {
+        events[count].data= data;
+        events[count].res= cqe->res;
+        count++;
+      }
+      io_uring_cqe_seen(&up->ring, cqe);
+    }
+    if (count || timeout_ms == 0)
+      break;
+
+    int err= io_uring_wait_cqe(&up->ring, &cqe);
+    if (err < 0 && err != -EINTR)
+    {
+      errno= -err;
+      count= -1;
+      break;
+    }
+  }
+
+  if (timeout_ms != 0)
+  {
+    mysql_mutex_lock(&up->sq_mutex);
+    up->listener_waiting= false;
+    mysql_mutex_unlock(&up->sq_mutex);
+  }
+  mysql_mutex_unlock(&up->cq_mutex);
+  return count;
+}
+
+/**
+  Linked timeout of a connection's poll request has expired, kill it.
+  Connection is then handed out as an event, so that a worker aborts it.
+*/
+
+static void uring_connection_timed_out(connection_t *connection)
+{
+  THD *thd= connection->thd;
+  mysql_mutex_lock(&thd->LOCK_thd_data);
+  thd->killed= THD::KILL_CONNECTION;
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
+}
+#endif /* HAVE_LIBURING */
+
+
+/*
+  Poll descriptor operations of a thread group. They use the io_uring
+  variant when the pool was started with it, io_poll_*() otherwise.
+*/
+
+static int group_poll_create(thread_group_t *thread_group)
+{
+#ifdef HAVE_LIBURING
+  if (use_io_uring)
+  {
+    thread_group->uring= uring_poll_create();
+    return thread_group->uring ? thread_group->uring->ring.ring_fd : -1;
+  }
+#endif
+  return io_poll_create();
+}
+
+static void group_poll_close(thread_group_t *thread_group)
+{
+#ifdef HAVE_LIBURING
+  if (thread_group->uring)
+  {
+    uring_poll_destroy(thread_group->uring);
+    thread_group->uring= NULL;
+    return;
+  }
+#endif
+  close(thread_group->pollfd);
+}
+
+static int group_poll_start_read(thread_group_t *thread_group, int fd,
+                                 connection_t *connection, bool associate)
+{
+#ifdef HAVE_LIBURING
+  if (thread_group->uring)
+    return uring_poll_start_read(thread_group->uring, fd, connection,
+                                 connection ? &connection->poll_timeout : NULL);
+#endif
+  if (associate)
+    return io_poll_associate_fd(thread_group->pollfd, fd, connection);
+  return io_poll_start_read(thread_group->pollfd, fd, connection);
+}
+
+static int group_poll_disassociate(thread_group_t *thread_group, int fd)
+{
+#ifdef HAVE_LIBURING
+  /* Nothing to do, one-shot poll requests are gone once they completed */
+  if (thread_group->uring)
+    return 0;
+#endif
+  return io_poll_disassociate_fd(thread_group->pollfd, fd);
+}
+
+/**
+  Wait for connections with pending events. Only infinite and zero timeouts
+  are supported.
+*/
+
+static int group_poll_wait(thread_group_t *thread_group,
+                           connection_t **connections, int maxevents,
+                           int timeout_ms)
+{
+  int cnt;
+#ifdef HAVE_LIBURING
+  if (thread_group->uring)
+  {
+    uring_event_t ev[MAX_EVENTS];
+    cnt= uring_poll_wait(thread_group->uring, ev,
+                         MY_MIN(maxevents, MAX_EVENTS), timeout_ms);
+    for (int i= 0; i < cnt; i++)
+    {
+      connections[i]= (connection_t *) ev[i].data;
+      if (connections[i] && ev[i].res == -ECANCELED)
+        uring_connection_timed_out(connections[i]);
+    }
+    return cnt;
+  }
+#endif
+  native_event ev[MAX_EVENTS];
+  cnt= io_poll_wait(thread_group->pollfd, ev, MY_MIN(maxevents, MAX_EVENTS),
+                    timeout_ms);
+  for (int i= 0; i < cnt; i++)
+    connections[i]= (connection_t *) native_event_get_userdata(&ev[i]);
+  return cnt;
+}
+
 namespace {
 
 /*
@@ -448,6 +762,31 @@ inline bool connection_is_high_prio(const connection_t *c)
 
 } // namespace
 
+/**
+  Find the group with the fewest connections. Ties go to the group with fewer
+  active threads. Counters are read without locking, an approximate answer
+  is good enough here.
+
+  @param start - group index to start the scan from, spreads ties between
+                 groups
+*/
+
+static thread_group_t *least_loaded_group(uint start)
+{
+  uint count= group_count;
+  thread_group_t *best= &all_groups[start % count];
+
+  for (uint i= 1; i < count; i++)
+  {
+    thread_group_t *group= &all_groups[(start + i) % count];
+    if (group->connection_count < best->connection_count ||
+        (group->connection_count == best->connection_count &&
+         group->active_thread_count < best->active_thread_count))
+      best= group;
+  }
+  return best;
+}
+
 /* Dequeue element from a workqueue */
 
 static connection_t *queue_get(thread_group_t *thread_group)
@@ -473,6 +812,71 @@ static connection_t *queue_get(thread_group_t *thread_group)
 }
 
 
+/**
+  Take a queued event from another group.
+
+  Called by a worker that found nothing to do in its own group. Only events
+  that no worker of the victim group is going to pick up soon are taken, i.e.
+  the victim has no idle threads in its waiting list. The connection moves
+  into the thief's group for good, its socket is re-registered with the
+  thief's poll descriptor by start_io() once the request is handled.
+
+  The thief's group mutex must be held. Other groups are only try-locked, so
+  there is no lock order to care about.
+
+  @return connection with pending event, or NULL if there is nothing to steal
+*/
+
+static connection_t *steal_event(thread_group_t *thief)
+{
+  DBUG_ENTER("steal_event");
+  uint count= group_count;
+  uint self= (uint) (thief - all_groups);
+  connection_t *c= NULL;
+
+  for (uint i= 1; i < count && !c; i++)
+  {
+    thread_group_t *victim= &all_groups[(self + i) % count];
+
+    /* Unlocked peek, avoid touching the mutex of groups with nothing queued */
+    if (victim->high_prio_queue.is_empty() && victim->queue.is_empty())
+      continue;
+
+    if (mysql_mutex_trylock(&victim->mutex) != 0)
+      continue;
+
+    if (!victim->shutdown && victim->waiting_threads.is_empty())
+    {
+      if ((c= victim->high_prio_queue.front()))
+        victim->high_prio_queue.remove(c);
+      else if ((c= victim->queue.front()))
+        victim->queue.remove(c);
+
+      if (c)
+        victim->connection_count--;
+    }
+    mysql_mutex_unlock(&victim->mutex);
+
+    if (c && c->bound_to_poll_descriptor)
+    {
+      /* The event was one-shot, the socket is disarmed in victim's poll set */
+      Vio *vio= c->thd->get_protocol_classic()->get_vio();
+      group_poll_disassociate(victim, mysql_socket_getfd(vio->mysql_socket));
+      c->bound_to_poll_descriptor= false;
+    }
+  }
+
+  if (c)
+  {
+    c->thread_group= thief;
+    thief->connection_count++;
+    thief->queue_event_count++;
+    my_atomic_add64(&tp_stats.num_stolen_events, 1);
+  }
+  DBUG_RETURN(c);
+}
+
+
 class Thd_timeout_checker : public Do_THD_Impl
 {
 private:
@@ -585,6 +989,9 @@ static void* timer_thread(void *param)
         if(all_groups[i].connection_count)
            check_stall(&all_groups[i]);
       }
+
+      /* Pick the migration target for idle connections, see start_io() */
+      rebalance_target= least_loaded_group(0);
       
       /* Check if any client exceeded wait_timeout */
       if (timer->next_timeout_check <= timer->current_microtime)
@@ -710,13 +1117,13 @@ static connection_t * listener(worker_thread_t *current_thread,
 
   for(;;)
   {
-    native_event ev[MAX_EVENTS];
+    connection_t *ev[MAX_EVENTS];
     int cnt;
     
     if (thread_group->shutdown)
       break;
   
-    cnt = io_poll_wait(thread_group->pollfd, ev, MAX_EVENTS, -1);
+    cnt = group_poll_wait(thread_group, ev, MAX_EVENTS, -1);
     
     if (cnt <=0)
     {
@@ -788,7 +1195,7 @@ static connection_t * listener(worker_thread_t *current_thread,
     */
     for(int i=(listener_picks_event)?1:0; i < cnt ; i++)
     {
-      connection_t *c= (connection_t *)native_event_get_userdata(&ev[i]);
+      connection_t *c= ev[i];
       if (connection_is_high_prio(c))
       {
         c->tickets--;
@@ -804,7 +1211,7 @@ static connection_t * listener(worker_thread_t *current_thread,
     if (listener_picks_event)
     {
       /* Handle the first event. */
-      retval= (connection_t *)native_event_get_userdata(&ev[0]);
+      retval= ev[0];
       mysql_mutex_unlock(&thread_group->mutex);
       break;
     }
@@ -987,6 +1394,10 @@ static int thread_group_init(thread_group_t *thread_group,
   thread_group->pthread_attr = thread_attr;
   mysql_mutex_init(key_group_mutex, &thread_group->mutex, NULL);
   thread_group->pollfd= -1;
+#ifdef HAVE_LIBURING
+  thread_group->uring= NULL;
+#endif
+  thread_group->numa_node= -1;
   thread_group->shutdown_pipe[0]= -1;
   thread_group->shutdown_pipe[1]= -1;
   DBUG_RETURN(0);
@@ -997,7 +1408,7 @@ static void thread_group_destroy(thread_group_t *thread_group)
   mysql_mutex_destroy(&thread_group->mutex);
   if (thread_group->pollfd != -1)
   {
-    close(thread_group->pollfd);
+    group_poll_close(thread_group);
     thread_group->pollfd= -1;
   }
   for(int i=0; i < 2; i++)
@@ -1059,8 +1470,8 @@ static void thread_group_close(thread_group_t *thread_group)
   }
   
   /* Wake listener */
-  if (io_poll_associate_fd(thread_group->pollfd, 
-      thread_group->shutdown_pipe[0], NULL))
+  if (group_poll_start_read(thread_group, thread_group->shutdown_pipe[0],
+                            NULL, true))
   {
     mysql_mutex_unlock(&thread_group->mutex);
     DBUG_VOID_RETURN;
@@ -1172,11 +1583,9 @@ static connection_t *get_event(worker_thread_t *current_thread,
     */
     if (!oversubscribed)
     {
-      native_event nev;
-      if (io_poll_wait(thread_group->pollfd,&nev,1, 0) == 1)
+      if (group_poll_wait(thread_group, &connection, 1, 0) == 1)
       {
         thread_group->io_event_count++;
-        connection = (connection_t *)native_event_get_userdata(&nev);
 
         /*
           Since we are going to perform an out-of-order event processing for the
@@ -1208,6 +1617,18 @@ static connection_t *get_event(worker_thread_t *current_thread,
       }
     }
 
+    /*
+      Before going to sleep, help out groups that have a backlog, so that a
+      few heavy connections hashed into one group do not queue up while
+      other groups idle.
+    */
+    if (!oversubscribed && threadpool_work_stealing)
+    {
+      connection= steal_event(thread_group);
+      if (connection)
+        break;
+    }
+
     /* And now, finally sleep */ 
     current_thread->woken = false; /* wake() sets this to true */
 
@@ -1362,8 +1783,8 @@ bool Thread_pool_connection_handler::add_connection(Channel_info *channel_info)
 
   thd->event_scheduler.data= connection;
 
-  /* Assign connection to a group. */
-  thread_group_t *group= &all_groups[thd->thread_id() % group_count];
+  /* Assign connection to the least loaded group. */
+  thread_group_t *group= least_loaded_group(thd->thread_id());
 
   connection->thread_group=group;
 
@@ -1487,6 +1908,16 @@ static void set_wait_timeout(connection_t *c)
     1000LL*pool_timer.tick_interval +
     1000000LL*c->thd->get_wait_timeout();
 
+#ifdef HAVE_LIBURING
+  if (use_io_uring)
+  {
+    /* Enforced by the timeout linked to the poll request */
+    c->poll_timeout.tv_sec= c->thd->get_wait_timeout();
+    c->poll_timeout.tv_nsec= 0;
+    DBUG_VOID_RETURN;
+  }
+#endif
+
   set_next_timeout_check(c->abs_wait_timeout);
   DBUG_VOID_RETURN;
 }
@@ -1513,7 +1944,7 @@ static int change_group(connection_t *c,
   mysql_mutex_lock(&old_group->mutex);
   if (c->bound_to_poll_descriptor)
   {
-    io_poll_disassociate_fd(old_group->pollfd,fd);
+    group_poll_disassociate(old_group, fd);
     c->bound_to_poll_descriptor= false;
   }
   c->thread_group->connection_count--;
@@ -1543,11 +1974,25 @@ static int start_io(connection_t *connection)
     connection should need to migrate  to another group, this ensures
     to ensure equal load between groups.
 
-    So we recalculate in which group the connection should be, based
-    on thread_id and current group count, and migrate if necessary.
+    Connections also migrate when their group has got noticeably more
+    connections than the least loaded group found by the timer. This is
+    done here, where the connection is idle and no request is in flight.
   */ 
-  thread_group_t *group = 
-    &all_groups[connection->thd->thread_id() % group_count];
+  thread_group_t *group= connection->thread_group;
+
+  if ((uint) (group - all_groups) >= group_count)
+  {
+    group= least_loaded_group(connection->thd->thread_id());
+  }
+  else
+  {
+    thread_group_t *target= rebalance_target;
+    if (target && target != group &&
+        (uint) (target - all_groups) < group_count &&
+        group->connection_count >
+          target->connection_count + REBALANCE_CONNECTION_DIFF)
+      group= target;
+  }
 
   if (group != connection->thread_group)
   {
@@ -1561,10 +2006,10 @@ static int start_io(connection_t *connection)
   if (!connection->bound_to_poll_descriptor)
   {
     connection->bound_to_poll_descriptor= true;
-    return io_poll_associate_fd(group->pollfd, fd, connection);
+    return group_poll_start_read(group, fd, connection, true);
   }
   
-  return io_poll_start_read(group->pollfd, fd, connection);
+  return group_poll_start_read(group, fd, connection, false);
 }
 
 static void handle_event(connection_t *connection)
@@ -1617,6 +2062,18 @@ static void *worker_main(void *param)
   this_thread.thread_group= thread_group;
   this_thread.event_count=0;
 
+#ifdef HAVE_LIBNUMA
+  if (thread_group->numa_node >= 0)
+  {
+    /*
+      Keep all threads of the group, the listener included, on the CPUs and
+      memory of its node.
+    */
+    numa_run_on_node(thread_group->numa_node);
+    numa_set_localalloc();
+  }
+#endif
+
 #ifdef HAVE_PSI_THREAD_INTERFACE
     PSI_THREAD_CALL(set_thread_account)
       (NULL, 0, NULL, 0);
@@ -1653,6 +2110,65 @@ static void *worker_main(void *param)
 }
 
 
+/**
+  Spread thread groups round-robin over the NUMA nodes. Each group has its
+  own poll descriptor, so this also gives every node its own listener
+  poll sets.
+*/
+
+static void assign_numa_nodes()
+{
+#ifdef HAVE_LIBNUMA
+  if (numa_available() < 0)
+  {
+    sql_print_warning("thread_pool_numa_affinity is ignored, NUMA is not "
+                      "available on this system");
+    return;
+  }
+
+  int nodes[MAX_THREAD_GROUPS];
+  uint node_count= 0;
+  for (int n= 0; n <= numa_max_node() && node_count < MAX_THREAD_GROUPS; n++)
+  {
+    if (numa_bitmask_isbitset(numa_all_nodes_ptr, n))
+      nodes[node_count++]= n;
+  }
+  if (node_count == 0)
+    return;
+
+  for (uint i= 0; i < array_elements(all_groups); i++)
+    all_groups[i].numa_node= nodes[i % node_count];
+#else
+  sql_print_warning("thread_pool_numa_affinity is ignored, server is built "
+                    "without NUMA support");
+#endif
+}
+
+
+/**
+  Use io_uring for the thread groups if a ring can be set up, which may
+  be prevented by the kernel version, seccomp policy or memlock limit.
+*/
+
+static void check_io_uring()
+{
+#ifdef HAVE_LIBURING
+  uring_poll_t *probe= uring_poll_create();
+  if (!probe)
+  {
+    sql_print_warning("thread_pool_io_uring is ignored, io_uring_queue_init() "
+                      "failed, errno=%d", errno);
+    return;
+  }
+  uring_poll_destroy(probe);
+  use_io_uring= true;
+#else
+  sql_print_warning("thread_pool_io_uring is ignored, server is built "
+                    "without io_uring support");
+#endif
+}
+
+
 bool tp_init()
 {
   DBUG_ENTER("tp_init");
@@ -1662,6 +2178,10 @@ bool tp_init()
   {
     thread_group_init(&all_groups[i], get_connection_attrib());  
   }
+  if (threadpool_numa_affinity)
+    assign_numa_nodes();
+  if (threadpool_io_uring)
+    check_io_uring();
   tp_set_threadpool_size(threadpool_size);
   if(group_count == 0)
   {
@@ -1712,11 +2232,13 @@ void tp_set_threadpool_size(uint size)
     mysql_mutex_lock(&group->mutex);
     if (group->pollfd == -1)
     {
-      group->pollfd= io_poll_create();
+      group->pollfd= group_poll_create(group);
       success= (group->pollfd >= 0);
       if(!success)
       {
-        sql_print_error("io_poll_create() failed, errno=%d\n", errno);
+        sql_print_error("%s failed, errno=%d\n",
+                        use_io_uring ? "io_uring_queue_init()" :
+                        "io_poll_create()", errno);
       }
     }  
     mysql_mutex_unlock(&all_groups[i].mutex);
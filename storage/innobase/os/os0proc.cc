@@ -33,6 +33,7 @@ Created 9/30/1995 Heikki Tuuri
 *******************************************************/
 
 #include "ha_prototypes.h"
+#include "my_sys.h"
 
 #include "os0proc.h"
 #ifdef UNIV_NONINL
@@ -106,6 +107,9 @@ os_proc_get_number(void)
 }
 
 /** Allocates large pages memory.
+On Linux the memory is mapped by my_large_mmap(), which applies the
+large_pages, large_pages_thp, large_pages_numa and large_pages_prefault
+settings of the server.
 @param[in,out]	n	Number of bytes to allocate
 @return allocated memory */
 void*
@@ -116,49 +120,20 @@ os_mem_alloc_large(
 	void*	ptr;
 	ulint	size;
 #if defined HAVE_LINUX_LARGE_PAGES && defined UNIV_LINUX
-	int shmid;
-	struct shmid_ds buf;
+	size_t	mapped = *n;
 
-	if (!os_use_large_pages || !os_large_page_size) {
-		goto skip;
+	ptr = my_large_mmap(&mapped, populate);
+	if (UNIV_UNLIKELY(ptr == NULL)) {
+		ib::error() << "mmap(" << *n << " bytes) failed;"
+			" errno " << my_errno();
+		return(NULL);
 	}
 
-	/* Align block size to os_large_page_size */
-	ut_ad(ut_is_2pow(os_large_page_size));
-	size = ut_2pow_round(*n + (os_large_page_size - 1),
-			     os_large_page_size);
-
-	shmid = shmget(IPC_PRIVATE, (size_t) size, SHM_HUGETLB | SHM_R | SHM_W);
-	if (shmid < 0) {
-		ib::warn() << "Failed to allocate " << size
-			<< " bytes. errno " << errno;
-		ptr = NULL;
-	} else {
-		ptr = shmat(shmid, NULL, 0);
-		if (ptr == (void*)-1) {
-			ib::warn() << "Failed to attach shared memory segment,"
-				" errno " << errno;
-			ptr = NULL;
-		}
-
-		/* Remove the shared memory segment so that it will be
-		automatically freed after memory is detached or
-		process exits */
-		shmctl(shmid, IPC_RMID, &buf);
-	}
-
-	if (ptr) {
-		*n = size;
-		os_atomic_increment_ulint(
-			&os_total_large_mem_allocated, size);
-
-		UNIV_MEM_ALLOC(ptr, size);
-		return(ptr);
-	}
-
-	ib::warn() << "Using conventional memory pool";
-skip:
-#endif /* HAVE_LINUX_LARGE_PAGES && UNIV_LINUX */
+	size = *n = mapped;
+	os_atomic_increment_ulint(&os_total_large_mem_allocated, size);
+	UNIV_MEM_ALLOC(ptr, size);
+	return(ptr);
+#else /* HAVE_LINUX_LARGE_PAGES && UNIV_LINUX */
 
 #ifdef _WIN32
 	SYSTEM_INFO	system_info;
@@ -199,24 +174,14 @@ skip:
 	}
 #endif
 
-#if OS_MAP_ANON && OS_MAP_POPULATE
-	/* MAP_POPULATE is only supported for private mappings
-	since Linux 2.6.23. */
-	populate = populate && !os_compare_release("2.6.23");
-
-	if (populate) {
-		ib::warn() << "mmap(MAP_POPULATE) is not supported for private mappings. "
-			"Forcing preallocation by faulting in pages.";
-	}
-#endif
-
 	/* Initialize the entire buffer to force the allocation
 	of physical memory page frames. */
-	if (populate) {
+	if (populate && !OS_MAP_POPULATE) {
 		memset(ptr, '\0', size);
 	}
 
 	return(ptr);
+#endif /* HAVE_LINUX_LARGE_PAGES && UNIV_LINUX */
 }
 
 /** Frees large pages memory.
@@ -230,14 +195,15 @@ os_mem_free_large(
 	ut_a(os_total_large_mem_allocated >= size);
 
 #if defined HAVE_LINUX_LARGE_PAGES && defined UNIV_LINUX
-	if (os_use_large_pages && os_large_page_size && !shmdt(ptr)) {
+	if (my_large_munmap(ptr, size)) {
+		ib::error() << "munmap(" << ptr << ", " << size << ") failed;"
+			" errno " << errno;
+	} else {
 		os_atomic_decrement_ulint(
 			&os_total_large_mem_allocated, size);
 		UNIV_MEM_FREE(ptr, size);
-		return;
 	}
-#endif /* HAVE_LINUX_LARGE_PAGES && UNIV_LINUX */
-#ifdef _WIN32
+#elif defined _WIN32
 	/* When RELEASE memory, the size parameter must be 0.
 	Do not use MEM_RELEASE with MEM_DECOMMIT. */
 	if (!VirtualFree(ptr, 0, MEM_RELEASE)) {
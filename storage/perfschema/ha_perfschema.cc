@@ -40,6 +40,7 @@
 #include "pfs_user.h"
 #include "pfs_program.h"
 #include "pfs_prepared_stmt.h"
+#include "pfs_sampler.h"
 #include "pfs_buffer_container.h"
 
 handlerton *pfs_hton= NULL;
@@ -194,6 +195,8 @@ static struct st_mysql_show_var pfs_status_vars[]=
     (char*) &global_prepared_stmt_container.m_lost, SHOW_LONG, SHOW_SCOPE_GLOBAL},
   {"Performance_schema_metadata_lock_lost",
     (char*) &global_mdl_container.m_lost, SHOW_LONG, SHOW_SCOPE_GLOBAL},
+  {"Performance_schema_sample_stacks_lost",
+    (char*) &sample_stack_lost, SHOW_LONG, SHOW_SCOPE_GLOBAL},
   {NullS, NullS, SHOW_LONG, SHOW_SCOPE_GLOBAL}
 };
 
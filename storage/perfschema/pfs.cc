@@ -63,6 +63,7 @@
 #include "sp_head.h"
 #include "mdl.h" /* mdl_key_init */
 #include "pfs_digest.h"
+#include "pfs_sampler.h"
 #include "pfs_program.h"
 #include "pfs_prepared_stmt.h"
 
@@ -3832,6 +3833,14 @@ pfs_start_idle_wait_v1(PSI_idle_locker_state* state, const char *src_file, uint
 {
   assert(state != NULL);
 
+  /*
+    The session waits for its next command,
+    publish the statement digests it aggregated locally for long enough.
+  */
+  PFS_thread *idle_thread= my_thread_get_THR_PFS();
+  if (likely(idle_thread != NULL))
+    flush_idle_digest_thread_cache(idle_thread);
+
   if (!flag_global_instrumentation)
     return NULL;
 
@@ -5467,6 +5476,14 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
     wait_time= timer_end - state->m_timer_start;
   }
 
+  if (flags & STATE_FLAG_DIGEST)
+  {
+    /* The statement is no longer running, stop sampling its digest. */
+    PFS_thread *pfs_thread= my_thread_get_THR_PFS();
+    if (likely(pfs_thread != NULL) && pfs_thread->m_sample_has_digest)
+      sampler_clear_digest(pfs_thread);
+  }
+
   PFS_statement_stat *event_name_array;
   uint index= klass->m_event_name_index;
   PFS_statement_stat *stat;
@@ -5476,6 +5493,7 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
   */
   const sql_digest_storage *digest_storage= NULL;
   PFS_statement_stat *digest_stat= NULL;
+  PFS_digest_histogram *digest_histogram= NULL;
   PFS_program *pfs_program= NULL;
   PFS_prepared_stmt *pfs_prepared_stmt= NULL;
 
@@ -5496,7 +5514,8 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
         /* Populate PFS_statements_digest_stat with computed digest information.*/
         digest_stat= find_or_create_digest(thread, digest_storage,
                                            state->m_schema_name,
-                                           state->m_schema_name_length);
+                                           state->m_schema_name_length,
+                                           & digest_histogram);
       }
     }
 
@@ -5579,7 +5598,8 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
           /* Populate statements_digest_stat with computed digest information. */
           digest_stat= find_or_create_digest(thread, digest_storage,
                                              state->m_schema_name,
-                                             state->m_schema_name_length);
+                                             state->m_schema_name_length,
+                                             & digest_histogram);
         }
       }
     }
@@ -5626,6 +5646,12 @@ void pfs_end_statement_v1(PSI_statement_locker *locker, void *stmt_da)
     if (flags & STATE_FLAG_TIMED)
     {
       digest_stat->aggregate_value(wait_time);
+
+      if (digest_histogram != NULL)
+      {
+        time_normalizer *normalizer= time_normalizer::get(statement_timer);
+        digest_histogram->aggregate_value(normalizer->wait_to_pico(wait_time));
+      }
     }
     else
     {
@@ -6419,6 +6445,13 @@ void pfs_digest_end_v1(PSI_digest_locker *locker, const sql_digest_storage *dige
   if (statement_state->m_flags & STATE_FLAG_DIGEST)
   {
     statement_state->m_digest= digest;
+
+    if (pfs_sampling_interval != 0)
+    {
+      PFS_thread *pfs_thread= my_thread_get_THR_PFS();
+      if (likely(pfs_thread != NULL))
+        sampler_set_digest(pfs_thread, digest);
+    }
   }
 }
 
@@ -300,6 +300,7 @@ void pfs_automated_sizing(PFS_global_param *param)
     param->m_metadata_lock_sizing= 0;
     param->m_max_digest_length= 0;
     param->m_max_sql_text_length= 0;
+    param->m_sample_stack_sizing= 0;
   }
 }
 
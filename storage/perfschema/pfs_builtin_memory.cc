@@ -106,6 +106,7 @@ PFS_builtin_memory_class builtin_memory_table_share_lock;
 
 PFS_builtin_memory_class builtin_memory_program;
 PFS_builtin_memory_class builtin_memory_prepared_stmt;
+PFS_builtin_memory_class builtin_memory_sample_stacks;
 
 PFS_builtin_memory_class builtin_memory_scalable_buffer;
 
@@ -277,6 +278,8 @@ void init_all_builtin_memory_class()
                              "memory/performance_schema/events_statements_summary_by_program");
   init_builtin_memory_class( & builtin_memory_prepared_stmt,
                              "memory/performance_schema/prepared_statements_instances");
+  init_builtin_memory_class( & builtin_memory_sample_stacks,
+                             "memory/performance_schema/events_samples_summary_by_stack");
 
   init_builtin_memory_class( & builtin_memory_scalable_buffer,
                              "memory/performance_schema/scalable_buffer");
@@ -365,6 +368,7 @@ static PFS_builtin_memory_class* all_builtin_memory[]=
 
   & builtin_memory_program,
   & builtin_memory_prepared_stmt,
+  & builtin_memory_sample_stacks,
 
   & builtin_memory_scalable_buffer,
 
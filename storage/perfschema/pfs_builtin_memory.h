@@ -135,6 +135,7 @@ extern PFS_builtin_memory_class builtin_memory_table_share_lock;
 
 extern PFS_builtin_memory_class builtin_memory_program;
 extern PFS_builtin_memory_class builtin_memory_prepared_stmt;
+extern PFS_builtin_memory_class builtin_memory_sample_stacks;
 
 extern PFS_builtin_memory_class builtin_memory_scalable_buffer;
 
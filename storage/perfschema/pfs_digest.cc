@@ -192,13 +192,91 @@ static LF_PINS* get_digest_hash_pins(PFS_thread *thread)
   return thread->m_digest_hash_pins;
 }
 
+/**
+  Publish the statements aggregated in a thread cache entry
+  to the shared digest record.
+  Statistics aggregated for a record that was truncated since
+  are discarded.
+*/
+static void flush_digest_cache_entry(PFS_digest_thread_cache *entry)
+{
+  PFS_statements_digest_stat *pfs= entry->m_digest_stat;
+
+  if (entry->m_pending != 0 &&
+      pfs->m_lock.copy_version_state() == entry->m_version)
+  {
+    pfs->m_stat.aggregate(& entry->m_stat);
+    pfs->m_histogram.aggregate(& entry->m_histogram);
+    if (pfs->m_last_seen < entry->m_last_seen)
+      pfs->m_last_seen= entry->m_last_seen;
+  }
+
+  entry->m_pending= 0;
+  entry->m_stat.reset();
+  entry->m_histogram.reset();
+}
+
+/**
+  Use a thread cache entry for a digest record,
+  publishing what the entry aggregated for its previous digest.
+  The shared record keeps LAST_SEEN up to date when the first statement
+  of a batch is aggregated, @c flush_digest_cache_entry() does it for
+  the last one.
+*/
+static PFS_statement_stat*
+cache_digest(PFS_digest_thread_cache *entry,
+             const PFS_digest_key *hash_key,
+             PFS_statements_digest_stat *pfs,
+             ulonglong now,
+             PFS_digest_histogram **histogram)
+{
+  uint32 version= pfs->m_lock.copy_version_state();
+
+  if ((version & STATE_MASK) != PFS_LOCK_ALLOCATED)
+  {
+    /* Record still being created by another thread, do not cache it. */
+    pfs->m_last_seen= now;
+    *histogram= & pfs->m_histogram;
+    return & pfs->m_stat;
+  }
+
+  if (entry->m_digest_stat != NULL)
+    flush_digest_cache_entry(entry);
+
+  memcpy(& entry->m_digest_key, hash_key, sizeof(PFS_digest_key));
+  entry->m_digest_stat= pfs;
+  entry->m_version= version;
+  entry->m_pending= 1;
+  entry->m_stat.reset();
+  entry->m_histogram.reset();
+  entry->m_first_pending= now;
+  entry->m_last_seen= now;
+  pfs->m_last_seen= now;
+
+  *histogram= & entry->m_histogram;
+  return & entry->m_stat;
+}
+
+/**
+  Find the statistics to aggregate a statement digest to.
+  Statistics are aggregated in a per thread cache first,
+  @sa PFS_digest_thread_cache.
+  @param thread the running thread
+  @param digest_storage the statement digest
+  @param schema_name the statement current schema
+  @param schema_name_length length of @c schema_name
+  @param [out] histogram the latency histogram to aggregate to
+  @return the statement statistics to aggregate to, or NULL
+*/
 PFS_statement_stat*
 find_or_create_digest(PFS_thread *thread,
                       const sql_digest_storage *digest_storage,
                       const char *schema_name,
-                      uint schema_name_length)
+                      uint schema_name_length,
+                      PFS_digest_histogram **histogram)
 {
   assert(digest_storage != NULL);
+  *histogram= NULL;
 
   if (statements_digest_stat_array == NULL)
     return NULL;
@@ -236,6 +314,39 @@ find_or_create_digest(PFS_thread *thread,
 
   ulonglong now= my_micro_time();
 
+  PFS_digest_thread_cache *cached=
+    & thread->m_digest_cache[hash_key.m_md5[0] & (DIGEST_THREAD_CACHE_SIZE - 1)];
+
+  if (cached->m_digest_stat != NULL &&
+      memcmp(& cached->m_digest_key, & hash_key, sizeof(PFS_digest_key)) == 0)
+  {
+    if (likely(cached->m_digest_stat->m_lock.copy_version_state() ==
+               cached->m_version))
+    {
+      if (cached->m_pending >= DIGEST_THREAD_FLUSH_COUNT ||
+          (cached->m_pending != 0 &&
+           now - cached->m_first_pending >= DIGEST_THREAD_FLUSH_TIME))
+      {
+        /* Publish the batch, and this statement, to the shared record. */
+        flush_digest_cache_entry(cached);
+        pfs= cached->m_digest_stat;
+        pfs->m_last_seen= now;
+        *histogram= & pfs->m_histogram;
+        return & pfs->m_stat;
+      }
+
+      if (cached->m_pending == 0)
+        cached->m_first_pending= now;
+      cached->m_pending++;
+      cached->m_last_seen= now;
+      *histogram= & cached->m_histogram;
+      return & cached->m_stat;
+    }
+
+    /* The digest record was truncated, and maybe reused. */
+    cached->m_digest_stat= NULL;
+  }
+
 search:
 
   /* Lookup LF_HASH using this new key. */
@@ -247,9 +358,8 @@ search:
   {
     /* If digest already exists, update stats and return. */
     pfs= *entry;
-    pfs->m_last_seen= now;
     lf_hash_search_unpin(pins);
-    return & pfs->m_stat;
+    return cache_digest(cached, & hash_key, pfs, now, histogram);
   }
 
   lf_hash_search_unpin(pins);
@@ -263,6 +373,7 @@ search:
     if (pfs->m_first_seen == 0)
       pfs->m_first_seen= now;
     pfs->m_last_seen= now;
+    *histogram= & pfs->m_histogram;
     return & pfs->m_stat;
   }
 
@@ -299,7 +410,7 @@ search:
         if (likely(res == 0))
         {
           pfs->m_lock.dirty_to_allocated(& dirty_state);
-          return & pfs->m_stat;
+          return cache_digest(cached, & hash_key, pfs, now, histogram);
         }
 
         pfs->m_lock.dirty_to_free(& dirty_state);
@@ -330,9 +441,67 @@ search:
   if (pfs->m_first_seen == 0)
     pfs->m_first_seen= now;
   pfs->m_last_seen= now;
+  *histogram= & pfs->m_histogram;
   return & pfs->m_stat;
 }
 
+/**
+  Publish all the digest statistics aggregated locally by a thread.
+  Done when the thread is destroyed, and when it opens the digest
+  tables, so that a session sees its own statements.
+  @param thread the thread, which must be the running thread or a
+  thread being destroyed
+  @param release true to empty the cache as well
+*/
+void flush_digest_thread_cache(PFS_thread *thread, bool release)
+{
+  for (uint i= 0; i < DIGEST_THREAD_CACHE_SIZE; i++)
+  {
+    PFS_digest_thread_cache *entry= & thread->m_digest_cache[i];
+
+    if (entry->m_digest_stat != NULL)
+    {
+      if (entry->m_pending != 0 && statements_digest_stat_array != NULL)
+        flush_digest_cache_entry(entry);
+      if (release)
+        entry->m_digest_stat= NULL;
+    }
+  }
+}
+
+/**
+  Publish the digest statistics aggregated locally by a session going
+  idle, for the digests which reached DIGEST_THREAD_FLUSH_COUNT
+  statements or DIGEST_THREAD_FLUSH_TIME of age. Sessions run a few
+  statements between idle waits, publishing everything at every idle
+  wait would write to the shared records for almost every statement.
+  @param thread the running thread
+*/
+void flush_idle_digest_thread_cache(PFS_thread *thread)
+{
+  ulonglong now= 0;
+
+  if (statements_digest_stat_array == NULL)
+    return;
+
+  for (uint i= 0; i < DIGEST_THREAD_CACHE_SIZE; i++)
+  {
+    PFS_digest_thread_cache *entry= & thread->m_digest_cache[i];
+
+    if (entry->m_digest_stat == NULL || entry->m_pending == 0)
+      continue;
+
+    if (entry->m_pending < DIGEST_THREAD_FLUSH_COUNT)
+    {
+      if (now == 0)
+        now= my_micro_time();
+      if (now - entry->m_first_pending < DIGEST_THREAD_FLUSH_TIME)
+        continue;
+    }
+    flush_digest_cache_entry(entry);
+  }
+}
+
 void purge_digest(PFS_thread* thread, PFS_digest_key *hash_key)
 {
   LF_PINS *pins= get_digest_hash_pins(thread);
@@ -361,6 +530,7 @@ void PFS_statements_digest_stat::reset_data(unsigned char *token_array, size_t l
   m_lock.set_dirty(& dirty_state);
   m_digest_storage.reset(token_array, length);
   m_stat.reset();
+  m_histogram.reset();
   m_first_seen= 0;
   m_last_seen= 0;
   m_lock.dirty_to_free(& dirty_state);
@@ -404,3 +574,14 @@ void reset_esms_by_digest()
   digest_full= false;
 }
 
+
+void reset_histogram_by_digest()
+{
+  uint index;
+
+  if (statements_digest_stat_array == NULL)
+    return;
+
+  for (index= 0; index < digest_max; index++)
+    statements_digest_stat_array[index].m_histogram.reset();
+}
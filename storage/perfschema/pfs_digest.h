@@ -48,6 +48,65 @@ struct PFS_digest_key
   uint m_schema_name_length;
 };
 
+/**
+  Number of buckets in a statement digest latency histogram.
+  Bucket 0 counts statements faster than 2^DIGEST_HISTOGRAM_BASE_BITS pico
+  seconds, bucket N counts statements in
+  [2^(DIGEST_HISTOGRAM_BASE_BITS + N - 1), 2^(DIGEST_HISTOGRAM_BASE_BITS + N)[,
+  the last bucket is open ended.
+*/
+#define DIGEST_HISTOGRAM_BUCKETS 32
+/** Upper bound of histogram bucket 0, 2^20 pico seconds is about 1 micro second. */
+#define DIGEST_HISTOGRAM_BASE_BITS 20
+
+/** Latency histogram of a statement digest. */
+struct PFS_digest_histogram
+{
+  ulonglong m_count[DIGEST_HISTOGRAM_BUCKETS];
+
+  inline void reset(void)
+  {
+    memset(m_count, 0, sizeof(m_count));
+  }
+
+  static inline uint bucket_index(ulonglong pico)
+  {
+    uint index= 0;
+
+    pico>>= DIGEST_HISTOGRAM_BASE_BITS;
+    while (pico != 0 && index < DIGEST_HISTOGRAM_BUCKETS - 1)
+    {
+      pico>>= 1;
+      index++;
+    }
+    return index;
+  }
+
+  /** Lower bound of a bucket, in pico seconds. */
+  static inline ulonglong bucket_low(uint index)
+  {
+    return (index == 0) ? 0 : 1ULL << (DIGEST_HISTOGRAM_BASE_BITS + index - 1);
+  }
+
+  /** Upper bound of a bucket, in pico seconds. */
+  static inline ulonglong bucket_high(uint index)
+  {
+    return (index == DIGEST_HISTOGRAM_BUCKETS - 1) ?
+      ULLONG_MAX : 1ULL << (DIGEST_HISTOGRAM_BASE_BITS + index);
+  }
+
+  inline void aggregate_value(ulonglong pico)
+  {
+    m_count[bucket_index(pico)]++;
+  }
+
+  inline void aggregate(const PFS_digest_histogram *histogram)
+  {
+    for (uint i= 0; i < DIGEST_HISTOGRAM_BUCKETS; i++)
+      m_count[i]+= histogram->m_count[i];
+  }
+};
+
 /** A statement digest stat record. */
 struct PFS_ALIGNED PFS_statements_digest_stat
 {
@@ -63,6 +122,9 @@ struct PFS_ALIGNED PFS_statements_digest_stat
   /** Statement stat. */
   PFS_statement_stat m_stat;
 
+  /** Statement latency histogram. */
+  PFS_digest_histogram m_histogram;
+
   /** First and last seen timestamps.*/
   ulonglong m_first_seen;
   ulonglong m_last_seen;
@@ -73,6 +135,50 @@ struct PFS_ALIGNED PFS_statements_digest_stat
   void reset_index(PFS_thread *thread);
 };
 
+/**
+  Number of digests aggregated locally by each thread.
+  Must be a power of 2.
+*/
+#define DIGEST_THREAD_CACHE_SIZE 8
+/**
+  Number of statements a thread aggregates locally for a digest,
+  before publishing them to EVENTS_STATEMENTS_SUMMARY_BY_DIGEST.
+*/
+#define DIGEST_THREAD_FLUSH_COUNT 32
+/**
+  Age, in micro seconds, after which statements aggregated locally for
+  a digest are published at the next statement end with that digest,
+  or when the session goes idle.
+*/
+#define DIGEST_THREAD_FLUSH_TIME 1000000
+
+/**
+  A digest stat record, private to a thread.
+  Statements ending with the same digest in a row are aggregated here
+  first, and published to the shared record in batches, so that hot
+  digests do not make every session write the same cache lines,
+  nor search the digest hash, for every statement.
+*/
+struct PFS_digest_thread_cache
+{
+  /** Digest Schema + MD5 Hash. */
+  PFS_digest_key m_digest_key;
+  /** Shared record for this digest, NULL when the entry is empty. */
+  PFS_statements_digest_stat *m_digest_stat;
+  /** Lock version of @c m_digest_stat when the entry was filled. */
+  uint32 m_version;
+  /** Number of statements not yet published. */
+  uint m_pending;
+  /** Statement stat, not yet published. */
+  PFS_statement_stat m_stat;
+  /** Statement latency histogram, not yet published. */
+  PFS_digest_histogram m_histogram;
+  /** Timestamp of the first statement not yet published. */
+  ulonglong m_first_pending;
+  /** Last seen timestamp, not yet published. */
+  ulonglong m_last_seen;
+};
+
 int init_digest(const PFS_global_param *param);
 void cleanup_digest();
 
@@ -81,9 +187,13 @@ void cleanup_digest_hash(void);
 PFS_statement_stat* find_or_create_digest(PFS_thread *thread,
                                           const sql_digest_storage *digest_storage,
                                           const char *schema_name,
-                                          uint schema_name_length);
+                                          uint schema_name_length,
+                                          PFS_digest_histogram **histogram);
+void flush_digest_thread_cache(PFS_thread *thread, bool release);
+void flush_idle_digest_thread_cache(PFS_thread *thread);
 
 void reset_esms_by_digest();
+void reset_histogram_by_digest();
 
 /* Exposing the data directly, for iterators. */
 extern PFS_statements_digest_stat *statements_digest_stat_array;
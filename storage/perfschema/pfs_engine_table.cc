@@ -71,7 +71,9 @@
 #include "table_esms_by_account_by_event_name.h"
 #include "table_esms_global_by_event_name.h"
 #include "table_esms_by_digest.h"
+#include "table_esmh_by_digest.h"
 #include "table_esms_by_program.h"
+#include "table_samples_by_stack.h"
 
 #include "table_events_transactions.h"
 #include "table_ets_by_thread_by_event_name.h"
@@ -281,7 +283,9 @@ static PFS_engine_table_share *all_shares[]=
   &table_esms_by_host_by_event_name::m_share,
   &table_esms_global_by_event_name::m_share,
   &table_esms_by_digest::m_share,
+  &table_esmh_by_digest::m_share,
   &table_esms_by_program::m_share,
+  &table_samples_by_stack::m_share,
 
   &table_events_transactions_current::m_share,
   &table_events_transactions_history::m_share,
@@ -557,6 +557,8 @@ PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
     pfs->m_host_hash_pins= NULL;
     pfs->m_digest_hash_pins= NULL;
     pfs->m_program_hash_pins= NULL;
+    for (uint i= 0; i < DIGEST_THREAD_CACHE_SIZE; i++)
+      pfs->m_digest_cache[i].m_digest_stat= NULL;
 
     pfs->m_username_length= 0;
     pfs->m_hostname_length= 0;
@@ -567,6 +569,7 @@ PFS_thread* create_thread(PFS_thread_class *klass, const void *identity,
     pfs->m_stage_progress= NULL;
     pfs->m_processlist_info[0]= '\0';
     pfs->m_processlist_info_length= 0;
+    pfs->m_sample_has_digest= false;
     pfs->m_connection_type= NO_VIO_TYPE;
     pfs->m_start_time_usec = 0;
     pfs->m_rows_sent = 0;
@@ -712,6 +715,7 @@ void destroy_thread(PFS_thread *pfs)
     lf_hash_put_pins(pfs->m_host_hash_pins);
     pfs->m_host_hash_pins= NULL;
   }
+  flush_digest_thread_cache(pfs, true);
   if (pfs->m_digest_hash_pins)
   {
     lf_hash_put_pins(pfs->m_digest_hash_pins);
@@ -55,6 +55,7 @@ class THD;
 #include "pfs_events_stages.h"
 #include "pfs_events_statements.h"
 #include "pfs_events_transactions.h"
+#include "pfs_digest.h"
 #include "pfs_server.h"
 #include "lf.h"
 #include "pfs_con_slice.h"
@@ -603,6 +604,16 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice
     Protected by @c m_stmt_lock.
   */
   uint m_processlist_info_length;
+  /**
+    Digest MD5 of the current statement, for the sampling profiler.
+    Protected by @c m_stmt_lock.
+  */
+  unsigned char m_sample_digest[MD5_HASH_SIZE];
+  /**
+    True when @c m_sample_digest is set.
+    Protected by @c m_stmt_lock.
+  */
+  bool m_sample_has_digest;
 
   PFS_events_stages m_stage_current;
 
@@ -612,6 +623,13 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice
 
   PFS_events_transactions m_transaction_current;
 
+  /**
+    Digests aggregated locally, for EVENTS_STATEMENTS_SUMMARY_BY_DIGEST.
+    Indexed by the first byte of the digest MD5.
+    Only accessed by the thread itself.
+  */
+  PFS_digest_thread_cache m_digest_cache[DIGEST_THREAD_CACHE_SIZE];
+
   THD *m_thd;
   PFS_host *m_host;
   PFS_user *m_user;
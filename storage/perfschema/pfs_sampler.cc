@@ -0,0 +1,418 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file storage/perfschema/pfs_sampler.cc
+  Statement sampling profiler (implementation).
+*/
+
+#include "my_global.h"
+#include "my_sys.h"
+#include "my_thread.h"
+#include "thr_mutex.h"
+#include "thr_cond.h"
+#include "pfs_sampler.h"
+#include "pfs_instr.h"
+#include "pfs_instr_class.h"
+#include "pfs_global.h"
+#include "pfs_builtin_memory.h"
+#include "pfs_buffer_container.h"
+#include <string.h>
+
+ulong pfs_sampling_interval= 0;
+size_t sample_stack_max= 0;
+ulong sample_stack_lost= 0;
+
+/** EVENTS_SAMPLES_SUMMARY_BY_STACK hash table, open addressing. */
+PFS_sample_stack *sample_stack_array= NULL;
+
+static bool sampler_inited= false;
+static bool sampler_stop= false;
+/** True while the sampler thread runs, protected by @c LOCK_sampler. */
+static bool sampler_running= false;
+/** True when @c sampler_thread is a thread not joined yet. */
+static bool sampler_joinable= false;
+static my_thread_handle sampler_thread;
+/**
+  Protects @c sample_stack_array against concurrent writers.
+  The sampler thread holds it for a full sampling round,
+  TRUNCATE TABLE takes it to reset the stacks.
+  Readers of the table use the per record lock only.
+  Also protects the sampler thread state.
+*/
+static native_mutex_t LOCK_sampler;
+static native_cond_t COND_sampler;
+
+static uint32 sample_stack_hash(const unsigned char *digest,
+                                const PFS_stage_class *stage,
+                                const PFS_instr_class *wait)
+{
+  uint32 hash= 2166136261U;
+  uint i;
+
+  if (digest != NULL)
+  {
+    for (i= 0; i < MD5_HASH_SIZE; i++)
+      hash= (hash ^ digest[i]) * 16777619U;
+  }
+  hash= (hash ^ (uint32) ((intptr) stage >> 3)) * 16777619U;
+  hash= (hash ^ (uint32) ((intptr) wait >> 3)) * 16777619U;
+  return hash;
+}
+
+/**
+  Count one sample.
+  Only called by the sampler thread, with @c LOCK_sampler held,
+  so that a record never has two concurrent writers.
+*/
+static void add_sample(const unsigned char *digest,
+                       PFS_stage_class *stage,
+                       PFS_instr_class *wait)
+{
+  uint32 hash= sample_stack_hash(digest, stage, wait);
+  size_t index= hash % sample_stack_max;
+  size_t attempts;
+  PFS_sample_stack *pfs;
+  pfs_dirty_state dirty_state;
+
+  for (attempts= 0; attempts < sample_stack_max; attempts++)
+  {
+    pfs= & sample_stack_array[index];
+
+    if (pfs->m_lock.is_free())
+    {
+      if (pfs->m_lock.free_to_dirty(& dirty_state))
+      {
+        pfs->m_has_digest= (digest != NULL);
+        if (digest != NULL)
+          memcpy(pfs->m_digest, digest, MD5_HASH_SIZE);
+        pfs->m_stage= stage;
+        pfs->m_wait= wait;
+        pfs->m_hash= hash;
+        pfs->m_count= 1;
+        pfs->m_lock.dirty_to_allocated(& dirty_state);
+        return;
+      }
+    }
+    else if (pfs->m_hash == hash &&
+             pfs->m_stage == stage &&
+             pfs->m_wait == wait &&
+             pfs->m_has_digest == (digest != NULL) &&
+             (digest == NULL ||
+              memcmp(pfs->m_digest, digest, MD5_HASH_SIZE) == 0))
+    {
+      pfs->m_count++;
+      return;
+    }
+
+    if (++index == sample_stack_max)
+      index= 0;
+  }
+
+  sample_stack_lost++;
+}
+
+/**
+  Find the class of the innermost pending wait of a thread.
+  The wait stack is read without locks, as for EVENTS_WAITS_CURRENT,
+  so every class pointer found is sanitized.
+*/
+static PFS_instr_class *sample_current_wait(PFS_thread *pfs, bool *idle)
+{
+  PFS_events_waits *bottom= & pfs->m_events_waits_stack[WAIT_STACK_BOTTOM];
+  PFS_events_waits *safe_current= pfs->m_events_waits_current;
+  PFS_events_waits *wait;
+
+  *idle= false;
+
+  if (safe_current <= bottom ||
+      safe_current > & pfs->m_events_waits_stack[WAIT_STACK_SIZE])
+    return NULL;
+
+  wait= safe_current - 1;
+
+  switch (wait->m_wait_class)
+  {
+  case WAIT_CLASS_IDLE:
+    *idle= true;
+    return NULL;
+  case WAIT_CLASS_METADATA:
+    return sanitize_metadata_class(wait->m_class);
+  case WAIT_CLASS_MUTEX:
+    return sanitize_mutex_class((PFS_mutex_class*) wait->m_class);
+  case WAIT_CLASS_RWLOCK:
+    return sanitize_rwlock_class((PFS_rwlock_class*) wait->m_class);
+  case WAIT_CLASS_COND:
+    return sanitize_cond_class((PFS_cond_class*) wait->m_class);
+  case WAIT_CLASS_TABLE:
+    return sanitize_table_class(wait->m_class);
+  case WAIT_CLASS_FILE:
+    return sanitize_file_class((PFS_file_class*) wait->m_class);
+  case WAIT_CLASS_SOCKET:
+    return sanitize_socket_class((PFS_socket_class*) wait->m_class);
+  case NO_WAIT_CLASS:
+  default:
+    return NULL;
+  }
+}
+
+/**
+  Take one sample of every instrumented thread.
+  Called with @c LOCK_sampler held.
+*/
+static void sample_all_threads_locked()
+{
+  PFS_thread_iterator it= global_thread_container.iterate();
+  PFS_thread *pfs= it.scan_next();
+  pfs_optimistic_state lock;
+  unsigned char digest[MD5_HASH_SIZE];
+  bool has_digest;
+  bool idle;
+
+  while (pfs != NULL)
+  {
+    PFS_stage_class *stage= find_stage_class(pfs->m_stage);
+    PFS_instr_class *wait= sample_current_wait(pfs, & idle);
+
+    pfs->m_stmt_lock.begin_optimistic_lock(& lock);
+    has_digest= pfs->m_sample_has_digest;
+    if (has_digest)
+      memcpy(digest, pfs->m_sample_digest, MD5_HASH_SIZE);
+    if (! pfs->m_stmt_lock.end_optimistic_lock(& lock))
+      has_digest= false;
+
+    /* Idle sessions, and threads doing nothing instrumented, are not profiled. */
+    if (! idle && (has_digest || stage != NULL || wait != NULL))
+      add_sample(has_digest ? digest : NULL, stage, wait);
+
+    pfs= it.scan_next();
+  }
+}
+
+/** Take one sample of every instrumented thread, now. */
+void sample_all_threads()
+{
+  if (! sampler_inited)
+    return;
+
+  native_mutex_lock(& LOCK_sampler);
+  sample_all_threads_locked();
+  native_mutex_unlock(& LOCK_sampler);
+}
+
+/**
+  Sampler thread body.
+  The thread exits as soon as sampling is disabled,
+  @c pfs_sampling_interval_changed() starts a new one when it is enabled again.
+*/
+extern "C" void *sampler_thread_main(void *arg MY_ATTRIBUTE((unused)))
+{
+  struct timespec abstime;
+  ulong interval;
+
+  my_thread_init();
+
+  native_mutex_lock(& LOCK_sampler);
+  while (! sampler_stop && (interval= pfs_sampling_interval) != 0)
+  {
+    set_timespec_nsec(& abstime, interval * 1000000ULL);
+    native_cond_timedwait(& COND_sampler, & LOCK_sampler, & abstime);
+
+    if (! sampler_stop && pfs_sampling_interval != 0)
+      sample_all_threads_locked();
+  }
+  sampler_running= false;
+  native_mutex_unlock(& LOCK_sampler);
+
+  my_thread_end();
+  return NULL;
+}
+
+/**
+  Start the sampler thread.
+  Called with @c LOCK_sampler held, when the thread is not running.
+  @return 0 on success
+*/
+static int start_sampler_thread()
+{
+  my_thread_attr_t attr;
+  int rc;
+
+  /* A previous sampler thread saw sampling disabled, and is exiting. */
+  if (sampler_joinable)
+  {
+    my_thread_join(& sampler_thread, NULL);
+    sampler_joinable= false;
+  }
+
+  my_thread_attr_init(& attr);
+  rc= my_thread_create(& sampler_thread, & attr, sampler_thread_main, NULL);
+  my_thread_attr_destroy(& attr);
+
+  if (rc == 0)
+  {
+    sampler_running= true;
+    sampler_joinable= true;
+  }
+  return rc;
+}
+
+/**
+  Initialize table EVENTS_SAMPLES_SUMMARY_BY_STACK.
+  The sampler thread is only started when sampling is enabled.
+  @param param performance schema sizing
+*/
+int init_sampler(const PFS_global_param *param)
+{
+  int rc= 0;
+
+  sample_stack_max= param->m_sample_stack_sizing;
+  sample_stack_lost= 0;
+  sampler_stop= false;
+  sampler_running= false;
+  sampler_joinable= false;
+
+  if (sample_stack_max == 0)
+    return 0;
+
+  sample_stack_array=
+    PFS_MALLOC_ARRAY(& builtin_memory_sample_stacks,
+                     sample_stack_max,
+                     sizeof(PFS_sample_stack), PFS_sample_stack,
+                     MYF(MY_ZEROFILL));
+
+  if (unlikely(sample_stack_array == NULL))
+    return 1;
+
+  native_mutex_init(& LOCK_sampler, NULL);
+  native_cond_init(& COND_sampler);
+  sampler_inited= true;
+
+  if (pfs_sampling_interval != 0)
+  {
+    native_mutex_lock(& LOCK_sampler);
+    rc= start_sampler_thread();
+    native_mutex_unlock(& LOCK_sampler);
+  }
+
+  if (rc != 0)
+  {
+    cleanup_sampler();
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  Start or stop sampling after a change of @c pfs_sampling_interval.
+  A running sampler thread picks up the new interval, or exits.
+*/
+void pfs_sampling_interval_changed()
+{
+  if (! sampler_inited)
+    return;
+
+  native_mutex_lock(& LOCK_sampler);
+  if (sampler_running)
+    native_cond_signal(& COND_sampler);
+  else if (pfs_sampling_interval != 0 && start_sampler_thread() != 0)
+    pfs_print_error("Failed to start the performance schema sampler thread\n");
+  native_mutex_unlock(& LOCK_sampler);
+}
+
+bool is_sampler_running()
+{
+  bool running;
+
+  if (! sampler_inited)
+    return false;
+
+  native_mutex_lock(& LOCK_sampler);
+  running= sampler_running;
+  native_mutex_unlock(& LOCK_sampler);
+  return running;
+}
+
+/** Stop the sampler thread, and cleanup table EVENTS_SAMPLES_SUMMARY_BY_STACK. */
+void cleanup_sampler(void)
+{
+  if (sampler_inited)
+  {
+    native_mutex_lock(& LOCK_sampler);
+    sampler_stop= true;
+    native_cond_signal(& COND_sampler);
+    native_mutex_unlock(& LOCK_sampler);
+
+    if (sampler_joinable)
+    {
+      my_thread_join(& sampler_thread, NULL);
+      sampler_joinable= false;
+    }
+
+    native_cond_destroy(& COND_sampler);
+    native_mutex_destroy(& LOCK_sampler);
+    sampler_inited= false;
+  }
+
+  PFS_FREE_ARRAY(& builtin_memory_sample_stacks,
+                 sample_stack_max,
+                 sizeof(PFS_sample_stack),
+                 sample_stack_array);
+  sample_stack_array= NULL;
+}
+
+/** Reset table EVENTS_SAMPLES_SUMMARY_BY_STACK. */
+void reset_sample_stacks(void)
+{
+  if (! sampler_inited)
+    return;
+
+  native_mutex_lock(& LOCK_sampler);
+  for (size_t index= 0; index < sample_stack_max; index++)
+  {
+    PFS_sample_stack *pfs= & sample_stack_array[index];
+    if (pfs->m_lock.is_populated())
+      pfs->m_lock.allocated_to_free();
+  }
+  sample_stack_lost= 0;
+  native_mutex_unlock(& LOCK_sampler);
+}
+
+/**
+  Publish the digest of the statement a thread is executing,
+  for the sampler thread to pick up.
+  Only done when sampling is enabled, to keep the MD5 computation
+  out of the statement path otherwise.
+*/
+void sampler_set_digest(PFS_thread *thread, const sql_digest_storage *digest)
+{
+  pfs_dirty_state dirty_state;
+
+  thread->m_stmt_lock.allocated_to_dirty(& dirty_state);
+  compute_digest_md5(digest, thread->m_sample_digest);
+  thread->m_sample_has_digest= true;
+  thread->m_stmt_lock.dirty_to_allocated(& dirty_state);
+}
+
+void sampler_clear_digest(PFS_thread *thread)
+{
+  pfs_dirty_state dirty_state;
+
+  thread->m_stmt_lock.allocated_to_dirty(& dirty_state);
+  thread->m_sample_has_digest= false;
+  thread->m_stmt_lock.dirty_to_allocated(& dirty_state);
+}
+
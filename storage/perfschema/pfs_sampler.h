@@ -0,0 +1,82 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef PFS_SAMPLER_H
+#define PFS_SAMPLER_H
+
+/**
+  @file storage/perfschema/pfs_sampler.h
+  Statement sampling profiler (declarations).
+
+  While sampling is enabled,
+  a background thread wakes up every @c pfs_sampling_interval milliseconds
+  and records, for every instrumented thread, what it is doing right now:
+  the statement digest, the current stage and the innermost pending wait.
+  Identical (digest, stage, wait) stacks are counted in a fixed size table,
+  exposed as EVENTS_SAMPLES_SUMMARY_BY_STACK.
+  @sa pfs_sampling_interval
+
+  Instrumented threads never write to the sample table,
+  so the cost of the profiler is paid by the sampler thread only,
+  and is bounded by the sampling interval.
+*/
+
+#include "pfs_global.h"
+#include "pfs_lock.h"
+#include "pfs_server.h"
+#include "sql_digest.h"
+
+struct PFS_global_param;
+struct PFS_thread;
+struct PFS_stage_class;
+struct PFS_instr_class;
+
+extern size_t sample_stack_max;
+extern ulong sample_stack_lost;
+
+/** One aggregated sample stack: (digest, stage, wait). */
+struct PFS_ALIGNED PFS_sample_stack
+{
+  /** Internal lock. */
+  pfs_lock m_lock;
+  /** Statement digest MD5, when @c m_has_digest is true. */
+  unsigned char m_digest[MD5_HASH_SIZE];
+  /** True when the sampled thread was executing a digested statement. */
+  bool m_has_digest;
+  /** Stage of the sampled thread, or NULL. */
+  PFS_stage_class *m_stage;
+  /** Innermost pending wait of the sampled thread, or NULL. */
+  PFS_instr_class *m_wait;
+  /** Hash of the stack, used for probing. */
+  uint32 m_hash;
+  /** Number of samples that hit this stack. */
+  ulonglong m_count;
+};
+
+int init_sampler(const PFS_global_param *param);
+void cleanup_sampler();
+void reset_sample_stacks();
+void sample_all_threads();
+bool is_sampler_running();
+
+void sampler_set_digest(PFS_thread *thread, const sql_digest_storage *digest);
+void sampler_clear_digest(PFS_thread *thread);
+
+/* Exposing the data directly, for iterators. */
+extern PFS_sample_stack *sample_stack_array;
+
+#endif
+
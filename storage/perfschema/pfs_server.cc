@@ -49,6 +49,7 @@
 #include "pfs_program.h"
 #include "template_utils.h"
 #include "pfs_prepared_stmt.h"
+#include "pfs_sampler.h"
 
 PFS_global_param pfs_param;
 
@@ -149,7 +150,8 @@ initialize_performance_schema(PFS_global_param *param)
       init_digest_hash(param) ||
       init_program(param) ||
       init_program_hash(param) ||
-      init_prepared_stmt(param))
+      init_prepared_stmt(param) ||
+      init_sampler(param))
   {
     /*
       The performance schema initialization failed.
@@ -229,6 +231,12 @@ static void destroy_pfs_thread(void *key)
 
 static void cleanup_performance_schema(void)
 {
+  /*
+    The sampler thread reads every other buffer.
+  */
+
+  cleanup_sampler();
+
   /*
     my.cnf options
   */
@@ -246,6 +246,12 @@ struct PFS_global_param
   long m_max_digest_length;
   ulong m_max_sql_text_length;
 
+  /**
+    Maximum number of rows in table EVENTS_SAMPLES_SUMMARY_BY_STACK.
+    @sa sample_stack_lost.
+  */
+  ulong m_sample_stack_sizing;
+
   /** Sizing hints, for auto tuning. */
   PFS_sizing_hints m_hints;
 };
@@ -256,6 +262,16 @@ struct PFS_global_param
 */
 extern PFS_global_param pfs_param;
 
+/**
+  Statement sampling interval, in milliseconds.
+  0 disables the sampling profiler.
+  @sa table_samples_by_stack
+*/
+extern ulong pfs_sampling_interval;
+
+/** Start or stop the sampler thread, after @c pfs_sampling_interval changed. */
+void pfs_sampling_interval_changed();
+
 /**
   Null initialization.
   Disable all instrumentation, size all internal buffers to 0.
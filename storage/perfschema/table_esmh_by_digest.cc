@@ -0,0 +1,300 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file storage/perfschema/table_esmh_by_digest.cc
+  Table EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST (implementation).
+*/
+
+#include "my_global.h"
+#include "my_thread.h"
+#include "pfs_instr_class.h"
+#include "pfs_column_types.h"
+#include "pfs_column_values.h"
+#include "table_esmh_by_digest.h"
+#include "pfs_global.h"
+#include "pfs_instr.h"
+#include "pfs_digest.h"
+#include "field.h"
+
+THR_LOCK table_esmh_by_digest::m_table_lock;
+
+static const TABLE_FIELD_TYPE field_types[]=
+{
+  {
+    { C_STRING_WITH_LEN("SCHEMA_NAME") },
+    { C_STRING_WITH_LEN("varchar(64)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("DIGEST") },
+    { C_STRING_WITH_LEN("varchar(32)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("BUCKET_NUMBER") },
+    { C_STRING_WITH_LEN("int(10)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("BUCKET_TIMER_LOW") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("BUCKET_TIMER_HIGH") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("COUNT_BUCKET") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("COUNT_BUCKET_AND_LOWER") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("BUCKET_QUANTILE") },
+    { C_STRING_WITH_LEN("double(7,6)") },
+    { NULL, 0}
+  }
+};
+
+TABLE_FIELD_DEF
+table_esmh_by_digest::m_field_def=
+{ 8, field_types };
+
+PFS_engine_table_share_state
+table_esmh_by_digest::m_share_state = {
+  false /* m_checked */
+};
+
+PFS_engine_table_share
+table_esmh_by_digest::m_share=
+{
+  { C_STRING_WITH_LEN("events_statements_histogram_by_digest") },
+  &pfs_truncatable_acl,
+  table_esmh_by_digest::create,
+  NULL, /* write_row */
+  table_esmh_by_digest::delete_all_rows,
+  table_esmh_by_digest::get_row_count,
+  sizeof(pos_esmh_by_digest),
+  &m_table_lock,
+  &m_field_def,
+  false, /* m_perpetual */
+  false, /* m_optional */
+  &m_share_state
+};
+
+PFS_engine_table*
+table_esmh_by_digest::create(void)
+{
+  /* Show the statements this session aggregated locally. */
+  PFS_thread *thread= PFS_thread::get_current_thread();
+  if (thread != NULL)
+    flush_digest_thread_cache(thread, false);
+  return new table_esmh_by_digest();
+}
+
+int
+table_esmh_by_digest::delete_all_rows(void)
+{
+  reset_histogram_by_digest();
+  return 0;
+}
+
+ha_rows
+table_esmh_by_digest::get_row_count(void)
+{
+  return digest_max * DIGEST_HISTOGRAM_BUCKETS;
+}
+
+table_esmh_by_digest::table_esmh_by_digest()
+  : PFS_engine_table(&m_share, &m_pos),
+    m_row_exists(false), m_pos(), m_next_pos()
+{}
+
+void table_esmh_by_digest::reset_position(void)
+{
+  m_pos.reset();
+  m_next_pos.reset();
+}
+
+int table_esmh_by_digest::rnd_next(void)
+{
+  PFS_statements_digest_stat* digest_stat;
+
+  if (statements_digest_stat_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  for (m_pos.set_at(&m_next_pos);
+       m_pos.m_index_1 < digest_max;
+       m_pos.next_digest())
+  {
+    digest_stat= &statements_digest_stat_array[m_pos.m_index_1];
+    if (digest_stat->m_lock.is_populated() &&
+        digest_stat->m_first_seen != 0 &&
+        m_pos.m_index_2 < DIGEST_HISTOGRAM_BUCKETS)
+    {
+      make_row(digest_stat, m_pos.m_index_2);
+      m_next_pos.set_after(&m_pos);
+      return 0;
+    }
+  }
+
+  return HA_ERR_END_OF_FILE;
+}
+
+int
+table_esmh_by_digest::rnd_pos(const void *pos)
+{
+  PFS_statements_digest_stat* digest_stat;
+
+  if (statements_digest_stat_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  set_position(pos);
+
+  if (m_pos.m_index_1 >= digest_max ||
+      m_pos.m_index_2 >= DIGEST_HISTOGRAM_BUCKETS)
+    return HA_ERR_RECORD_DELETED;
+
+  digest_stat= &statements_digest_stat_array[m_pos.m_index_1];
+
+  if (digest_stat->m_lock.is_populated())
+  {
+    if (digest_stat->m_first_seen != 0)
+    {
+      make_row(digest_stat, m_pos.m_index_2);
+      return 0;
+    }
+  }
+
+  return HA_ERR_RECORD_DELETED;
+}
+
+void table_esmh_by_digest::make_row(PFS_statements_digest_stat *digest_stat,
+                                    uint bucket)
+{
+  pfs_optimistic_state lock;
+  ulonglong count_bucket_and_lower= 0;
+  ulonglong count_star= 0;
+  ulonglong count;
+
+  m_row_exists= false;
+
+  digest_stat->m_lock.begin_optimistic_lock(&lock);
+
+  m_row.m_schema_name_length= digest_stat->m_digest_key.m_schema_name_length;
+  if (m_row.m_schema_name_length > sizeof(m_row.m_schema_name))
+    m_row.m_schema_name_length= 0;
+  if (m_row.m_schema_name_length > 0)
+    memcpy(m_row.m_schema_name, digest_stat->m_digest_key.m_schema_name,
+           m_row.m_schema_name_length);
+
+  /* Record [0] aggregates lost digests, and has no DIGEST. */
+  if (digest_stat->m_digest_storage.m_byte_count > 0)
+  {
+    MD5_HASH_TO_STRING(digest_stat->m_digest_key.m_md5, m_row.m_digest);
+    m_row.m_digest_length= MD5_HASH_TO_STRING_LENGTH;
+  }
+  else
+    m_row.m_digest_length= 0;
+
+  for (uint i= 0; i < DIGEST_HISTOGRAM_BUCKETS; i++)
+  {
+    count= digest_stat->m_histogram.m_count[i];
+    count_star+= count;
+    if (i <= bucket)
+      count_bucket_and_lower+= count;
+    if (i == bucket)
+      m_row.m_count_bucket= count;
+  }
+
+  if (! digest_stat->m_lock.end_optimistic_lock(&lock))
+    return;
+
+  m_row.m_bucket_number= bucket;
+  m_row.m_bucket_timer_low= PFS_digest_histogram::bucket_low(bucket);
+  m_row.m_bucket_timer_high= PFS_digest_histogram::bucket_high(bucket);
+  m_row.m_count_bucket_and_lower= count_bucket_and_lower;
+  m_row.m_bucket_quantile= (count_star == 0) ? 0.0 :
+    ((double) count_bucket_and_lower) / count_star;
+
+  m_row_exists= true;
+}
+
+int table_esmh_by_digest
+::read_row_values(TABLE *table, unsigned char *buf, Field **fields,
+                  bool read_all)
+{
+  Field *f;
+
+  if (unlikely(! m_row_exists))
+    return HA_ERR_RECORD_DELETED;
+
+  /* Set the null bits */
+  assert(table->s->null_bytes == 1);
+  buf[0]= 0;
+
+  for (; (f= *fields) ; fields++)
+  {
+    if (read_all || bitmap_is_set(table->read_set, f->field_index))
+    {
+      switch(f->field_index)
+      {
+      case 0: /* SCHEMA_NAME */
+        if (m_row.m_schema_name_length > 0)
+          set_field_varchar_utf8(f, m_row.m_schema_name,
+                                 m_row.m_schema_name_length);
+        else
+          f->set_null();
+        break;
+      case 1: /* DIGEST */
+        if (m_row.m_digest_length > 0)
+          set_field_varchar_utf8(f, m_row.m_digest, m_row.m_digest_length);
+        else
+          f->set_null();
+        break;
+      case 2: /* BUCKET_NUMBER */
+        set_field_ulong(f, m_row.m_bucket_number);
+        break;
+      case 3: /* BUCKET_TIMER_LOW */
+        set_field_ulonglong(f, m_row.m_bucket_timer_low);
+        break;
+      case 4: /* BUCKET_TIMER_HIGH */
+        set_field_ulonglong(f, m_row.m_bucket_timer_high);
+        break;
+      case 5: /* COUNT_BUCKET */
+        set_field_ulonglong(f, m_row.m_count_bucket);
+        break;
+      case 6: /* COUNT_BUCKET_AND_LOWER */
+        set_field_ulonglong(f, m_row.m_count_bucket_and_lower);
+        break;
+      case 7: /* BUCKET_QUANTILE */
+        set_field_double(f, m_row.m_bucket_quantile);
+        break;
+      default:
+        assert(false);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef TABLE_ESMH_BY_DIGEST_H
+#define TABLE_ESMH_BY_DIGEST_H
+
+/**
+  @file storage/perfschema/table_esmh_by_digest.h
+  Table EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST (declarations).
+*/
+
+#include "table_helper.h"
+#include "pfs_digest.h"
+
+/**
+  @addtogroup Performance_schema_tables
+  @{
+*/
+
+/**
+  A row of table
+  PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST.
+*/
+struct row_esmh_by_digest
+{
+  /** Column SCHEMA_NAME. */
+  char m_schema_name[NAME_LEN];
+  /** Length in bytes of @c m_schema_name. */
+  uint m_schema_name_length;
+  /** Column DIGEST. */
+  char m_digest[COL_DIGEST_SIZE];
+  /** Length in bytes of @c m_digest. */
+  uint m_digest_length;
+  /** Column BUCKET_NUMBER. */
+  ulong m_bucket_number;
+  /** Column BUCKET_TIMER_LOW. */
+  ulonglong m_bucket_timer_low;
+  /** Column BUCKET_TIMER_HIGH. */
+  ulonglong m_bucket_timer_high;
+  /** Column COUNT_BUCKET. */
+  ulonglong m_count_bucket;
+  /** Column COUNT_BUCKET_AND_LOWER. */
+  ulonglong m_count_bucket_and_lower;
+  /** Column BUCKET_QUANTILE. */
+  double m_bucket_quantile;
+};
+
+/** Position of a cursor on PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST. */
+struct pos_esmh_by_digest : public PFS_double_index
+{
+  pos_esmh_by_digest()
+    : PFS_double_index(0, 0)
+  {}
+
+  inline void reset(void)
+  {
+    m_index_1= 0;
+    m_index_2= 0;
+  }
+
+  inline void next_digest(void)
+  {
+    m_index_1++;
+    m_index_2= 0;
+  }
+};
+
+/** Table PERFORMANCE_SCHEMA.EVENTS_STATEMENTS_HISTOGRAM_BY_DIGEST. */
+class table_esmh_by_digest : public PFS_engine_table
+{
+public:
+  static PFS_engine_table_share_state m_share_state;
+  /** Table share */
+  static PFS_engine_table_share m_share;
+  static PFS_engine_table* create();
+  static int delete_all_rows();
+  static ha_rows get_row_count();
+
+  virtual int rnd_next();
+  virtual int rnd_pos(const void *pos);
+  virtual void reset_position(void);
+
+protected:
+  virtual int read_row_values(TABLE *table,
+                              unsigned char *buf,
+                              Field **fields,
+                              bool read_all);
+
+  table_esmh_by_digest();
+
+public:
+  ~table_esmh_by_digest()
+  {}
+
+protected:
+  void make_row(PFS_statements_digest_stat *digest_stat, uint bucket);
+
+private:
+  /** Table share lock. */
+  static THR_LOCK m_table_lock;
+  /** Fields definition. */
+  static TABLE_FIELD_DEF m_field_def;
+
+  /** Current row. */
+  row_esmh_by_digest m_row;
+  /** True is the current row exists. */
+  bool m_row_exists;
+  /** Current position. */
+  pos_esmh_by_digest m_pos;
+  /** Next position. */
+  pos_esmh_by_digest m_next_pos;
+};
+
+/** @} */
+#endif
@@ -219,6 +219,10 @@ table_esms_by_digest::m_share=
 PFS_engine_table*
 table_esms_by_digest::create(void)
 {
+  /* Show the statements this session aggregated locally. */
+  PFS_thread *thread= PFS_thread::get_current_thread();
+  if (thread != NULL)
+    flush_digest_thread_cache(thread, false);
   return new table_esms_by_digest();
 }
 
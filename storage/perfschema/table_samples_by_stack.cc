@@ -0,0 +1,268 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file storage/perfschema/table_samples_by_stack.cc
+  Table EVENTS_SAMPLES_SUMMARY_BY_STACK (implementation).
+*/
+
+#include "my_global.h"
+#include "my_thread.h"
+#include "pfs_instr_class.h"
+#include "pfs_column_types.h"
+#include "pfs_column_values.h"
+#include "table_samples_by_stack.h"
+#include "pfs_global.h"
+#include "pfs_sampler.h"
+#include "field.h"
+
+THR_LOCK table_samples_by_stack::m_table_lock;
+
+static const TABLE_FIELD_TYPE field_types[]=
+{
+  {
+    { C_STRING_WITH_LEN("DIGEST") },
+    { C_STRING_WITH_LEN("varchar(32)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("STAGE_NAME") },
+    { C_STRING_WITH_LEN("varchar(128)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("WAIT_NAME") },
+    { C_STRING_WITH_LEN("varchar(128)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("STACK") },
+    { C_STRING_WITH_LEN("varchar(512)") },
+    { NULL, 0}
+  },
+  {
+    { C_STRING_WITH_LEN("COUNT_STAR") },
+    { C_STRING_WITH_LEN("bigint(20)") },
+    { NULL, 0}
+  }
+};
+
+TABLE_FIELD_DEF
+table_samples_by_stack::m_field_def=
+{ 5, field_types };
+
+PFS_engine_table_share_state
+table_samples_by_stack::m_share_state = {
+  false /* m_checked */
+};
+
+PFS_engine_table_share
+table_samples_by_stack::m_share=
+{
+  { C_STRING_WITH_LEN("events_samples_summary_by_stack") },
+  &pfs_truncatable_acl,
+  table_samples_by_stack::create,
+  NULL, /* write_row */
+  table_samples_by_stack::delete_all_rows,
+  table_samples_by_stack::get_row_count,
+  sizeof(PFS_simple_index),
+  &m_table_lock,
+  &m_field_def,
+  false, /* m_perpetual */
+  false, /* m_optional */
+  &m_share_state
+};
+
+PFS_engine_table*
+table_samples_by_stack::create(void)
+{
+  return new table_samples_by_stack();
+}
+
+int
+table_samples_by_stack::delete_all_rows(void)
+{
+  reset_sample_stacks();
+  return 0;
+}
+
+ha_rows
+table_samples_by_stack::get_row_count(void)
+{
+  return sample_stack_max;
+}
+
+table_samples_by_stack::table_samples_by_stack()
+  : PFS_engine_table(&m_share, &m_pos),
+    m_row_exists(false), m_pos(0), m_next_pos(0)
+{}
+
+void table_samples_by_stack::reset_position(void)
+{
+  m_pos= 0;
+  m_next_pos= 0;
+}
+
+int table_samples_by_stack::rnd_next(void)
+{
+  PFS_sample_stack *pfs;
+
+  if (sample_stack_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  for (m_pos.set_at(&m_next_pos);
+       m_pos.m_index < sample_stack_max;
+       m_pos.next())
+  {
+    pfs= &sample_stack_array[m_pos.m_index];
+    if (pfs->m_lock.is_populated())
+    {
+      make_row(pfs);
+      m_next_pos.set_after(&m_pos);
+      return 0;
+    }
+  }
+
+  return HA_ERR_END_OF_FILE;
+}
+
+int
+table_samples_by_stack::rnd_pos(const void *pos)
+{
+  PFS_sample_stack *pfs;
+
+  if (sample_stack_array == NULL)
+    return HA_ERR_END_OF_FILE;
+
+  set_position(pos);
+  pfs= &sample_stack_array[m_pos.m_index];
+
+  if (pfs->m_lock.is_populated())
+  {
+    make_row(pfs);
+    return 0;
+  }
+
+  return HA_ERR_RECORD_DELETED;
+}
+
+void table_samples_by_stack::make_row(PFS_sample_stack *pfs)
+{
+  pfs_optimistic_state lock;
+  PFS_stage_class *stage;
+  PFS_instr_class *wait;
+  char *stack= m_row.m_stack;
+
+  m_row_exists= false;
+
+  pfs->m_lock.begin_optimistic_lock(&lock);
+
+  if (pfs->m_has_digest)
+  {
+    MD5_HASH_TO_STRING(pfs->m_digest, m_row.m_digest);
+    m_row.m_digest_length= MD5_HASH_TO_STRING_LENGTH;
+  }
+  else
+    m_row.m_digest_length= 0;
+
+  stage= pfs->m_stage;
+  wait= pfs->m_wait;
+  m_row.m_count= pfs->m_count;
+
+  if (! pfs->m_lock.end_optimistic_lock(&lock))
+    return;
+
+  /* Class names are immutable once a class is registered. */
+  m_row.m_stage_name= (stage != NULL) ? stage->m_name : NULL;
+  m_row.m_stage_name_length= (stage != NULL) ? stage->m_name_length : 0;
+  m_row.m_wait_name= (wait != NULL) ? wait->m_name : NULL;
+  m_row.m_wait_name_length= (wait != NULL) ? wait->m_name_length : 0;
+
+  /* Missing frames are skipped, the stack always starts at the root. */
+  compile_time_assert(COL_SAMPLE_STACK_SIZE >
+                      MD5_HASH_TO_STRING_LENGTH + 2 * PFS_MAX_INFO_NAME_LENGTH);
+  if (m_row.m_digest_length != 0)
+    stack= strmake(stack, m_row.m_digest, m_row.m_digest_length);
+  if (m_row.m_stage_name_length != 0)
+  {
+    if (stack != m_row.m_stack)
+      *stack++= ';';
+    stack= strmake(stack, m_row.m_stage_name, m_row.m_stage_name_length);
+  }
+  if (m_row.m_wait_name_length != 0)
+  {
+    if (stack != m_row.m_stack)
+      *stack++= ';';
+    stack= strmake(stack, m_row.m_wait_name, m_row.m_wait_name_length);
+  }
+  m_row.m_stack_length= (uint) (stack - m_row.m_stack);
+
+  m_row_exists= true;
+}
+
+int table_samples_by_stack
+::read_row_values(TABLE *table, unsigned char *buf, Field **fields,
+                  bool read_all)
+{
+  Field *f;
+
+  if (unlikely(! m_row_exists))
+    return HA_ERR_RECORD_DELETED;
+
+  /* Set the null bits */
+  assert(table->s->null_bytes == 1);
+  buf[0]= 0;
+
+  for (; (f= *fields) ; fields++)
+  {
+    if (read_all || bitmap_is_set(table->read_set, f->field_index))
+    {
+      switch(f->field_index)
+      {
+      case 0: /* DIGEST */
+        if (m_row.m_digest_length > 0)
+          set_field_varchar_utf8(f, m_row.m_digest, m_row.m_digest_length);
+        else
+          f->set_null();
+        break;
+      case 1: /* STAGE_NAME */
+        if (m_row.m_stage_name_length > 0)
+          set_field_varchar_utf8(f, m_row.m_stage_name,
+                                 m_row.m_stage_name_length);
+        else
+          f->set_null();
+        break;
+      case 2: /* WAIT_NAME */
+        if (m_row.m_wait_name_length > 0)
+          set_field_varchar_utf8(f, m_row.m_wait_name,
+                                 m_row.m_wait_name_length);
+        else
+          f->set_null();
+        break;
+      case 3: /* STACK */
+        set_field_varchar_utf8(f, m_row.m_stack, m_row.m_stack_length);
+        break;
+      case 4: /* COUNT_STAR */
+        set_field_ulonglong(f, m_row.m_count);
+        break;
+      default:
+        assert(false);
+      }
+    }
+  }
+
+  return 0;
+}
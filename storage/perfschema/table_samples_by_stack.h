@@ -0,0 +1,113 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#ifndef TABLE_SAMPLES_BY_STACK_H
+#define TABLE_SAMPLES_BY_STACK_H
+
+/**
+  @file storage/perfschema/table_samples_by_stack.h
+  Table EVENTS_SAMPLES_SUMMARY_BY_STACK (declarations).
+*/
+
+#include "table_helper.h"
+#include "pfs_sampler.h"
+
+/**
+  @addtogroup Performance_schema_tables
+  @{
+*/
+
+/** Size of column STACK. */
+#define COL_SAMPLE_STACK_SIZE 512
+
+/**
+  A row of table
+  PERFORMANCE_SCHEMA.EVENTS_SAMPLES_SUMMARY_BY_STACK.
+*/
+struct row_samples_by_stack
+{
+  /** Column DIGEST. */
+  char m_digest[COL_DIGEST_SIZE];
+  /** Length in bytes of @c m_digest, 0 for NULL. */
+  uint m_digest_length;
+  /** Column STAGE_NAME. */
+  const char *m_stage_name;
+  /** Length in bytes of @c m_stage_name, 0 for NULL. */
+  uint m_stage_name_length;
+  /** Column WAIT_NAME. */
+  const char *m_wait_name;
+  /** Length in bytes of @c m_wait_name, 0 for NULL. */
+  uint m_wait_name_length;
+  /**
+    Column STACK.
+    The folded "digest;stage;wait" frames, as consumed by flamegraph tools.
+  */
+  char m_stack[COL_SAMPLE_STACK_SIZE];
+  /** Length in bytes of @c m_stack. */
+  uint m_stack_length;
+  /** Column COUNT_STAR. */
+  ulonglong m_count;
+};
+
+/** Table PERFORMANCE_SCHEMA.EVENTS_SAMPLES_SUMMARY_BY_STACK. */
+class table_samples_by_stack : public PFS_engine_table
+{
+public:
+  static PFS_engine_table_share_state m_share_state;
+  /** Table share */
+  static PFS_engine_table_share m_share;
+  static PFS_engine_table* create();
+  static int delete_all_rows();
+  static ha_rows get_row_count();
+
+  virtual int rnd_next();
+  virtual int rnd_pos(const void *pos);
+  virtual void reset_position(void);
+
+protected:
+  virtual int read_row_values(TABLE *table,
+                              unsigned char *buf,
+                              Field **fields,
+                              bool read_all);
+
+  table_samples_by_stack();
+
+public:
+  ~table_samples_by_stack()
+  {}
+
+protected:
+  void make_row(PFS_sample_stack *pfs);
+
+  /** Current row. */
+  row_samples_by_stack m_row;
+  /** True is the current row exists. */
+  bool m_row_exists;
+
+private:
+  /** Table share lock. */
+  static THR_LOCK m_table_lock;
+  /** Fields definition. */
+  static TABLE_FIELD_DEF m_field_def;
+
+  /** Current position. */
+  PFS_simple_index m_pos;
+  /** Next position. */
+  PFS_simple_index m_next_pos;
+};
+
+/** @} */
+#endif
@@ -128,6 +128,7 @@ void test_bootstrap()
   param.m_metadata_lock_sizing= 0;
   param.m_max_digest_length= 0;
   param.m_max_sql_text_length= 0;
+  param.m_sample_stack_sizing= 0;
 
   param.m_hints.m_table_definition_cache = 100;
   param.m_hints.m_table_open_cache       = 100;
@@ -201,6 +202,7 @@ PSI * load_perfschema()
   param.m_metadata_lock_sizing= 10;
   param.m_max_digest_length= 0;
   param.m_max_sql_text_length= 1000;
+  param.m_sample_stack_sizing= 0;
 
   param.m_hints.m_table_definition_cache = 100;
   param.m_hints.m_table_open_cache       = 100;
@@ -1596,6 +1598,7 @@ void test_event_name_index()
   param.m_metadata_lock_sizing= 10;
   param.m_max_digest_length= 0;
   param.m_max_sql_text_length= 1000;
+  param.m_sample_stack_sizing= 0;
 
   param.m_mutex_sizing= 0;
   param.m_rwlock_sizing= 0;
@@ -1845,6 +1848,7 @@ void test_leaks()
   param.m_statement_stack_sizing= 10;
   param.m_max_digest_length= 1000;
   param.m_max_sql_text_length= 1000;
+  param.m_sample_stack_sizing= 0;
 
   param.m_hints.m_table_definition_cache = 100;
   param.m_hints.m_table_open_cache       = 100;
@@ -27,6 +27,8 @@
 #include <pfs_global.h>
 #include <pfs_instr_class.h>
 #include <pfs_buffer_container.h>
+#include <pfs_digest.h>
+#include <pfs.h>
 #include <tap.h>
 
 #include "stub_global_status_var.h"
@@ -80,14 +82,213 @@ void test_digest_length_overflow()
   ok(rc == 1, "digest length overflow (init_digest)");
 }
 
+void test_digest_histogram()
+{
+  const ulonglong base= 1ULL << DIGEST_HISTOGRAM_BASE_BITS;
+  PFS_digest_histogram histogram;
+  PFS_digest_histogram other;
+  bool bounds_ok= true;
+
+  ok(PFS_digest_histogram::bucket_index(0) == 0, "bucket of 0");
+  ok(PFS_digest_histogram::bucket_index(base - 1) == 0, "bucket below base");
+  ok(PFS_digest_histogram::bucket_index(base) == 1, "bucket of base");
+  ok(PFS_digest_histogram::bucket_index(2 * base - 1) == 1, "bucket below 2 * base");
+  ok(PFS_digest_histogram::bucket_index(2 * base) == 2, "bucket of 2 * base");
+  ok(PFS_digest_histogram::bucket_index(ULLONG_MAX) == DIGEST_HISTOGRAM_BUCKETS - 1,
+     "last bucket is open ended");
+
+  for (uint i= 0; i < DIGEST_HISTOGRAM_BUCKETS; i++)
+  {
+    ulonglong low= PFS_digest_histogram::bucket_low(i);
+    ulonglong high= PFS_digest_histogram::bucket_high(i);
+
+    if (PFS_digest_histogram::bucket_index(low) != i ||
+        PFS_digest_histogram::bucket_index(high - 1) != i)
+      bounds_ok= false;
+    if (i > 0 && low != PFS_digest_histogram::bucket_high(i - 1))
+      bounds_ok= false;
+  }
+  ok(bounds_ok, "bucket bounds are contiguous");
+
+  histogram.reset();
+  other.reset();
+  histogram.aggregate_value(10);
+  histogram.aggregate_value(base);
+  other.aggregate_value(base + 1);
+  histogram.aggregate(& other);
+  ok(histogram.m_count[0] == 1 && histogram.m_count[1] == 2,
+     "histogram aggregate");
+}
+
+/*
+  Not a test, helper for test_digest_thread_cache():
+  end a statement, as pfs_end_statement_v1() does.
+  The MD5 of digests is not computed by the unit tests,
+  digests only differ by schema, and share the same thread cache entry.
+*/
+void end_statement(PFS_thread *thread, const char *schema)
+{
+  unsigned char tokens[16];
+  sql_digest_storage digest;
+  PFS_digest_histogram *histogram;
+  PFS_statement_stat *stat;
+
+  memset(tokens, 1, sizeof(tokens));
+  digest.reset(tokens, sizeof(tokens));
+  digest.m_byte_count= 4;
+
+  stat= find_or_create_digest(thread, & digest, schema, (uint) strlen(schema),
+                              & histogram);
+  if (stat != NULL)
+  {
+    stat->aggregate_value(1000);
+    histogram->aggregate_value(1000);
+  }
+}
+
+/*
+  Not a test, helper for test_digest_thread_cache():
+  the shared EVENTS_STATEMENTS_SUMMARY_BY_DIGEST record of a schema.
+*/
+PFS_statements_digest_stat *find_digest_row(const char *schema)
+{
+  for (size_t index= 1; index < digest_max; index++)
+  {
+    PFS_statements_digest_stat *pfs= & statements_digest_stat_array[index];
+    if (pfs->m_lock.is_populated() &&
+        pfs->m_digest_key.m_schema_name_length == strlen(schema) &&
+        memcmp(pfs->m_digest_key.m_schema_name, schema, strlen(schema)) == 0)
+      return pfs;
+  }
+  return NULL;
+}
+
+ulonglong digest_row_count(const char *schema)
+{
+  PFS_statements_digest_stat *pfs= find_digest_row(schema);
+  return (pfs != NULL) ? pfs->m_stat.m_timer1_stat.m_count : 0;
+}
+
+void init_fake_thread(PFS_thread *thread)
+{
+  thread->m_digest_hash_pins= NULL;
+  for (uint i= 0; i < DIGEST_THREAD_CACHE_SIZE; i++)
+    thread->m_digest_cache[i].m_digest_stat= NULL;
+}
+
+void test_digest_thread_cache()
+{
+  PFS_global_param param;
+  PFS_thread thread_1;
+  PFS_thread thread_2;
+  PFS_digest_thread_cache *entry;
+  int i;
+
+  memset(& param, 0, sizeof(param));
+  param.m_enabled= true;
+  param.m_digest_sizing= 10;
+  param.m_max_digest_length= 16;
+  pfs_max_digest_length= param.m_max_digest_length;
+  pfs_max_sqltext= 0;
+
+  ok(init_digest(& param) == 0, "init_digest");
+  init_digest_hash(& param);
+  init_fake_thread(& thread_1);
+  init_fake_thread(& thread_2);
+
+  /* Statements are published by batches of DIGEST_THREAD_FLUSH_COUNT. */
+  for (i= 0; i < DIGEST_THREAD_FLUSH_COUNT; i++)
+    end_statement(& thread_1, "db1");
+  ok(find_digest_row("db1") != NULL, "digest row created");
+  ok(digest_row_count("db1") == 0, "statements aggregated locally");
+  end_statement(& thread_1, "db1");
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 1,
+     "batch published with the statement that ended it");
+  ok(find_digest_row("db1")->m_histogram.m_count[0] ==
+     DIGEST_THREAD_FLUSH_COUNT + 1, "histogram published");
+
+  /* Another session caching an existing row updates LAST_SEEN. */
+  find_digest_row("db1")->m_last_seen= 0;
+  end_statement(& thread_2, "db1");
+  ok(find_digest_row("db1")->m_last_seen != 0, "last seen when first cached");
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 1,
+     "statement aggregated locally");
+
+  /*
+    Going idle publishes the statements older than DIGEST_THREAD_FLUSH_TIME,
+    and keeps the digest cached.
+  */
+  entry= & thread_2.m_digest_cache[0];
+  flush_idle_digest_thread_cache(& thread_2);
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 1,
+     "young statement kept when idle");
+  entry->m_first_pending-= DIGEST_THREAD_FLUSH_TIME;
+  flush_idle_digest_thread_cache(& thread_2);
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 2,
+     "old statement published when idle");
+  ok(entry->m_digest_stat == find_digest_row("db1") && entry->m_pending == 0,
+     "still cached");
+
+  /* Statements older than DIGEST_THREAD_FLUSH_TIME are published. */
+  end_statement(& thread_2, "db1");
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 2,
+     "young statement aggregated locally");
+  entry->m_first_pending-= DIGEST_THREAD_FLUSH_TIME;
+  end_statement(& thread_2, "db1");
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 4,
+     "old statement published");
+
+  /* Another digest in the same cache entry publishes the previous one. */
+  end_statement(& thread_2, "db1");
+  end_statement(& thread_2, "db2");
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT + 5,
+     "published when evicted");
+  ok(digest_row_count("db2") == 0, "new digest aggregated locally");
+
+  /* Statistics of a truncated row are dropped, not published. */
+  for (i= 0; i < 5; i++)
+    end_statement(& thread_1, "db1");
+  my_create_thread_local_key(& THR_PFS, NULL);
+  my_set_thread_local(THR_PFS, & thread_1);
+  reset_esms_by_digest();
+  my_delete_thread_local_key(THR_PFS);
+  ok(find_digest_row("db1") == NULL && find_digest_row("db2") == NULL,
+     "truncated");
+
+  /* Going idle publishes DIGEST_THREAD_FLUSH_COUNT statements at once. */
+  for (i= 0; i < DIGEST_THREAD_FLUSH_COUNT - 1; i++)
+    end_statement(& thread_1, "db1");
+  flush_idle_digest_thread_cache(& thread_1);
+  ok(find_digest_row("db1") != NULL && digest_row_count("db1") == 0,
+     "stale statistics dropped, few statements kept when idle");
+  end_statement(& thread_1, "db1");
+  flush_idle_digest_thread_cache(& thread_1);
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT,
+     "full batch published when idle");
+
+  /* The row of db2 was truncated as well. */
+  flush_digest_thread_cache(& thread_2, true);
+  ok(digest_row_count("db1") == DIGEST_THREAD_FLUSH_COUNT,
+     "stale statistics dropped on release");
+  ok(thread_2.m_digest_cache[0].m_digest_stat == NULL, "released");
+
+  flush_digest_thread_cache(& thread_1, true);
+  lf_hash_put_pins(thread_1.m_digest_hash_pins);
+  lf_hash_put_pins(thread_2.m_digest_hash_pins);
+  cleanup_digest_hash();
+  cleanup_digest();
+}
+
 void do_all_tests()
 {
   test_digest_length_overflow();
+  test_digest_histogram();
+  test_digest_thread_cache();
 }
 
 int main(int, char **)
 {
-  plan(3);
+  plan(30);
   MY_INIT("pfs_misc-t");
   do_all_tests();
   return (exit_status());
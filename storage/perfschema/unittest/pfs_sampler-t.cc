@@ -0,0 +1,192 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <my_global.h>
+#include <my_thread.h>
+#include <pfs_server.h>
+#include <pfs_instr_class.h>
+#include <pfs_instr.h>
+#include <pfs_global.h>
+#include <pfs_sampler.h>
+#include <table_samples_by_stack.h>
+#include <tap.h>
+#include <string.h>
+#include <memory.h>
+#include "stub_print_error.h"
+#include "stub_pfs_defaults.h"
+#include "stub_global_status_var.h"
+
+/* Access to the rows of EVENTS_SAMPLES_SUMMARY_BY_STACK. */
+class test_samples_by_stack : public table_samples_by_stack
+{
+public:
+  const row_samples_by_stack *next_row()
+  {
+    while (rnd_next() == 0)
+    {
+      if (m_row_exists)
+        return & m_row;
+    }
+    return NULL;
+  }
+};
+
+PSI * load_perfschema()
+{
+  PSI_bootstrap *boot;
+  PFS_global_param param;
+
+  memset(& param, 0, sizeof(param));
+  param.m_enabled= true;
+  param.m_thread_class_sizing= 10;
+  param.m_thread_sizing= 10;
+  param.m_stage_class_sizing= 10;
+  param.m_statement_stack_sizing= 10;
+  param.m_memory_class_sizing= 10;
+  param.m_sample_stack_sizing= 2;
+
+  param.m_hints.m_table_definition_cache = 100;
+  param.m_hints.m_table_open_cache       = 100;
+  param.m_hints.m_max_connections        = 100;
+  param.m_hints.m_open_files_limit       = 100;
+  param.m_hints.m_max_prepared_stmt_count= 100;
+
+  pre_initialize_performance_schema();
+  boot= initialize_performance_schema(& param);
+  return (PSI*) boot->get_interface(PSI_VERSION_1);
+}
+
+/* Number of rows, and total count, of EVENTS_SAMPLES_SUMMARY_BY_STACK. */
+uint count_rows(const char *stage_name, ulonglong *stage_count)
+{
+  test_samples_by_stack table;
+  const row_samples_by_stack *row;
+  uint rows= 0;
+
+  *stage_count= 0;
+  while ((row= table.next_row()) != NULL)
+  {
+    rows++;
+    if (row->m_stage_name_length == strlen(stage_name) &&
+        memcmp(row->m_stage_name, stage_name, row->m_stage_name_length) == 0 &&
+        row->m_stack_length == row->m_stage_name_length &&
+        memcmp(row->m_stack, stage_name, row->m_stack_length) == 0 &&
+        row->m_digest_length == 0 && row->m_wait_name_length == 0)
+      *stage_count= row->m_count;
+  }
+  return rows;
+}
+
+void test_samples_by_stack()
+{
+  PSI *psi;
+  ulonglong count;
+
+  diag("test_samples_by_stack");
+
+  pfs_sampling_interval= 0;
+  psi= load_perfschema();
+  ok(! is_sampler_running(), "no sampler thread while sampling is disabled");
+
+  PSI_stage_key stage_key_A;
+  PSI_stage_key stage_key_B;
+  PSI_stage_key stage_key_C;
+  PSI_stage_info stage_A= { 0, "S-A", 0};
+  PSI_stage_info stage_B= { 0, "S-B", 0};
+  PSI_stage_info stage_C= { 0, "S-C", 0};
+  PSI_stage_info *all_stage[]= { & stage_A, & stage_B, & stage_C };
+  PSI_thread_key thread_key_1;
+  PSI_thread_info all_thread[]=
+  {
+    { & thread_key_1, "T-1", 0}
+  };
+
+  psi->register_stage("test", all_stage, 3);
+  psi->register_thread("test", all_thread, 1);
+  stage_key_A= stage_A.m_key;
+  stage_key_B= stage_B.m_key;
+  stage_key_C= stage_C.m_key;
+
+  PFS_thread *thread_1= (PFS_thread*) psi->new_thread(thread_key_1, NULL, 0);
+  PFS_thread *thread_2= (PFS_thread*) psi->new_thread(thread_key_1, NULL, 0);
+  ok(thread_1 != NULL && thread_2 != NULL, "threads");
+
+  ok(count_rows("stage/test/S-A", & count) == 0, "empty table");
+
+  /* Threads doing nothing instrumented are not sampled. */
+  sample_all_threads();
+  ok(count_rows("stage/test/S-A", & count) == 0, "nothing sampled");
+
+  thread_1->m_stage= stage_key_A;
+  thread_2->m_stage= stage_key_A;
+  sample_all_threads();
+  sample_all_threads();
+  ok(count_rows("stage/test/S-A", & count) == 1, "one stack");
+  ok(count == 4, "two samples of two threads");
+
+  thread_2->m_stage= stage_key_B;
+  sample_all_threads();
+  ok(count_rows("stage/test/S-A", & count) == 2, "two stacks");
+  ok(count == 5, "one more sample");
+  ok(count_rows("stage/test/S-B", & count) == 2 && count == 1, "S-B sampled");
+
+  /* The table is full. */
+  thread_2->m_stage= stage_key_C;
+  sample_all_threads();
+  ok(count_rows("stage/test/S-C", & count) == 2 && count == 0, "S-C not kept");
+  ok(sample_stack_lost == 1, "lost 1");
+
+  ok(table_samples_by_stack::delete_all_rows() == 0, "truncate");
+  ok(count_rows("stage/test/S-A", & count) == 0, "empty after truncate");
+  ok(sample_stack_lost == 0, "lost reset");
+
+  /* Enabling sampling starts the thread, disabling it stops the thread. */
+  pfs_sampling_interval= 1;
+  pfs_sampling_interval_changed();
+  ok(is_sampler_running(), "sampler thread started");
+
+  for (int i= 0; i < 1000 && count_rows("stage/test/S-A", & count) == 0; i++)
+    my_sleep(1000);
+  ok(count > 0, "sampled by the sampler thread");
+
+  pfs_sampling_interval= 0;
+  pfs_sampling_interval_changed();
+  for (int i= 0; i < 1000 && is_sampler_running(); i++)
+    my_sleep(1000);
+  ok(! is_sampler_running(), "sampler thread stopped");
+
+  /* Started again, then stopped by the shutdown. */
+  pfs_sampling_interval= 1;
+  pfs_sampling_interval_changed();
+  ok(is_sampler_running(), "sampler thread started again");
+
+  shutdown_performance_schema();
+  pfs_sampling_interval= 0;
+}
+
+void do_all_tests()
+{
+  test_samples_by_stack();
+}
+
+int main(int, char **)
+{
+  plan(18);
+
+  MY_INIT("pfs_sampler-t");
+  do_all_tests();
+  return (exit_status());
+}
@@ -80,6 +80,7 @@
 #include "./rdb_datadic.h"
 #include "./rdb_i_s.h"
 #include "./rdb_index_merge.h"
+#include "./rdb_large_page_allocator.h"
 #include "./rdb_mutex_wrapper.h"
 #include "./rdb_psi.h"
 #include "./rdb_threads.h"
@@ -566,6 +567,9 @@ static long long rocksdb_block_cache_size = RDB_DEFAULT_BLOCK_CACHE_SIZE;
 static long long rocksdb_sim_cache_size = 0;
 static double rocksdb_cache_high_pri_pool_ratio = 0.0;
 static my_bool rocksdb_cache_dump = FALSE;
+#ifdef HAVE_LINUX_LARGE_PAGES
+static my_bool rocksdb_block_cache_large_pages = FALSE;
+#endif
 /* Use unsigned long long instead of uint64_t because of MySQL compatibility */
 static unsigned long long  // NOLINT(runtime/int)
     rocksdb_rate_limiter_bytes_per_sec = 0;
@@ -1657,6 +1661,16 @@ static MYSQL_SYSVAR_BOOL(cache_dump, rocksdb_cache_dump,
                          "Include RocksDB block cache content in core dump.",
                          nullptr, nullptr, true);
 
+#ifdef HAVE_LINUX_LARGE_PAGES
+static MYSQL_SYSVAR_BOOL(
+    block_cache_large_pages, rocksdb_block_cache_large_pages,
+    PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+    "Allocate the RocksDB block cache from large page arenas, following the "
+    "large_pages, large_pages_thp, large_pages_numa and large_pages_prefault "
+    "settings of the server.",
+    nullptr, nullptr, false);
+#endif
+
 static MYSQL_SYSVAR_DOUBLE(cache_high_pri_pool_ratio,
                            rocksdb_cache_high_pri_pool_ratio,
                            PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
@@ -2277,6 +2291,9 @@ static struct st_mysql_sys_var *rocksdb_system_variables[] = {
     MYSQL_SYSVAR(sim_cache_size),
     MYSQL_SYSVAR(cache_high_pri_pool_ratio),
     MYSQL_SYSVAR(cache_dump),
+#ifdef HAVE_LINUX_LARGE_PAGES
+    MYSQL_SYSVAR(block_cache_large_pages),
+#endif
     MYSQL_SYSVAR(cache_index_and_filter_blocks),
     MYSQL_SYSVAR(cache_index_and_filter_with_high_priority),
     MYSQL_SYSVAR(pin_l0_filter_and_index_blocks_in_cache),
@@ -5178,6 +5195,12 @@ static int rocksdb_init_func(void *const p) {
 
   if (!rocksdb_tbl_options->no_block_cache) {
     std::shared_ptr<rocksdb::MemoryAllocator> memory_allocator;
+#ifdef HAVE_LINUX_LARGE_PAGES
+    if (rocksdb_block_cache_large_pages) {
+      memory_allocator =
+          std::make_shared<Rdb_large_page_allocator>(rocksdb_cache_dump);
+    } else
+#endif
     if (!rocksdb_cache_dump) {
 #ifdef HAVE_JEMALLOC
       size_t block_size = rocksdb_tbl_options->block_size;
@@ -0,0 +1,344 @@
+/* Copyright (c) 2017, Percona and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* This C++ file's header file */
+#include "./rdb_large_page_allocator.h"
+
+#ifdef HAVE_LINUX_LARGE_PAGES
+
+/* C++ standard header files */
+#include <algorithm>
+#include <new>
+
+/* C standard header files */
+#include <stdlib.h>
+#include <sys/mman.h>
+
+namespace myrocks {
+
+/*
+  Header at the start of every arena mapping, followed by the blocks.
+  Every byte between blocks() and m_pos belongs to a block, so that the
+  blocks of an arena can be walked when it is released.
+*/
+struct Rdb_large_page_allocator::Arena {
+  Arena *m_prev;
+  Arena *m_next;
+  size_t m_mapped_size;
+  /* Start of the space not carved yet, and end of the mapping. */
+  char *m_pos;
+  char *m_end;
+  /* Blocks handed out by Allocate() and not deallocated yet. */
+  size_t m_live;
+
+  static constexpr size_t HEADER_SIZE = 64;
+
+  char *blocks() { return reinterpret_cast<char *>(this) + HEADER_SIZE; }
+};
+
+/*
+  Header in front of every block.  Keeps the block 16 byte aligned, and
+  records where the block came from so that Deallocate() needs no lookup.
+*/
+struct Rdb_large_page_allocator::Block {
+  uint32_t m_class;
+  uint32_t m_unused;
+  union {
+    /* Arena of a block in a size class. */
+    Arena *m_arena;
+    /* Mapped size of a block mapped directly. */
+    size_t m_mapped_size;
+  };
+};
+
+constexpr size_t Rdb_large_page_allocator::Arena::HEADER_SIZE;
+
+namespace {
+
+typedef Rdb_large_page_allocator Allocator;
+
+static_assert(sizeof(Allocator::Block) == 16,
+              "block header must keep blocks 16 byte aligned");
+static_assert(sizeof(Allocator::Arena) <= Allocator::Arena::HEADER_SIZE,
+              "arena header must fit in front of the blocks");
+
+/* m_class values for blocks which are not in a size class. */
+const uint32_t CLASS_DIRECT = UINT32_MAX;
+const uint32_t CLASS_MALLOC = UINT32_MAX - 1;
+
+/* Free list links, kept in the body of a free block. */
+struct Free_links {
+  Allocator::Block *m_prev;
+  Allocator::Block *m_next;
+};
+
+inline Allocator::Block *header_of(void *p) {
+  return reinterpret_cast<Allocator::Block *>(p) - 1;
+}
+
+inline Free_links *links_of(Allocator::Block *block) {
+  return reinterpret_cast<Free_links *>(block + 1);
+}
+
+}  // anonymous namespace
+
+constexpr size_t Rdb_large_page_allocator::ARENA_SIZE;
+constexpr size_t Rdb_large_page_allocator::MIN_CLASS_SIZE;
+constexpr size_t Rdb_large_page_allocator::MAX_CLASS_SIZE;
+constexpr uint Rdb_large_page_allocator::NUM_CLASSES;
+
+Rdb_large_page_allocator::Rdb_large_page_allocator(bool dump_arenas)
+    : m_dump_arenas(dump_arenas) {
+  std::fill(m_free, m_free + NUM_CLASSES, nullptr);
+}
+
+Rdb_large_page_allocator::~Rdb_large_page_allocator() {
+  while (m_arenas != nullptr) {
+    Arena *const arena = m_arenas;
+    m_arenas = arena->m_next;
+    my_large_munmap(arena, arena->m_mapped_size);
+  }
+}
+
+/* Smallest class holding size bytes, size must be <= MAX_CLASS_SIZE. */
+uint Rdb_large_page_allocator::size_class(size_t size) {
+  if (size <= MIN_CLASS_SIZE) return 0;
+
+  /* 2^shift < size <= 2^(shift + 1) */
+  const uint shift = 63 - __builtin_clzll(size - 1);
+  const size_t step = size_t(1) << (shift - 2);
+  const uint k = (size - 1 - (size_t(1) << shift)) / step;
+  return (shift - 6) * 4 + k + 1;
+}
+
+size_t Rdb_large_page_allocator::class_size(uint cls) {
+  if (cls == 0) return MIN_CLASS_SIZE;
+
+  const uint shift = (cls - 1) / 4 + 6;
+  const uint k = (cls - 1) % 4;
+  return (size_t(1) << shift) + (k + 1) * (size_t(1) << (shift - 2));
+}
+
+/* Largest class of at most size bytes, size must be >= MIN_CLASS_SIZE. */
+uint Rdb_large_page_allocator::fitting_class(size_t size) {
+  if (size >= MAX_CLASS_SIZE) return NUM_CLASSES - 1;
+
+  const uint cls = size_class(size);
+  return class_size(cls) > size ? cls - 1 : cls;
+}
+
+size_t Rdb_large_page_allocator::arena_bytes() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_arena_bytes;
+}
+
+void *Rdb_large_page_allocator::map(size_t *size) {
+  void *ptr = my_large_mmap(size, FALSE);
+  if (ptr != nullptr && !m_dump_arenas) madvise(ptr, *size, MADV_DONTDUMP);
+  return ptr;
+}
+
+void Rdb_large_page_allocator::push_free(Block *block) {
+  Free_links *const links = links_of(block);
+  Block *&head = m_free[block->m_class];
+
+  links->m_prev = nullptr;
+  links->m_next = head;
+  if (head != nullptr) links_of(head)->m_prev = block;
+  head = block;
+}
+
+void Rdb_large_page_allocator::unlink_free(Block *block) {
+  Free_links *const links = links_of(block);
+
+  if (links->m_prev != nullptr)
+    links_of(links->m_prev)->m_next = links->m_next;
+  else
+    m_free[block->m_class] = links->m_next;
+  if (links->m_next != nullptr) links_of(links->m_next)->m_prev = links->m_prev;
+}
+
+/*
+  Turn size bytes at pos into free blocks of arena.  All sizes are
+  multiples of 16 and every size from 64 to 128 bytes is a class, so
+  pieces are taken leaving at least MIN_CLASS_SIZE bytes until the rest
+  is a class itself.  Returns the end of the last block, only less than
+  MIN_CLASS_SIZE bytes can be left over.
+*/
+char *Rdb_large_page_allocator::split_free(Arena *arena, char *pos,
+                                          size_t size) {
+  while (size >= MIN_CLASS_SIZE) {
+    const uint cls = size <= 2 * MIN_CLASS_SIZE
+                         ? size_class(size)
+                         : fitting_class(size - MIN_CLASS_SIZE);
+    Block *const block = reinterpret_cast<Block *>(pos);
+    block->m_class = cls;
+    block->m_arena = arena;
+    push_free(block);
+    pos += class_size(cls);
+    size -= class_size(cls);
+  }
+  return pos;
+}
+
+/* Best fit: a free block of class cls, else the smallest larger one. */
+Rdb_large_page_allocator::Block *Rdb_large_page_allocator::take_free(
+    uint cls) {
+  for (uint larger = cls; larger < NUM_CLASSES; larger++) {
+    Block *const block = m_free[larger];
+    if (block == nullptr) continue;
+
+    unlink_free(block);
+    const size_t rest = class_size(larger) - class_size(cls);
+    /* Too small a rest stays with the block, as part of its class. */
+    if (rest >= MIN_CLASS_SIZE) {
+      block->m_class = cls;
+      split_free(block->m_arena,
+                 reinterpret_cast<char *>(block) + class_size(cls), rest);
+    }
+    return block;
+  }
+  return nullptr;
+}
+
+/* Cut a new block out of the current arena, mapping a new one if needed. */
+Rdb_large_page_allocator::Block *Rdb_large_page_allocator::carve(uint cls) {
+  const size_t size = class_size(cls);
+  Arena *arena = m_current;
+
+  if (arena == nullptr || size_t(arena->m_end - arena->m_pos) < size) {
+    size_t mapped = ARENA_SIZE;
+    void *const ptr = map(&mapped);
+    if (ptr == nullptr) return nullptr;
+
+    if (arena != nullptr) {
+      /* The tail of the previous arena serves the smaller requests. */
+      arena->m_pos =
+          split_free(arena, arena->m_pos, arena->m_end - arena->m_pos);
+    }
+
+    arena = new (ptr) Arena();
+    arena->m_prev = nullptr;
+    arena->m_next = m_arenas;
+    if (m_arenas != nullptr) m_arenas->m_prev = arena;
+    m_arenas = arena;
+    arena->m_mapped_size = mapped;
+    arena->m_pos = arena->blocks();
+    arena->m_end = static_cast<char *>(ptr) + mapped;
+    arena->m_live = 0;
+    m_current = arena;
+    m_arena_bytes += mapped;
+  }
+
+  Block *const block = reinterpret_cast<Block *>(arena->m_pos);
+  arena->m_pos += size;
+  block->m_class = cls;
+  block->m_arena = arena;
+  return block;
+}
+
+/*
+  Called when the last block of arena is freed: all its blocks are in the
+  free lists.  The current arena is kept and carved again from its start,
+  any other is unmapped.
+*/
+void Rdb_large_page_allocator::release(Arena *arena) {
+  for (char *pos = arena->blocks(); pos < arena->m_pos;) {
+    Block *const block = reinterpret_cast<Block *>(pos);
+    pos += class_size(block->m_class);
+    unlink_free(block);
+  }
+
+  if (arena == m_current) {
+    arena->m_pos = arena->blocks();
+    return;
+  }
+
+  if (arena->m_prev != nullptr)
+    arena->m_prev->m_next = arena->m_next;
+  else
+    m_arenas = arena->m_next;
+  if (arena->m_next != nullptr) arena->m_next->m_prev = arena->m_prev;
+  m_arena_bytes -= arena->m_mapped_size;
+  my_large_munmap(arena, arena->m_mapped_size);
+}
+
+void *Rdb_large_page_allocator::Allocate(size_t size) {
+  const size_t total = size + sizeof(Block);
+  Block *block = nullptr;
+
+  if (total <= MAX_CLASS_SIZE) {
+    const uint cls = size_class(total);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    block = take_free(cls);
+    if (block == nullptr) block = carve(cls);
+    if (block != nullptr) {
+      block->m_arena->m_live++;
+      return block + 1;
+    }
+  } else {
+    size_t mapped = total;
+    block = static_cast<Block *>(map(&mapped));
+    if (block != nullptr) {
+      block->m_class = CLASS_DIRECT;
+      block->m_mapped_size = mapped;
+      return block + 1;
+    }
+  }
+
+  /* Out of large memory: the block cache still works on the heap. */
+  block = static_cast<Block *>(malloc(total));
+  if (block == nullptr) return nullptr;
+  block->m_class = CLASS_MALLOC;
+  block->m_mapped_size = 0;
+  return block + 1;
+}
+
+void Rdb_large_page_allocator::Deallocate(void *p) {
+  if (p == nullptr) return;
+
+  Block *const block = header_of(p);
+  switch (block->m_class) {
+    case CLASS_MALLOC:
+      free(block);
+      return;
+    case CLASS_DIRECT:
+      my_large_munmap(block, block->m_mapped_size);
+      return;
+    default: {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      Arena *const arena = block->m_arena;
+      push_free(block);
+      if (--arena->m_live == 0) release(arena);
+    }
+  }
+}
+
+size_t Rdb_large_page_allocator::UsableSize(void *p,
+                                            size_t allocation_size) const {
+  const Block *const block = header_of(p);
+  switch (block->m_class) {
+    case CLASS_MALLOC:
+      return allocation_size;
+    case CLASS_DIRECT:
+      return block->m_mapped_size - sizeof(Block);
+    default:
+      return class_size(block->m_class) - sizeof(Block);
+  }
+}
+
+}  // namespace myrocks
+
+#endif  // HAVE_LINUX_LARGE_PAGES
@@ -0,0 +1,103 @@
+/* Copyright (c) 2017, Percona and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#pragma once
+
+/* C++ standard header file */
+#include <mutex>
+
+/* MySQL header files */
+#include "my_global.h"
+#include "my_sys.h"
+
+/* RocksDB header files */
+#include "rocksdb/memory_allocator.h"
+
+namespace myrocks {
+
+#ifdef HAVE_LINUX_LARGE_PAGES
+
+/*
+  Block cache allocator carving blocks out of large arenas mapped with
+  my_large_mmap(), so that the block cache is backed by huge pages and
+  follows the large_pages_numa and large_pages_prefault settings.
+
+  Blocks are rounded up to one of four size classes per power of two and
+  recycled through per class free lists. A request for which its class
+  has no free block takes the smallest larger free block and splits it,
+  and the unused tail of an arena is split into free blocks when the next
+  arena is mapped. An arena is unmapped as soon as its last block is
+  freed, except for the arena blocks are currently carved from, so the
+  memory held beyond the blocks in use is the free space of the arenas
+  still in use plus at most one arena. Requests above the largest class
+  are mapped directly.
+*/
+class Rdb_large_page_allocator : public rocksdb::MemoryAllocator {
+  Rdb_large_page_allocator(const Rdb_large_page_allocator &) = delete;
+  Rdb_large_page_allocator &operator=(const Rdb_large_page_allocator &) =
+      delete;
+
+ public:
+  explicit Rdb_large_page_allocator(bool dump_arenas);
+  virtual ~Rdb_large_page_allocator() override;
+
+  virtual const char *Name() const override {
+    return "Rdb_large_page_allocator";
+  }
+  virtual void *Allocate(size_t size) override;
+  virtual void Deallocate(void *p) override;
+  virtual size_t UsableSize(void *p, size_t allocation_size) const override;
+
+  /* Bytes currently mapped for the arenas. */
+  size_t arena_bytes();
+
+  static constexpr size_t ARENA_SIZE = 64 * 1024 * 1024;
+  static constexpr size_t MIN_CLASS_SIZE = 64;
+  static constexpr size_t MAX_CLASS_SIZE = 4 * 1024 * 1024;
+  /* Four classes per power of two from 64 bytes to 4MB. */
+  static constexpr uint NUM_CLASSES = 65;
+
+  static uint size_class(size_t size);
+  static size_t class_size(uint cls);
+  static uint fitting_class(size_t size);
+
+  /* Headers of the arenas and of the blocks, see the .cc file. */
+  struct Arena;
+  struct Block;
+
+ private:
+  void *map(size_t *size);
+  Block *carve(uint cls);
+  Block *take_free(uint cls);
+  char *split_free(Arena *arena, char *pos, size_t size);
+  void push_free(Block *block);
+  void unlink_free(Block *block);
+  void release(Arena *arena);
+
+  const bool m_dump_arenas;
+
+  /* Protects the free lists and the arenas. */
+  std::mutex m_mutex;
+  /* Doubly linked lists of the free blocks of each class. */
+  Block *m_free[NUM_CLASSES];
+  /* All arenas, and the one new blocks are carved from. */
+  Arena *m_arenas = nullptr;
+  Arena *m_current = nullptr;
+  size_t m_arena_bytes = 0;
+};
+
+#endif  // HAVE_LINUX_LARGE_PAGES
+
+}  // namespace myrocks
@@ -0,0 +1,134 @@
+/* Copyright (c) 2017, Percona and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* C++ standard header files */
+#include <cassert>
+#include <vector>
+
+/* MyRocks header files */
+#include "../rdb_large_page_allocator.h"
+
+#ifdef HAVE_LINUX_LARGE_PAGES
+
+using myrocks::Rdb_large_page_allocator;
+
+void test_size_classes() {
+  const uint last = Rdb_large_page_allocator::NUM_CLASSES - 1;
+
+  assert(Rdb_large_page_allocator::size_class(1) == 0);
+  assert(Rdb_large_page_allocator::size_class(64) == 0);
+  assert(Rdb_large_page_allocator::size_class(65) == 1);
+  assert(Rdb_large_page_allocator::class_size(0) == 64);
+  assert(Rdb_large_page_allocator::class_size(1) == 80);
+  assert(Rdb_large_page_allocator::class_size(4) == 128);
+  assert(Rdb_large_page_allocator::class_size(5) == 160);
+  assert(Rdb_large_page_allocator::class_size(last) ==
+         Rdb_large_page_allocator::MAX_CLASS_SIZE);
+
+  for (uint cls = 0; cls <= last; cls++) {
+    const size_t size = Rdb_large_page_allocator::class_size(cls);
+    assert(size % 16 == 0);
+    assert(Rdb_large_page_allocator::size_class(size) == cls);
+    assert(Rdb_large_page_allocator::fitting_class(size) == cls);
+    if (cls < last) {
+      assert(Rdb_large_page_allocator::size_class(size + 1) == cls + 1);
+      assert(Rdb_large_page_allocator::fitting_class(size + 1) == cls);
+    }
+    if (cls > 0) {
+      assert(Rdb_large_page_allocator::class_size(cls - 1) < size);
+      assert(Rdb_large_page_allocator::fitting_class(size - 1) == cls - 1);
+    }
+  }
+
+  // Smallest class holding the size, wasting at most a quarter of it
+  for (size_t size = 1; size <= Rdb_large_page_allocator::MAX_CLASS_SIZE;
+       size += size / 7 + 1) {
+    const uint cls = Rdb_large_page_allocator::size_class(size);
+    const size_t rounded = Rdb_large_page_allocator::class_size(cls);
+    assert(rounded >= size);
+    assert(cls == 0 || Rdb_large_page_allocator::class_size(cls - 1) < size);
+    assert(size <= 64 || (rounded - size) * 4 <= size);
+  }
+}
+
+void test_reuse() {
+  const size_t arena = Rdb_large_page_allocator::ARENA_SIZE;
+  const size_t large = 1024 * 1024;
+  Rdb_large_page_allocator alloc(false);
+
+  // A freed block serves smaller requests of other classes
+  void *keep = alloc.Allocate(100);
+  char *big = static_cast<char *>(alloc.Allocate(large));
+  assert(alloc.UsableSize(big, large) >= large);
+  const size_t mapped = alloc.arena_bytes();
+  assert(mapped >= arena);
+  alloc.Deallocate(big);
+
+  const size_t big_class = Rdb_large_page_allocator::class_size(
+      Rdb_large_page_allocator::size_class(large + 16));
+  std::vector<void *> small;
+  for (int i = 0; i < 48; i++) {
+    char *p = static_cast<char *>(alloc.Allocate(16 * 1024 - 100));
+    assert(p >= big && p < big + big_class);
+    small.push_back(p);
+  }
+  assert(alloc.arena_bytes() == mapped);
+  for (void *p : small) alloc.Deallocate(p);
+
+  // Arenas are unmapped once empty, except the current one
+  std::vector<void *> blocks;
+  for (size_t total = 0; total < 3 * arena; total += large)
+    blocks.push_back(alloc.Allocate(large));
+  assert(alloc.arena_bytes() >= 3 * arena);
+  for (void *p : blocks) alloc.Deallocate(p);
+  alloc.Deallocate(keep);
+  assert(alloc.arena_bytes() <= mapped);
+
+  // Carving starts over in the emptied current arena
+  blocks.clear();
+  for (size_t total = 0; total < arena / 2; total += large)
+    blocks.push_back(alloc.Allocate(large));
+  assert(alloc.arena_bytes() <= mapped);
+  for (void *p : blocks) alloc.Deallocate(p);
+}
+
+void test_direct() {
+  const size_t size = 8 * 1024 * 1024;
+  const ulonglong mapped = my_large_mmap_bytes;
+  Rdb_large_page_allocator alloc(false);
+
+  char *p = static_cast<char *>(alloc.Allocate(size));
+  assert(alloc.UsableSize(p, size) >= size);
+  assert(my_large_mmap_bytes >= mapped + size);
+  p[0] = p[size - 1] = 1;
+  alloc.Deallocate(p);
+  assert(my_large_mmap_bytes == mapped);
+  assert(alloc.arena_bytes() == 0);
+}
+
+int main(int argc, char **argv) {
+  MY_INIT(argv[0]);
+  test_size_classes();
+  test_reuse();
+  test_direct();
+  my_end(0);
+  return 0;
+}
+
+#else
+
+int main(int argc, char **argv) { return 0; }
+
+#endif  // HAVE_LINUX_LARGE_PAGES
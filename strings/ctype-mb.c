@@ -383,6 +383,103 @@ int my_wildcmp_mb(const CHARSET_INFO *cs,
 }
 
 
+/*
+  Length of the run of 7-bit bytes at the start of [s, e).
+
+  Every multi-byte character set using my_numchars_mb() and friends has
+  ASCII compatible single byte characters: a byte below 0x80 in a lead
+  position is always one character. The scanners below use this to skip
+  ASCII text a word or a vector at a time.
+
+  On x86-64 SSE2 is always available; the AVX2 variant is picked at the
+  first call when the CPU (and the OS) support it. Other platforms
+  test eight bytes at a time.
+*/
+
+#define ASCII_WORD_MASK 0x8080808080808080ULL
+
+static size_t ascii_prefix_len_word(const uchar *s, const uchar *e)
+{
+  const uchar *start= s;
+  ulonglong word;
+
+  for (; s + 8 <= e; s+= 8)
+  {
+    memcpy(&word, s, 8);
+    if (word & ASCII_WORD_MASK)
+      break;
+  }
+  while (s < e && *s < 0x80)
+    s++;
+  return (size_t) (s - start);
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <emmintrin.h>
+#include <immintrin.h>
+
+static size_t ascii_prefix_len_sse2(const uchar *s, const uchar *e)
+{
+  const uchar *start= s;
+
+  for (; s + 16 <= e; s+= 16)
+  {
+    int mask= _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) s));
+    if (mask)
+      return (size_t) (s - start) + __builtin_ctz(mask);
+  }
+  return (size_t) (s - start) + ascii_prefix_len_word(s, e);
+}
+
+__attribute__((target("avx2")))
+static size_t ascii_prefix_len_avx2(const uchar *s, const uchar *e)
+{
+  const uchar *start= s;
+
+  for (; s + 32 <= e; s+= 32)
+  {
+    int mask= _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*) s));
+    if (mask)
+      return (size_t) (s - start) + __builtin_ctz(mask);
+  }
+  return (size_t) (s - start) + ascii_prefix_len_sse2(s, e);
+}
+
+static size_t ascii_prefix_len_select(const uchar *s, const uchar *e);
+
+/*
+  Set once, by the first caller. Concurrent first calls all store
+  the same value, so no synchronization is needed.
+*/
+static size_t (*ascii_prefix_len_func)(const uchar *, const uchar *)=
+  ascii_prefix_len_select;
+
+static size_t ascii_prefix_len_select(const uchar *s, const uchar *e)
+{
+  __builtin_cpu_init();
+  ascii_prefix_len_func= __builtin_cpu_supports("avx2") ?
+    ascii_prefix_len_avx2 : ascii_prefix_len_sse2;
+  return ascii_prefix_len_func(s, e);
+}
+
+size_t my_ascii_prefix_len(const uchar *s, const uchar *e)
+{
+  /* Short runs are not worth an indirect call */
+  if (e - s < 16)
+    return ascii_prefix_len_word(s, e);
+  return ascii_prefix_len_func(s, e);
+}
+
+#else
+
+size_t my_ascii_prefix_len(const uchar *s, const uchar *e)
+{
+  return ascii_prefix_len_word(s, e);
+}
+
+#endif
+
+
 size_t my_numchars_mb(const CHARSET_INFO *cs MY_ATTRIBUTE((unused)),
 		      const char *pos, const char *end)
 {
@@ -390,6 +487,13 @@ size_t my_numchars_mb(const CHARSET_INFO *cs MY_ATTRIBUTE((unused)),
   while (pos < end) 
   {
     uint mb_len;
+    if ((uchar) *pos < 0x80)
+    {
+      size_t n= my_ascii_prefix_len((const uchar*) pos, (const uchar*) end);
+      pos+= n;
+      count+= n;
+      continue;
+    }
     pos+= (mb_len= my_ismbchar(cs,pos,end)) ? mb_len : 1;
     count++;
   }
@@ -405,6 +509,15 @@ size_t my_charpos_mb(const CHARSET_INFO *cs MY_ATTRIBUTE((unused)),
   while (length && pos < end)
   {
     uint mb_len;
+    if ((uchar) *pos < 0x80)
+    {
+      size_t n= my_ascii_prefix_len((const uchar*) pos, (const uchar*)
+                                    (length < (size_t) (end - pos) ?
+                                     pos + length : end));
+      pos+= n;
+      length-= n;
+      continue;
+    }
     pos+= (mb_len= my_ismbchar(cs, pos, end)) ? mb_len : 1;
     length--;
   }
@@ -6532,7 +6532,8 @@ MY_UCA_INFO my_uca_v400=
         0,       /*   nitems          */
         NULL,    /*   item            */
         NULL     /*   flags           */
-      }
+      },
+      NULL       /* ascii_weights     */
     },
   },
 
@@ -19108,7 +19109,8 @@ MY_UCA_INFO my_uca_v520=
         0,           /*   nitems          */
         NULL,        /*   item            */
         NULL         /*   flags           */
-      }
+      },
+      NULL           /* ascii_weights     */
     },
   },
 
@@ -19466,6 +19468,7 @@ typedef struct my_uca_scanner_st
   int page;
   int code;
   const CHARSET_INFO *cs;
+  const uint16 *ascii_weights; /* Fast path weights, or NULL */
 } my_uca_scanner;
 
 /*
@@ -19912,6 +19915,61 @@ my_uca_scanner_init_any(my_uca_scanner *scanner,
   scanner->wbeg= nochar; 
   scanner->level= level;
   scanner->cs= cs;
+  /* The fast path needs ASCII compatible single byte characters */
+  scanner->ascii_weights= cs->mbminlen == 1 ? level->ascii_weights : NULL;
+}
+
+
+/*
+  Position a scanner after a prefix of fast path ASCII characters,
+  as if they had been scanned by my_uca_scanner_next_any().
+*/
+static inline void
+my_uca_scanner_skip_ascii(my_uca_scanner *scanner, size_t length)
+{
+  if (length)
+  {
+    scanner->sbeg+= length;
+    scanner->page= 0;
+    scanner->code= scanner->sbeg[-1];
+    scanner->wbeg= nochar + 1;
+  }
+}
+
+
+/*
+  Length of the common prefix of two strings which consists
+  of fast path ASCII characters only. Such characters have
+  one weight each, so the prefix compares equal.
+*/
+static size_t
+my_uca_common_ascii_prefix(const uint16 *ascii_weights,
+                           const uchar *s, size_t slen,
+                           const uchar *t, size_t tlen)
+{
+  size_t length= MY_MIN(slen, tlen);
+  size_t i= 0;
+
+  if (!ascii_weights)
+    return 0;
+
+  /* Find the first difference a word at a time */
+  for (; i + 8 <= length; i+= 8)
+  {
+    ulonglong sw, tw;
+    memcpy(&sw, s + i, 8);
+    memcpy(&tw, t + i, 8);
+    if (sw != tw)
+      break;
+  }
+  while (i < length && s[i] == t[i])
+    i++;
+
+  /* Then cut the prefix at the first non fast path character */
+  length= my_ascii_prefix_len(s, s + i);
+  for (i= 0; i < length && ascii_weights[s[i]]; i++)
+  { }
+  return i;
 }
 
 static int my_uca_scanner_next_any(my_uca_scanner *scanner)
@@ -19931,6 +19989,21 @@ static int my_uca_scanner_next_any(my_uca_scanner *scanner)
     my_wc_t wc[MY_UCA_MAX_CONTRACTION];
     int mblen;
 
+    /*
+      Fast path for ASCII characters with a single weight,
+      which are not part of any contraction.
+      Keep page and code up to date for previous context checks,
+      and make wbeg point to an end of weights which is not nochar.
+    */
+    if (scanner->ascii_weights && scanner->sbeg < scanner->send &&
+        *scanner->sbeg < 0x80 && scanner->ascii_weights[*scanner->sbeg])
+    {
+      scanner->page= 0;
+      scanner->code= *scanner->sbeg++;
+      scanner->wbeg= nochar + 1;
+      return scanner->ascii_weights[scanner->code];
+    }
+
     /* Get next character */
     if (((mblen= scanner->cs->cset->mb_wc(scanner->cs, wc,
                                           scanner->sbeg,
@@ -20069,9 +20142,15 @@ static int my_strnncoll_uca(const CHARSET_INFO *cs,
   my_uca_scanner tscanner;
   int s_res;
   int t_res;
+  size_t prefix;
   
   scanner_handler->init(&sscanner, cs, &cs->uca->level[0], s, slen);
   scanner_handler->init(&tscanner, cs, &cs->uca->level[0], t, tlen);
+
+  prefix= my_uca_common_ascii_prefix(sscanner.ascii_weights,
+                                     s, slen, t, tlen);
+  my_uca_scanner_skip_ascii(&sscanner, prefix);
+  my_uca_scanner_skip_ascii(&tscanner, prefix);
   
   do
   {
@@ -20170,6 +20249,7 @@ static int my_strnncollsp_uca(const CHARSET_INFO *cs,
 {
   my_uca_scanner sscanner, tscanner;
   int s_res, t_res;
+  size_t prefix;
   
 #ifndef VARCHAR_WITH_DIFF_ENDSPACE_ARE_DIFFERENT_FOR_UNIQUE
   diff_if_only_endspace_difference= 0;
@@ -20177,6 +20257,11 @@ static int my_strnncollsp_uca(const CHARSET_INFO *cs,
 
   scanner_handler->init(&sscanner, cs, &cs->uca->level[0], s, slen);
   scanner_handler->init(&tscanner, cs, &cs->uca->level[0], t, tlen);
+
+  prefix= my_uca_common_ascii_prefix(sscanner.ascii_weights,
+                                     s, slen, t, tlen);
+  my_uca_scanner_skip_ascii(&sscanner, prefix);
+  my_uca_scanner_skip_ascii(&tscanner, prefix);
   
   do
   {
@@ -20312,6 +20397,19 @@ my_strnxfrm_uca(const CHARSET_INFO *cs,
   int   s_res;
   my_uca_scanner scanner;
   scanner_handler->init(&scanner, cs, &cs->uca->level[0], src, srclen);
+
+  /* Leading run of fast path ASCII characters, typical for sort keys */
+  if (scanner.ascii_weights)
+  {
+    const uchar *s= scanner.sbeg;
+    for (; dst + 2 <= de && nweights && s < scanner.send && *s < 0x80 &&
+           (s_res= scanner.ascii_weights[*s]); s++, nweights--)
+    {
+      *dst++= s_res >> 8;
+      *dst++= s_res & 0xFF;
+    }
+    my_uca_scanner_skip_ascii(&scanner, s - scanner.sbeg);
+  }
   
   for (; dst < de && nweights &&
          (s_res= scanner_handler->next(&scanner)) > 0 ; nweights--)
@@ -22099,6 +22197,40 @@ ex:
 }
 
 
+/*
+  Build the weight table used by the scanner fast path
+  for U+0000..U+007F. Characters with more than one weight,
+  ignorable characters and characters taking part in contractions
+  get zero and go through the full scanner.
+*/
+
+static my_bool
+init_ascii_weights(MY_CHARSET_LOADER *loader, MY_UCA_WEIGHT_LEVEL *level)
+{
+  uint16 *ascii_weights;
+  uint length= level->lengths[0];
+  uint ch;
+
+  /* Default UCA levels are shared by many collations */
+  if (level->ascii_weights || !level->weights[0] || length < 2)
+    return FALSE;
+
+  if (!(ascii_weights= (uint16 *) (loader->once_alloc)(0x80 *
+                                                       sizeof(uint16))))
+    return TRUE;
+
+  for (ch= 0; ch < 0x80; ch++)
+  {
+    const uint16 *weight= level->weights[0] + ch * length;
+    my_bool contraction= my_uca_have_contractions_quick(level) &&
+                         level->contractions.flags[ch];
+    ascii_weights[ch]= (!contraction && !weight[1]) ? weight[0] : 0;
+  }
+  level->ascii_weights= ascii_weights;
+  return FALSE;
+}
+
+
 /*
   Universal CHARSET_INFO compatible wrappers
   for the above internal functions.
@@ -22112,7 +22244,9 @@ my_coll_init_uca(CHARSET_INFO *cs, MY_CHARSET_LOADER *loader)
   cs->ctype= my_charset_utf8_unicode_ci.ctype;
   if (!cs->caseinfo)
     cs->caseinfo= &my_unicase_default;
-  return create_tailoring(cs, loader);
+  if (create_tailoring(cs, loader))
+    return TRUE;
+  return cs->uca ? init_ascii_weights(loader, &cs->uca->level[0]) : FALSE;
 }
 
 static int my_strnncoll_any_uca(const CHARSET_INFO *cs,
@@ -5981,6 +5981,14 @@ my_well_formed_len_utf8(const CHARSET_INFO *cs, const char *b, const char *e,
   {
     int mb_len;
 
+    if (b < e && (uchar) *b < 0x80)
+    {
+      size_t n= my_ascii_prefix_len((const uchar*) b, (const uchar*)
+                                    (pos < (size_t) (e - b) ? b + pos : e));
+      b+= n;
+      pos-= n;
+      continue;
+    }
     if ((mb_len= my_valid_mbcharlen_utf8(cs, (uchar*) b, (uchar*) e)) <= 0)
     {
       *error= b < e ? 1 : 0;
@@ -8080,12 +8088,27 @@ my_caseup_utf8mb4(const CHARSET_INFO *cs, char *src, size_t srclen,
   int srcres, dstres;
   char *srcend= src + srclen, *dstend= dst + dstlen, *dst0= dst;
   const MY_UNICASE_INFO *uni_plane= cs->caseinfo;
+  const MY_UNICASE_CHARACTER *page0= uni_plane->page[0];
   assert(src != dst || cs->caseup_multiply == 1);
 
-  while ((src < srcend) &&
-         (srcres= my_mb_wc_utf8mb4(cs, &wc,
-                                   (uchar *) src, (uchar*) srcend)) > 0)
+  while (src < srcend)
   {
+    /*
+      ASCII fast path: skip the decode and encode steps when an ASCII
+      character maps to an ASCII character. This is not true for every
+      collation, e.g. 'i' is upper cased to U+0130 in Turkish.
+    */
+    if ((uchar) *src < 0x80 && page0 != NULL &&
+        page0[(uchar) *src].toupper < 0x80)
+    {
+      if (dst >= dstend)
+        break;
+      *dst++= (char) page0[(uchar) *src++].toupper;
+      continue;
+    }
+    if ((srcres= my_mb_wc_utf8mb4(cs, &wc,
+                                  (uchar *) src, (uchar*) srcend)) <= 0)
+      break;
     my_toupper_utf8mb4(uni_plane, &wc);
     if ((dstres= my_wc_mb_utf8mb4(cs, wc, (uchar*) dst, (uchar*) dstend)) <= 0)
       break;
@@ -8183,12 +8206,27 @@ my_casedn_utf8mb4(const CHARSET_INFO *cs,
   int srcres, dstres;
   char *srcend= src + srclen, *dstend= dst + dstlen, *dst0= dst;
   const MY_UNICASE_INFO *uni_plane= cs->caseinfo;
+  const MY_UNICASE_CHARACTER *page0= uni_plane->page[0];
   assert(src != dst || cs->casedn_multiply == 1);
 
-  while ((src < srcend) &&
-         (srcres= my_mb_wc_utf8mb4(cs, &wc,
-                                   (uchar*) src, (uchar*) srcend)) > 0)
+  while (src < srcend)
   {
+    /*
+      ASCII fast path: skip the decode and encode steps when an ASCII
+      character maps to an ASCII character. This is not true for every
+      collation, e.g. 'i' is upper cased to U+0130 in Turkish.
+    */
+    if ((uchar) *src < 0x80 && page0 != NULL &&
+        page0[(uchar) *src].tolower < 0x80)
+    {
+      if (dst >= dstend)
+        break;
+      *dst++= (char) page0[(uchar) *src++].tolower;
+      continue;
+    }
+    if ((srcres= my_mb_wc_utf8mb4(cs, &wc,
+                                  (uchar*) src, (uchar*) srcend)) <= 0)
+      break;
     my_tolower_utf8mb4(uni_plane, &wc);
     if ((dstres= my_wc_mb_utf8mb4(cs, wc, (uchar*) dst, (uchar*) dstend)) <= 0)
       break;
@@ -8535,6 +8573,14 @@ size_t my_well_formed_len_utf8mb4(const CHARSET_INFO *cs,
   {
     int mb_len;
 
+    if (b < e && (uchar) *b < 0x80)
+    {
+      size_t n= my_ascii_prefix_len((const uchar*) b, (const uchar*)
+                                    (pos < (size_t) (e - b) ? b + pos : e));
+      b+= n;
+      pos-= n;
+      continue;
+    }
     if ((mb_len= my_valid_mbcharlen_utf8mb4(cs, (uchar*) b, (uchar*) e)) <= 0)
     {
       *error= b < e ? 1 : 0;
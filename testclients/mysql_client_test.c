@@ -21186,6 +21186,78 @@ static void test_bug32391415()
   myquery2(mysql, rc);
 }
 
+#ifndef EMBEDDED_LIBRARY
+/* Value of Ssl_sessions_reused for the TLS connection of lmysql */
+static int tls_session_reused(MYSQL *lmysql)
+{
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  int rc, reused;
+
+  rc= mysql_query(lmysql, "SHOW SESSION STATUS LIKE 'Ssl_sessions_reused'");
+  myquery2(lmysql, rc);
+  res= mysql_store_result(lmysql);
+  DIE_UNLESS(res);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(row);
+  reused= atoi(row[1]);
+  mysql_free_result(res);
+  return reused;
+}
+
+/*
+  mysql_reconnect() resumes the TLS session of the lost connection: the
+  server reports SSL_session_reused() for the new connection.
+*/
+static void test_tls_session_resumption()
+{
+  MYSQL *lmysql;
+  enum mysql_ssl_mode ssl_mode= SSL_MODE_REQUIRED;
+  unsigned long thread_id;
+  char query[MAX_TEST_QUERY_LENGTH];
+  int rc;
+
+  myheader("test_tls_session_resumption");
+
+  lmysql= mysql_client_init(NULL);
+  DIE_UNLESS(lmysql != NULL);
+  mysql_options(lmysql, MYSQL_OPT_SSL_MODE, &ssl_mode);
+  if (!mysql_real_connect(lmysql, opt_host, opt_user, opt_password,
+                          current_db, opt_port, opt_unix_socket, 0))
+  {
+    if (!opt_silent)
+      fprintf(stdout, "Skipping test_tls_session_resumption: %s\n",
+              mysql_error(lmysql));
+    mysql_close(lmysql);
+    return;
+  }
+  lmysql->reconnect= 1;
+  DIE_UNLESS(tls_session_reused(lmysql) == 0);
+
+  /* Lose the connection, the next command reconnects */
+  thread_id= mysql_thread_id(lmysql);
+  sprintf(query, "KILL %lu", thread_id);
+  if (thread_query(query))
+    exit(1);
+  rc= mysql_ping(lmysql);
+  myquery2(lmysql, rc);
+  DIE_UNLESS(mysql_thread_id(lmysql) != thread_id);
+  DIE_UNLESS(tls_session_reused(lmysql) == 1);
+
+  /* The resumed connection hands a session on in turn */
+  thread_id= mysql_thread_id(lmysql);
+  sprintf(query, "KILL %lu", thread_id);
+  if (thread_query(query))
+    exit(1);
+  rc= mysql_ping(lmysql);
+  myquery2(lmysql, rc);
+  DIE_UNLESS(mysql_thread_id(lmysql) != thread_id);
+  DIE_UNLESS(tls_session_reused(lmysql) == 1);
+
+  mysql_close(lmysql);
+}
+#endif
+
 static struct my_tests_st my_tests[]= {
   { "disable_query_logs", disable_query_logs },
   { "test_view_sp_list_fields", test_view_sp_list_fields },
@@ -21480,6 +21552,9 @@ static struct my_tests_st my_tests[]= {
   { "test_bug25701141", test_bug25701141 },
   { "test_bug27443252", test_bug27443252 },
   { "test_bug32391415", test_bug32391415 },
+#ifndef EMBEDDED_LIBRARY
+  { "test_tls_session_resumption", test_tls_session_resumption },
+#endif
   { 0, 0 }
 };
 
@@ -0,0 +1,142 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the audit log ring buffer: concurrent writers must
+  produce a stream without gaps, with every record whole and the
+  records of each writer in the order it wrote them.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_thread.h>
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../plugin/audit_log/buffer.c"
+#undef min
+
+PSI_memory_key key_memory_audit_log_buffer= PSI_NOT_INSTRUMENTED;
+int64 audit_log_buffer_size_overflow= 0;
+
+namespace audit_log_buffer_unittest {
+
+const int num_threads= 8;
+const int num_records= 5000;
+
+/* Only the flush worker writes, one call at a time */
+std::string flushed;
+
+extern "C" int collect_flushed(void *data MY_ATTRIBUTE((unused)),
+                               const char *buf, size_t len,
+                               log_record_state_t state
+                               MY_ATTRIBUTE((unused)))
+{
+  flushed.append(buf, len);
+  return 0;
+}
+
+struct Thread_arg
+{
+  audit_log_buffer_t *log;
+  int writer;
+};
+
+/* Records of varying length, "<writer> <sequence> <padding>\n" */
+extern "C" void *write_records(void *arg)
+{
+  Thread_arg *targ= static_cast<Thread_arg*>(arg);
+  char record[128];
+
+  my_thread_init();
+  for (int i= 0; i < num_records; i++)
+  {
+    int len= snprintf(record, sizeof(record), "%d %d %.*s\n",
+                      targ->writer, i, (i * 7) % 60,
+                      "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+    audit_log_buffer_write(targ->log, record, len);
+  }
+  my_thread_end();
+  return NULL;
+}
+
+void check_stream(size_t buffer_size)
+{
+  my_thread_handle threads[num_threads];
+  Thread_arg args[num_threads];
+  my_thread_attr_t attr;
+
+  flushed.clear();
+  audit_log_buffer_t *log= audit_log_buffer_init(buffer_size, 0,
+                                                 collect_flushed, NULL);
+  ASSERT_TRUE(log != NULL);
+
+  my_thread_attr_init(&attr);
+  for (int i= 0; i < num_threads; i++)
+  {
+    args[i].log= log;
+    args[i].writer= i;
+    ASSERT_EQ(0, my_thread_create(&threads[i], &attr, write_records,
+                                  &args[i]));
+  }
+  for (int i= 0; i < num_threads; i++)
+    my_thread_join(&threads[i], NULL);
+  my_thread_attr_destroy(&attr);
+
+  // Flushes everything committed before the worker stops
+  audit_log_buffer_shutdown(log);
+
+  std::vector<int> next(num_threads, 0);
+  size_t start= 0, end;
+  int records= 0;
+  while ((end= flushed.find('\n', start)) != std::string::npos)
+  {
+    int writer, seq, padding;
+    std::string line(flushed, start, end - start);
+    ASSERT_EQ(2, sscanf(line.c_str(), "%d %d", &writer, &seq)) << line;
+    ASSERT_TRUE(writer >= 0 && writer < num_threads) << line;
+    EXPECT_EQ(next[writer], seq) << line;
+    padding= (int) line.size() - (int) line.find(' ', line.find(' ') + 1) - 1;
+    EXPECT_EQ((seq * 7) % 60, padding) << line;
+    next[writer]= seq + 1;
+    records++;
+    start= end + 1;
+  }
+  EXPECT_EQ(flushed.size(), start);
+  EXPECT_EQ(num_threads * num_records, records);
+}
+
+TEST(AuditLogBuffer, ConcurrentWritersLargeBuffer)
+{
+  check_stream(1024 * 1024);
+}
+
+TEST(AuditLogBuffer, ConcurrentWritersWrapAround)
+{
+  // Much smaller than the data: writers wait for space and records wrap
+  check_stream(4096);
+}
+
+}
@@ -0,0 +1,401 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the parallel parsing of LOAD DATA INFILE: the fields
+  replayed from the parser threads must be those READ_INFO reads by
+  itself, whatever the chunk boundaries cut, including enclosed and
+  escaped terminators which make the parsers guess the first line of a
+  chunk wrong.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include <fcntl.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../sql/sql_load.cc"
+#undef GET
+#undef PUSH
+
+namespace load_data_parallel_unittest {
+
+using my_testing::Server_initializer;
+using my_testing::Mock_error_handler;
+
+/* FIELDS TERMINATED BY, LINES TERMINATED BY, ENCLOSED BY, ESCAPED BY */
+struct Format
+{
+  const char *field_term;
+  const char *line_term;
+  const char *enclosed;
+  const char *escape;
+};
+
+const Format csv_format= { ",", "\n", "\"", "\\" };
+const Format multi_byte_format= { "||", "\r\n", "'", "" };
+
+const uint num_fields= 3;
+/* Smaller than many fields, for the READ_INFO buffers to grow */
+const uint tot_length= 16;
+
+class Random
+{
+public:
+  explicit Random(uint32 seed) : m_state(seed) {}
+  uint operator()(uint n)
+  {
+    m_state= m_state * 1103515245U + 12345U;
+    return (m_state >> 8) % n;
+  }
+private:
+  uint32 m_state;
+};
+
+
+class LoadDataParallelTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    initializer.SetUp();
+    m_max_threads= load_data_parallel_max_threads;
+    load_data_parallel_max_threads= 64;
+    m_file= -1;
+  }
+
+  virtual void TearDown()
+  {
+    close_file();
+    load_data_parallel_max_threads= m_max_threads;
+    initializer.TearDown();
+  }
+
+  THD *thd() { return initializer.thd(); }
+
+  void write_file(const std::string &data)
+  {
+    close_file();
+    m_data= data;
+    m_file= create_temp_file(m_name, NULL, "ld", O_CREAT | O_EXCL | O_RDWR,
+                             MYF(MY_WME));
+    ASSERT_LE(0, m_file);
+    ASSERT_EQ(0U, my_pwrite(m_file, (const uchar*) data.data(), data.size(),
+                            0, MYF(MY_NABP)));
+  }
+
+  void close_file()
+  {
+    if (m_file >= 0)
+    {
+      my_close(m_file, MYF(0));
+      my_delete(m_name, MYF(0));
+      m_file= -1;
+    }
+  }
+
+  /*
+    Lines of num_fields fields give or take one: plain fields, NULLs,
+    enclosed fields holding terminators and enclosing characters, some
+    of them spanning many line terminators, and escaped terminators.
+  */
+  static std::string make_lines(const Format &format, uint lines,
+                                uint32 seed)
+  {
+    const std::string field_term(format.field_term);
+    const std::string line_term(format.line_term);
+    const std::string enclosed(format.enclosed);
+    const std::string escape(format.escape);
+    Random random(seed);
+    std::string data;
+
+    for (uint i= 0; i < lines; i++)
+    {
+      const uint fields= num_fields - 1 + random(3);
+      for (uint j= 0; j < fields; j++)
+      {
+        if (j)
+          data+= field_term;
+        switch (random(escape.empty() ? 3 : 6)) {
+        case 0:
+          data.append(random(40), static_cast<char>('a' + random(26)));
+          break;
+        case 1:
+          data+= enclosed;
+          for (uint k= random(100) + 1; k > 0; k--)
+            data+= "x" + line_term;
+          data+= enclosed;
+          break;
+        case 2:
+          data+= enclosed;
+          for (uint k= random(10) + 1; k > 0; k--)
+            data+= (random(2) ? line_term : field_term) + enclosed +
+              enclosed + "y";
+          data+= enclosed;
+          break;
+        case 3:
+          data+= escape + "N";
+          break;
+        case 4:
+          data+= "z" + escape + line_term + escape + field_term + escape +
+            escape + escape + enclosed;
+          break;
+        case 5:
+          data+= enclosed + escape + enclosed + line_term + escape +
+            line_term + enclosed;
+          break;
+        }
+      }
+      /* The last line may end without a line terminator */
+      if (i + 1 < lines || random(2))
+        data+= line_term;
+    }
+    return data;
+  }
+
+  /* Any mix of the terminators, enclosing and escape characters */
+  static std::string make_garbage(const Format &format, size_t length,
+                                  uint32 seed)
+  {
+    const std::string alphabet= std::string("ab") + format.field_term +
+      format.line_term + format.enclosed + format.escape;
+    Random random(seed);
+    std::string data;
+
+    for (size_t i= 0; i < length; i++)
+      data+= alphabet[random(static_cast<uint>(alphabet.size()))];
+    return data;
+  }
+
+  /*
+    Read the file the way read_sep_field() does, with the given number
+    of parser threads or none, and describe every call and its outcome.
+    A read without parser threads saves the offsets at which the lines
+    start in m_line_starts.
+  */
+  std::string parse(const Format &format, uint threads, my_off_t chunk_size)
+  {
+    const String field_term(format.field_term, &my_charset_bin);
+    const String line_start("", &my_charset_bin);
+    const String line_term(format.line_term, &my_charset_bin);
+    const String enclosed(format.enclosed, &my_charset_bin);
+    const int escape= *format.escape ? (uchar) format.escape[0] : INT_MAX;
+    READ_INFO info(m_file, tot_length, &my_charset_latin1, field_term,
+                   line_start, line_term, enclosed, escape, false, false);
+    Load_data_parallel parallel;
+    std::string out;
+
+    EXPECT_FALSE(info.error);
+    if (threads == 0)
+      m_line_starts.assign(1, 0);
+    else if (parallel.start(m_file, threads, num_fields, 0, m_data.size(),
+                            chunk_size, tot_length, &my_charset_latin1,
+                            field_term, line_term, enclosed, escape))
+    {
+      ADD_FAILURE() << "no parser threads";
+      return out;
+    }
+    else
+      info.set_parallel(&parallel);
+
+    for (;;)
+    {
+      uint i;
+      for (i= 0; i < num_fields; i++)
+      {
+        if (info.read_field())
+          break;
+        out+= info.enclosed ? "[E:" : info.found_null ? "[N:" : "[";
+        out.append((const char*) info.row_start,
+                   info.row_end - info.row_start);
+        out+= "]";
+      }
+      if (info.error)
+      {
+        out+= "<error>";
+        break;
+      }
+      if (i < num_fields)
+      {
+        if (i == 0)
+          break;
+        out+= "<short>";
+      }
+      const int res= info.next_line();
+      if (info.line_cuted)
+        out+= "<cut>";
+      out+= "\n";
+      if (res)
+        break;
+      if (threads == 0)
+        m_line_starts.push_back(info.position());
+    }
+
+    info.set_parallel(NULL);
+    parallel.end();
+    return out;
+  }
+
+  /*
+    Number of chunk boundaries after which the first line terminator
+    does not end a line, so that the parser of the chunk guesses its
+    first line wrong. Needs m_line_starts.
+  */
+  uint wrong_guesses(const Format &format, my_off_t chunk_size)
+  {
+    const std::string line_term(format.line_term);
+    uint wrong= 0;
+
+    for (size_t pos= chunk_size; pos < m_data.size(); pos+= chunk_size)
+    {
+      size_t guess= m_data.find(line_term, pos - min<size_t>(
+                                  pos, line_term.size()));
+      std::vector<my_off_t>::const_iterator line=
+        std::lower_bound(m_line_starts.begin(), m_line_starts.end(), pos);
+      if (line == m_line_starts.end() || guess == std::string::npos)
+        break;
+      if (guess + line_term.size() != *line)
+        wrong++;
+    }
+    return wrong;
+  }
+
+  /*
+    Check that the parser threads give what a serial read gives, for
+    any number of threads and chunk size.
+
+    @return the number of wrong guesses of the first line of a chunk
+  */
+  uint check_parse(const Format &format, const std::string &data)
+  {
+    static const uint threads[]= { 1, 2, 4 };
+    static const my_off_t chunk_sizes[]= { 1, 7, 61, 256, 4096 };
+    uint wrong= 0;
+
+    write_file(data);
+    const std::string expected= parse(format, 0, 0);
+    for (uint j= 0; j < array_elements(chunk_sizes); j++)
+    {
+      wrong+= wrong_guesses(format, chunk_sizes[j]);
+      for (uint i= 0; i < array_elements(threads); i++)
+      {
+        EXPECT_EQ(expected, parse(format, threads[i], chunk_sizes[j]))
+          << threads[i] << " threads, chunks of " << chunk_sizes[j];
+      }
+    }
+    return wrong;
+  }
+
+  Server_initializer initializer;
+  ulong m_max_threads;
+  char m_name[FN_REFLEN];
+  File m_file;
+  std::string m_data;
+  std::vector<my_off_t> m_line_starts;
+};
+
+
+TEST_F(LoadDataParallelTest, EnclosedAndEscapedTerminators)
+{
+  // Chunk boundaries inside enclosed fields make wrong guesses
+  EXPECT_LT(0U, check_parse(csv_format, make_lines(csv_format, 300, 1)));
+  // One line over many chunks
+  check_parse(csv_format, make_lines(csv_format, 1, 2));
+}
+
+
+TEST_F(LoadDataParallelTest, MultiByteTerminators)
+{
+  // Boundaries also cut the terminators, without an escape character
+  EXPECT_LT(0U, check_parse(multi_byte_format,
+                            make_lines(multi_byte_format, 300, 3)));
+}
+
+
+TEST_F(LoadDataParallelTest, AnyInput)
+{
+  for (uint32 seed= 1; seed <= 4; seed++)
+  {
+    check_parse(csv_format, make_garbage(csv_format, 3000, seed));
+    check_parse(multi_byte_format,
+                make_garbage(multi_byte_format, 3000, seed));
+  }
+}
+
+
+TEST_F(LoadDataParallelTest, MaxThreads)
+{
+  const String field_term(csv_format.field_term, &my_charset_bin);
+  const String line_term(csv_format.line_term, &my_charset_bin);
+  const String enclosed(csv_format.enclosed, &my_charset_bin);
+  Load_data_parallel first, second;
+
+  write_file(make_lines(csv_format, 100, 4));
+  load_data_parallel_max_threads= 0;
+  EXPECT_TRUE(first.start(m_file, 2, num_fields, 0, m_data.size(), 61,
+                          tot_length, &my_charset_latin1, field_term,
+                          line_term, enclosed, '\\'));
+
+  // The first statement takes all the threads, the second gets none
+  load_data_parallel_max_threads= 2;
+  EXPECT_FALSE(first.start(m_file, 4, num_fields, 0, m_data.size(), 61,
+                           tot_length, &my_charset_latin1, field_term,
+                           line_term, enclosed, '\\'));
+  EXPECT_TRUE(second.start(m_file, 1, num_fields, 0, m_data.size(), 61,
+                           tot_length, &my_charset_latin1, field_term,
+                           line_term, enclosed, '\\'));
+  first.end();
+  EXPECT_FALSE(second.start(m_file, 1, num_fields, 0, m_data.size(), 61,
+                            tot_length, &my_charset_latin1, field_term,
+                            line_term, enclosed, '\\'));
+  second.end();
+}
+
+
+#ifndef NDEBUG
+TEST_F(LoadDataParallelTest, ParserOutOfMemory)
+{
+  // Parser threads use the initial settings
+  DBUG_SET_INITIAL("+d,load_data_parser_oom");
+  // Every chunk is parsed again by the statement thread
+  check_parse(csv_format, make_lines(csv_format, 100, 5));
+  DBUG_SET_INITIAL("-d,load_data_parser_oom");
+}
+
+
+TEST_F(LoadDataParallelTest, ReparseOutOfMemory)
+{
+  write_file(make_lines(csv_format, 100, 6));
+  DBUG_SET_INITIAL("+d,load_data_parser_oom");
+  DBUG_SET("+d,load_data_reparse_oom");
+  {
+    Mock_error_handler error_handler(thd(), ER_OUTOFMEMORY);
+    EXPECT_EQ("<error>", parse(csv_format, 2, 61));
+  }
+  DBUG_SET("-d,load_data_reparse_oom");
+  DBUG_SET_INITIAL("-d,load_data_parser_oom");
+}
+#endif
+
+}
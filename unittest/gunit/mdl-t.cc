@@ -2857,6 +2857,73 @@ TEST_F(MDLTest, UnusedConcurrentThree)
 }
 
 
+/**
+  Check that "fast path" locks taken through MDL_context's cache of
+  MDL_lock objects land on the right object, also after the cached
+  object was freed and reused for another key, and that they respect
+  "obtrusive" locks held by other contexts.
+*/
+
+TEST_F(MDLTest, CachedFastPath)
+{
+  Notification lock_grabbed;
+  Notification release_locks;
+  MDL_thread mdl_thread(table_name1, MDL_EXCLUSIVE, &lock_grabbed,
+                        &release_locks, NULL, NULL);
+
+  /* Free unused objects at once, so that they get reused. */
+  mdl_locks_unused_locks_low_water= 0;
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED_WRITE,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_NE(m_null_ticket, m_request.ticket);
+  m_mdl_context.release_transactional_locks();
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name2, MDL_SHARED_WRITE,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_NE(m_null_ticket, m_request.ticket);
+  m_mdl_context.release_transactional_locks();
+  EXPECT_EQ(0, mdl_get_unused_locks_count());
+
+  /* Keep unused objects around from now on, so that cache hits happen. */
+  mdl_locks_unused_locks_low_water= MDL_LOCKS_UNUSED_LOCKS_LOW_WATER_DEFAULT;
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED_WRITE,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_NE(m_null_ticket, m_request.ticket);
+  EXPECT_TRUE(m_mdl_context.owns_equal_or_stronger_lock(MDL_key::TABLE,
+                                                        db_name, table_name1,
+                                                        MDL_SHARED_WRITE));
+  m_mdl_context.release_transactional_locks();
+  EXPECT_EQ(1, mdl_get_unused_locks_count());
+
+  /* The cached object is locked exclusively by another context. */
+  mdl_thread.start();
+  lock_grabbed.wait_for_notification();
+
+  MDL_REQUEST_INIT(&m_request,
+                   MDL_key::TABLE, db_name, table_name1, MDL_SHARED_WRITE,
+                   MDL_TRANSACTION);
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_EQ(m_null_ticket, m_request.ticket);
+
+  release_locks.notify();
+  mdl_thread.join();
+
+  EXPECT_FALSE(m_mdl_context.try_acquire_lock(&m_request));
+  EXPECT_NE(m_null_ticket, m_request.ticket);
+  m_mdl_context.release_transactional_locks();
+  EXPECT_EQ(1, mdl_get_unused_locks_count());
+}
+
+
 /**
   Finally test which involves many threads using, unusing and
   freeing MDL_lock objects.
@@ -23,6 +23,8 @@
 #include "m_string.h"
 #include "my_sys.h"
 
+#include <algorithm>
+
 namespace mf_iocache_unittest {
 
 static const size_t CACHE_SIZE= 16384;
@@ -145,4 +147,223 @@ TEST_P(IOCacheTest, MDEV9044)
 
 #endif
 
+/*
+  Read-ahead (use_async_io) tests. In order to do benchmarking,
+  configure in optimized mode, generate a separate executable for
+  this file:
+    cmake -DMERGE_UNITTESTS=0
+  and raise num_iterations below.
+*/
+
+#if !defined(NDEBUG)
+// There is no point in benchmarking anything in debug mode.
+static const int num_iterations= 1;
+#else
+// Set this so that each test case takes a few seconds.
+// And set it back to a small value before pushing!!
+// static const int num_iterations= 200;
+static const int num_iterations= 1;
+#endif
+
+class IOCacheAsyncTest: public ::testing::Test
+{
+protected:
+  static uchar pattern(my_off_t pos)
+  {
+    return static_cast<uchar>((pos * 7 + (pos >> 11)) & 0xFF);
+  }
+
+  static bool data_bad(const uchar *buf, size_t len, my_off_t pos)
+  {
+    for (size_t i= 0; i < len; i++)
+      if (buf[i] != pattern(pos + i))
+        return true;
+    return false;
+  }
+
+  virtual void SetUp()
+  {
+    init_io_cache_encryption(false);
+    m_random_state= 1;
+  }
+
+  uint next_random()
+  {
+    m_random_state= m_random_state * 1103515245U + 12345U;
+    return (m_random_state >> 16) & 0x7FFF;
+  }
+
+  /* Write file_size bytes of the pattern to a new temporary file */
+  void write_file(IO_CACHE *info, size_t cache_size, my_off_t file_size)
+  {
+    uchar buf[1000];
+    int res= open_cached_file(info, 0, 0, cache_size, 0);
+    ASSERT_EQ(0, res) << "open_cached_file";
+    for (my_off_t pos= 0; pos < file_size; pos+= sizeof(buf))
+    {
+      size_t len= static_cast<size_t>(std::min<my_off_t>(sizeof(buf),
+                                                         file_size - pos));
+      for (size_t i= 0; i < len; i++)
+        buf[i]= pattern(pos + i);
+      ASSERT_EQ(0, my_b_write(info, buf, len));
+    }
+  }
+
+  uint m_random_state;
+};
+
+TEST_F(IOCacheAsyncTest, SequentialRead)
+{
+  IO_CACHE info;
+  const my_off_t file_size= 40 * CACHE_SIZE + 123;
+  uchar buf[3 * CACHE_SIZE];
+  my_off_t pos= 0;
+  int res;
+
+  write_file(&info, CACHE_SIZE, file_size);
+  res= reinit_io_cache(&info, READ_CACHE, 0, 1, 0);
+  EXPECT_EQ(0, res) << "reinit READ_CACHE with read-ahead" << INFO_TAIL;
+  EXPECT_TRUE(info.aio != NULL);
+
+  /* Small and large reads, some of more than a buffer */
+  while (pos < file_size)
+  {
+    size_t len= next_random() % 4 ? next_random() % 3000 + 1 :
+                                    next_random() % sizeof(buf) + 1;
+    if (pos + len > file_size)
+      break;
+    res= my_b_read(&info, buf, len);
+    ASSERT_EQ(0, res) << "read " << len << " at " << pos << INFO_TAIL;
+    ASSERT_FALSE(data_bad(buf, len, pos)) << "data at " << pos;
+    pos+= len;
+    EXPECT_EQ(pos, my_b_tell(&info));
+  }
+
+  /* A read across the end of file returns what there is */
+  size_t rest= static_cast<size_t>(file_size - pos);
+  res= my_b_read(&info, buf, rest + 10);
+  EXPECT_EQ(1, res) << "read past end of file" << INFO_TAIL;
+  EXPECT_EQ(static_cast<int>(rest), info.error);
+  EXPECT_FALSE(data_bad(buf, rest, pos));
+
+  close_cached_file(&info);
+}
+
+TEST_F(IOCacheAsyncTest, SeekAndReinit)
+{
+  IO_CACHE info;
+  const my_off_t file_size= 20 * CACHE_SIZE;
+  uchar buf[CACHE_SIZE];
+  int res;
+
+  write_file(&info, CACHE_SIZE, file_size);
+  res= reinit_io_cache(&info, READ_CACHE, 0, 1, 0);
+  EXPECT_EQ(0, res) << "reinit READ_CACHE with read-ahead" << INFO_TAIL;
+
+  /* Random seeks discard the block read ahead */
+  for (int i= 0; i < 500; i++)
+  {
+    my_off_t pos= next_random() * 37 % (file_size - sizeof(buf));
+    size_t len= next_random() % sizeof(buf) + 1;
+    my_b_seek(&info, pos);
+    res= my_b_read(&info, buf, len);
+    ASSERT_EQ(0, res) << "read " << len << " at " << pos << INFO_TAIL;
+    ASSERT_FALSE(data_bad(buf, len, pos)) << "data at " << pos;
+    /* And go on sequentially for a while */
+    res= my_b_read(&info, buf, 100);
+    ASSERT_EQ(0, res) << INFO_TAIL;
+    ASSERT_FALSE(data_bad(buf, 100, pos + len));
+  }
+
+  /* Overwrite the start of the file, read-ahead must not return old data */
+  res= reinit_io_cache(&info, WRITE_CACHE, 0, 0, 1);
+  EXPECT_EQ(0, res) << "reinit WRITE_CACHE" << INFO_TAIL;
+  memset(buf, 0xA5, sizeof(buf));
+  EXPECT_EQ(0, my_b_write(&info, buf, sizeof(buf)));
+  EXPECT_EQ(0, my_b_flush_io_cache(&info, 1));
+
+  res= reinit_io_cache(&info, READ_CACHE, 0, 1, 1);
+  EXPECT_EQ(0, res) << "reinit READ_CACHE" << INFO_TAIL;
+  EXPECT_TRUE(info.aio != NULL);
+  memset(buf, 0, sizeof(buf));
+  res= my_b_read(&info, buf, sizeof(buf));
+  EXPECT_EQ(0, res) << INFO_TAIL;
+  for (size_t i= 0; i < sizeof(buf); i++)
+    ASSERT_EQ(0xA5, buf[i]) << "at " << i;
+
+  close_cached_file(&info);
+}
+
+TEST_F(IOCacheAsyncTest, GetAndFill)
+{
+  IO_CACHE info;
+  const my_off_t file_size= 10 * CACHE_SIZE + 5;
+  my_off_t pos= 0;
+  int res;
+
+  write_file(&info, CACHE_SIZE, file_size);
+  res= reinit_io_cache(&info, READ_CACHE, 0, 1, 0);
+  EXPECT_EQ(0, res) << INFO_TAIL;
+
+  for (; pos < file_size / 2; pos++)
+    ASSERT_EQ(pattern(pos), my_b_get(&info)) << "at " << pos;
+  pos+= my_b_bytes_in_cache(&info);
+  info.read_pos= info.read_end;
+
+  size_t length;
+  while ((length= my_b_fill(&info)))
+  {
+    EXPECT_FALSE(data_bad(info.read_pos, length, pos)) << "fill at " << pos;
+    pos+= length;
+    info.read_pos= info.read_end;
+  }
+  EXPECT_EQ(file_size, pos);
+  EXPECT_EQ(my_b_EOF, my_b_get(&info));
+
+  close_cached_file(&info);
+}
+
+/*
+  Sequential read of a file, with some work on every byte,
+  so that the consumer and the I/O can overlap.
+*/
+static void bench_read(bool use_async_io)
+{
+  IO_CACHE info;
+  const size_t cache_size= 128 * 1024;
+  const my_off_t file_size= 64 * cache_size;
+  uchar buf[1024];
+  int res;
+
+  memset(buf, 1, sizeof(buf));
+  res= open_cached_file(&info, 0, 0, cache_size, 0);
+  ASSERT_EQ(0, res);
+  for (my_off_t pos= 0; pos < file_size; pos+= sizeof(buf))
+    ASSERT_EQ(0, my_b_write(&info, buf, sizeof(buf)));
+
+  for (int i= 0; i < num_iterations; i++)
+  {
+    ulonglong sum= 0;
+    res= reinit_io_cache(&info, READ_CACHE, 0, use_async_io, 0);
+    ASSERT_EQ(0, res);
+    while (my_b_read(&info, buf, sizeof(buf)) == 0)
+    {
+      for (size_t j= 0; j < sizeof(buf); j++)
+        sum= sum * 31 + buf[j];
+    }
+    EXPECT_NE(0U, sum);
+  }
+  close_cached_file(&info);
+}
+
+TEST_F(IOCacheAsyncTest, BenchSyncRead)
+{
+  bench_read(false);
+}
+
+TEST_F(IOCacheAsyncTest, BenchAsyncRead)
+{
+  bench_read(true);
+}
+
 } // namespace mf_iocache_unittest
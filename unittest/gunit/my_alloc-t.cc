@@ -162,6 +162,40 @@ TEST_F(MyAllocTest, CheckErrorReporting)
   EXPECT_EQ(1, error_handler.handle_called());
 }
 
+TEST_F(MyAllocTest, RecycleBlocks)
+{
+  // Recycling is disabled for valgrind and ASAN, like preallocation
+#if !defined(HAVE_VALGRIND) && !defined(HAVE_ASAN)
+  set_memroot_recycle_limit(&m_root, 64 * 1024);
+  for (size_t objcount= 0; objcount < 100; ++objcount)
+    EXPECT_TRUE(alloc_root(&m_root, 100));
+  const size_t allocated= m_root.allocated_size;
+
+  // Everything is below the limit, so all blocks are kept
+  free_root(&m_root, MY_KEEP_PREALLOC);
+  EXPECT_EQ(allocated, m_root.allocated_size);
+
+  // A smaller round of allocations is served from the kept blocks
+  for (size_t objcount= 0; objcount < 50; ++objcount)
+    EXPECT_TRUE(alloc_root(&m_root, 100));
+  EXPECT_EQ(allocated, m_root.allocated_size);
+
+  // Without a limit only the (absent) prealloc block survives
+  set_memroot_recycle_limit(&m_root, 0);
+  free_root(&m_root, MY_KEEP_PREALLOC);
+  EXPECT_EQ(0U, m_root.allocated_size);
+#endif
+}
+
+TEST_F(MyAllocTest, ClaimBlocks)
+{
+  // Blocks of any size come from my_malloc() or the pool
+  EXPECT_TRUE(alloc_root(&m_root, 100));
+  EXPECT_TRUE(alloc_root(&m_root, 4 * 1024 * 1024));
+  claim_root(&m_root);
+  free_root(&m_root, MYF(0));
+}
+
 TEST_F(MyPreAllocTest, PreAlloc)
 {
   // PREALLOCATE_MEMORY_CHUNKS is not defined for valgrind and ASAN
@@ -0,0 +1,332 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the offset index files of mysqlbinlog, and for the
+  planning of the parallel decoding of binlog files from the indexes:
+  which segments --start-position, --stop-position, --start-datetime,
+  --stop-datetime, --include-gtids and --exclude-gtids leave out.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../client/mysqlbinlog_index.cc"
+
+namespace mysqlbinlog_index_unittest {
+
+const char *uuid= "aaaaaaaa-aaaa-aaaa-aaaa-aaaaaaaaaaaa";
+const char *other_uuid= "bbbbbbbb-bbbb-bbbb-bbbb-bbbbbbbbbbbb";
+
+const uint num_logs= 3;
+const uint num_segments= 3;
+const my_off_t segment_size= 1000;
+
+bool operator==(const Binlog_segment &a, const Binlog_segment &b)
+{
+  return (a.start == b.start && a.end == b.end && a.max_when == b.max_when &&
+          a.gtid_only == b.gtid_only && a.gtids == b.gtids);
+}
+
+std::string gtid_text(const char *sid, const char *gnos)
+{
+  return std::string(sid) + ":" + gnos;
+}
+
+
+class MysqlbinlogIndexTest : public ::testing::Test
+{
+protected:
+  MysqlbinlogIndexTest()
+    : m_sid_map(NULL), m_include(&m_sid_map), m_exclude(&m_sid_map)
+  {}
+
+  virtual void SetUp()
+  {
+    m_filter.start_position= BIN_LOG_HEADER_SIZE;
+    m_filter.stop_position= ~(my_off_t)0;
+    m_filter.start_datetime= 0;
+    m_filter.stop_datetime= MY_TIME_T_MAX;
+    m_filter.filter_server_id= false;
+    m_filter.include_gtids= NULL;
+    m_filter.exclude_gtids= NULL;
+
+    /*
+      Logs of segments of one transaction each, which is GTID
+      3 * log + segment + 1, at second 100 + 10 * log + segment.
+    */
+    m_indexes.resize(num_logs);
+    for (uint l= 0; l < num_logs; l++)
+    {
+      Binlog_index &index= m_indexes[l];
+      index.file_size= num_segments * segment_size;
+      index.created= 100 + 10 * l;
+      index.relay_log= false;
+      index.segments.resize(num_segments);
+      for (uint s= 0; s < num_segments; s++)
+      {
+        std::ostringstream gno;
+        gno << 3 * l + s + 1;
+        Binlog_segment &segment= index.segments[s];
+        segment.start= s ? s * segment_size : BIN_LOG_HEADER_SIZE;
+        segment.end= (s + 1) * segment_size;
+        segment.max_when= 100 + 10 * l + s;
+        segment.gtid_only= true;
+        segment.gtids= gtid_text(uuid, gno.str().c_str());
+      }
+    }
+  }
+
+  /*
+    Describe the ranges planned for m_indexes as "log:start-end", end
+    being * for the last segment of a log, followed by F for the first
+    range of a log.
+  */
+  std::string plan()
+  {
+    std::string out;
+
+    m_ranges.clear();
+    plan_binlog_segments(m_indexes, m_filter, &m_ranges);
+    for (size_t i= 0; i < m_ranges.size(); i++)
+    {
+      const Binlog_segment_range &range= m_ranges[i];
+      std::ostringstream str;
+      str << (i ? " " : "") << range.log_number << ":" << range.start_position
+          << "-";
+      if (range.end_position == ~(my_off_t)0)
+        str << "*";
+      else
+        str << range.end_position;
+      if (range.print_fd)
+        str << "F";
+      out+= str.str();
+
+      EXPECT_EQ(i + 1 < m_ranges.size(), range.flush_head) << i;
+      EXPECT_EQ(range.log_number == num_logs - 1 ?
+                m_filter.stop_position : ~(my_off_t)0,
+                range.stop_position) << i;
+    }
+    return out;
+  }
+
+  void set_gtids(Gtid_set *set, const Gtid_set **filter_set,
+                 const std::string &text)
+  {
+    set->clear();
+    ASSERT_EQ(RETURN_STATUS_OK, set->add_gtid_text(text.c_str()));
+    *filter_set= set;
+  }
+
+  Sid_map m_sid_map;
+  Gtid_set m_include;
+  Gtid_set m_exclude;
+  Binlog_segment_filter m_filter;
+  std::vector<Binlog_index> m_indexes;
+  std::vector<Binlog_segment_range> m_ranges;
+};
+
+
+TEST_F(MysqlbinlogIndexTest, WriteRead)
+{
+  Binlog_index index= m_indexes[1];
+  Binlog_index read;
+  std::string long_gtids= uuid;
+
+  // Not in the GTID sets, and with lines longer than the read buffer
+  index.segments[1].gtid_only= false;
+  index.segments[1].gtids.clear();
+  index.segments[2].max_when= MY_TIME_T_MAX;
+  for (int gno= 1; gno < 2000; gno+= 2)
+  {
+    std::ostringstream str;
+    str << ":" << gno;
+    long_gtids+= str.str();
+  }
+  index.segments[2].gtids= long_gtids + "," + gtid_text(other_uuid, "1-5");
+  index.relay_log= true;
+
+  FILE *file= tmpfile();
+  ASSERT_TRUE(file != NULL);
+  EXPECT_FALSE(write_binlog_index(file, &index));
+
+  rewind(file);
+  read.file_size= index.file_size;
+  read.created= index.created;
+  EXPECT_FALSE(read_binlog_index(file, &read));
+  EXPECT_TRUE(read.relay_log);
+  ASSERT_EQ(index.segments.size(), read.segments.size());
+  for (size_t i= 0; i < index.segments.size(); i++)
+    EXPECT_TRUE(index.segments[i] == read.segments[i]) << i;
+
+  // The index of another version of the binlog file
+  rewind(file);
+  read.file_size= index.file_size + 1;
+  EXPECT_TRUE(read_binlog_index(file, &read));
+  rewind(file);
+  read.file_size= index.file_size;
+  read.created= index.created + 1;
+  EXPECT_TRUE(read_binlog_index(file, &read));
+  fclose(file);
+}
+
+
+TEST_F(MysqlbinlogIndexTest, ReadInvalid)
+{
+  static const char *contents[]=
+  {
+    "",
+    "# mysqlbinlog offset index 2\n3000 110 0\n4 1000 110 1 -\n",
+    "# mysqlbinlog offset index 1\n3000 110\n4 1000 110 1 -\n",
+    // No segment
+    "# mysqlbinlog offset index 1\n3000 110 0\n",
+    "# mysqlbinlog offset index 1\n3000 110 0\n4 1000 110 1 -\n4 1000\n"
+  };
+  Binlog_index index;
+
+  for (uint i= 0; i < array_elements(contents); i++)
+  {
+    FILE *file= tmpfile();
+    ASSERT_TRUE(file != NULL);
+    fputs(contents[i], file);
+    rewind(file);
+    index.file_size= 3000;
+    index.created= 110;
+    EXPECT_TRUE(read_binlog_index(file, &index)) << i;
+    fclose(file);
+  }
+}
+
+
+TEST_F(MysqlbinlogIndexTest, WholeLogs)
+{
+  EXPECT_EQ("0:4-1000F 0:1000-2000 0:2000-* "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+  for (size_t i= 0; i < m_ranges.size(); i++)
+    EXPECT_EQ(0, m_ranges[i].start_datetime) << i;
+}
+
+
+TEST_F(MysqlbinlogIndexTest, Positions)
+{
+  // Segments starting at or after --stop-position are left out
+  m_filter.stop_position= 1500;
+  EXPECT_EQ("0:4-1000F 0:1000-2000 0:2000-* "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000", plan());
+  m_filter.stop_position= 1000;
+  EXPECT_EQ("0:4-1000F 0:1000-2000 0:2000-* "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F", plan());
+
+  // --start-position may be inside a segment of the first log
+  m_filter.stop_position= ~(my_off_t)0;
+  m_filter.start_position= 1500;
+  EXPECT_EQ("0:1500-2000F 0:2000-* "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+  m_filter.start_position= 2000;
+  EXPECT_EQ("0:2000-*F "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+
+  // The last segment is decoded to tell about a position past the end
+  m_filter.start_position= 5000;
+  EXPECT_EQ("0:5000-*F "
+            "1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+}
+
+
+TEST_F(MysqlbinlogIndexTest, Datetimes)
+{
+  // Segments before --start-datetime are left out
+  m_filter.start_datetime= 111;
+  EXPECT_EQ("1:1000-2000F 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+  // Only the first range may have events before --start-datetime
+  EXPECT_EQ(111, m_ranges[0].start_datetime);
+  for (size_t i= 1; i < m_ranges.size(); i++)
+    EXPECT_EQ(0, m_ranges[i].start_datetime) << i;
+
+  // Planning stops after the segment reaching --stop-datetime
+  m_filter.stop_datetime= 121;
+  EXPECT_EQ("1:1000-2000F 1:2000-* "
+            "2:4-1000F 2:1000-2000", plan());
+  m_filter.stop_datetime= 111;
+  EXPECT_EQ("1:1000-2000F", plan());
+
+  // Unless events are filtered by --server-id
+  m_filter.filter_server_id= true;
+  EXPECT_EQ("1:1000-2000F 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+  m_filter.filter_server_id= false;
+
+  // A segment of unknown timestamps is decoded, and does not stop the plan
+  m_filter.stop_datetime= MY_TIME_T_MAX;
+  m_indexes[0].segments[2].max_when= MY_TIME_T_MAX;
+  EXPECT_EQ("0:2000-*F 1:1000-2000F 1:2000-* "
+            "2:4-1000F 2:1000-2000 2:2000-*", plan());
+  EXPECT_EQ(111, m_ranges[0].start_datetime);
+  EXPECT_EQ(111, m_ranges[1].start_datetime);
+  EXPECT_EQ(0, m_ranges[2].start_datetime);
+  m_filter.stop_datetime= 100;
+  EXPECT_EQ("0:2000-*F 1:1000-2000F", plan());
+}
+
+
+TEST_F(MysqlbinlogIndexTest, Gtids)
+{
+  // Segments without any included GTID are left out
+  set_gtids(&m_include, &m_filter.include_gtids, gtid_text(uuid, "4-5"));
+  EXPECT_EQ("1:4-1000F 1:1000-2000", plan());
+  set_gtids(&m_include, &m_filter.include_gtids, gtid_text(other_uuid, "1"));
+  EXPECT_EQ("", plan());
+
+  // Unless they have other events, or transactions without a GTID
+  m_indexes[2].segments[0].gtid_only= false;
+  m_indexes[2].segments[1].gtid_only= false;
+  m_indexes[2].segments[1].gtids.clear();
+  EXPECT_EQ("2:4-1000F 2:1000-2000", plan());
+  m_filter.include_gtids= NULL;
+
+  // Segments of excluded GTIDs only are left out
+  m_indexes[0].segments[1].gtids= gtid_text(uuid, "2,") +
+    gtid_text(other_uuid, "1");
+  set_gtids(&m_exclude, &m_filter.exclude_gtids, gtid_text(uuid, "1-6"));
+  EXPECT_EQ("0:1000-2000F 2:4-1000F 2:1000-2000 2:2000-*", plan());
+
+  // Both
+  set_gtids(&m_include, &m_filter.include_gtids, gtid_text(uuid, "2-9"));
+  set_gtids(&m_exclude, &m_filter.exclude_gtids, gtid_text(uuid, "1-3:9"));
+  EXPECT_EQ("0:1000-2000F 1:4-1000F 1:1000-2000 1:2000-* "
+            "2:4-1000F 2:1000-2000", plan());
+
+  // GTID pruning goes with the datetimes and positions
+  m_filter.start_datetime= 112;
+  m_filter.stop_position= 1000;
+  EXPECT_EQ("1:2000-*F 2:4-1000F", plan());
+}
+
+}
@@ -0,0 +1,398 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the workload helpers of mysqlslap: the latency
+  histogram and its percentiles, the parsing of the ${uniform:...} and
+  ${zipf:...} key placeholders and the distribution of their keys, and
+  the query slots of --rate.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../client/mysqlslap_workload.cc"
+
+namespace mysqlslap_workload_unittest {
+
+/* Highest value counted with value */
+ulonglong bucket_top(ulonglong value)
+{
+  return latency_bucket_value(latency_bucket(value));
+}
+
+
+class LatencyHistogramTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    memset(&m_histogram, 0, sizeof(m_histogram));
+  }
+  void record(ulonglong value, uint count= 1)
+  {
+    for (uint i= 0; i < count; i++)
+      latency_record(&m_histogram, value);
+  }
+
+  latency_histogram m_histogram;
+};
+
+
+TEST_F(LatencyHistogramTest, BucketBoundaries)
+{
+  const ulonglong max_value= (1ULL << LATENCY_MAX_BITS) - 1;
+
+  for (ulonglong value= 0; value < LATENCY_SUB_BUCKETS; value++)
+  {
+    EXPECT_EQ(value, latency_bucket(value));
+    EXPECT_EQ(value, latency_bucket_value(latency_bucket(value)));
+  }
+
+  for (uint bits= LATENCY_SUB_BUCKET_BITS; bits <= LATENCY_MAX_BITS; bits++)
+  {
+    const ulonglong edges[]= { (1ULL << bits) - 1, 1ULL << bits,
+                               (1ULL << bits) + 1, (3ULL << bits) / 2 };
+    for (uint e= 0; e < array_elements(edges); e++)
+    {
+      ulonglong value= edges[e];
+      if (value > max_value)
+        continue;
+      uint bucket= latency_bucket(value);
+      ASSERT_LT(bucket, (uint) LATENCY_BUCKETS) << value;
+      EXPECT_GE(latency_bucket_value(bucket), value);
+      EXPECT_LT(latency_bucket_value(bucket - 1), value);
+      EXPECT_LE(latency_bucket_value(bucket) - value, value / 64) << value;
+    }
+  }
+
+  // The buckets go up to LATENCY_MAX_BITS, longer latencies are clamped.
+  EXPECT_EQ((uint) LATENCY_BUCKETS - 1, latency_bucket(max_value));
+  EXPECT_EQ(max_value, latency_bucket_value(LATENCY_BUCKETS - 1));
+  EXPECT_EQ((uint) LATENCY_BUCKETS - 1, latency_bucket(max_value + 1));
+  EXPECT_EQ((uint) LATENCY_BUCKETS - 1, latency_bucket(~0ULL));
+
+  // Two values per bucket from 128 to 255.
+  EXPECT_EQ(latency_bucket(200), latency_bucket(201));
+  EXPECT_NE(latency_bucket(201), latency_bucket(202));
+  EXPECT_EQ(201U, bucket_top(200));
+}
+
+
+TEST_F(LatencyHistogramTest, PercentilesAtBucketEdges)
+{
+  EXPECT_EQ(0U, latency_percentile(&m_histogram, 50));
+
+  // Never above the largest recorded latency.
+  record(200);
+  EXPECT_EQ(200U, latency_percentile(&m_histogram, 50));
+  EXPECT_EQ(200U, latency_percentile(&m_histogram, 99.9));
+  EXPECT_EQ(200U, latency_percentile(&m_histogram, 0));
+
+  record(300);
+  EXPECT_EQ(201U, latency_percentile(&m_histogram, 50));
+  EXPECT_EQ(300U, latency_percentile(&m_histogram, 50.1));
+  EXPECT_EQ(300U, latency_percentile(&m_histogram, 100));
+}
+
+
+TEST_F(LatencyHistogramTest, SmallCounts)
+{
+  // 1 to 10: the rank of a percentile is rounded up.
+  for (ulonglong value= 1; value <= 10; value++)
+    record(value);
+  EXPECT_EQ(5U, latency_percentile(&m_histogram, 50));
+  EXPECT_EQ(9U, latency_percentile(&m_histogram, 90));
+  EXPECT_EQ(10U, latency_percentile(&m_histogram, 90.1));
+  EXPECT_EQ(10U, latency_percentile(&m_histogram, 99));
+  EXPECT_EQ(10U, latency_percentile(&m_histogram, 99.9));
+
+  // p99.9 is the slowest query with less than a thousand queries.
+  SetUp();
+  record(100, 998);
+  record(5000);
+  EXPECT_EQ(100U, latency_percentile(&m_histogram, 99));
+  EXPECT_EQ(5000U, latency_percentile(&m_histogram, 99.9));
+
+  // It is not with a thousand and more.
+  SetUp();
+  record(100, 1000);
+  record(5000);
+  EXPECT_EQ(100U, latency_percentile(&m_histogram, 99.9));
+  EXPECT_EQ(5000U, latency_percentile(&m_histogram, 100));
+}
+
+
+TEST_F(LatencyHistogramTest, Merge)
+{
+  latency_histogram other;
+  memset(&other, 0, sizeof(other));
+
+  record(10, 90);
+  for (uint i= 0; i < 10; i++)
+    latency_record(&other, 1000);
+  latency_merge(&m_histogram, &other);
+
+  EXPECT_EQ(100U, m_histogram.count);
+  EXPECT_EQ(1000U, m_histogram.max);
+  EXPECT_EQ(90U, m_histogram.buckets[latency_bucket(10)]);
+  EXPECT_EQ(10U, m_histogram.buckets[latency_bucket(1000)]);
+  EXPECT_EQ(10U, latency_percentile(&m_histogram, 90));
+  EXPECT_EQ(1000U, latency_percentile(&m_histogram, 91));
+  EXPECT_EQ(1000U, latency_percentile(&m_histogram, 99.9));
+}
+
+
+class KeyParamsTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    memset(&m_stmt, 0, sizeof(m_stmt));
+  }
+  virtual void TearDown()
+  {
+    free_params();
+  }
+  void free_params()
+  {
+    key_param *param, *next;
+    for (param= m_stmt.params; param; param= next)
+    {
+      next= param->next;
+      my_free(param);
+    }
+    m_stmt.params= NULL;
+  }
+  int parse(const std::string &query)
+  {
+    free_params();
+    m_query= query;
+    m_stmt.string= &m_query[0];
+    m_stmt.length= m_query.length();
+    return parse_key_params(&m_stmt);
+  }
+
+  std::string m_query;
+  statement m_stmt;
+};
+
+
+TEST_F(KeyParamsTest, Parse)
+{
+  ASSERT_EQ(0, parse("SELECT 1"));
+  EXPECT_TRUE(m_stmt.params == NULL);
+
+  ASSERT_EQ(0, parse("SELECT * FROM t1 WHERE a = ${uniform:1:10} "
+                     "AND b = ${zipf:5:5} AND c = ${zipf:0:999:0.5}"));
+  key_param *param= m_stmt.params;
+  ASSERT_TRUE(param != NULL);
+  EXPECT_EQ(m_query.find("${uniform"), param->offset);
+  EXPECT_EQ(strlen("${uniform:1:10}"), param->length);
+  EXPECT_FALSE(param->zipf);
+  EXPECT_EQ(1U, param->low);
+  EXPECT_EQ(10U, param->items);
+
+  param= param->next;
+  ASSERT_TRUE(param != NULL);
+  EXPECT_EQ(m_query.find("${zipf:5"), param->offset);
+  EXPECT_TRUE(param->zipf);
+  EXPECT_EQ(5U, param->low);
+  EXPECT_EQ(1U, param->items);
+  EXPECT_DOUBLE_EQ(0.99, param->theta);
+
+  param= param->next;
+  ASSERT_TRUE(param != NULL);
+  EXPECT_EQ(strlen("${zipf:0:999:0.5}"), param->length);
+  EXPECT_EQ(0U, param->low);
+  EXPECT_EQ(1000U, param->items);
+  EXPECT_DOUBLE_EQ(0.5, param->theta);
+  EXPECT_TRUE(param->next == NULL);
+}
+
+
+TEST_F(KeyParamsTest, Malformed)
+{
+  const char *queries[]=
+  {
+    "SELECT ${",
+    "SELECT ${uniform:1:10",
+    "SELECT ${}",
+    "SELECT ${random:1:10}",
+    "SELECT ${uniform}",
+    "SELECT ${uniform:1}",
+    "SELECT ${uniform:1:}",
+    "SELECT ${uniform::10}",
+    "SELECT ${uniform:a:10}",
+    "SELECT ${uniform:1:10x}",
+    "SELECT ${uniform:10:1}",
+    "SELECT ${uniform:-1:10}",
+    "SELECT ${uniform:-5:-1}",
+    "SELECT ${uniform: 1:10}",
+    "SELECT ${uniform:0:}",
+    "SELECT ${uniform:1:10:0.5}",
+    "SELECT ${zipf:1:10:}",
+    "SELECT ${zipf:1:10:0.5:1}",
+    "SELECT ${uniform:1:10}, ${zipf:1}"
+  };
+  for (uint i= 0; i < array_elements(queries); i++)
+    EXPECT_EQ(1, parse(queries[i])) << queries[i];
+}
+
+
+TEST_F(KeyParamsTest, ThetaBounds)
+{
+  EXPECT_EQ(1, parse("SELECT ${zipf:1:10:0}"));
+  EXPECT_EQ(1, parse("SELECT ${zipf:1:10:0.0}"));
+  EXPECT_EQ(1, parse("SELECT ${zipf:1:10:-0.5}"));
+  EXPECT_EQ(1, parse("SELECT ${zipf:1:10:1}"));
+  EXPECT_EQ(1, parse("SELECT ${zipf:1:10:1.5}"));
+  EXPECT_EQ(0, parse("SELECT ${zipf:1:10:0.001}"));
+  EXPECT_DOUBLE_EQ(0.001, m_stmt.params->theta);
+  EXPECT_EQ(0, parse("SELECT ${zipf:1:10:0.999}"));
+  EXPECT_DOUBLE_EQ(0.999, m_stmt.params->theta);
+}
+
+
+TEST_F(KeyParamsTest, QueryLength)
+{
+  // Every key takes up to 20 characters in the buffer of run_task().
+  const std::string param= "${uniform:1:2}";
+  const size_t longest= HUGE_STRING_LENGTH - 2 * 20 - 1;
+  std::string query= "SELECT " + param + ", " + param + " FROM t1 ";
+
+  query.append(longest - query.length(), ' ');
+  EXPECT_EQ(0, parse(query));
+  query.append(" ");
+  EXPECT_EQ(1, parse(query));
+
+  // Without placeholders, the length is not limited here.
+  EXPECT_EQ(0, parse(std::string(2 * HUGE_STRING_LENGTH, ' ')));
+}
+
+
+TEST_F(KeyParamsTest, UniformKeys)
+{
+  const uint draws= 10000;
+  std::vector<uint> counts(10);
+
+  ASSERT_EQ(0, parse("SELECT ${uniform:100:109}"));
+  EXPECT_EQ(100U, random_key(m_stmt.params, 0));
+  EXPECT_EQ(109U, random_key(m_stmt.params, 0.999999));
+  EXPECT_EQ(109U, random_key(m_stmt.params, 1));
+  for (uint i= 0; i < draws; i++)
+  {
+    ulonglong key= random_key(m_stmt.params, (i + 0.5) / draws);
+    ASSERT_GE(key, 100U);
+    ASSERT_LE(key, 109U);
+    counts[key - 100]++;
+  }
+  for (uint i= 0; i < counts.size(); i++)
+    EXPECT_EQ(draws / 10, counts[i]);
+}
+
+
+TEST_F(KeyParamsTest, ZipfRankSkew)
+{
+  const uint draws= 100000;
+  const uint items= 1000;
+  double top_share[2];
+
+  for (uint t= 0; t < 2; t++)
+  {
+    std::vector<uint> counts(items);
+
+    ASSERT_EQ(0, parse(t == 0 ? "SELECT ${zipf:1:1000}" :
+                                "SELECT ${zipf:1:1000:0.5}"));
+    const key_param *param= m_stmt.params;
+    for (uint i= 0; i < draws; i++)
+    {
+      ulonglong key= random_key(param, (i + 0.5) / draws);
+      ASSERT_GE(key, 1U);
+      ASSERT_LE(key, items);
+      counts[key - 1]++;
+    }
+
+    // The hottest key gets 1 / zeta(items, theta) of the queries.
+    top_share[t]= (double) counts[0] / draws;
+    EXPECT_NEAR(1 / param->zetan, top_share[t], 0.001);
+    EXPECT_GT(counts[0], counts[1]);
+    EXPECT_GT(counts[1], counts[9]);
+    EXPECT_GT(counts[9], counts[items - 1]);
+
+    uint top_ten= 0, upper_half= 0;
+    for (uint i= 0; i < 10; i++)
+      top_ten+= counts[i];
+    for (uint i= items / 2; i < items; i++)
+      upper_half+= counts[i];
+    if (t == 0)
+    {
+      EXPECT_GT(top_ten, draws * 35 / 100);
+      EXPECT_LT(upper_half, draws * 10 / 100);
+    }
+    else
+    {
+      EXPECT_LT(top_ten, draws * 10 / 100);
+      EXPECT_GT(upper_half, draws * 25 / 100);
+    }
+  }
+  EXPECT_GT(top_share[0], 5 * top_share[1]);
+
+  // With one or two keys.
+  ASSERT_EQ(0, parse("SELECT ${zipf:7:7}"));
+  EXPECT_EQ(7U, random_key(m_stmt.params, 0));
+  EXPECT_EQ(7U, random_key(m_stmt.params, 0.99));
+  ASSERT_EQ(0, parse("SELECT ${zipf:1:2}"));
+  EXPECT_EQ(1U, random_key(m_stmt.params, 0.5));
+  EXPECT_EQ(2U, random_key(m_stmt.params, 0.99));
+}
+
+
+TEST(QuerySlotsTest, TakeQuerySlot)
+{
+  query_slots slots;
+  ulonglong slot;
+
+  slots.interval= 10;
+  slots.next= 1000;
+  slots.left= 3;
+  slots.measure_start= 1020;
+  native_mutex_init(&slots.mutex, NULL);
+
+  // The slots of the warm-up are not counted.
+  const ulonglong expected[]= { 1000, 1010, 1020, 1030, 1040 };
+  for (uint i= 0; i < array_elements(expected); i++)
+  {
+    ASSERT_FALSE(take_query_slot(&slots, &slot));
+    EXPECT_EQ(expected[i], slot);
+  }
+  EXPECT_EQ(0U, slots.left);
+
+  slot= 0;
+  EXPECT_TRUE(take_query_slot(&slots, &slot));
+  EXPECT_EQ(0U, slot);
+  EXPECT_DOUBLE_EQ(1050, slots.next);
+
+  native_mutex_destroy(&slots.mutex);
+}
+
+}  // namespace mysqlslap_workload_unittest
@@ -0,0 +1,271 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the partitioned key cache: requests split at key cache
+  block boundaries over several partitions, and resizes while other
+  threads read and write through the cache.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_thread.h>
+#include <keycache.h>
+#include <mysql/psi/mysql_thread.h>
+
+#include <algorithm>
+#include <fcntl.h>
+#include <string.h>
+
+namespace mysys_key_cache_unittest {
+
+const uint block_size= 1024;
+const uint num_partitions= 4;
+const size_t cache_size= 256 * 1024;
+const uint num_threads= 4;
+const size_t region_size= 16 * 1024;
+const size_t file_size= num_threads * region_size;
+const int level= 3;
+
+/* The file content, version 0 is the initial content */
+uchar pattern(my_off_t pos, uint version)
+{
+  return static_cast<uchar>(pos * 7 + version * 13);
+}
+
+void init_thread_var(st_keycache_thread_var *thread_var)
+{
+  memset(thread_var, 0, sizeof(*thread_var));
+  mysql_cond_init(PSI_NOT_INSTRUMENTED, &thread_var->suspend);
+}
+
+class KeyCacheTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    uchar buf[file_size];
+
+    init_thread_var(&m_thread_var);
+    m_file= create_temp_file(m_name, NULL, "kc", O_CREAT | O_EXCL | O_RDWR,
+                             MYF(MY_WME));
+    ASSERT_LE(0, m_file);
+    for (size_t i= 0; i < file_size; i++)
+      buf[i]= pattern(i, 0);
+    ASSERT_EQ(0U, my_pwrite(m_file, buf, file_size, 0, MYF(MY_NABP)));
+
+    memset(&m_key_cache, 0, sizeof(m_key_cache));
+    m_key_cache.param_partitions= num_partitions;
+    ASSERT_LT(0, init_key_cache(&m_key_cache, block_size, cache_size,
+                                100, 300));
+    ASSERT_EQ(num_partitions, m_key_cache.partitions);
+  }
+
+  virtual void TearDown()
+  {
+    end_key_cache(&m_key_cache, 1);
+    my_close(m_file, MYF(0));
+    my_delete(m_name, MYF(0));
+    mysql_cond_destroy(&m_thread_var.suspend);
+  }
+
+  /* Check length bytes at pos, of version inside [from, to[, else 0 */
+  static bool data_ok(const uchar *buf, my_off_t pos, size_t length,
+                      my_off_t from, my_off_t to, uint version)
+  {
+    for (size_t i= 0; i < length; i++, pos++)
+    {
+      if (buf[i] != pattern(pos, (pos >= from && pos < to) ? version : 0))
+        return false;
+    }
+    return true;
+  }
+
+  KEY_CACHE m_key_cache;
+  st_keycache_thread_var m_thread_var;
+  char m_name[FN_REFLEN];
+  File m_file;
+};
+
+
+TEST_F(KeyCacheTest, SplitRead)
+{
+  uchar buf[4 * block_size];
+  uint used_partitions= 0;
+
+  // Starts and ends in the middle of a block
+  ASSERT_TRUE(key_cache_read(&m_key_cache, &m_thread_var, m_file, 1000,
+                             level, buf, 3 * block_size, block_size, 0) ==
+              buf);
+  EXPECT_TRUE(data_ok(buf, 1000, 3 * block_size, 0, 0, 0));
+
+  // The last read is shorter, up to the end of the file
+  for (my_off_t pos= 100; pos < file_size; pos+= sizeof(buf))
+  {
+    size_t length= std::min<size_t>(sizeof(buf), file_size - pos);
+    ASSERT_TRUE(key_cache_read(&m_key_cache, &m_thread_var, m_file, pos,
+                               level, buf, length, block_size, 0) == buf);
+    EXPECT_TRUE(data_ok(buf, pos, length, 0, 0, 0)) << pos;
+  }
+
+  for (uint i= 0; i < num_partitions; i++)
+  {
+    if (m_key_cache.partition_array[i].blocks_used > 0)
+      used_partitions++;
+  }
+  EXPECT_LT(1U, used_partitions);
+
+  update_key_cache_stats(&m_key_cache);
+  EXPECT_EQ(file_size / block_size, m_key_cache.blocks_used);
+  EXPECT_EQ(m_key_cache.global_cache_read, m_key_cache.blocks_used);
+}
+
+
+TEST_F(KeyCacheTest, SplitWrite)
+{
+  const my_off_t from= 1500;
+  const size_t length= 5 * block_size + 100;
+  uchar buf[8 * block_size];
+
+  for (size_t i= 0; i < length; i++)
+    buf[i]= pattern(from + i, 1);
+  // Kept in the cache until flushed
+  ASSERT_EQ(0, key_cache_write(&m_key_cache, &m_thread_var, m_file, from,
+                               level, buf, length, block_size, 1));
+
+  ASSERT_TRUE(key_cache_read(&m_key_cache, &m_thread_var, m_file, 0,
+                             level, buf, sizeof(buf), block_size, 0) == buf);
+  EXPECT_TRUE(data_ok(buf, 0, sizeof(buf), from, from + length, 1));
+
+  ASSERT_EQ(0U, my_pread(m_file, buf, sizeof(buf), 0, MYF(MY_NABP)));
+  EXPECT_TRUE(data_ok(buf, 0, sizeof(buf), 0, 0, 0));
+
+  update_key_cache_stats(&m_key_cache);
+  EXPECT_LT(1UL, m_key_cache.global_blocks_changed);
+
+  ASSERT_EQ(0, flush_key_blocks(&m_key_cache, &m_thread_var, m_file,
+                                FLUSH_KEEP));
+  ASSERT_EQ(0U, my_pread(m_file, buf, sizeof(buf), 0, MYF(MY_NABP)));
+  EXPECT_TRUE(data_ok(buf, 0, sizeof(buf), from, from + length, 1));
+}
+
+
+struct Thread_arg
+{
+  KEY_CACHE *key_cache;
+  File file;
+  my_off_t region;
+  /* What the region of the thread must contain */
+  uchar shadow[region_size];
+  int iterations;
+  int errors;
+};
+
+/*
+  Reads and writes ranges of the region of the thread, at any offset,
+  checking that the cache returns what the thread wrote last.
+*/
+extern "C" void *read_write_region(void *arg)
+{
+  Thread_arg *targ= static_cast<Thread_arg*>(arg);
+  st_keycache_thread_var thread_var;
+  uchar buf[4 * block_size];
+  uint32 random= static_cast<uint32>(targ->region) + 1;
+
+  my_thread_init();
+  init_thread_var(&thread_var);
+  for (int i= 0; i < targ->iterations; i++)
+  {
+    random= random * 1103515245U + 12345U;
+    size_t offset= (random >> 8) % (region_size - sizeof(buf));
+    size_t length= (random >> 4) % sizeof(buf) + 1;
+    my_off_t pos= targ->region + offset;
+
+    if (random & 1)
+    {
+      for (size_t j= 0; j < length; j++)
+        buf[j]= pattern(pos + j, i + 1);
+      if (key_cache_write(targ->key_cache, &thread_var, targ->file, pos,
+                          level, buf, length, block_size, random & 2))
+        targ->errors++;
+      memcpy(targ->shadow + offset, buf, length);
+    }
+    else if (key_cache_read(targ->key_cache, &thread_var, targ->file, pos,
+                            level, buf, length, block_size, 0) != buf ||
+             memcmp(buf, targ->shadow + offset, length))
+      targ->errors++;
+  }
+  mysql_cond_destroy(&thread_var.suspend);
+  my_thread_end();
+  return NULL;
+}
+
+
+TEST_F(KeyCacheTest, ResizeUnderLoad)
+{
+  my_thread_handle threads[num_threads];
+  Thread_arg *args= new Thread_arg[num_threads];
+  my_thread_attr_t attr;
+
+  my_thread_attr_init(&attr);
+  for (uint i= 0; i < num_threads; i++)
+  {
+    args[i].key_cache= &m_key_cache;
+    args[i].file= m_file;
+    args[i].region= i * region_size;
+    for (size_t j= 0; j < region_size; j++)
+      args[i].shadow[j]= pattern(args[i].region + j, 0);
+    args[i].iterations= 20000;
+    args[i].errors= 0;
+    ASSERT_EQ(0, my_thread_create(&threads[i], &attr, read_write_region,
+                                  &args[i]));
+  }
+
+  // The partition of every block changes with the block size
+  for (int i= 0; i < 20; i++)
+  {
+    uint new_block_size= (i % 2) ? block_size : 2 * block_size;
+    size_t new_size= (i % 3) ? cache_size : cache_size / 2;
+    EXPECT_LT(0, resize_key_cache(&m_key_cache, &m_thread_var,
+                                  new_block_size, new_size, 100, 300));
+    EXPECT_EQ(new_block_size, m_key_cache.key_cache_block_size);
+    my_sleep(1000);
+  }
+
+  for (uint i= 0; i < num_threads; i++)
+    my_thread_join(&threads[i], NULL);
+  my_thread_attr_destroy(&attr);
+
+  ASSERT_EQ(0, flush_key_blocks(&m_key_cache, &m_thread_var, m_file,
+                                FLUSH_KEEP));
+  for (uint i= 0; i < num_threads; i++)
+  {
+    uchar buf[region_size];
+    EXPECT_EQ(0, args[i].errors) << "thread " << i;
+    ASSERT_EQ(0U, my_pread(m_file, buf, region_size, args[i].region,
+                           MYF(MY_NABP)));
+    EXPECT_EQ(0, memcmp(buf, args[i].shadow, region_size)) << "thread " << i;
+  }
+  delete [] args;
+}
+
+}
@@ -0,0 +1,257 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for epoch based reclamation in LF_HASH (LF_HASH_EPOCH),
+  and a multi-threaded look-up benchmark comparing it with pins.
+
+  In order to do benchmarking, configure in optimized mode, and
+  generate a separate executable for this file:
+    cmake -DMERGE_UNITTESTS=0
+  and raise num_iterations below.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_thread.h>
+#include <lf.h>
+
+namespace mysys_lf_epoch_unittest {
+
+#if !defined(NDEBUG)
+// There is no point in benchmarking anything in debug mode.
+const int num_iterations= 1;
+#else
+// Set this so that each test case takes a few seconds.
+// And set it back to a small value before pushing!!
+// const int num_iterations= 2000;
+const int num_iterations= 2;
+#endif
+
+const int num_threads= 8;
+const int32 num_keys= 1000;
+
+struct Thread_arg
+{
+  LF_HASH *hash;
+  int32 first_key;
+  int32 cycles;
+  int32 errors;
+};
+
+/*
+  Insert, find and delete keys overlapping with other threads,
+  and check that whatever is found has the key looked for.
+*/
+extern "C" void *test_epoch_hash(void *arg)
+{
+  Thread_arg *targ= static_cast<Thread_arg*>(arg);
+  LF_PINS *pins;
+
+  my_thread_init();
+  pins= lf_hash_get_pins(targ->hash);
+
+  for (int32 cycle= 0; cycle < targ->cycles; cycle++)
+  {
+    for (int32 i= 0; i < num_keys; i++)
+    {
+      int32 key= (targ->first_key + i) % (2 * num_keys);
+      if (lf_hash_insert(targ->hash, pins, &key) < 0)
+        targ->errors++;
+    }
+    for (int32 i= 0; i < num_keys; i++)
+    {
+      int32 key= (targ->first_key + i) % (2 * num_keys);
+      int32 *found= static_cast<int32*>(lf_hash_search(targ->hash, pins,
+                                                       &key, sizeof(key)));
+      if (found == MY_ERRPTR || (found && *found != key))
+        targ->errors++;
+      lf_hash_search_unpin(pins);
+    }
+    for (int32 i= 0; i < num_keys; i++)
+    {
+      int32 key= (targ->first_key + i) % (2 * num_keys);
+      if (lf_hash_delete(targ->hash, pins, &key, sizeof(key)) < 0)
+        targ->errors++;
+    }
+  }
+
+  lf_hash_put_pins(pins);
+  my_thread_end();
+  return NULL;
+}
+
+void run_threads(void *(*func)(void *), Thread_arg *args)
+{
+  my_thread_handle threads[num_threads];
+  my_thread_attr_t attr;
+
+  my_thread_attr_init(&attr);
+  for (int i= 0; i < num_threads; i++)
+    ASSERT_EQ(0, my_thread_create(&threads[i], &attr, func, &args[i]));
+  for (int i= 0; i < num_threads; i++)
+    my_thread_join(&threads[i], NULL);
+  my_thread_attr_destroy(&attr);
+}
+
+TEST(MysysLfEpoch, ConcurrentInsertSearchDelete)
+{
+  LF_HASH hash;
+  Thread_arg args[num_threads];
+
+  lf_hash_init(&hash, sizeof(int32), LF_HASH_UNIQUE | LF_HASH_EPOCH,
+               0, sizeof(int32), NULL, &my_charset_bin);
+
+  for (int i= 0; i < num_threads; i++)
+  {
+    args[i].hash= &hash;
+    args[i].first_key= i * num_keys / 2;
+    args[i].cycles= 20;
+    args[i].errors= 0;
+  }
+  run_threads(test_epoch_hash, args);
+
+  for (int i= 0; i < num_threads; i++)
+    EXPECT_EQ(0, args[i].errors);
+  EXPECT_EQ(0, hash.count);
+
+  lf_hash_destroy(&hash);
+}
+
+/*
+  An element found by lf_hash_search() must not be reused before
+  lf_hash_search_unpin(), even if it is deleted meanwhile and many
+  more elements are deleted after it.
+*/
+TEST(MysysLfEpoch, NoReuseWhileInEpoch)
+{
+  LF_HASH hash;
+  LF_PINS *reader, *writer;
+  int32 key= -1;
+  int32 *found;
+
+  lf_hash_init(&hash, sizeof(int32), LF_HASH_UNIQUE | LF_HASH_EPOCH,
+               0, sizeof(int32), NULL, &my_charset_bin);
+  reader= lf_hash_get_pins(&hash);
+  writer= lf_hash_get_pins(&hash);
+
+  EXPECT_EQ(0, lf_hash_insert(&hash, writer, &key));
+  found= static_cast<int32*>(lf_hash_search(&hash, reader, &key, sizeof(key)));
+  ASSERT_TRUE(found != NULL && found != MY_ERRPTR);
+  EXPECT_EQ(0, lf_hash_delete(&hash, writer, &key, sizeof(key)));
+
+  for (int32 i= 0; i < 100 * LF_EPOCH_BATCH_SIZE; i++)
+  {
+    EXPECT_EQ(0, lf_hash_insert(&hash, writer, &i));
+    EXPECT_EQ(0, lf_hash_delete(&hash, writer, &i, sizeof(i)));
+  }
+  EXPECT_EQ(-1, *found);
+  lf_hash_search_unpin(reader);
+
+  /* Now the writer can reclaim, and hand the rest over on put_pins. */
+  for (int32 i= 0; i < 100 * LF_EPOCH_BATCH_SIZE; i++)
+  {
+    EXPECT_EQ(0, lf_hash_insert(&hash, writer, &i));
+    EXPECT_EQ(0, lf_hash_delete(&hash, writer, &i, sizeof(i)));
+  }
+  EXPECT_GT(hash.alloc.pinbox.global_epoch, 1U);
+  EXPECT_EQ(0, hash.count);
+
+  lf_hash_put_pins(writer);
+  lf_hash_put_pins(reader);
+  lf_hash_destroy(&hash);
+}
+
+/*
+  Read mostly workload: every thread looks up keys of a preloaded hash,
+  with a few inserts and deletes of keys of its own.
+*/
+extern "C" void *bench_lookup(void *arg)
+{
+  Thread_arg *targ= static_cast<Thread_arg*>(arg);
+  LF_PINS *pins;
+  uint32 x= static_cast<uint32>(targ->first_key) + 1;
+
+  my_thread_init();
+  pins= lf_hash_get_pins(targ->hash);
+
+  for (int32 cycle= 0; cycle < targ->cycles; cycle++)
+  {
+    for (int32 i= 0; i < num_keys * 10; i++)
+    {
+      x= x * 1103515245U + 12345U;
+      int32 key= (x >> 8) % num_keys;
+      int32 *found= static_cast<int32*>(lf_hash_search(targ->hash, pins,
+                                                       &key, sizeof(key)));
+      if (found == NULL || found == MY_ERRPTR || *found != key)
+        targ->errors++;
+      lf_hash_search_unpin(pins);
+    }
+    int32 own= num_keys + targ->first_key;
+    lf_hash_insert(targ->hash, pins, &own);
+    lf_hash_delete(targ->hash, pins, &own, sizeof(own));
+  }
+
+  lf_hash_put_pins(pins);
+  my_thread_end();
+  return NULL;
+}
+
+void bench(uint flags)
+{
+  LF_HASH hash;
+  LF_PINS *pins;
+  Thread_arg args[num_threads];
+
+  lf_hash_init(&hash, sizeof(int32), LF_HASH_UNIQUE | flags,
+               0, sizeof(int32), NULL, &my_charset_bin);
+  pins= lf_hash_get_pins(&hash);
+  for (int32 key= 0; key < num_keys; key++)
+    lf_hash_insert(&hash, pins, &key);
+  lf_hash_put_pins(pins);
+
+  for (int i= 0; i < num_threads; i++)
+  {
+    args[i].hash= &hash;
+    args[i].first_key= i;
+    args[i].cycles= num_iterations;
+    args[i].errors= 0;
+  }
+  run_threads(bench_lookup, args);
+
+  for (int i= 0; i < num_threads; i++)
+    EXPECT_EQ(0, args[i].errors);
+  EXPECT_EQ(num_keys, hash.count);
+  lf_hash_destroy(&hash);
+}
+
+TEST(MysysLfEpoch, BenchLookupPins)
+{
+  bench(0);
+}
+
+TEST(MysysLfEpoch, BenchLookupEpoch)
+{
+  bench(LF_HASH_EPOCH);
+}
+
+}
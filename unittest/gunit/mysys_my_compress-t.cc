@@ -0,0 +1,197 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+  Unit tests of the per connection compression contexts of my_compress.c.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <vector>
+
+namespace mysys_my_compress_unittest {
+
+class CompressContextTest :
+  public ::testing::TestWithParam<enum_compression_algorithm>
+{
+protected:
+  virtual void SetUp()
+  {
+    compress_ctx= my_compress_context_new(GetParam(), 3);
+    uncompress_ctx= my_compress_context_new(GetParam(), 3);
+    ASSERT_TRUE(compress_ctx != NULL);
+    ASSERT_TRUE(uncompress_ctx != NULL);
+  }
+
+  virtual void TearDown()
+  {
+    my_compress_context_free(compress_ctx);
+    my_compress_context_free(uncompress_ctx);
+  }
+
+  /* Text which compresses well. */
+  static std::vector<uchar> text(size_t length)
+  {
+    static const char words[]= "select a, b from t1 where c = 42 order by d; ";
+    std::vector<uchar> data(length);
+    for (size_t i= 0; i < length; i++)
+      data[i]= words[i % (sizeof(words) - 1)];
+    return data;
+  }
+
+  /* Random bytes, which do not compress. */
+  static std::vector<uchar> noise(size_t length)
+  {
+    std::vector<uchar> data(length);
+    ulonglong seed= 0x9e3779b97f4a7c15ULL;
+    for (size_t i= 0; i < length; i++)
+    {
+      seed= seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      data[i]= (uchar) (seed >> 56);
+    }
+    return data;
+  }
+
+  /*
+    Sends data through both contexts like a packet of the protocol, and
+    checks that it comes back unchanged.
+
+    @return Length of the packet after my_compress_ctx(), 0 if it was
+    not compressed.
+  */
+  size_t round_trip(const std::vector<uchar> &data)
+  {
+    std::vector<uchar> packet(data);
+    size_t len= data.size(), complen;
+
+    EXPECT_FALSE(my_compress_ctx(compress_ctx, &packet[0], &len, &complen));
+    if (complen)
+    {
+      EXPECT_EQ(data.size(), complen);
+      EXPECT_LT(len, data.size());
+    }
+    else
+      EXPECT_EQ(data.size(), len);
+
+    EXPECT_FALSE(my_uncompress_ctx(uncompress_ctx, &packet[0], len,
+                                   &complen));
+    EXPECT_EQ(data.size(), complen);
+    EXPECT_TRUE(packet == data);
+    return complen == len ? 0 : len;
+  }
+
+  COMPRESS_CONTEXT *compress_ctx;
+  COMPRESS_CONTEXT *uncompress_ctx;
+};
+
+#ifdef HAVE_ZSTD
+INSTANTIATE_TEST_CASE_P(Algorithms, CompressContextTest,
+                        ::testing::Values(MYSQL_ZLIB, MYSQL_ZSTD));
+#else
+INSTANTIATE_TEST_CASE_P(Algorithms, CompressContextTest,
+                        ::testing::Values(MYSQL_ZLIB));
+#endif
+
+
+TEST_P(CompressContextTest, RoundTrip)
+{
+  static const size_t lengths[]=
+    { 1000, 4096, 16 * 1024, 100 * 1000, 1024 * 1024 };
+
+  for (size_t i= 0; i < array_elements(lengths); i++)
+  {
+    SCOPED_TRACE(lengths[i]);
+    EXPECT_NE(0U, round_trip(text(lengths[i])));
+    EXPECT_EQ(0U, compress_ctx->bypass);
+  }
+}
+
+
+TEST_P(CompressContextTest, ShortPacket)
+{
+  std::vector<uchar> data= text(MIN_COMPRESS_LENGTH - 1);
+  size_t len= data.size(), complen= 1;
+
+  EXPECT_FALSE(my_compress_ctx(compress_ctx, &data[0], &len, &complen));
+  EXPECT_EQ(0U, complen);
+  EXPECT_EQ(MIN_COMPRESS_LENGTH - 1, len);
+  EXPECT_TRUE(data == text(MIN_COMPRESS_LENGTH - 1));
+  EXPECT_EQ(0U, compress_ctx->buffer_length);
+}
+
+
+TEST_P(CompressContextTest, Passthrough)
+{
+  std::vector<uchar> data= noise(1000);
+  std::vector<uchar> packet(data);
+  size_t complen= 0;
+
+  EXPECT_FALSE(my_uncompress_ctx(uncompress_ctx, &packet[0], packet.size(),
+                                 &complen));
+  EXPECT_EQ(data.size(), complen);
+  EXPECT_TRUE(packet == data);
+  EXPECT_EQ(0U, uncompress_ctx->buffer_length);
+}
+
+
+TEST_P(CompressContextTest, Incompressible)
+{
+  EXPECT_EQ(0U, round_trip(noise(1000)));
+  EXPECT_EQ((uint) COMPRESS_BYPASS_PACKETS, compress_ctx->bypass);
+}
+
+
+TEST_P(CompressContextTest, BypassCountdown)
+{
+  EXPECT_EQ(0U, round_trip(noise(1000)));
+
+  /* Even packets which compress well are skipped for a while. */
+  for (uint i= COMPRESS_BYPASS_PACKETS; i > 0; i--)
+  {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(i, compress_ctx->bypass);
+    EXPECT_EQ(0U, round_trip(text(1000)));
+  }
+  EXPECT_EQ(0U, compress_ctx->bypass);
+  EXPECT_NE(0U, round_trip(text(1000)));
+  EXPECT_EQ(0U, compress_ctx->bypass);
+}
+
+
+TEST_P(CompressContextTest, ScratchBuffer)
+{
+  EXPECT_NE(0U, round_trip(text(1000)));
+  EXPECT_NE(0U, compress_ctx->buffer_length);
+  EXPECT_NE(0U, uncompress_ctx->buffer_length);
+
+  /* Buffers for large packets are not kept. */
+  EXPECT_NE(0U, round_trip(text(1024 * 1024)));
+  EXPECT_EQ(0U, compress_ctx->buffer_length);
+  EXPECT_EQ(0U, uncompress_ctx->buffer_length);
+
+  EXPECT_NE(0U, round_trip(text(1000)));
+  EXPECT_GE((size_t) COMPRESS_KEEP_BUFFER_LENGTH,
+            compress_ctx->buffer_length);
+  EXPECT_GE((size_t) COMPRESS_KEEP_BUFFER_LENGTH,
+            uncompress_ctx->buffer_length);
+}
+
+}
@@ -0,0 +1,174 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include "mysqld.h"
+#include "sql_class.h"
+#include "sql_prepare.h"
+
+namespace prepared_stmt_cache_unittest {
+
+using my_testing::Server_initializer;
+
+class PreparedStmtCacheTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    initializer.SetUp();
+    saved_cache_size= prepared_stmt_cache_size;
+    saved_max_count= max_prepared_stmt_count;
+    prepared_stmt_cache_size= 1024 * 1024;
+    max_prepared_stmt_count= 16382;
+  }
+
+  virtual void TearDown()
+  {
+    thd()->stmt_map.reset();
+    EXPECT_EQ(0, my_atomic_load64(&prepared_stmt_cache_memory));
+    prepared_stmt_cache_size= saved_cache_size;
+    max_prepared_stmt_count= saved_max_count;
+    initializer.TearDown();
+  }
+
+  THD *thd() { return initializer.thd(); }
+
+  /* A statement of the session, as mysqld_stmt_prepare() leaves it */
+  Prepared_statement *make_stmt(const char *key)
+  {
+    Prepared_statement *stmt= new Prepared_statement(thd());
+    String key_str(key, strlen(key), &my_charset_bin);
+    EXPECT_FALSE(stmt->set_cache_key(key_str));
+    EXPECT_EQ(0, thd()->stmt_map.insert(thd(), stmt));
+    return stmt;
+  }
+
+  Prepared_statement *unpark(const char *key)
+  {
+    return thd()->stmt_map.unpark(key, strlen(key));
+  }
+
+  Server_initializer initializer;
+  ulong saved_cache_size;
+  ulong saved_max_count;
+};
+
+
+TEST_F(PreparedStmtCacheTest, ParkAndReuse)
+{
+  Prepared_statement *stmt= make_stmt("SELECT 1");
+  const int64 size= (int64) stmt->memory_used();
+
+  thd()->stmt_map.park(stmt);
+  EXPECT_EQ(size, my_atomic_load64(&prepared_stmt_cache_memory));
+  EXPECT_TRUE(thd()->stmt_map.find(stmt->id) == NULL);
+
+  EXPECT_TRUE(unpark("SELECT 2") == NULL);
+  Prepared_statement *reused= unpark("SELECT 1");
+  ASSERT_EQ(stmt, reused);
+  EXPECT_EQ(thd(), reused->thd);
+  EXPECT_EQ(0, my_atomic_load64(&prepared_stmt_cache_memory));
+  EXPECT_TRUE(unpark("SELECT 1") == NULL);
+
+  // Back in the map under a new id, as reuse_parked_statement() does.
+  reused->id= ++thd()->statement_id_counter;
+  EXPECT_EQ(0, thd()->stmt_map.insert(thd(), reused));
+  EXPECT_EQ(reused, thd()->stmt_map.find(reused->id));
+}
+
+
+TEST_F(PreparedStmtCacheTest, EvictLeastRecentlyParked)
+{
+  Prepared_statement *a= make_stmt("a");
+  Prepared_statement *b= make_stmt("b");
+  Prepared_statement *c= make_stmt("c");
+  const size_t size= a->memory_used();
+
+  prepared_stmt_cache_size= 2 * size + size / 2;
+  thd()->stmt_map.park(a);
+  thd()->stmt_map.park(b);
+
+  // Taking b and parking it again makes a the least recently parked.
+  EXPECT_EQ(b, unpark("b"));
+  EXPECT_EQ(0, thd()->stmt_map.insert(thd(), b));
+  thd()->stmt_map.park(b);
+  thd()->stmt_map.park(c);
+  EXPECT_GE((int64) prepared_stmt_cache_size,
+            my_atomic_load64(&prepared_stmt_cache_memory));
+
+  EXPECT_TRUE(unpark("a") == NULL);
+  Prepared_statement *reused_b= unpark("b");
+  Prepared_statement *reused_c= unpark("c");
+  EXPECT_EQ(b, reused_b);
+  EXPECT_EQ(c, reused_c);
+  delete reused_b;
+  delete reused_c;
+}
+
+
+TEST_F(PreparedStmtCacheTest, SameTextTwice)
+{
+  Prepared_statement *first= make_stmt("SELECT 1");
+  Prepared_statement *second= make_stmt("SELECT 1");
+
+  thd()->stmt_map.park(first);
+  thd()->stmt_map.park(second);
+
+  Prepared_statement *x= unpark("SELECT 1");
+  Prepared_statement *y= unpark("SELECT 1");
+  EXPECT_NE((Prepared_statement *) NULL, x);
+  EXPECT_NE((Prepared_statement *) NULL, y);
+  EXPECT_NE(x, y);
+  EXPECT_TRUE(unpark("SELECT 1") == NULL);
+  delete x;
+  delete y;
+}
+
+
+TEST_F(PreparedStmtCacheTest, TooLargeIsNotKept)
+{
+  Prepared_statement *kept= make_stmt("kept");
+  Prepared_statement *large= make_stmt("large");
+  const size_t size= kept->memory_used();
+
+  prepared_stmt_cache_size= size;
+  thd()->stmt_map.park(kept);
+
+  // Does not fit even in an empty cache: deleted without evicting anything.
+  prepared_stmt_cache_size= size - 1;
+  thd()->stmt_map.park(large);
+  EXPECT_EQ((int64) size, my_atomic_load64(&prepared_stmt_cache_memory));
+  EXPECT_TRUE(unpark("large") == NULL);
+
+  /*
+    With the room taken by statements of other sessions, the session
+    evicts its own statements, and the reservation of a statement that
+    still does not fit is rolled back.
+  */
+  prepared_stmt_cache_size= 2 * size;
+  my_atomic_add64(&prepared_stmt_cache_memory, (int64) (2 * size));
+  thd()->stmt_map.park(make_stmt("other"));
+  EXPECT_EQ((int64) (2 * size), my_atomic_load64(&prepared_stmt_cache_memory));
+  my_atomic_add64(&prepared_stmt_cache_memory, -(int64) (2 * size));
+  EXPECT_TRUE(unpark("kept") == NULL);
+  EXPECT_TRUE(unpark("other") == NULL);
+}
+
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../client/dump/table_chunk_ranges.cc"
+
+using Mysql::Tools::Dump::is_integer_column_type;
+using Mysql::Tools::Dump::get_key_range_conditions;
+
+namespace pump_table_chunks_unittest {
+
+std::string join(const std::vector<std::string>& conditions)
+{
+  std::string result;
+  for (size_t i= 0; i < conditions.size(); ++i)
+    result+= (i ? " | " : "") + conditions[i];
+  return result;
+}
+
+std::string ranges(bool is_unsigned, const char* min_value,
+  const char* max_value, uint64 row_count, uint64 chunk_rows)
+{
+  return join(get_key_range_conditions("`id`", is_unsigned, min_value,
+    max_value, row_count, chunk_rows));
+}
+
+TEST(PumpTableChunks, IntegerTypes)
+{
+  bool is_unsigned= true;
+  EXPECT_TRUE(is_integer_column_type("int(11)", &is_unsigned));
+  EXPECT_FALSE(is_unsigned);
+  EXPECT_TRUE(is_integer_column_type("int(10) unsigned", &is_unsigned));
+  EXPECT_TRUE(is_unsigned);
+  EXPECT_TRUE(is_integer_column_type("tinyint(3) unsigned zerofill",
+    &is_unsigned));
+  EXPECT_TRUE(is_unsigned);
+  EXPECT_TRUE(is_integer_column_type("smallint(6)", &is_unsigned));
+  EXPECT_FALSE(is_unsigned);
+  EXPECT_TRUE(is_integer_column_type("mediumint(9)", &is_unsigned));
+  EXPECT_TRUE(is_integer_column_type("bigint(20) unsigned", &is_unsigned));
+  EXPECT_TRUE(is_unsigned);
+  EXPECT_TRUE(is_integer_column_type("bigint", &is_unsigned));
+  EXPECT_FALSE(is_unsigned);
+
+  // Types with "int" in their name
+  EXPECT_FALSE(is_integer_column_type("point", &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("multipoint", &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("varchar(10)", &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("decimal(20,0) unsigned",
+    &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("double unsigned", &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("enum('int','bigint')",
+    &is_unsigned));
+  EXPECT_FALSE(is_integer_column_type("", &is_unsigned));
+}
+
+TEST(PumpTableChunks, SmallRanges)
+{
+  EXPECT_EQ("`id` < -5 | `id` >= -5 AND `id` < 0 | "
+    "`id` >= 0 AND `id` < 5 | `id` >= 5",
+    ranges(false, "-10", "10", 100, 25));
+  EXPECT_EQ("`id` < 4 | `id` >= 4 AND `id` < 7 | `id` >= 7",
+    ranges(true, "1", "10", 21, 10));
+
+  // No more chunks than values
+  EXPECT_EQ("`id` < 2 | `id` >= 2", ranges(false, "1", "3", 100, 1));
+  EXPECT_EQ("", ranges(false, "7", "7", 100, 1));
+  EXPECT_EQ("", ranges(true, "7", "8", 100, 1));
+
+  // Small tables are not split
+  EXPECT_EQ("", ranges(false, "1", "1000", 10, 10));
+  EXPECT_EQ("", ranges(false, "1", "1000", 10, 0));
+  EXPECT_EQ("", ranges(false, "1000", "1", 100, 10));
+}
+
+TEST(PumpTableChunks, SignedEdges)
+{
+  EXPECT_EQ("`id` < -9223372036854775804 | `id` >= -9223372036854775804",
+    ranges(false, "-9223372036854775808", "-9223372036854775800", 20, 10));
+  EXPECT_EQ("`id` < 9223372036854775803 | `id` >= 9223372036854775803",
+    ranges(false, "9223372036854775799", "9223372036854775807", 20, 10));
+  EXPECT_EQ("`id` < 0 | `id` >= 0", ranges(false, "-4", "4", 20, 10));
+}
+
+TEST(PumpTableChunks, UnsignedEdges)
+{
+  EXPECT_EQ("`id` < 9223372036854775812 | `id` >= 9223372036854775812",
+    ranges(true, "9223372036854775808", "9223372036854775817", 10, 5));
+  EXPECT_EQ("`id` < 18446744073709551611 | `id` >= 18446744073709551611",
+    ranges(true, "18446744073709551607", "18446744073709551615", 20, 10));
+}
+
+TEST(PumpTableChunks, FullBigintRange)
+{
+  EXPECT_EQ("`id` < -4611686018427387905 | "
+    "`id` >= -4611686018427387905 AND `id` < -2 | "
+    "`id` >= -2 AND `id` < 4611686018427387901 | "
+    "`id` >= 4611686018427387901",
+    ranges(false, "-9223372036854775808", "9223372036854775807", 4, 1));
+  EXPECT_EQ("`id` < 4611686018427387903 | "
+    "`id` >= 4611686018427387903 AND `id` < 9223372036854775806 | "
+    "`id` >= 9223372036854775806 AND `id` < 13835058055282163709 | "
+    "`id` >= 13835058055282163709",
+    ranges(true, "0", "18446744073709551615", 4, 1));
+
+  // Every bound is above the previous one, and ranges follow each other
+  std::vector<std::string> conditions= get_key_range_conditions("k", false,
+    "-9223372036854775808", "9223372036854775807", 1000, 1);
+  ASSERT_EQ(1000U, conditions.size());
+  longlong previous= LLONG_MIN;
+  for (size_t i= 0; i + 1 < conditions.size(); ++i)
+  {
+    size_t pos= conditions[i].rfind("k < ");
+    ASSERT_NE(std::string::npos, pos) << conditions[i];
+    std::string bound= conditions[i].substr(pos + 4);
+    longlong value= strtoll(bound.c_str(), NULL, 10);
+    EXPECT_LT(previous, value) << conditions[i];
+    EXPECT_EQ("k >= " + bound, conditions[i + 1].substr(0, 5 + bound.size()));
+    previous= value;
+  }
+}
+
+}
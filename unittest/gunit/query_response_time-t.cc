@@ -0,0 +1,247 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/**
+  @file
+
+  Unit tests for the histograms of the QUERY_RESPONSE_TIME plugin: the
+  layout of the high dynamic range histogram for each hdr_precision,
+  the merging of the per CPU shards, and the values reported by
+  QUERY_RESPONSE_TIME_PERCENTILES at bucket edges.
+*/
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "../../plugin/query_response_time/query_response_time.cc"
+
+ulong opt_query_response_time_range_base= QRT_DEFAULT_BASE;
+ulong opt_query_response_time_hdr_precision= QRT_DEFAULT_HDR_PRECISION;
+
+namespace query_response_time_unittest {
+
+using query_response_time::hdr_layout;
+using query_response_time::time_collector;
+using query_response_time::utility;
+
+const double percentiles[]=
+  { 50.0, 75.0, 90.0, 95.0, 99.0, 99.9, 99.99, 100.0 };
+const uint percentile_count= array_elements(percentiles);
+
+class QueryResponseTimeTest : public ::testing::TestWithParam<uint>
+{
+protected:
+  virtual void SetUp()
+  {
+    m_utility.setup(QRT_DEFAULT_BASE);
+    m_hdr.setup(GetParam());
+    m_time= new time_collector(m_utility, m_hdr);
+    m_time->flush();
+    m_counts= new ulonglong[m_hdr.bucket_count()];
+  }
+  virtual void TearDown()
+  {
+    delete [] m_counts;
+    delete m_time;
+  }
+
+  /* Records the times in turn in each shard, alternating reads and writes */
+  void collect(const ulonglong *times, uint count)
+  {
+    for (uint i= 0; i < count; ++i)
+      m_time->collect(i % 2 ? WRITE : READ, times[i], i);
+  }
+  ulonglong fill_percentiles(QUERY_TYPE type, ulonglong *values)
+  {
+    return m_time->percentiles(type, percentiles, percentile_count,
+                               values, m_counts);
+  }
+
+  utility m_utility;
+  hdr_layout m_hdr;
+  time_collector *m_time;
+  ulonglong *m_counts;
+};
+
+INSTANTIATE_TEST_CASE_P(HdrPrecision, QueryResponseTimeTest,
+                        ::testing::Values(1U, 2U));
+
+
+TEST_P(QueryResponseTimeTest, HdrLayout)
+{
+  const uint precision= GetParam();
+  const uint sub_bucket_bits= precision == 1 ? 5 : 8;
+  const ulonglong max_value= (1ULL << HDR_MAX_VALUE_BITS) - 1;
+
+  EXPECT_EQ(precision, m_hdr.precision());
+  EXPECT_EQ(((HDR_MAX_VALUE_BITS - sub_bucket_bits + 2U) <<
+             (sub_bucket_bits - 1)) + 1, m_hdr.bucket_count());
+  EXPECT_LE(m_hdr.bucket_count(), (uint) HDR_MAX_BUCKET_COUNT);
+
+  // Small values have their own bucket.
+  for (ulonglong value= 0; value < (1ULL << sub_bucket_bits); ++value)
+  {
+    EXPECT_EQ(value, m_hdr.index(value));
+    EXPECT_EQ(value, m_hdr.highest_value(m_hdr.index(value)));
+  }
+
+  // Every bucket edge, with the required number of significant digits.
+  ulonglong error= 1;
+  for (uint i= 0; i < precision; ++i)
+    error*= 10;
+  for (uint bits= sub_bucket_bits; bits <= HDR_MAX_VALUE_BITS; ++bits)
+  {
+    const ulonglong edges[]= { (1ULL << bits) - 1, 1ULL << bits,
+                               (1ULL << bits) + 1, (3ULL << bits) / 2 };
+    for (uint e= 0; e < array_elements(edges); ++e)
+    {
+      ulonglong value= edges[e];
+      if (value > max_value)
+        continue;
+      uint index= m_hdr.index(value);
+      ASSERT_LT(index, m_hdr.overflow_index()) << value;
+      EXPECT_GE(m_hdr.highest_value(index), value);
+      EXPECT_LT(m_hdr.highest_value(index - 1), value);
+      EXPECT_LE(m_hdr.highest_value(index) - value, value / error) << value;
+    }
+  }
+
+  // The longest times do not share the last bucket with the overflow.
+  EXPECT_EQ(m_hdr.overflow_index() - 1, m_hdr.index(max_value));
+  EXPECT_EQ(max_value, m_hdr.highest_value(m_hdr.overflow_index() - 1));
+  EXPECT_EQ(m_hdr.overflow_index(), m_hdr.index(max_value + 1));
+  EXPECT_EQ(m_hdr.overflow_index(), m_hdr.index(~0ULL));
+  EXPECT_EQ(m_hdr.bucket_count() - 1, m_hdr.overflow_index());
+  EXPECT_EQ(HDR_OVERFLOW_VALUE, m_hdr.highest_value(m_hdr.overflow_index()));
+}
+
+
+TEST_P(QueryResponseTimeTest, MergeShards)
+{
+  const uint count= 1000;
+  ulonglong times[count];
+  ulonglong sum= 0;
+  for (uint i= 0; i < count; ++i)
+    sum+= (times[i]= (i * 7919ULL) % 3000000);
+  collect(times, count);
+
+  ulonglong hdr_total[3]= { 0, 0, 0 };
+  for (uint i= 0; i < m_hdr.bucket_count(); ++i)
+  {
+    hdr_total[ANY]+= m_time->hdr_count(ANY, i);
+    hdr_total[READ]+= m_time->hdr_count(READ, i);
+    hdr_total[WRITE]+= m_time->hdr_count(WRITE, i);
+    EXPECT_EQ(m_time->hdr_count(ANY, i),
+              m_time->hdr_count(READ, i) + m_time->hdr_count(WRITE, i));
+  }
+  EXPECT_EQ(count, hdr_total[ANY]);
+  EXPECT_EQ(count / 2, hdr_total[READ]);
+  EXPECT_EQ(count / 2, hdr_total[WRITE]);
+
+  for (uint i= 0; i < count; ++i)
+    EXPECT_LE(1U, m_time->hdr_count(ANY, m_hdr.index(times[i])));
+
+  ulonglong bound_count= 0, bound_total= 0;
+  for (uint i= 0; i < m_utility.bound_count(); ++i)
+  {
+    bound_count+= m_time->count(ANY, i);
+    bound_total+= m_time->total(ANY, i);
+  }
+  EXPECT_EQ(count, bound_count);
+  EXPECT_EQ(sum, bound_total);
+
+  ulonglong values[percentile_count];
+  EXPECT_EQ(count, fill_percentiles(ANY, values));
+  m_time->flush();
+  EXPECT_EQ(0U, fill_percentiles(ANY, values));
+  for (uint p= 0; p < percentile_count; ++p)
+    EXPECT_EQ(0U, values[p]);
+}
+
+
+TEST_P(QueryResponseTimeTest, PercentilesAtBucketEdges)
+{
+  // 1 to 1000 microseconds, reported as the top of their bucket.
+  const uint count= 1000;
+  ulonglong times[count];
+  for (uint i= 0; i < count; ++i)
+    times[i]= i + 1;
+  collect(times, count);
+
+  const ulonglong expected[2][percentile_count]=
+  {
+    { 511, 767, 927, 959, 991, 1023, 1023, 1023 },
+    { 501, 751, 903, 951, 991, 999, 1003, 1003 }
+  };
+  ulonglong values[percentile_count];
+  EXPECT_EQ(count, fill_percentiles(ANY, values));
+  for (uint p= 0; p < percentile_count; ++p)
+    EXPECT_EQ(expected[GetParam() - 1][p], values[p]) << percentiles[p];
+
+  // Each type on its own: the odd times are reads.
+  EXPECT_EQ(count / 2, fill_percentiles(READ, values));
+  EXPECT_EQ(m_hdr.highest_value(m_hdr.index(499)), values[0]);
+  EXPECT_EQ(m_hdr.highest_value(m_hdr.index(999)), values[percentile_count - 1]);
+  EXPECT_EQ(count / 2, fill_percentiles(WRITE, values));
+  EXPECT_EQ(m_hdr.highest_value(m_hdr.index(500)), values[0]);
+  EXPECT_EQ(m_hdr.highest_value(m_hdr.index(1000)), values[percentile_count - 1]);
+}
+
+
+TEST_P(QueryResponseTimeTest, FewQueries)
+{
+  const ulonglong times[]= { 10, 20, 5000 };
+  collect(times, array_elements(times));
+
+  ulonglong values[percentile_count];
+  EXPECT_EQ(3U, fill_percentiles(ANY, values));
+  EXPECT_EQ(20U, values[0]);
+  EXPECT_EQ(20U, values[1]);
+  for (uint p= 2; p < percentile_count; ++p)
+    EXPECT_EQ(m_hdr.highest_value(m_hdr.index(5000)), values[p]);
+
+  m_time->flush();
+  m_time->collect(READ, 42, 3);
+  EXPECT_EQ(1U, fill_percentiles(ANY, values));
+  for (uint p= 0; p < percentile_count; ++p)
+    EXPECT_EQ(m_hdr.highest_value(m_hdr.index(42)), values[p]);
+}
+
+
+TEST_P(QueryResponseTimeTest, Overflow)
+{
+  const ulonglong max_value= (1ULL << HDR_MAX_VALUE_BITS) - 1;
+  ulonglong times[100];
+  for (uint i= 0; i < 99; ++i)
+    times[i]= 100;
+  times[99]= max_value + 1;
+  collect(times, array_elements(times));
+
+  ulonglong values[percentile_count];
+  EXPECT_EQ(100U, fill_percentiles(ANY, values));
+  EXPECT_EQ(m_hdr.highest_value(m_hdr.index(100)), values[4]);  // 99
+  EXPECT_EQ(HDR_OVERFLOW_VALUE, values[5]);                     // 99.9
+  EXPECT_EQ(HDR_OVERFLOW_VALUE, values[percentile_count - 1]);
+
+  // The longest time below the overflow is not reported as too long.
+  m_time->flush();
+  m_time->collect(READ, max_value, 0);
+  EXPECT_EQ(1U, fill_percentiles(ANY, values));
+  EXPECT_EQ(max_value, values[percentile_count - 1]);
+}
+
+}  // namespace query_response_time_unittest
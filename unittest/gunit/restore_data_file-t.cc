@@ -0,0 +1,146 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "my_global.h"
+#include <string>
+#include <vector>
+
+#define UNITTEST_DATA_FILE_LOADER
+#include "../client/restore/data_file_loader.cc"
+
+using Mysql::Tools::Restore::get_batch_length;
+using Mysql::Tools::Restore::get_quoted_table_name;
+using Mysql::Tools::Restore::parse_data_file_name;
+
+namespace restore_data_file_unittest {
+
+/*
+  Cuts data into batches the way Data_file_loader does, reading it in
+  pieces of at most piece bytes.
+*/
+std::vector<std::string> split(const std::string& data, uint64 batch_size,
+  size_t piece)
+{
+  std::vector<std::string> batches;
+  size_t pos= 0;
+  while (pos < data.size())
+  {
+    bool complete= false;
+    uint64 batch_bytes= 0;
+    while (!complete && pos < data.size())
+    {
+      size_t length= std::min(piece, data.size() - pos);
+      size_t bytes= get_batch_length(data.data() + pos, length, batch_bytes,
+        batch_size, &complete);
+      EXPECT_LT(0U, bytes);
+      EXPECT_GE(length, bytes);
+      batch_bytes+= bytes;
+      pos+= bytes;
+    }
+    batches.push_back(data.substr(pos - batch_bytes, batch_bytes));
+  }
+  return batches;
+}
+
+std::string join(const std::vector<std::string>& batches)
+{
+  std::string result;
+  for (size_t i= 0; i < batches.size(); ++i)
+    result+= (i ? "|" : "") + batches[i];
+  return result;
+}
+
+TEST(RestoreDataFile, FileNames)
+{
+  std::string schema, table;
+  EXPECT_TRUE(parse_data_file_name("db.t1.0.txt", &schema, &table));
+  EXPECT_EQ("db", schema);
+  EXPECT_EQ("t1", table);
+  EXPECT_TRUE(parse_data_file_name("db.t1.12.txt.zst", &schema, &table));
+  EXPECT_EQ("t1", table);
+  EXPECT_TRUE(parse_data_file_name("my@2edb.t@60x.3.txt", &schema, &table));
+  EXPECT_EQ("my.db", schema);
+  EXPECT_EQ("t`x", table);
+
+  EXPECT_FALSE(parse_data_file_name("db.t1.txt", &schema, &table));
+  EXPECT_FALSE(parse_data_file_name("db.t1.x1.txt", &schema, &table));
+  EXPECT_FALSE(parse_data_file_name("db.t1.1.csv", &schema, &table));
+  EXPECT_FALSE(parse_data_file_name("db@2.t1.1.txt", &schema, &table));
+  EXPECT_FALSE(parse_data_file_name("db@zz.t1.1.txt", &schema, &table));
+  EXPECT_FALSE(parse_data_file_name(".t1.1.txt", &schema, &table));
+
+  EXPECT_EQ("`d``b`.`t`", get_quoted_table_name("d`b", "t"));
+}
+
+TEST(RestoreDataFile, BatchEnds)
+{
+  const std::string data("aaa\nbbb\nccc\n");
+
+  // Batches end with the line crossing the batch size
+  EXPECT_EQ("aaa\nbbb\n|ccc\n", join(split(data, 5, 1024)));
+  EXPECT_EQ("aaa\n|bbb\n|ccc\n", join(split(data, 4, 1024)));
+  EXPECT_EQ("aaa\n|bbb\n|ccc\n", join(split(data, 1, 1024)));
+  EXPECT_EQ("aaa\nbbb\nccc\n", join(split(data, 12, 1024)));
+  EXPECT_EQ("aaa\nbbb\nccc\n", join(split(data, 100, 1024)));
+
+  // The last line may have no line end
+  EXPECT_EQ("aaa\n|bbb", join(split("aaa\nbbb", 2, 1024)));
+}
+
+TEST(RestoreDataFile, BatchesIndependentOfReads)
+{
+  std::string data;
+  uint32 random= 1;
+  for (int i= 0; i < 2000; i++)
+  {
+    random= random * 1103515245U + 12345U;
+    data.append((random >> 8) % 300, 'x');
+    data+= '\n';
+  }
+
+  const uint64 batch_sizes[]= { 1, 100, 1000, 4096, 100000 };
+  for (size_t i= 0; i < array_elements(batch_sizes); i++)
+  {
+    const uint64 batch_size= batch_sizes[i];
+    std::vector<std::string> batches= split(data, batch_size, 4096);
+    std::string loaded;
+
+    for (size_t j= 0; j < batches.size(); j++)
+    {
+      const std::string& batch= batches[j];
+      loaded+= batch;
+      // A resumed load starts on a line
+      EXPECT_EQ('\n', batch[batch.size() - 1]) << batch_size << " " << j;
+      if (j + 1 < batches.size())
+      {
+        EXPECT_LE(batch_size, batch.size()) << batch_size << " " << j;
+        // The first line end at or after the batch size ends the batch
+        EXPECT_EQ(batch.size() - 1, batch.find('\n', batch_size - 1))
+          << batch_size << " " << j;
+      }
+    }
+    EXPECT_EQ(data, loaded);
+
+    EXPECT_EQ(join(batches), join(split(data, batch_size, 1)));
+    EXPECT_EQ(join(batches), join(split(data, batch_size, 7)));
+  }
+}
+
+}
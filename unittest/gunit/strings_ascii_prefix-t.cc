@@ -0,0 +1,326 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+/*
+  Tests for the ASCII fast paths of the multi-byte character sets:
+  my_ascii_prefix_len(), numchars, charpos, well_formed_len and
+  caseup/casedn for utf8mb4.
+
+  The results are compared with the original one character at a time
+  loops, which are kept here as reference implementations.
+  In order to do benchmarking, configure in optimized mode, and
+  generate a separate executable for this file:
+    cmake -DMERGE_UNITTESTS=0
+  and raise num_iterations below.
+ */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+#include <gtest/gtest.h>
+#include <string>
+
+#include "m_ctype.h"
+
+namespace strings_ascii_prefix_unittest {
+
+#if !defined(NDEBUG)
+// There is no point in benchmarking anything in debug mode.
+const size_t num_iterations= 1ULL;
+#else
+// Set this so that each test case takes a few seconds.
+// And set it back to a small value before pushing!!
+// const size_t num_iterations= 2000000ULL;
+const size_t num_iterations= 2ULL;
+#endif
+
+size_t numchars_orig(const CHARSET_INFO *cs, const char *pos, const char *end)
+{
+  size_t count= 0;
+  while (pos < end)
+  {
+    uint mb_len;
+    pos+= (mb_len= my_ismbchar(cs, pos, end)) ? mb_len : 1;
+    count++;
+  }
+  return count;
+}
+
+size_t charpos_orig(const CHARSET_INFO *cs, const char *pos, const char *end,
+                    size_t length)
+{
+  const char *start= pos;
+  while (length && pos < end)
+  {
+    uint mb_len;
+    pos+= (mb_len= my_ismbchar(cs, pos, end)) ? mb_len : 1;
+    length--;
+  }
+  return (size_t) (length ? end + 2 - start : pos - start);
+}
+
+size_t well_formed_len_orig(const CHARSET_INFO *cs, const char *b,
+                            const char *e, size_t pos, int *error)
+{
+  const char *b_start= b;
+  *error= 0;
+  while (pos)
+  {
+    my_wc_t wc;
+    int mb_len;
+    if ((mb_len= cs->cset->mb_wc(cs, &wc, (uchar*) b, (uchar*) e)) <= 0)
+    {
+      *error= b < e ? 1 : 0;
+      break;
+    }
+    b+= mb_len;
+    pos--;
+  }
+  return (size_t) (b - b_start);
+}
+
+size_t casefold_orig(const CHARSET_INFO *cs, bool upper,
+                     const char *src, size_t srclen,
+                     char *dst, size_t dstlen)
+{
+  const char *srcend= src + srclen;
+  char *dstend= dst + dstlen, *dst0= dst;
+  const MY_UNICASE_INFO *uni_plane= cs->caseinfo;
+  my_wc_t wc;
+  int srcres, dstres;
+
+  while (src < srcend &&
+         (srcres= cs->cset->mb_wc(cs, &wc, (uchar*) src, (uchar*) srcend)) > 0)
+  {
+    const MY_UNICASE_CHARACTER *page;
+    if (wc <= uni_plane->maxchar && (page= uni_plane->page[wc >> 8]))
+      wc= upper ? page[wc & 0xFF].toupper : page[wc & 0xFF].tolower;
+    if ((dstres= cs->cset->wc_mb(cs, wc, (uchar*) dst, (uchar*) dstend)) <= 0)
+      break;
+    src+= srcres;
+    dst+= dstres;
+  }
+  return (size_t) (dst - dst0);
+}
+
+const char *pieces[]=
+{
+  "a", "Z", "I", "i", " hello world ",
+  "0123456789abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+  "\xc3\xa9",                                   // U+00E9
+  "\xc4\xb0",                                   // U+0130
+  "\xe2\x82\xac",                               // U+20AC
+  "\xf0\x9f\x98\x80",                           // U+1F600
+  "\xff",                                       // Invalid
+  "\xc3"                                        // Truncated
+};
+
+class StringsAsciiPrefixTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    // A utf8mb4 character set with Turkish case rules.
+    m_turkish= my_charset_utf8mb4_general_ci;
+    m_turkish.caseinfo= &my_unicase_turkish;
+    m_random_state= 1;
+  }
+
+  uint next_random()
+  {
+    m_random_state= m_random_state * 1103515245U + 12345U;
+    return (m_random_state >> 16) & 0x7FFF;
+  }
+
+  std::string random_string()
+  {
+    std::string s;
+    uint count= next_random() % 24;
+    for (uint i= 0; i < count; i++)
+      s.append(pieces[next_random() % array_elements(pieces)]);
+    return s;
+  }
+
+  CHARSET_INFO m_turkish;
+  uint m_random_state;
+};
+
+TEST_F(StringsAsciiPrefixTest, AsciiPrefixLen)
+{
+  uchar buf[300];
+  memset(buf, 'a', sizeof(buf));
+
+  for (size_t high= 0; high < sizeof(buf); high++)
+  {
+    buf[high]= 0x80;
+    for (size_t start= 0; start <= high; start++)
+    {
+      EXPECT_EQ(high - start, my_ascii_prefix_len(buf + start,
+                                                  buf + sizeof(buf)));
+      EXPECT_EQ(high - start, my_ascii_prefix_len(buf + start, buf + high));
+    }
+    buf[high]= 'a';
+  }
+  EXPECT_EQ(sizeof(buf), my_ascii_prefix_len(buf, buf + sizeof(buf)));
+  EXPECT_EQ(0U, my_ascii_prefix_len(buf, buf));
+}
+
+TEST_F(StringsAsciiPrefixTest, CompareWithOriginal)
+{
+  const CHARSET_INFO *charsets[]=
+  {
+    &my_charset_utf8mb4_general_ci,
+    &my_charset_utf8_general_ci,
+    &my_charset_sjis_japanese_ci,
+    &m_turkish
+  };
+
+  for (uint i= 0; i < 20000; i++)
+  {
+    const CHARSET_INFO *cs= charsets[next_random() % array_elements(charsets)];
+    std::string s= random_string();
+    const char *b= s.data() + next_random() % (s.length() + 1);
+    const char *e= s.data() + s.length();
+    size_t pos= next_random() % 64;
+
+    EXPECT_EQ(numchars_orig(cs, b, e), cs->cset->numchars(cs, b, e));
+    EXPECT_EQ(charpos_orig(cs, b, e, pos), cs->cset->charpos(cs, b, e, pos));
+
+    if (cs != &my_charset_sjis_japanese_ci)
+    {
+      int error_orig, error;
+      EXPECT_EQ(well_formed_len_orig(cs, b, e, pos, &error_orig),
+                cs->cset->well_formed_len(cs, b, e, pos, &error));
+      EXPECT_EQ(error_orig, error);
+    }
+
+    if (cs->mbmaxlen == 4)
+    {
+      char expected[4096], result[4096];
+      size_t dstlen= next_random() % (2 * (e - b) + 2);
+      size_t len;
+
+      len= casefold_orig(cs, false, b, e - b, expected, dstlen);
+      EXPECT_EQ(len, cs->cset->casedn(cs, const_cast<char*>(b), e - b,
+                                      result, dstlen));
+      EXPECT_EQ(0, memcmp(expected, result, len));
+
+      len= casefold_orig(cs, true, b, e - b, expected, dstlen);
+      EXPECT_EQ(len, cs->cset->caseup(cs, const_cast<char*>(b), e - b,
+                                      result, dstlen));
+      EXPECT_EQ(0, memcmp(expected, result, len));
+    }
+  }
+}
+
+TEST_F(StringsAsciiPrefixTest, TurkishCaseFolding)
+{
+  char src[]= "Iii";
+  char dst[16];
+  size_t len;
+
+  // 'i' is upper cased to U+0130, not to 'I'.
+  len= m_turkish.cset->caseup(&m_turkish, src, 3, dst, sizeof(dst));
+  EXPECT_EQ(std::string("I\xc4\xb0\xc4\xb0"), std::string(dst, len));
+
+  // 'I' is lower cased to U+0131, not to 'i'.
+  len= m_turkish.cset->casedn(&m_turkish, src, 3, dst, sizeof(dst));
+  EXPECT_EQ(std::string("\xc4\xb1ii"), std::string(dst, len));
+}
+
+#if defined(GTEST_HAS_PARAM_TEST)
+
+class StringsAsciiPrefixBenchmark : public ::testing::TestWithParam<size_t>
+{
+protected:
+  virtual void SetUp()
+  {
+    m_length= GetParam();
+    for (size_t ix= 0; ix < m_length; ++ix)
+      m_string.push_back(static_cast<char>('a' + ix % 26));
+    // One non-ASCII character at the end, like most real text.
+    m_string.append("\xc3\xa9");
+    m_dst.resize(m_string.length());
+  }
+  size_t m_length;
+  std::string m_string;
+  std::string m_dst;
+};
+
+size_t test_values[]= {8, 64, 1000, 100000};
+
+INSTANTIATE_TEST_CASE_P(Ascii, StringsAsciiPrefixBenchmark,
+                        ::testing::ValuesIn(test_values));
+
+TEST_P(StringsAsciiPrefixBenchmark, NumcharsOriginal)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_length + 1, numchars_orig(cs, m_string.data(),
+                                          m_string.data() + m_string.length()));
+}
+
+TEST_P(StringsAsciiPrefixBenchmark, Numchars)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_length + 1,
+              cs->cset->numchars(cs, m_string.data(),
+                                 m_string.data() + m_string.length()));
+}
+
+TEST_P(StringsAsciiPrefixBenchmark, WellFormedLenOriginal)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  int error;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_string.length(),
+              well_formed_len_orig(cs, m_string.data(),
+                                   m_string.data() + m_string.length(),
+                                   m_string.length(), &error));
+}
+
+TEST_P(StringsAsciiPrefixBenchmark, WellFormedLen)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  int error;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_string.length(),
+              cs->cset->well_formed_len(cs, m_string.data(),
+                                        m_string.data() + m_string.length(),
+                                        m_string.length(), &error));
+}
+
+TEST_P(StringsAsciiPrefixBenchmark, CasednOriginal)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_string.length(),
+              casefold_orig(cs, false, m_string.data(), m_string.length(),
+                            &m_dst[0], m_dst.length()));
+}
+
+TEST_P(StringsAsciiPrefixBenchmark, Casedn)
+{
+  const CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  for (size_t ix= 0; ix < num_iterations; ++ix)
+    EXPECT_EQ(m_string.length(),
+              cs->cset->casedn(cs, &m_string[0], m_string.length(),
+                               &m_dst[0], m_dst.length()));
+}
+
+#endif  // GTEST_HAS_PARAM_TEST
+
+}
@@ -407,4 +407,68 @@ TEST_F(StringsUTF8mb4Test, MyIsmbcharUtf8mb4)
   /* Not testing for illegal charaters as same is tested in above test case */
 }
 
+
+/*
+  The UCA collations handle runs of ASCII characters without the
+  full weight scanner. Check that they sort exactly like the scanner,
+  also with contractions ("ch" in Czech) and ignorable characters.
+*/
+TEST(StringsUCATest, AsciiFastPath)
+{
+  const char *collations[]=
+  {
+    "utf8mb4_unicode_ci", "utf8mb4_unicode_520_ci",
+    "utf8mb4_czech_ci", "utf8mb4_spanish2_ci", "utf8_unicode_ci"
+  };
+  const char *strings[]=
+  {
+    "", "a", "A", "ab", "abc ", "abc", "abd", "customer_0001",
+    "customer_0002", "cha", "cHa", "cia", "hab", "ll", "lz",
+    "a\x01b", "ab\x01", "caf\xc3\xa9", "cafe", "cafe\xcc\x81",
+    "stra\xc3\x9f""e", "strasse", "x\xf0\x9f\x98\x80", "ab\xff"
+  };
+
+  for (size_t c= 0; c < array_elements(collations); c++)
+  {
+    CHARSET_INFO *cs= get_charset_by_name(collations[c], MYF(0));
+    ASSERT_TRUE(cs != NULL);
+    MY_UCA_WEIGHT_LEVEL *level= &cs->uca->level[0];
+    uint16 *ascii_weights= level->ascii_weights;
+    EXPECT_TRUE(ascii_weights != NULL);
+
+    for (size_t i= 0; i < array_elements(strings); i++)
+    {
+      const uchar *s= reinterpret_cast<const uchar*>(strings[i]);
+      size_t slen= strlen(strings[i]);
+      uchar fast_key[128], slow_key[128];
+      size_t fast_len, slow_len;
+
+      fast_len= cs->coll->strnxfrm(cs, fast_key, sizeof(fast_key), 64,
+                                   s, slen, MY_STRXFRM_PAD_WITH_SPACE);
+      level->ascii_weights= NULL;
+      slow_len= cs->coll->strnxfrm(cs, slow_key, sizeof(slow_key), 64,
+                                   s, slen, MY_STRXFRM_PAD_WITH_SPACE);
+      level->ascii_weights= ascii_weights;
+      EXPECT_EQ(slow_len, fast_len);
+      EXPECT_EQ(0, memcmp(slow_key, fast_key, fast_len));
+
+      for (size_t j= 0; j < array_elements(strings); j++)
+      {
+        const uchar *t= reinterpret_cast<const uchar*>(strings[j]);
+        size_t tlen= strlen(strings[j]);
+        int fast_cmp, slow_cmp;
+
+        fast_cmp= cs->coll->strnncollsp(cs, s, slen, t, tlen, 0);
+        level->ascii_weights= NULL;
+        slow_cmp= cs->coll->strnncollsp(cs, s, slen, t, tlen, 0);
+        level->ascii_weights= ascii_weights;
+        EXPECT_EQ(slow_cmp < 0, fast_cmp < 0)
+          << strings[i] << " " << strings[j];
+        EXPECT_EQ(slow_cmp > 0, fast_cmp > 0)
+          << strings[i] << " " << strings[j];
+      }
+    }
+  }
+}
+
 }
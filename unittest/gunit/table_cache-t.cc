@@ -65,6 +65,11 @@ protected:
     thd_manager->set_unit_test();
     // Reset thread ID counter for each test.
     thd_manager->set_thread_id_counter(1);
+    /*
+      Tests rely on connections being assigned to table cache
+      instances by thread id, not by the CPU they happen to run on.
+    */
+    table_cache_cpu_affinity= false;
     for (uint i= 0; i < MAX_THREADS; ++i)
     {
       initializer[i].SetUp();
@@ -657,6 +662,73 @@ TEST_F(TableCacheDoubleCacheTest, ManagerFreeAllUnused)
 }
 
 
+/*
+  Test that TABLE objects remember the table cache instance which
+  holds them, so they are given back to it even if the connection
+  uses a different instance by then.
+*/
+
+TEST_F(TableCacheDoubleCacheTest, ManagerCacheOfTable)
+{
+  THD *thd_1= get_thd(0);
+  THD *thd_2= get_thd(1);
+
+  Table_cache *table_cache_1= table_cache_manager.get_cache(thd_1);
+  Table_cache *table_cache_2= table_cache_manager.get_cache(thd_2);
+  EXPECT_TRUE(table_cache_1 != table_cache_2);
+
+  Mock_share share_1("share_1");
+  TABLE *table_1= share_1.create_table(thd_1);
+  TABLE *table_2= share_1.create_table(thd_1);
+
+  table_cache_1->lock();
+  table_cache_1->add_used_table(thd_1, table_1);
+  table_cache_1->unlock();
+
+  // Emulate connection which has moved to another instance.
+  table_cache_2->lock();
+  table_cache_2->add_used_table(thd_1, table_2);
+  table_cache_2->unlock();
+
+  EXPECT_TRUE(Table_cache_manager::get_cache(table_1) == table_cache_1);
+  EXPECT_TRUE(Table_cache_manager::get_cache(table_2) == table_cache_2);
+
+  Table_cache *tc= Table_cache_manager::get_cache(table_2);
+  tc->lock();
+  tc->release_table(thd_1, table_2);
+  tc->unlock();
+
+  EXPECT_EQ(1U, table_cache_1->cached_tables());
+  EXPECT_EQ(1U, table_cache_2->cached_tables());
+
+  // The released TABLE is found in the instance which holds it.
+  my_hash_value_type hash_value= my_calc_hash(&table_def_cache,
+                                   (uchar*)share_1.table_cache_key.str,
+                                   share_1.table_cache_key.length);
+  TABLE *table_3;
+  TABLE_SHARE *share_3;
+
+  table_cache_2->lock();
+  table_3= table_cache_2->get_table(thd_2, hash_value,
+                                    share_1.table_cache_key.str,
+                                    share_1.table_cache_key.length,
+                                    &share_3);
+  EXPECT_TRUE(table_3 == table_2);
+  EXPECT_TRUE(share_3 == &share_1);
+  table_cache_2->remove_table(table_2);
+  table_cache_2->unlock();
+
+  table_cache_1->lock();
+  table_cache_1->remove_table(table_1);
+  table_cache_1->unlock();
+
+  EXPECT_EQ(0U, table_cache_manager.cached_tables());
+
+  share_1.destroy_table(table_1);
+  share_1.destroy_table(table_2);
+}
+
+
 /*
   Test for Table_cache_manager/Table_cache::cached_tables().
 */
@@ -0,0 +1,142 @@
+/* Copyright (c) 2024 Percona LLC and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "my_config.h"
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include "my_thread.h"
+#include "mysqld.h"
+#include "sql_class.h"
+#include "conn_handler/thd_pool.h"
+
+namespace thd_pool_unittest {
+
+using my_testing::Server_initializer;
+
+/*
+  Leaks of THD::reinit_for_connection(), which runs THD::init() a second
+  time, are reported by the Valgrind and ASAN runs of the unit tests.
+*/
+class ThdPoolTest : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    initializer.SetUp();
+    saved_pool_size= Thd_pool::pool_size;
+  }
+
+  virtual void TearDown()
+  {
+    Thd_pool::pool_size= saved_pool_size;
+    initializer.TearDown();
+  }
+
+  /* The session state THD::init() sets up for a new connection */
+  static void expect_same_session(THD *fresh, THD *pooled)
+  {
+    EXPECT_EQ(fresh->variables.sql_mode, pooled->variables.sql_mode);
+    EXPECT_EQ(fresh->variables.option_bits, pooled->variables.option_bits);
+    EXPECT_EQ(fresh->variables.tx_isolation, pooled->variables.tx_isolation);
+    EXPECT_EQ(fresh->variables.pseudo_server_id,
+              pooled->variables.pseudo_server_id);
+    EXPECT_EQ(pooled->thread_id(), pooled->variables.pseudo_thread_id);
+    EXPECT_EQ(fresh->tx_isolation, pooled->tx_isolation);
+    EXPECT_EQ(fresh->tx_read_only, pooled->tx_read_only);
+    EXPECT_EQ(fresh->server_status, pooled->server_status);
+    EXPECT_EQ(fresh->update_lock_default, pooled->update_lock_default);
+    EXPECT_EQ(fresh->insert_lock_default, pooled->insert_lock_default);
+    EXPECT_EQ(fresh->charset(), pooled->charset());
+    EXPECT_EQ(0U, pooled->status_var.questions);
+    EXPECT_EQ(0U, pooled->status_var.com_stmt_prepare);
+  }
+
+  Server_initializer initializer;
+  ulong saved_pool_size;
+};
+
+
+/* Construct a THD on another thread, as the pool thread does */
+extern "C" void *construct_thd(void *arg)
+{
+  my_thread_init();
+  *static_cast<THD **>(arg)= new THD(false);
+  my_thread_end();
+  return NULL;
+}
+
+
+TEST_F(ThdPoolTest, PooledMatchesFresh)
+{
+  Thd_pool::pool_size= 2;
+  ASSERT_FALSE(Thd_pool::init(false));
+
+  THD *pooled= NULL;
+  for (int i= 0; i < 1000 && (pooled= Thd_pool::get()) == NULL; i++)
+    my_sleep(1000);
+  ASSERT_TRUE(pooled != NULL);
+
+  THD *fresh= new THD(false);
+  expect_same_session(fresh, pooled);
+  delete fresh;
+  delete pooled;
+
+  // Deletes the THDs left in the pool.
+  Thd_pool::destroy();
+  initializer.thd()->store_globals();
+}
+
+
+TEST_F(ThdPoolTest, ReinitLoadsCurrentGlobals)
+{
+  my_thread_handle thread;
+  my_thread_attr_t attr;
+  THD *pooled= NULL;
+
+  my_thread_attr_init(&attr);
+  ASSERT_EQ(0, my_thread_create(&thread, &attr, construct_thd, &pooled));
+  my_thread_join(&thread, NULL);
+  my_thread_attr_destroy(&attr);
+  ASSERT_TRUE(pooled != NULL);
+
+  // Global variables changed while the THD waited in the pool.
+  const sql_mode_t saved_sql_mode= global_system_variables.sql_mode;
+  const ulong saved_isolation= global_system_variables.tx_isolation;
+  global_system_variables.sql_mode= MODE_ANSI_QUOTES | MODE_NO_BACKSLASH_ESCAPES;
+  global_system_variables.tx_isolation= ISO_SERIALIZABLE;
+
+  // What Thd_pool::get() does, twice, as a THD may be reinitialized again.
+  pooled->claim_memory_ownership();
+  pooled->reinit_for_connection();
+  pooled->reinit_for_connection();
+
+  THD *fresh= new THD(false);
+  expect_same_session(fresh, pooled);
+  EXPECT_EQ(MODE_ANSI_QUOTES | MODE_NO_BACKSLASH_ESCAPES,
+            pooled->variables.sql_mode);
+  EXPECT_EQ(ISO_SERIALIZABLE, pooled->tx_isolation);
+  EXPECT_TRUE(pooled->server_status & SERVER_STATUS_NO_BACKSLASH_ESCAPES);
+
+  global_system_variables.sql_mode= saved_sql_mode;
+  global_system_variables.tx_isolation= saved_isolation;
+  delete fresh;
+  delete pooled;
+  initializer.thd()->store_globals();
+}
+
+}
@@ -264,6 +264,39 @@ size_t vio_write(Vio *vio, const uchar* buf, size_t size)
   DBUG_RETURN(ret);
 }
 
+#ifndef _WIN32
+size_t vio_writev(Vio *vio, const struct iovec *iov, int iovcnt)
+{
+  ssize_t ret;
+  int flags= 0;
+  struct msghdr msg;
+  DBUG_ENTER("vio_writev");
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov= (struct iovec *) iov;
+  msg.msg_iovlen= iovcnt;
+
+  /* If timeout is enabled, do not block. */
+  if (vio->write_timeout >= 0)
+    flags= VIO_DONTWAIT;
+
+  while ((ret= mysql_socket_sendmsg(vio->mysql_socket, &msg, flags)) == -1)
+  {
+    int error= socket_errno;
+
+    /* The operation would block? */
+    if (error != SOCKET_EAGAIN && error != SOCKET_EWOULDBLOCK)
+      break;
+
+    /* Wait for the output buffer to become writable.*/
+    if ((ret= vio_socket_io_wait(vio, VIO_IO_EVENT_WRITE)))
+      break;
+  }
+
+  DBUG_RETURN(ret);
+}
+#endif
+
 #ifdef _WIN32
 static void CALLBACK cancel_io_apc(ULONG_PTR data)
 {
@@ -369,6 +369,7 @@ static int ssl_handshake_loop(Vio *vio, SSL *ssl,
 static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio,
                   long timeout MY_ATTRIBUTE((unused)),
                   ssl_handshake_func_t func,
+                  SSL_SESSION *session,
                   unsigned long *ssl_errno_holder)
 {
   int r;
@@ -419,6 +420,13 @@ static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio,
       }
   }
 #endif
+  /*
+    Offer the session of an earlier connection: if the server accepts its
+    ticket, the handshake skips the key exchange and certificate checks.
+  */
+  if (session != NULL && !SSL_set_session(ssl, session))
+    DBUG_PRINT("info", ("SSL_set_session failed, doing a full handshake"));
+
   ERR_clear_error();
 
   if ((r= ssl_handshake_loop(vio, ssl, func, ssl_errno_holder)) < 1)
@@ -444,6 +452,7 @@ static int ssl_do(struct st_VioSSLFd *ptr, Vio *vio,
 
     DBUG_PRINT("info",("SSL connection succeeded"));
     DBUG_PRINT("info",("Using cipher: '%s'" , SSL_get_cipher_name(ssl)));
+    DBUG_PRINT("info",("Session reused: %d", (int) SSL_session_reused(ssl)));
 
     if ((cert= SSL_get_peer_certificate (ssl)))
     {
@@ -474,7 +483,7 @@ int sslaccept(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
               unsigned long *ssl_errno_holder)
 {
   DBUG_ENTER("sslaccept");
-  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_accept, ssl_errno_holder));
+  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_accept, NULL, ssl_errno_holder));
 }
 
 
@@ -482,7 +491,18 @@ int sslconnect(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
                unsigned long *ssl_errno_holder)
 {
   DBUG_ENTER("sslconnect");
-  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_connect, ssl_errno_holder));
+  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_connect, NULL,
+                     ssl_errno_holder));
+}
+
+
+int sslconnect_with_session(struct st_VioSSLFd *ptr, Vio *vio, long timeout,
+                            SSL_SESSION *session,
+                            unsigned long *ssl_errno_holder)
+{
+  DBUG_ENTER("sslconnect_with_session");
+  DBUG_RETURN(ssl_do(ptr, vio, timeout, SSL_connect, session,
+                     ssl_errno_holder));
 }
 
 